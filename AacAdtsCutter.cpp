@@ -0,0 +1,174 @@
+#include <errno.h>
+#include <unistd.h>
+
+#include <sys/sendfile.h>
+#include <sys/types.h>
+
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsIndex.h"
+#include "AacAudioBlock.h"
+
+#include "AacAdtsCutter.h"
+
+// Ways of copying, tried in order until one works for the files involved
+enum AacCopyMethod
+{
+  AAC_COPY_FILE_RANGE,  // In the kernel, sharing extents where the filesystem can
+  AAC_COPY_SENDFILE,  // In the kernel, to any output including pipes
+  AAC_COPY_WRITE,  // From the mapping
+};
+
+// Copies bytes [offset, offset + size) of the input to the output's current
+//  position, falling back to the next method when one isn't supported
+static bool copyRange(int inputFd, const uint8_t *bytes, uint64_t offset, uint64_t size, int outputFd, AacCopyMethod *method)
+{
+  off_t inputOffset = offset;
+
+  while (size)
+  {
+    ssize_t count;
+
+    switch (*method)
+    {
+    case AAC_COPY_FILE_RANGE:
+      count = copy_file_range(inputFd, &inputOffset, outputFd, NULL, size, 0);
+      break;
+    case AAC_COPY_SENDFILE:
+      count = sendfile(outputFd, inputFd, &inputOffset, size);
+      break;
+    default:
+      count = ::write(outputFd, bytes + inputOffset, size);
+      if (count > 0)
+        inputOffset += count;
+      break;
+    }
+
+    if (count > 0)
+    {
+      size -= count;
+      continue;
+    }
+
+    if (count == 0)
+    {
+      errno = EIO;  // The source is shorter than its index says
+      return false;
+    }
+
+    if (errno == EINTR)
+      continue;
+
+    bool isUnsupported = (errno == EXDEV) || (errno == EINVAL) || (errno == ENOSYS) || (errno == EOPNOTSUPP) || (errno == EBADF);
+    if ((*method == AAC_COPY_WRITE) || !isUnsupported)
+      return false;
+
+    *method = static_cast<AacCopyMethod>(*method + 1);
+  }
+
+  return true;
+}
+
+bool AacAdtsCutter::addRange(int fd, const uint8_t *bytes, const AacAdtsIndex *index, uint64_t startSample, uint64_t endSample)
+{
+  endSample = std::min(endSample, index->getSampleCount());
+  if (startSample >= endSample)
+    return false;
+
+  size_t first = index->findFrame(startSample);
+  size_t last = index->findFrame(endSample - 1);
+
+  AacAdtsCutSegment segment;
+  segment.fd    = fd;
+  segment.bytes = bytes;
+  segment.index = index;
+
+  segment.hasPreRoll = m_isPreRolled && (first > 0);
+  segment.firstFrame = first - (segment.hasPreRoll ? 1 : 0);
+  segment.frameCount = last + 1 - segment.firstFrame;
+
+  AacAdtsIndexEntry firstEntry = index->getEntry(first);
+  AacAdtsIndexEntry lastEntry  = index->getEntry(last);
+
+  segment.leadingSamples  = startSample - firstEntry.sample;
+  segment.trailingSamples = lastEntry.sample + (lastEntry.blockCount * AAC_AUDIO_BLOCK_SAMPLE_COUNT) - endSample;
+
+  segment.offset = index->getEntry(segment.firstFrame).offset;
+  segment.size = 0;
+
+  for (size_t frame = segment.firstFrame; frame <= last; frame++)
+    segment.size += index->getEntry(frame).size;
+
+  segment.spliceMismatches = m_segments.empty() ? 0 : getSpliceMismatches(&m_segments.back(), &segment);
+
+  m_segments.push_back(segment);
+  return true;
+}
+
+unsigned int AacAdtsCutter::getSpliceMismatches(const AacAdtsCutSegment *previous, const AacAdtsCutSegment *next)
+{
+  auto before = AacAdtsFrameHeader(previous->bytes + previous->index->getEntry(previous->firstFrame + previous->frameCount - 1).offset);
+  auto after  = AacAdtsFrameHeader(next->bytes + next->index->getEntry(next->firstFrame).offset);
+
+  unsigned int mismatches = 0;
+
+  if (before.getProfile() != after.getProfile())
+    mismatches |= AAC_SPLICE_PROFILE;
+
+  if (before.getSampleRate() != after.getSampleRate())
+    mismatches |= AAC_SPLICE_SAMPLE_RATE;
+
+  auto beforeChannels = before.getChannelConfiguration();
+  auto afterChannels  = after.getChannelConfiguration();
+
+  if ((beforeChannels->fullChannelCount != afterChannels->fullChannelCount) || (beforeChannels->subwooferChannelCount != afterChannels->subwooferChannelCount))
+    mismatches |= AAC_SPLICE_CHANNEL_CONFIG;
+
+  return mismatches;
+}
+
+bool AacAdtsCutter::isCompatible(void)
+{
+  for (const auto &segment : m_segments)
+  {
+    if (segment.spliceMismatches)
+      return false;
+  }
+
+  return true;
+}
+
+bool AacAdtsCutter::write(int outputFd)
+{
+  AacCopyMethod method = AAC_COPY_FILE_RANGE;
+
+  for (const auto &segment : m_segments)
+  {
+    // Frames are nearly always back to back, but any damage skipped over
+    //  when indexing is left out, so copy each contiguous run in one go
+    uint64_t runOffset = segment.offset;
+    uint64_t runSize = 0;
+
+    for (size_t frame = segment.firstFrame; frame < segment.firstFrame + segment.frameCount; frame++)
+    {
+      AacAdtsIndexEntry entry = segment.index->getEntry(frame);
+
+      if (entry.offset != runOffset + runSize)
+      {
+        if (!copyRange(segment.fd, segment.bytes, runOffset, runSize, outputFd, &method))
+          return false;
+
+        runOffset = entry.offset;
+        runSize = 0;
+      }
+
+      runSize += entry.size;
+    }
+
+    if (!copyRange(segment.fd, segment.bytes, runOffset, runSize, outputFd, &method))
+      return false;
+  }
+
+  return true;
+}
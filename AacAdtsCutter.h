@@ -0,0 +1,80 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#ifndef AAC_ADTS_CUTTER_H
+#define AAC_ADTS_CUTTER_H
+
+class AacAdtsIndex;
+
+// Stream parameters that must match across a splice for the result to play
+//  as one stream
+enum AacAdtsSpliceMismatch : unsigned int
+{
+  AAC_SPLICE_PROFILE        = 0x1,
+  AAC_SPLICE_SAMPLE_RATE    = 0x2,
+  AAC_SPLICE_CHANNEL_CONFIG = 0x4,
+};
+
+// A run of whole frames copied from one source
+struct AacAdtsCutSegment
+{
+  int                 fd;
+  const uint8_t      *bytes;
+  const AacAdtsIndex *index;
+
+  size_t              firstFrame;
+  size_t              frameCount;
+
+  uint64_t            offset;  // Byte range in the source
+  uint64_t            size;
+
+  // Whole frames can only approximate the samples asked for. These are the
+  //  samples per channel copied before and after them, not counting any
+  //  pre-roll frame.
+  unsigned int        leadingSamples;
+  unsigned int        trailingSamples;
+
+  // An extra frame copied before the first wanted one, so that the overlap
+  //  of the first wanted frame decodes as it did in the source
+  bool                hasPreRoll;
+
+  // Parameters that differ from the end of the previous segment, if any
+  unsigned int        spliceMismatches;
+};
+
+// Builds a new ADTS stream from ranges of existing ones, copying whole
+//  frames without decoding them. The frames are found through each source's
+//  index, and the bytes are copied file to file by the kernel where possible.
+// AAC frames overlap, so the first block after any cut decodes without the
+//  audio that came before it in the source. Asking for pre-roll copies one
+//  more frame at the start of each segment, whose output can be dropped.
+class AacAdtsCutter
+{
+  std::vector<AacAdtsCutSegment> m_segments;
+
+  bool m_isPreRolled;
+
+  unsigned int getSpliceMismatches(const AacAdtsCutSegment *previous, const AacAdtsCutSegment *next);
+
+public:
+  AacAdtsCutter(void) : m_isPreRolled(false) {};
+
+  void setPreRoll(bool isPreRolled) { m_isPreRolled = isPreRolled; };
+
+  // Adds the frames holding samples [startSample, endSample) of a source,
+  //  which must stay open and mapped until written. The index must have been
+  //  built from the same bytes. Fails if the range is empty.
+  bool addRange(int fd, const uint8_t *bytes, const AacAdtsIndex *index, uint64_t startSample, uint64_t endSample);
+
+  const std::vector<AacAdtsCutSegment> &getSegments(void) { return m_segments; };
+
+  // True if no splice joins mismatched parameters
+  bool isCompatible(void);
+
+  // Writes every segment in order. Returns false with errno set on failure.
+  bool write(int outputFd);
+};
+
+#endif
@@ -1,5 +1,48 @@
+#include <array>
+
+#include "AacStructs.h"
+
 #include "AacAdtsFrame.h"
 
+// CRC-16 with polynomial x^16 + x^15 + x^2 + 1, as for MPEG audio
+#define AAC_CRC_POLYNOMIAL 0x8005
+#define AAC_CRC_INITIAL    0xFFFF
+
+static constexpr std::array<uint16_t, 256> makeCrcTable(void)
+{
+  std::array<uint16_t, 256> table = {};
+
+  for (unsigned int i = 0; i < 256; i++)
+  {
+    uint16_t crc = i << 8;
+    for (unsigned int bit = 0; bit < 8; bit++)
+      crc = (crc & 0x8000) ? ((crc << 1) ^ AAC_CRC_POLYNOMIAL) : (crc << 1);
+
+    table[i] = crc;
+  }
+
+  return table;
+}
+
+static constexpr std::array<uint16_t, 256> crcTable = makeCrcTable();
+
+static uint16_t updateCrc(uint16_t crc, uint8_t byte)
+{
+  return (crc << 8) ^ crcTable[(crc >> 8) ^ byte];
+}
+
+// Adds count bits (at most 8) from the top of byte
+static uint16_t updateCrcBits(uint16_t crc, uint8_t byte, unsigned int count)
+{
+  for (unsigned int bit = 0; bit < count; bit++)
+  {
+    bool isSet = ((crc >> 15) ^ (byte >> (7 - bit))) & 0x01;
+    crc = isSet ? ((crc << 1) ^ AAC_CRC_POLYNOMIAL) : (crc << 1);
+  }
+
+  return crc;
+}
+
 AacAdtsFrame::AacAdtsFrame(void)
 {
   m_reader = AacBitReader(NULL, 0);
@@ -11,3 +54,55 @@ void AacAdtsFrame::setHeader(const AacAdtsFrameHeader *header)
 
   m_reader = AacBitReader(m_header.getPayloadBytes(), m_header.getPayloadSize());
 }
+
+bool AacAdtsFrame::checkCrc(const AacSpectralBlock *block) const
+{
+  if (!m_header.hasCrcProtection())
+    return true;
+
+  // The CRC follows the header
+  const uint8_t *header = m_header.getPayloadBytes() - AAC_ADTS_FRAME_HEADER_SIZE - 2;
+  uint16_t expected = (header[AAC_ADTS_FRAME_HEADER_SIZE] << 8) | header[AAC_ADTS_FRAME_HEADER_SIZE + 1];
+
+  uint16_t crc = AAC_CRC_INITIAL;
+
+  for (unsigned int i = 0; i < AAC_ADTS_FRAME_HEADER_SIZE; i++)
+    crc = updateCrc(crc, header[i]);
+
+  // The regions are a few dozen bytes at most, so a byte at a time is
+  //  plenty. They don't start on byte boundaries, so each byte is pieced
+  //  together from two.
+  const uint8_t *payload = m_header.getPayloadBytes();
+
+  for (unsigned int r = 0; r < block->crcRegionCount; r++)
+  {
+    const AacCrcRegion *region = &block->crcRegions[r];
+
+    const uint8_t *bytes = payload + (region->start / 8);
+    unsigned int   shift = region->start % 8;
+
+    unsigned int byteCount = region->bitCount / 8;
+    for (unsigned int i = 0; i < byteCount; i++)
+      crc = updateCrc(crc, (bytes[i] << shift) | (shift ? (bytes[i + 1] >> (8 - shift)) : 0));
+
+    // The rest of the last byte, which can't run past the end of the block
+    unsigned int bitCount = region->bitCount % 8;
+    if (bitCount)
+    {
+      uint8_t last = bytes[byteCount] << shift;
+      if (shift + bitCount > 8)
+        last |= bytes[byteCount + 1] >> (8 - shift);
+
+      crc = updateCrcBits(crc, last, bitCount);
+    }
+
+    // Elements shorter than the protected length are padded with zeroes
+    unsigned int paddingCount = region->protectedBits - region->bitCount;
+    for (; paddingCount >= 8; paddingCount -= 8)
+      crc = updateCrc(crc, 0);
+
+    crc = updateCrcBits(crc, 0, paddingCount);
+  }
+
+  return crc == expected;
+}
@@ -6,6 +6,8 @@
 #ifndef AAC_ADTS_FRAME_H
 #define AAC_ADTS_FRAME_H
 
+struct AacSpectralBlock;
+
 class AacAdtsFrame
 {
   AacAdtsFrameHeader m_header;
@@ -21,6 +23,10 @@ public:
   size_t                    getSize(void) { return m_header.getFrameSize(); };
 
   AacBitReader             *getReader(void) { return &m_reader; };
+
+  // Checks the frame's CRC, if it has one, against the header and the
+  //  regions of the raw data block recorded while parsing it
+  bool                      checkCrc(const AacSpectralBlock *block) const;
 };
 
 #endif
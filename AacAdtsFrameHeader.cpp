@@ -49,6 +49,11 @@ const AacChannelConfiguration *AacAdtsFrameHeader::getChannelConfiguration(void)
   return &channelConfigurations[getChannelConfigurationIndex()];
 }
 
+const char *AacAdtsFrameHeader::getProfileName(AacAdtsProfile profile)
+{
+  return profileNames[profile & 0x03];
+}
+
 const uint8_t *AacAdtsFrameHeader::getPayloadBytes(void) const
 {
   assert(getDataBlockCount() == 1);
@@ -5,6 +5,7 @@
 #define AAC_ADTS_FRAME_HEADER_H
 
 #define AAC_ADTS_FRAME_HEADER_SIZE 7
+#define AAC_ADTS_MAX_FRAME_SIZE    8191  // 13-bit frame length field
 
 enum AacAdtsProfile
 {
@@ -48,10 +49,16 @@ public:
 
   const AacChannelConfiguration *getChannelConfiguration(void) const;
 
+  static const char *getProfileName(AacAdtsProfile profile);
+
   size_t getFrameSize(void) const { return ((m_bytes[3] & 0x03) << 11) | (m_bytes[4] << 3) | (m_bytes[5] >> 5); };
 
   unsigned int getDataBlockCount(void) const { return (m_bytes[6] & 0x03) + 1; };
 
+  // The fixed part of the header (everything before the copyright bits),
+  //  which should be the same in every frame of a stream
+  uint32_t getFixedFields(void) const { return (m_bytes[1] << 16) | (m_bytes[2] << 8) | (m_bytes[3] & 0xF0); };
+
   const uint8_t *getPayloadBytes(void) const;
   size_t         getPayloadSize(void) const;
 
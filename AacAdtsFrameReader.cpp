@@ -2,10 +2,14 @@
 
 #include "AacAdtsFrameHeader.h"
 #include "AacAdtsFrame.h"
+#include "AacSyncwordScanner.h"
 
 #include "AacAdtsFrameReader.h"
 
-#define ID3_HEADER_SIZE 10
+// Having found a frame that only fails to match the previous one's fixed
+//  fields, keep looking this much further for one that does before settling
+//  for it. The stream's parameters may really have changed.
+#define AAC_ADTS_RESYNC_WINDOW (AAC_ADTS_MAX_FRAME_SIZE * 2)
 
 bool AacAdtsFrameReader::isAtFrameHeader(void)
 {
@@ -21,23 +25,59 @@ bool AacAdtsFrameReader::readFrameHeader(AacAdtsFrameHeader *header)
     return false;
 
   header->setBytes(m_bytes + m_position);
+
+  m_fixedFields = header->getFixedFields();
+  m_hasFixedFields = true;
+
   return true;
 }
 
 bool AacAdtsFrameReader::readFrame(AacAdtsFrame *frame)
 {
-  if (!isAtFrameHeader())
+  AacAdtsFrameHeader header;
+  if (!readFrameHeader(&header))
     return false;
 
-  auto header = AacAdtsFrameHeader(m_bytes + m_position);
-
   if ((m_position + header.getFrameSize()) > m_size)
     return false;  // Not enough space left for entire frame
 
+  if (header.getFrameSize() < AAC_ADTS_FRAME_HEADER_SIZE + (header.hasCrcProtection() ? 2 : 0))
+    return false;  // Too short for its own header
+
+  // Frames carrying more than one raw data block aren't supported, so they
+  //  are passed over like damaged ones rather than parsed as one block
+  if (header.getDataBlockCount() != 1)
+    return false;
+
   frame->setHeader(&header);
   return true;
 }
 
+// Returns the size of the frame whose header is at position, or zero if it
+//  doesn't look like a usable frame header
+size_t AacAdtsFrameReader::getPlausibleFrameSize(size_t position)
+{
+  const uint8_t *bytes = m_bytes + position;
+
+  if (!AacAdtsFrameHeader::isFrameHeader(bytes))
+    return 0;
+
+  auto header = AacAdtsFrameHeader(bytes);
+
+  size_t frameSize = header.getFrameSize();
+  if (frameSize <= AAC_ADTS_FRAME_HEADER_SIZE + (header.hasCrcProtection() ? 2 : 0))
+    return 0;  // No room for a payload
+
+  return frameSize;
+}
+
+// Moves to the next frame header after the current position.
+// A candidate is only taken if another header with the same fixed fields
+//  follows it exactly one frame later (or the data ends first), which rules
+//  out stray syncwords and the intact headers of frames cut short by damage.
+//  Candidates matching the fixed fields of the last frame read are
+//  preferred; a chained candidate from a different stream is taken if
+//  nothing better turns up soon after it.
 size_t AacAdtsFrameReader::findNextFrame(void)
 {
   size_t remainingSize = getRemainingSize();
@@ -46,69 +86,119 @@ size_t AacAdtsFrameReader::findNextFrame(void)
 
   size_t initialPosition = m_position;
 
-  while (remainingSize >= 1)
+  size_t found = m_size;
+  size_t fallback = m_size;  // Followed by another frame, but from a different stream
+
+  // Start looking from the next byte in the stream
+  scanSyncwords(m_bytes, m_position + 1, m_size, 0xFF, 0xF0, [&](size_t candidate)
   {
-    // Start looking from the next byte in the stream
-    m_position++;
-    remainingSize--;
-
-    // Scan for first byte of syncword
-    const uint8_t *start = m_bytes + m_position;
-    const uint8_t *found = static_cast<const uint8_t *>(memchr(start, 0xFF, remainingSize));
-    if (found == NULL)
+    if ((fallback != m_size) && (candidate > fallback + AAC_ADTS_RESYNC_WINDOW))
     {
-      m_position = m_size;
-      break;  // Not found
+      found = fallback;
+      return true;
     }
 
-    // Move forward to new position
-    size_t skipCount = found - start;
-    m_position += skipCount;
-    remainingSize -= skipCount;
+    if (candidate + AAC_ADTS_FRAME_HEADER_SIZE >= m_size)
+      return true;  // Not enough remaining space
+
+    size_t frameSize = getPlausibleFrameSize(candidate);
+    if (frameSize == 0)
+      return false;
+
+    uint32_t fixedFields = AacAdtsFrameHeader(m_bytes + candidate).getFixedFields();
+
+    // Check the header that should follow, if there's room for one
+    size_t next = candidate + frameSize;
+    bool isChained = true;
+    if (next + AAC_ADTS_FRAME_HEADER_SIZE < m_size)
+      isChained = getPlausibleFrameSize(next) && (AacAdtsFrameHeader(m_bytes + next).getFixedFields() == fixedFields);
+
+    bool isSameStream = !m_hasFixedFields || (fixedFields == m_fixedFields);
 
-    // Is it large enough for a frame header?
-    if (remainingSize < AAC_ADTS_FRAME_HEADER_SIZE)
+    if (isChained && isSameStream)
     {
-      m_position = m_size;
-      break;  // Not enough remaining space
+      found = candidate;
+      return true;
     }
 
-    // Check if it looks like a frame header
-    if (AacAdtsFrameHeader::isFrameHeader(found))
-      break;  // Found it
-  }
+    if (isChained && (fallback == m_size))
+      fallback = candidate;
+
+    return false;
+  });
+
+  // Reached the end of the data
+  if (found == m_size)
+    found = fallback;
+
+  m_position = found;
 
   return m_position - initialPosition;
 }
 
-// Attempt to skip an ID3v2 header. These are normally at the start of the
-//  file.
-// The earlier ID3v1 header was placed at the end of the file, and is less
-//  likely to contain false positive syncwords.
+// Counts the complete frames from the current position to the end, without
+//  moving the reader. Only the headers are looked at.
+size_t AacAdtsFrameReader::countFrames(void)
+{
+  auto reader = *this;
+  size_t count = 0;
+
+  while (!reader.isComplete())
+  {
+    // Reading the whole frame would assume a single raw data block
+    AacAdtsFrameHeader header;
+    size_t frameSize = reader.readFrameHeader(&header) ? header.getFrameSize() : 0;
+
+    if ((frameSize < AAC_ADTS_FRAME_HEADER_SIZE) || (frameSize > reader.getRemainingSize()))
+    {
+      reader.findNextFrame();
+      continue;
+    }
+
+    count++;
+    reader.advance(frameSize);
+  }
+
+  return count;
+}
+
+// Returns the total size of the ID3v2 tag starting at bytes, or zero if there
+//  isn't one.
 // https://mutagen-specs.readthedocs.io/en/latest/id3/id3v2.3.0.html
-size_t AacAdtsFrameReader::skipID3(void)
+size_t AacAdtsFrameReader::getID3Size(const uint8_t *bytes, size_t size)
 {
-  if (getRemainingSize() < ID3_HEADER_SIZE)
+  if (size < ID3_HEADER_SIZE)
     return 0;  // Not enough space for ID3v2 header
 
-  if (memcmp(m_bytes + m_position, "ID3", 3))
+  if (memcmp(bytes, "ID3", 3))
     return 0;  // Signature mismatch
 
-  if ((m_bytes[m_position + 3] > 0x09) || (m_bytes[m_position + 4] > 0x09))
+  if ((bytes[3] > 0x09) || (bytes[4] > 0x09))
     return 0;  // Unreasonably-high version number components
 
   for (int i = 6; i < ID3_HEADER_SIZE; i++)
-    if (m_bytes[m_position + i] & 0x80)
+    if (bytes[i] & 0x80)
       return 0;  // Size bytes not allowed to have high bits set
 
   // The size is a four-byte big-endian number where the high bit of each byte
   //  is ignored, giving us a 28-bit result. The stored size does not include
   //  the size of the header.
-  size_t size = ID3_HEADER_SIZE;
-  size += m_bytes[m_position + 6] << 21;
-  size += m_bytes[m_position + 7] << 14;
-  size += m_bytes[m_position + 8] << 7;
-  size += m_bytes[m_position + 9];
+  size_t tagSize = ID3_HEADER_SIZE;
+  tagSize += bytes[6] << 21;
+  tagSize += bytes[7] << 14;
+  tagSize += bytes[8] << 7;
+  tagSize += bytes[9];
+
+  return tagSize;
+}
+
+// Attempt to skip an ID3v2 header. These are normally at the start of the
+//  file.
+// The earlier ID3v1 header was placed at the end of the file, and is less
+//  likely to contain false positive syncwords.
+size_t AacAdtsFrameReader::skipID3(void)
+{
+  size_t size = getID3Size(m_bytes + m_position, getRemainingSize());
 
   advance(size);
   return size;
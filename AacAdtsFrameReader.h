@@ -5,6 +5,8 @@
 #ifndef AAC_ADTS_FRAME_READER_H
 #define AAC_ADTS_FRAME_READER_H
 
+#define ID3_HEADER_SIZE 10
+
 class AacAdtsFrame;
 class AacAdtsFrameHeader;
 
@@ -15,8 +17,18 @@ class AacAdtsFrameReader
 
   size_t         m_position;
 
+  // Fixed header fields of the last header read, for telling real frames from
+  //  false syncwords when resynchronising
+  uint32_t       m_fixedFields;
+  bool           m_hasFixedFields;
+
+  size_t getPlausibleFrameSize(size_t position);
+
 public:
-  AacAdtsFrameReader(const uint8_t *bytes, size_t size) : m_bytes(bytes), m_size(size), m_position(0) {};
+  AacAdtsFrameReader(const uint8_t *bytes, size_t size) : m_bytes(bytes), m_size(size), m_position(0), m_fixedFields(0), m_hasFixedFields(false) {};
+
+  const uint8_t *getBytes(void) { return m_bytes; };
+  size_t getSize(void) { return m_size; };
 
   size_t getPosition(void) { return m_position; };
 
@@ -26,12 +38,20 @@ public:
   bool   isComplete(void) { return m_position >= m_size; };
 
   bool   readFrameHeader(AacAdtsFrameHeader *header);
+
+  // Fails as for a damaged frame on one with more than one raw data block,
+  //  which can't be decoded. Walks that only need the header fields should
+  //  use readFrameHeader() instead.
   bool   readFrame(AacAdtsFrame *frame);
 
   size_t findNextFrame(void);
 
+  size_t countFrames(void);
+
   size_t skipID3(void);
 
+  static size_t getID3Size(const uint8_t *bytes, size_t size);
+
   size_t getRemainingSize(void) { if (m_position >= m_size) return 0; return m_size - m_position; };
 };
 
@@ -0,0 +1,593 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacHuffmanEncoder.h"
+
+#include "AacAdtsGenerator.h"
+
+#define AAC_GENERATOR_MAX_CHANNEL_BITS 6144  // Decoder input buffer per channel
+#define AAC_GENERATOR_RATE_ATTEMPTS    8  // Tries at a frame before writing it without spectral values
+
+// The element layout of channel configurations 1 to 5 (Table 42)
+static const struct
+{
+  unsigned int channelCount;
+  unsigned int elementCount;
+  AacElementId elementIds[AAC_GENERATOR_MAX_ELEMENTS];
+} elementLayouts[] =
+{
+  {0, 0, {}},
+  {1, 1, {AAC_ID_SCE}},
+  {2, 1, {AAC_ID_CPE}},
+  {3, 2, {AAC_ID_SCE, AAC_ID_CPE}},
+  {4, 3, {AAC_ID_SCE, AAC_ID_CPE, AAC_ID_SCE}},
+  {5, 3, {AAC_ID_SCE, AAC_ID_CPE, AAC_ID_CPE}},
+};
+
+// Random numbers are taken straight from the generator, as the standard
+//  distributions may differ between libraries and the output shouldn't
+static double getRandomUnit(std::mt19937 &random)
+{
+  return random() / 4294967296.0;
+}
+
+static bool getRandomChance(std::mt19937 &random, double percent)
+{
+  return (getRandomUnit(random) * 100.0) < percent;
+}
+
+static unsigned int getRandomBelow(std::mt19937 &random, unsigned int limit)
+{
+  return random() % limit;
+}
+
+// Scalefactor bands that start below a frequency
+static unsigned int getSfbCount(const AacScalefactorBandOffsets *offsets, unsigned int windowSize, unsigned int sampleRate, unsigned int bandwidth)
+{
+  unsigned int count = 0;
+  while ((count < offsets->swbCount) && ((static_cast<uint64_t>(offsets->offsets[count]) * sampleRate / windowSize) < bandwidth))
+    count++;
+
+  return count;
+}
+
+// Splits the short windows into groups as decodeIcsInfo() does
+static void setWindowGroups(AacIcsInfo *ics, unsigned int windowGroupBits)
+{
+  ics->windowGroupCount = 1;
+  ics->windowGroups[0].winStart = 0;
+  ics->windowGroups[0].winLength = 1;
+
+  if (ics->isLongWindow)
+    return;
+
+  for (int i = 6; i >= 0; i--)
+  {
+    if ((windowGroupBits >> i & 0x01) == 0)
+    {
+      ics->windowGroupCount++;
+      ics->windowGroups[ics->windowGroupCount - 1].winStart = 7 - i;
+      ics->windowGroups[ics->windowGroupCount - 1].winLength = 1;
+    }
+    else
+    {
+      ics->windowGroups[ics->windowGroupCount - 1].winLength++;
+    }
+  }
+}
+
+AacAdtsGenerator::AacAdtsGenerator(void)
+{
+  m_sampleRateIndex = AAC_SAMPLE_RATE_44100;
+  m_bandInfo = NULL;
+  m_longSfbCount = 0;
+  m_shortSfbCount = 0;
+
+  m_elementCount = 0;
+
+  m_startChance = 0.0;
+  m_shortRunChance = 0.0;
+
+  m_bitsPerFrame = 0.0;
+  m_bitBalance = 0.0;
+  m_density = 0.0;
+  m_spectralBits = 0;
+
+  m_frameCount = 0;
+}
+
+bool AacAdtsGenerator::init(const AacAdtsGeneratorSettings &settings)
+{
+  if (!isSampleRateSupported(settings.sampleRate))
+    return false;
+
+  m_sampleRateIndex = AacConstants::getIndexBySampleRate(settings.sampleRate);
+
+  if ((settings.channelConfiguration < 1) || (settings.channelConfiguration >= std::size(elementLayouts)))
+    return false;  // Unsupported channel configuration
+
+  unsigned int weightTotal = 0;
+  for (unsigned int i = 0; i < AAC_GENERATOR_CODEBOOK_COUNT; i++)
+    weightTotal += settings.codebookWeights[i];
+
+  if (weightTotal == 0)
+    return false;  // No codebook to pick
+
+  m_settings = settings;
+  m_settings.tnsOrder = std::min(m_settings.tnsOrder, static_cast<unsigned int>(AAC_MAX_TNS_ORDER_LONG_LC));
+
+  m_bandInfo      = AacConstants::getScalefactorBandInfo(m_sampleRateIndex);
+  m_longSfbCount  = getSfbCount(m_bandInfo->longWindow, AAC_XFORM_WIN_SIZE_LONG, settings.sampleRate, settings.bandwidth);
+  m_shortSfbCount = getSfbCount(m_bandInfo->shortWindow, AAC_XFORM_WIN_SIZE_SHORT, settings.sampleRate, settings.bandwidth);
+
+  auto &layout = elementLayouts[settings.channelConfiguration];
+  m_elementCount = layout.elementCount;
+  for (unsigned int e = 0; e < m_elementCount; e++)
+  {
+    m_elementIds[e] = layout.elementIds[e];
+    m_windows[e] = {AAC_WINSEQ_LONG, AAC_WINSHAPE_SIN};
+  }
+
+  // A run of short blocks is framed by a LONG_START and a LONG_STOP. With
+  //  runs of two on average, a share f of short blocks needs a long block to
+  //  start one with a chance of 1 / (2 / f - 3). Past a half, every long
+  //  block starts one and the runs get longer instead.
+  double share = std::clamp(settings.shortPercent / 100.0, 0.0, 1.0);
+  if (share <= 0.0)
+  {
+    m_startChance = 0.0;
+    m_shortRunChance = 0.0;
+  }
+  else if (share <= 0.5)
+  {
+    m_startChance = 1.0 / ((2.0 / share) - 3.0);
+    m_shortRunChance = 0.5;
+  }
+  else
+  {
+    m_startChance = 1.0;
+    m_shortRunChance = (share >= 1.0) ? 1.0 : (1.0 - ((1.0 - share) / (2.0 * share)));
+  }
+
+  m_random.seed(settings.seed);
+
+  m_bitsPerFrame = static_cast<double>(settings.bitrate) * AAC_AUDIO_SAMPLE_OUTPUT_COUNT / settings.sampleRate;
+  m_bitBalance = 0.0;
+  m_density = 0.25;
+  m_frameCount = 0;
+
+  return true;
+}
+
+unsigned int AacAdtsGenerator::getMaxBitrate(unsigned int sampleRate, unsigned int channelConfiguration)
+{
+  if ((channelConfiguration < 1) || (channelConfiguration >= std::size(elementLayouts)))
+    return 0;
+
+  uint64_t frameBits = std::min(AAC_GENERATOR_MAX_CHANNEL_BITS * elementLayouts[channelConfiguration].channelCount, AAC_ADTS_MAX_FRAME_SIZE * 8U);
+  return frameBits * sampleRate / AAC_AUDIO_SAMPLE_OUTPUT_COUNT;
+}
+
+bool AacAdtsGenerator::isSampleRateSupported(unsigned int sampleRate)
+{
+  // Anything else maps to the nearest rate
+  return AacConstants::getSampleRateByIndex(AacConstants::getIndexBySampleRate(sampleRate)) == sampleRate;
+}
+
+AacWindowSequence AacAdtsGenerator::getNextWindowSequence(AacWindowSequence previous)
+{
+  switch (previous)
+  {
+  case AAC_WINSEQ_LONG_START:
+    return AAC_WINSEQ_8_SHORT;
+  case AAC_WINSEQ_8_SHORT:
+    return getRandomChance(m_random, m_shortRunChance * 100.0) ? AAC_WINSEQ_8_SHORT : AAC_WINSEQ_LONG_STOP;
+  default:
+    return getRandomChance(m_random, m_startChance * 100.0) ? AAC_WINSEQ_LONG_START : AAC_WINSEQ_LONG;
+  }
+}
+
+bool AacAdtsGenerator::generateFrame(std::vector<uint8_t> *frame)
+{
+  // The windows carry on from the previous block whatever the content, so
+  //  they're chosen before any attempt at it
+  for (unsigned int e = 0; e < m_elementCount; e++)
+  {
+    m_windows[e].windowSequence = getNextWindowSequence(m_windows[e].windowSequence);
+    m_windows[e].windowShape = getRandomChance(m_random, m_settings.kbdPercent) ? AAC_WINSHAPE_KBD : AAC_WINSHAPE_SIN;
+  }
+
+  uint32_t contentSeed = m_random();
+
+  double maxPayloadBits = getMaxBitrate(m_settings.sampleRate, m_settings.channelConfiguration) * static_cast<double>(AAC_AUDIO_SAMPLE_OUTPUT_COUNT) / m_settings.sampleRate - (AAC_ADTS_FRAME_HEADER_SIZE * 8);
+  double budget = m_bitsPerFrame + m_bitBalance;
+  double payloadBudget = std::clamp(budget - (AAC_ADTS_FRAME_HEADER_SIZE * 8), 0.0, maxPayloadBits);
+
+  // Each attempt writes the same content with fewer non-zero values, until
+  //  the frame fits its share of the bitrate
+  size_t usedBits;
+  for (unsigned int attempt = 0; ; attempt++)
+  {
+    std::mt19937 random(contentSeed);
+
+    m_writer.clear();
+    m_spectralBits = 0;
+
+    unsigned int instances[AAC_ID_END + 1] = {};
+    for (unsigned int e = 0; e < m_elementCount; e++)
+    {
+      if (!writeElement(random, e, instances[m_elementIds[e]]++))
+        return false;
+    }
+
+    usedBits = m_writer.getBitPosition() + 3;  // With the END element
+
+    if ((usedBits <= payloadBudget) || (m_density == 0.0) || (m_spectralBits == 0))
+      break;
+
+    if (attempt + 1 >= AAC_GENERATOR_RATE_ATTEMPTS)
+      m_density = 0.0;
+    else
+      m_density *= std::clamp((payloadBudget - (usedBits - m_spectralBits)) / m_spectralBits, 0.1, 0.9);
+  }
+
+  if (usedBits > maxPayloadBits)
+    return false;  // Side info alone is over the limit
+
+  // Steer the next frame's spectral data towards what was left for it here
+  if (m_spectralBits > 0)
+  {
+    double ratio = ((payloadBudget - (usedBits - m_spectralBits)) * 0.98) / m_spectralBits;
+    m_density = std::clamp(m_density * std::clamp(ratio, 0.5, 2.0), 0.0001, 1.0);
+  }
+
+  if (usedBits < payloadBudget)
+    writeFill(static_cast<size_t>(payloadBudget) - usedBits);
+
+  m_writer.writeUInt(3, AAC_ID_END);
+  m_writer.byteAlign();
+
+  size_t frameSize = AAC_ADTS_FRAME_HEADER_SIZE + m_writer.getSize();
+  writeHeader(frame, frameSize);
+  frame->insert(frame->end(), m_writer.getBytes(), m_writer.getBytes() + m_writer.getSize());
+
+  // A bitrate too low for the side info would otherwise leave a debt that
+  //  is never paid
+  m_bitBalance = std::max(budget - (frameSize * 8.0), -4.0 * m_bitsPerFrame);
+
+  m_frameCount++;
+
+  return true;
+}
+
+// An ADTS header without a CRC, for one raw data block
+void AacAdtsGenerator::writeHeader(std::vector<uint8_t> *frame, size_t frameSize)
+{
+  AacBitWriter header;
+
+  header.writeUInt(12, 0xFFF);  // Syncword
+  header.writeBit(1);  // MPEG-2
+  header.writeUInt(2, 0);  // Layer
+  header.writeBit(1);  // Protection absent
+  header.writeUInt(2, AAC_PROFILE_LC);
+  header.writeUInt(4, m_sampleRateIndex);
+  header.writeBit(0);  // Private
+  header.writeUInt(3, m_settings.channelConfiguration);
+  header.writeBit(0);  // Original
+  header.writeBit(0);  // Home
+  header.writeBit(0);  // Copyright ID
+  header.writeBit(0);  // Copyright ID start
+  header.writeUInt(13, frameSize);
+  header.writeUInt(11, 0x7FF);  // Buffer fullness: variable bitrate
+  header.writeUInt(2, 0);  // One raw data block
+
+  frame->insert(frame->end(), header.getBytes(), header.getBytes() + header.getSize());
+}
+
+bool AacAdtsGenerator::writeElement(std::mt19937 &random, unsigned int element, unsigned int instance)
+{
+  AacIcsInfo ics;
+  ics.windowSequence = m_windows[element].windowSequence;
+  ics.windowShape    = m_windows[element].windowShape;
+  ics.isLongWindow   = (ics.windowSequence != AAC_WINSEQ_8_SHORT);
+  ics.windowCount    = ics.isLongWindow ? 1 : AAC_MAX_WINDOW_COUNT;
+  ics.sfbCount       = ics.isLongWindow ? m_longSfbCount : m_shortSfbCount;
+
+  unsigned int windowGroupBits = ics.isLongWindow ? 0 : getRandomBelow(random, 0x80);
+  setWindowGroups(&ics, windowGroupBits);
+
+  m_writer.writeUInt(3, m_elementIds[element]);
+  m_writer.writeUInt(4, instance);
+
+  if (m_elementIds[element] == AAC_ID_SCE)
+    return writeChannel(random, &ics, windowGroupBits, false, ics.sfbCount);
+
+  // Both channels of a pair share their windows, as encoders normally have
+  //  them do, so that M/S and intensity stereo can be used
+  m_writer.writeBit(1);  // Common window
+  writeIcsInfo(&ics, windowGroupBits);
+  writeMsMask(random, &ics);
+
+  unsigned int intensityStart = ics.sfbCount;
+  if ((ics.sfbCount > 1) && getRandomChance(random, m_settings.intensityPercent))
+    intensityStart = (ics.sfbCount / 2) + getRandomBelow(random, ics.sfbCount - (ics.sfbCount / 2));
+
+  if (!writeChannel(random, &ics, windowGroupBits, true, ics.sfbCount))
+    return false;
+
+  return writeChannel(random, &ics, windowGroupBits, true, intensityStart);
+}
+
+// ics_info
+void AacAdtsGenerator::writeIcsInfo(const AacIcsInfo *ics, unsigned int windowGroupBits)
+{
+  m_writer.writeBit(0);  // Reserved
+  m_writer.writeUInt(2, ics->windowSequence);
+  m_writer.writeBit(ics->windowShape);
+
+  if (!ics->isLongWindow)
+  {
+    m_writer.writeUInt(4, ics->sfbCount);
+    m_writer.writeUInt(7, windowGroupBits);
+  }
+  else
+  {
+    m_writer.writeUInt(6, ics->sfbCount);
+    m_writer.writeBit(0);  // No prediction in LC
+  }
+}
+
+void AacAdtsGenerator::writeMsMask(std::mt19937 &random, const AacIcsInfo *ics)
+{
+  if (!getRandomChance(random, m_settings.msPercent))
+  {
+    m_writer.writeUInt(2, AAC_MS_MASK_ZERO);
+    return;
+  }
+
+  if (getRandomBelow(random, 2))
+  {
+    m_writer.writeUInt(2, AAC_MS_MASK_ONE);
+    return;
+  }
+
+  m_writer.writeUInt(2, AAC_MS_MASK_SUBBAND);
+  for (unsigned int g = 0; g < ics->windowGroupCount; g++)
+  {
+    for (unsigned int sfb = 0; sfb < ics->sfbCount; sfb++)
+      m_writer.writeBit(getRandomBelow(random, 2));
+  }
+}
+
+int AacAdtsGenerator::getRandomValue(std::mt19937 &random, unsigned int codebook)
+{
+  if (getRandomUnit(random) >= m_density)
+    return 0;
+
+  unsigned int magnitude;
+  if ((codebook == AAC_HCB_ESC) && getRandomChance(random, m_settings.escapePercent))
+  {
+    // Spread evenly over the escape lengths, 16 up to 8191
+    unsigned int bits = 4 + getRandomBelow(random, 9);
+    magnitude = (1 << bits) + getRandomBelow(random, 1 << bits);
+  }
+  else
+  {
+    magnitude = 1 + getRandomBelow(random, std::min(AacHuffmanEncoder::getLargestValue(codebook), 15U));
+  }
+
+  return getRandomBelow(random, 2) ? -static_cast<int>(magnitude) : magnitude;
+}
+
+// individual_channel_stream, with bands from intensityStart up coded as
+//  intensity positions
+bool AacAdtsGenerator::writeChannel(std::mt19937 &random, const AacIcsInfo *ics, unsigned int windowGroupBits, bool isCommonWindow, unsigned int intensityStart)
+{
+  AacHuffmanEncoder encoder(&m_writer);
+
+  unsigned int globalGain = 110 + getRandomBelow(random, 21);
+  m_writer.writeUInt(8, globalGain);
+
+  if (!isCommonWindow)
+    writeIcsInfo(ics, windowGroupBits);
+
+  // section_data
+  unsigned int weightTotal = 0;
+  for (unsigned int i = 0; i < AAC_GENERATOR_CODEBOOK_COUNT; i++)
+    weightTotal += m_settings.codebookWeights[i];
+
+  unsigned int sectionLengthBits = ics->isLongWindow ? 5 : 3;
+  unsigned int esc = (1 << sectionLengthBits) - 1;
+  unsigned int maxSectionLength = ics->isLongWindow ? 8 : 4;
+
+  uint8_t sfbCodebooks[AAC_MAX_WINDOW_GROUPS][AAC_MAX_SFB_COUNT];
+  for (unsigned int g = 0; g < ics->windowGroupCount; g++)
+  {
+    unsigned int k = 0;
+    while (k < ics->sfbCount)
+    {
+      unsigned int end = (k < intensityStart) ? intensityStart : ics->sfbCount;
+      unsigned int len = 1 + getRandomBelow(random, std::min(end - k, maxSectionLength));
+
+      unsigned int codebook = AAC_HCB_ZERO;
+      if (k >= intensityStart)
+      {
+        codebook = getRandomBelow(random, 2) ? AAC_HCB_INTENSITY : AAC_HCB_INTENSITY2;
+      }
+      else
+      {
+        unsigned int pick = getRandomBelow(random, weightTotal);
+        while (pick >= m_settings.codebookWeights[codebook])
+          pick -= m_settings.codebookWeights[codebook++];
+      }
+
+      m_writer.writeUInt(4, codebook);
+
+      unsigned int l = len;
+      while (l >= esc)
+      {
+        m_writer.writeUInt(sectionLengthBits, esc);
+        l -= esc;
+      }
+      m_writer.writeUInt(sectionLengthBits, l);
+
+      for (unsigned int sfb = k; sfb < k + len; sfb++)
+        sfbCodebooks[g][sfb] = codebook;
+
+      k += len;
+    }
+  }
+
+  // scale_factor_data, wandering a little around the global gain
+  int sf = globalGain;
+  for (unsigned int g = 0; g < ics->windowGroupCount; g++)
+  {
+    for (unsigned int sfb = 0; sfb < ics->sfbCount; sfb++)
+    {
+      unsigned int hcb = sfbCodebooks[g][sfb];
+      if (hcb == AAC_HCB_ZERO)
+        continue;
+
+      int offset;
+      if (AAC_IS_INTENSITY_CODEBOOK(hcb))
+      {
+        offset = static_cast<int>(getRandomBelow(random, 7)) - 3;
+      }
+      else
+      {
+        offset = static_cast<int>(getRandomBelow(random, 5)) - 2;
+        if (sf + offset < static_cast<int>(globalGain) - 8)
+          offset = 1;
+        else if (sf + offset > static_cast<int>(globalGain) + 8)
+          offset = -1;
+
+        sf += offset;
+      }
+
+      if (!encoder.encodeScalefactor(offset))
+        return false;
+    }
+  }
+
+  m_writer.writeBit(0);  // No pulse data
+
+  // tns_data
+  if (getRandomChance(random, m_settings.tnsPercent))
+  {
+    m_writer.writeBit(1);
+
+    unsigned int filterCountBits = ics->isLongWindow ? 2 : 1;
+    unsigned int lengthBits      = ics->isLongWindow ? 6 : 4;
+    unsigned int orderBits       = ics->isLongWindow ? 5 : 3;
+    unsigned int maxOrder        = ics->isLongWindow ? AAC_MAX_TNS_ORDER_LONG_LC : AAC_MAX_TNS_ORDER_SHORT;
+    unsigned int order           = std::min(m_settings.tnsOrder, maxOrder);
+
+    for (unsigned int w = 0; w < ics->windowCount; w++)
+    {
+      m_writer.writeUInt(filterCountBits, 1);
+
+      unsigned int coefficientBits = 3 + getRandomBelow(random, 2);
+      m_writer.writeBit(coefficientBits - 3);
+
+      m_writer.writeUInt(lengthBits, ics->sfbCount);
+      m_writer.writeUInt(orderBits, order);
+
+      if (order)
+      {
+        m_writer.writeBit(getRandomBelow(random, 2));  // Direction
+        m_writer.writeBit(0);  // Not compressed
+
+        // Any coefficients make a stable filter, as they're reflection
+        //  coefficients mapped through sin()
+        for (unsigned int o = 0; o < order; o++)
+          m_writer.writeUInt(coefficientBits, getRandomBelow(random, 1 << coefficientBits));
+      }
+    }
+  }
+  else
+  {
+    m_writer.writeBit(0);
+  }
+
+  m_writer.writeBit(0);  // No gain control in LC
+
+  // spectral_data. Sections are contiguous within a group, so writing band
+  //  by band gives the same tuples in the same order.
+  size_t spectralStart = m_writer.getBitPosition();
+
+  for (unsigned int g = 0; g < ics->windowGroupCount; g++)
+  {
+    for (unsigned int sfb = 0; sfb < ics->sfbCount; sfb++)
+    {
+      unsigned int codebook = sfbCodebooks[g][sfb];
+      if ((codebook == AAC_HCB_ZERO) || (codebook > AAC_HCB_ESC))
+        continue;  // No spectral data
+
+      const AacScalefactorBandOffsets *offsets = ics->isLongWindow ? m_bandInfo->longWindow : m_bandInfo->shortWindow;
+      unsigned int sampleCount = (offsets->offsets[sfb + 1] - offsets->offsets[sfb]) * ics->windowGroups[g].winLength;
+
+      if (codebook < AAC_HCB_FIRST_PAIR)
+      {
+        for (unsigned int k = 0; k < sampleCount; k += 4)
+        {
+          int v[4] = {getRandomValue(random, codebook), getRandomValue(random, codebook), getRandomValue(random, codebook), getRandomValue(random, codebook)};
+          if (!encoder.encode4(codebook, v))
+            return false;
+        }
+      }
+      else
+      {
+        for (unsigned int k = 0; k < sampleCount; k += 2)
+        {
+          int v[2] = {getRandomValue(random, codebook), getRandomValue(random, codebook)};
+          if (!encoder.encode2(codebook, v))
+            return false;
+        }
+      }
+    }
+  }
+
+  m_spectralBits += m_writer.getBitPosition() - spectralStart;
+
+  return true;
+}
+
+// Fill elements of EXT_FILL, taking up to bitCount bits
+void AacAdtsGenerator::writeFill(size_t bitCount)
+{
+  while (true)
+  {
+    // 3 bits of element ID and a 4-bit count, plus an 8-bit extension of
+    //  the count from 15 bytes up
+    size_t byteCount = (bitCount >= 7) ? ((bitCount - 7) / 8) : 0;
+    if (byteCount >= 15)
+      byteCount = std::clamp<size_t>((bitCount - 15) / 8, 14, 15 + 255 - 1);
+
+    if (byteCount == 0)
+      break;
+
+    m_writer.writeUInt(3, AAC_ID_FIL);
+    if (byteCount < 15)
+    {
+      m_writer.writeUInt(4, byteCount);
+      bitCount -= 7;
+    }
+    else
+    {
+      m_writer.writeUInt(4, 15);
+      m_writer.writeUInt(8, byteCount - 14);
+      bitCount -= 15;
+    }
+
+    // extension_type and fill_nibble, then fill bytes
+    m_writer.writeUInt(8, AAC_EXT_FILL << 4);
+    for (size_t i = 1; i < byteCount; i++)
+      m_writer.writeUInt(8, 0xA5);
+
+    bitCount -= byteCount * 8;
+  }
+}
@@ -0,0 +1,117 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <random>
+#include <vector>
+
+#include "AacConstants.h"
+#include "AacStructs.h"
+#include "AacBitWriter.h"
+
+#ifndef AAC_ADTS_GENERATOR_H
+#define AAC_ADTS_GENERATOR_H
+
+#define AAC_GENERATOR_MAX_ELEMENTS 3  // Channel configuration 5 is an SCE and two CPEs
+
+#define AAC_GENERATOR_CODEBOOK_COUNT (AAC_HCB_ESC + 1)
+
+// What a synthetic stream should exercise. Percentages are chances per
+//  block, channel or element, so short runs come out close to them rather
+//  than exact.
+struct AacAdtsGeneratorSettings
+{
+  unsigned int sampleRate;  // One of the ADTS sample rates
+  unsigned int channelConfiguration;  // 1 to 5, without an LFE
+  unsigned int bitrate;  // In bits per second over all channels
+  unsigned int bandwidth;  // In Hz; bands starting at or above it are left out
+
+  double       shortPercent;  // Blocks with eight short windows, not counting the transitions to them
+  double       kbdPercent;  // Blocks with the KBD window shape
+
+  // Relative weights of ZERO_HCB to ESC_HCB when picking each section's
+  //  codebook. The values in a section are drawn from its codebook's range.
+  unsigned int codebookWeights[AAC_GENERATOR_CODEBOOK_COUNT];
+  double       escapePercent;  // Non-zero values in ESC_HCB sections with an escape sequence
+
+  double       tnsPercent;  // Channels with TNS, one filter per window
+  unsigned int tnsOrder;  // Clamped to the LC maximum for the window length
+
+  double       msPercent;  // CPEs with M/S stereo
+  double       intensityPercent;  // CPEs with intensity stereo in the upper bands
+
+  uint32_t     seed;
+
+  AacAdtsGeneratorSettings(void) : sampleRate(44100), channelConfiguration(2), bitrate(128000), bandwidth(16000), shortPercent(5.0), kbdPercent(10.0),
+    codebookWeights{10, 8, 8, 6, 10, 6, 10, 6, 10, 4, 8, 14}, escapePercent(1.0), tnsPercent(20.0), tnsOrder(8), msPercent(50.0), intensityPercent(0.0),
+    seed(1) {};
+};
+
+// Writes valid AAC-LC ADTS frames with random content shaped by the
+//  settings, for benchmarking and stress testing without real recordings.
+//  The same settings and seed give the same bytes on any machine.
+// The spectral values are noise, so the audio means nothing. The bitrate is
+//  met by steering how many values are non-zero from frame to frame, with
+//  fill elements making up the difference, as a CBR encoder would.
+class AacAdtsGenerator
+{
+  struct ElementWindow
+  {
+    AacWindowSequence windowSequence;
+    AacWindowShape    windowShape;
+  };
+
+  AacAdtsGeneratorSettings      m_settings;
+
+  AacSampleRateIndex            m_sampleRateIndex;
+  const AacScalefactorBandInfo *m_bandInfo;
+  unsigned int                  m_longSfbCount;  // max_sfb for the bandwidth
+  unsigned int                  m_shortSfbCount;
+
+  unsigned int                  m_elementCount;
+  AacElementId                  m_elementIds[AAC_GENERATOR_MAX_ELEMENTS];
+  ElementWindow                 m_windows[AAC_GENERATOR_MAX_ELEMENTS];
+
+  double                        m_startChance;  // Of a long block being followed by a transition to short windows
+  double                        m_shortRunChance;  // Of a short block being followed by another
+
+  std::mt19937                  m_random;
+  AacBitWriter                  m_writer;
+
+  double                        m_bitsPerFrame;
+  double                        m_bitBalance;  // Bits written short of the bitrate so far
+  double                        m_density;  // Chance of a spectral value being non-zero
+  size_t                        m_spectralBits;  // In the frame being written
+
+  uint64_t                      m_frameCount;
+
+  AacWindowSequence getNextWindowSequence(AacWindowSequence previous);
+
+  void writeHeader(std::vector<uint8_t> *frame, size_t frameSize);
+  bool writeElement(std::mt19937 &random, unsigned int element, unsigned int instance);
+  void writeIcsInfo(const AacIcsInfo *ics, unsigned int windowGroupBits);
+  void writeMsMask(std::mt19937 &random, const AacIcsInfo *ics);
+  bool writeChannel(std::mt19937 &random, const AacIcsInfo *ics, unsigned int windowGroupBits, bool isCommonWindow, unsigned int intensityStart);
+  int  getRandomValue(std::mt19937 &random, unsigned int codebook);
+  void writeFill(size_t bitCount);
+
+public:
+  AacAdtsGenerator(void);
+
+  // Fails if the sample rate, channel configuration or bandwidth can't be
+  //  used
+  bool init(const AacAdtsGeneratorSettings &settings);
+
+  // Appends the next frame
+  bool generateFrame(std::vector<uint8_t> *frame);
+
+  uint64_t getFrameCount(void) const { return m_frameCount; };
+
+  // The largest bitrate the decoder input buffer allows, 6144 bits per
+  //  channel per frame
+  static unsigned int getMaxBitrate(unsigned int sampleRate, unsigned int channelConfiguration);
+
+  // Whether the sample rate is one of the ADTS rates with scalefactor bands
+  static bool isSampleRateSupported(unsigned int sampleRate);
+};
+
+#endif
@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+
+#include "AacAdtsIndex.h"
+
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME        0x00000100000001B3ULL
+
+AacAdtsIndex::AacAdtsIndex(void)
+{
+  m_map = NULL;
+  m_mapSize = 0;
+
+  m_header = NULL;
+  m_anchors = NULL;
+  m_entries = NULL;
+}
+
+AacAdtsIndex::~AacAdtsIndex(void)
+{
+  unmap();
+}
+
+void AacAdtsIndex::unmap(void)
+{
+  if (m_map)
+    munmap(m_map, m_mapSize);
+
+  m_map = NULL;
+  m_mapSize = 0;
+}
+
+size_t AacAdtsIndex::getDataSize(uint64_t frameCount, uint32_t interval)
+{
+  size_t anchorCount = (frameCount + interval - 1) / interval;
+
+  return sizeof(AacAdtsIndexHeader) + (anchorCount * sizeof(AacAdtsIndexAnchor)) + (frameCount * sizeof(AacAdtsIndexPackedEntry));
+}
+
+void AacAdtsIndex::attach(const void *data)
+{
+  m_header = static_cast<const AacAdtsIndexHeader *>(data);
+
+  size_t anchorCount = (m_header->frameCount + m_header->interval - 1) / m_header->interval;
+
+  m_anchors = reinterpret_cast<const AacAdtsIndexAnchor *>(m_header + 1);
+  m_entries = reinterpret_cast<const AacAdtsIndexPackedEntry *>(m_anchors + anchorCount);
+}
+
+bool AacAdtsIndex::build(AacAdtsFrameReader *reader, unsigned int interval)
+{
+  interval = std::clamp(interval, 1U, static_cast<unsigned int>(AAC_ADTS_INDEX_MAX_INTERVAL));
+
+  std::vector<AacAdtsIndexAnchor>      anchors;
+  std::vector<AacAdtsIndexPackedEntry> entries;
+
+  auto walker = *reader;
+  uint64_t sampleCount = 0;
+
+  while (!walker.isComplete())
+  {
+    // Only header fields are needed, and reading the whole frame would
+    //  reject frames with more than one raw data block
+    AacAdtsFrameHeader frameHeader;
+    size_t frameSize = walker.readFrameHeader(&frameHeader) ? frameHeader.getFrameSize() : 0;
+    if ((frameSize < AAC_ADTS_FRAME_HEADER_SIZE) || (frameSize > walker.getRemainingSize()))
+    {
+      walker.findNextFrame();
+      continue;
+    }
+
+    uint64_t offset = walker.getPosition();
+    unsigned int blockCount = frameHeader.getDataBlockCount();
+
+    if ((entries.size() % interval) == 0)
+      anchors.push_back({offset, sampleCount});
+
+    const AacAdtsIndexAnchor *anchor = &anchors.back();
+    if (offset - anchor->offset > UINT32_MAX)
+      return false;
+
+    AacAdtsIndexPackedEntry entry;
+    entry.offsetDelta   = offset - anchor->offset;
+    entry.sizeAndBlocks = frameSize | ((blockCount - 1) << 13);
+    entry.blockDelta    = (sampleCount - anchor->sample) / AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+    entries.push_back(entry);
+
+    sampleCount += blockCount * AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+
+    walker.advance(frameSize);
+  }
+
+  AacAdtsIndexHeader header = {};
+  header.magic       = AAC_ADTS_INDEX_MAGIC;
+  header.version     = AAC_ADTS_INDEX_VERSION;
+  header.frameCount  = entries.size();
+  header.sampleCount = sampleCount;
+  header.interval    = interval;
+
+  // Lay the index out as it is in a file
+  size_t size = getDataSize(header.frameCount, interval);
+  m_buffer.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+
+  uint8_t *data = reinterpret_cast<uint8_t *>(m_buffer.data());
+  memcpy(data, &header, sizeof(header));
+  memcpy(data + sizeof(header), anchors.data(), anchors.size() * sizeof(AacAdtsIndexAnchor));
+  memcpy(data + sizeof(header) + (anchors.size() * sizeof(AacAdtsIndexAnchor)), entries.data(), entries.size() * sizeof(AacAdtsIndexPackedEntry));
+
+  unmap();
+  attach(data);
+
+  return true;
+}
+
+// Fills in the source fields of the header from the file as it is now
+bool AacAdtsIndex::getFingerprint(const char *sourceFilename, AacAdtsIndexHeader *header)
+{
+  int fd = ::open(sourceFilename, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st))
+  {
+    close(fd);
+    return false;
+  }
+
+  header->sourceSize = st.st_size;
+  header->sourceModifiedTime = (static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000) + st.st_mtim.tv_nsec;
+
+  // A rewrite within the same second on a filesystem with coarse timestamps
+  //  would keep the size and time, but is unlikely to keep both ends
+  uint8_t bytes[AAC_ADTS_INDEX_HASH_SIZE];
+  uint64_t hash = FNV_OFFSET_BASIS;
+
+  size_t headSize = std::min<uint64_t>(header->sourceSize, AAC_ADTS_INDEX_HASH_SIZE);
+  size_t tailSize = std::min<uint64_t>(header->sourceSize - headSize, AAC_ADTS_INDEX_HASH_SIZE);
+
+  bool success = true;
+  for (auto [offset, size] : {std::pair<off_t, size_t>(0, headSize), std::pair<off_t, size_t>(st.st_size - tailSize, tailSize)})
+  {
+    if (pread(fd, bytes, size, offset) != static_cast<ssize_t>(size))
+    {
+      success = false;
+      break;
+    }
+
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ bytes[i]) * FNV_PRIME;
+  }
+
+  close(fd);
+
+  header->sourceHash = hash;
+  return success;
+}
+
+bool AacAdtsIndex::save(const char *indexFilename, const char *sourceFilename)
+{
+  if (!m_header)
+    return false;
+
+  AacAdtsIndexHeader header = *m_header;
+  if (!getFingerprint(sourceFilename, &header))
+    return false;
+
+  // Written alongside and renamed into place, so a reader never maps a
+  //  half-written index. The name is unique, so two processes indexing the
+  //  same file don't write over each other; the last rename wins.
+  std::string tempFilename = std::string(indexFilename) + ".XXXXXX";
+
+  int fd = mkstemp(tempFilename.data());
+  if (fd < 0)
+    return false;
+
+  // mkstemp() makes the file private, but an index is no secret
+  fchmod(fd, 0644);
+
+  FILE *file = fdopen(fd, "wb");
+  if (!file)
+  {
+    close(fd);
+    unlink(tempFilename.c_str());
+    return false;
+  }
+
+  // Anchors and entries follow the header, and there are none for a source
+  //  without frames
+  size_t dataSize = getDataSize(header.frameCount, header.interval) - sizeof(header);
+
+  bool success = (fwrite(&header, sizeof(header), 1, file) == 1);
+  success = success && ((dataSize == 0) || (fwrite(m_anchors, dataSize, 1, file) == 1));
+  success = (fclose(file) == 0) && success;
+
+  success = success && (rename(tempFilename.c_str(), indexFilename) == 0);
+
+  if (!success)
+    unlink(tempFilename.c_str());
+
+  return success;
+}
+
+// Checks that every frame of a loaded index lies within the source, so that
+//  a damaged sidecar can't send a reader past the end of the mapped file,
+//  and that the anchors and entries are in the order searches expect
+bool AacAdtsIndex::checkEntries(const AacAdtsIndexHeader *header)
+{
+  auto anchors = reinterpret_cast<const AacAdtsIndexAnchor *>(header + 1);
+  size_t anchorCount = (header->frameCount + header->interval - 1) / header->interval;
+
+  auto entries = reinterpret_cast<const AacAdtsIndexPackedEntry *>(anchors + anchorCount);
+
+  uint64_t previousSample = 0;
+
+  for (size_t a = 0; a < anchorCount; a++)
+  {
+    const AacAdtsIndexAnchor *anchor = &anchors[a];
+
+    if ((anchor->offset >= header->sourceSize) || (anchor->sample < previousSample) || (anchor->sample > header->sampleCount))
+      return false;
+
+    if ((a == 0) && (anchor->sample != 0))
+      return false;
+
+    previousSample = anchor->sample;
+
+    size_t first = a * header->interval;
+    size_t last = std::min<size_t>(first + header->interval, header->frameCount);
+
+    uint16_t previousBlockDelta = 0;
+
+    for (size_t f = first; f < last; f++)
+    {
+      const AacAdtsIndexPackedEntry *entry = &entries[f];
+
+      unsigned int size = entry->sizeAndBlocks & 0x1FFF;
+
+      // Checked in two steps, as the sum could wrap
+      if ((size < AAC_ADTS_FRAME_HEADER_SIZE) || (entry->offsetDelta > header->sourceSize - anchor->offset) || (size > header->sourceSize - anchor->offset - entry->offsetDelta))
+        return false;
+
+      // Each anchor is its first frame
+      if ((f == first) && ((entry->offsetDelta != 0) || (entry->blockDelta != 0)))
+        return false;
+
+      if (entry->blockDelta < previousBlockDelta)
+        return false;
+
+      previousBlockDelta = entry->blockDelta;
+    }
+  }
+
+  return true;
+}
+
+bool AacAdtsIndex::load(const char *indexFilename, const char *sourceFilename)
+{
+  int fd = ::open(indexFilename, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) || (static_cast<size_t>(st.st_size) < sizeof(AacAdtsIndexHeader)))
+  {
+    close(fd);
+    return false;
+  }
+
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (map == MAP_FAILED)
+    return false;
+
+  auto header = static_cast<const AacAdtsIndexHeader *>(map);
+
+  AacAdtsIndexHeader current;
+  bool success = (header->magic == AAC_ADTS_INDEX_MAGIC) && (header->version == AAC_ADTS_INDEX_VERSION);
+  success = success && (header->interval >= 1) && (header->interval <= AAC_ADTS_INDEX_MAX_INTERVAL);
+  success = success && (header->frameCount <= static_cast<size_t>(st.st_size) / sizeof(AacAdtsIndexPackedEntry));
+  success = success && (getDataSize(header->frameCount, header->interval) == static_cast<size_t>(st.st_size));
+  success = success && checkEntries(header);
+
+  // Stale if the source has changed since the index was saved
+  success = success && getFingerprint(sourceFilename, &current);
+  success = success && (header->sourceSize == current.sourceSize) && (header->sourceModifiedTime == current.sourceModifiedTime) && (header->sourceHash == current.sourceHash);
+
+  if (!success)
+  {
+    munmap(map, st.st_size);
+    return false;
+  }
+
+  unmap();
+  std::vector<uint64_t>().swap(m_buffer);
+
+  m_map = map;
+  m_mapSize = st.st_size;
+  attach(map);
+
+  return true;
+}
+
+bool AacAdtsIndex::open(AacAdtsFrameReader *reader, const char *sourceFilename)
+{
+  std::string indexFilename = getSidecarFilename(sourceFilename);
+
+  if (load(indexFilename.c_str(), sourceFilename))
+    return true;
+
+  if (!build(reader))
+    return false;
+
+  save(indexFilename.c_str(), sourceFilename);  // Best effort, e.g. the directory may be read-only
+  return true;
+}
+
+AacAdtsIndexEntry AacAdtsIndex::getEntry(size_t frame) const
+{
+  const AacAdtsIndexAnchor      *anchor = &m_anchors[frame / m_header->interval];
+  const AacAdtsIndexPackedEntry *packed = &m_entries[frame];
+
+  AacAdtsIndexEntry entry;
+  entry.offset     = anchor->offset + packed->offsetDelta;
+  entry.sample     = anchor->sample + (static_cast<uint64_t>(packed->blockDelta) * AAC_AUDIO_BLOCK_SAMPLE_COUNT);
+  entry.size       = packed->sizeAndBlocks & 0x1FFF;
+  entry.blockCount = (packed->sizeAndBlocks >> 13) + 1;
+
+  return entry;
+}
+
+size_t AacAdtsIndex::findFrame(uint64_t sample) const
+{
+  size_t frameCount = getFrameCount();
+  if (sample >= getSampleCount())
+    return frameCount;
+
+  // Frames nearly always hold one block each, which makes the obvious frame
+  //  the right one
+  size_t guess = sample / AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+  if (guess < frameCount)
+  {
+    AacAdtsIndexEntry entry = getEntry(guess);
+    if ((entry.sample <= sample) && (sample < entry.sample + (entry.blockCount * AAC_AUDIO_BLOCK_SAMPLE_COUNT)))
+      return guess;
+  }
+
+  // Otherwise find the last anchor at or before the sample, then the last
+  //  frame after it that starts at or before the sample
+  size_t anchorCount = (frameCount + m_header->interval - 1) / m_header->interval;
+
+  auto anchor = std::upper_bound(m_anchors, m_anchors + anchorCount, sample, [](uint64_t s, const AacAdtsIndexAnchor &a) { return s < a.sample; }) - 1;
+
+  size_t first = (anchor - m_anchors) * m_header->interval;
+  size_t last = std::min<size_t>(first + m_header->interval, frameCount);
+
+  uint64_t blockDelta = (sample - anchor->sample) / AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+
+  auto next = std::upper_bound(m_entries + first, m_entries + last, blockDelta, [](uint64_t b, const AacAdtsIndexPackedEntry &e) { return b < e.blockDelta; });
+
+  return (next - m_entries) - 1;
+}
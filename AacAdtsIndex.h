@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#ifndef AAC_ADTS_INDEX_H
+#define AAC_ADTS_INDEX_H
+
+// Frames per anchor. Larger intervals save a little space; the limit keeps
+//  each entry's block delta within 16 bits.
+#define AAC_ADTS_INDEX_DEFAULT_INTERVAL 256
+#define AAC_ADTS_INDEX_MAX_INTERVAL     16384
+
+#define AAC_ADTS_INDEX_MAGIC   0x58444941  // "AIDX" when stored little-endian
+#define AAC_ADTS_INDEX_VERSION 1
+
+// Bytes hashed from each end of the source file for its fingerprint
+#define AAC_ADTS_INDEX_HASH_SIZE 4096
+
+class AacAdtsFrameReader;
+
+struct AacAdtsIndexEntry
+{
+  uint64_t offset;  // Of the frame header within the input
+  uint64_t sample;  // Position of the frame's first sample in the decoded output
+  uint16_t size;
+  uint8_t  blockCount;  // Raw data blocks, each of AAC_AUDIO_BLOCK_SAMPLE_COUNT samples
+};
+
+// The index is kept in the same form in memory as in a sidecar file, so a
+//  saved index can be mapped and used as it is. All fields are in the
+//  writer's byte order; a reader with the other order sees a bad magic
+//  number and rebuilds.
+//
+//   header
+//   anchors[(frameCount + interval - 1) / interval]
+//   entries[frameCount]
+struct AacAdtsIndexHeader
+{
+  uint32_t magic;
+  uint32_t version;
+
+  // Fingerprint of the source file, for spotting a stale index
+  uint64_t sourceSize;
+  int64_t  sourceModifiedTime;  // In nanoseconds
+  uint64_t sourceHash;  // FNV-1a of the first and last AAC_ADTS_INDEX_HASH_SIZE bytes
+
+  uint64_t frameCount;
+  uint64_t sampleCount;
+  uint32_t interval;  // Frames per anchor
+  uint32_t reserved;
+};
+
+// Absolute position of every interval'th frame
+struct AacAdtsIndexAnchor
+{
+  uint64_t offset;
+  uint64_t sample;
+};
+
+// Each frame relative to the anchor before it
+struct AacAdtsIndexPackedEntry
+{
+  uint32_t offsetDelta;
+  uint16_t sizeAndBlocks;  // 13-bit frame size, then data block count minus one
+  uint16_t blockDelta;  // Blocks between the anchor and the frame's first sample
+};
+
+// The position of every frame in an ADTS stream, found with a header-only
+//  walk, for seeking without decoding everything before the target.
+// Sample positions count samples per channel from the first frame, as they
+//  would come out of a serial decode.
+class AacAdtsIndex
+{
+  std::vector<uint64_t>          m_buffer;  // Holds a built index
+
+  void                          *m_map;  // Or a loaded one
+  size_t                         m_mapSize;
+
+  const AacAdtsIndexHeader      *m_header;
+  const AacAdtsIndexAnchor      *m_anchors;
+  const AacAdtsIndexPackedEntry *m_entries;
+
+  static size_t getDataSize(uint64_t frameCount, uint32_t interval);
+  static bool   getFingerprint(const char *sourceFilename, AacAdtsIndexHeader *header);
+  static bool   checkEntries(const AacAdtsIndexHeader *header);
+
+  void attach(const void *data);
+  void unmap(void);
+
+public:
+  AacAdtsIndex(void);
+  ~AacAdtsIndex(void);
+
+  AacAdtsIndex(const AacAdtsIndex &) = delete;
+  AacAdtsIndex &operator=(const AacAdtsIndex &) = delete;
+
+  // Indexes from the reader's position to the end of its input, following
+  //  the same path as a serial decode, including resyncing after damage.
+  //  Frames of more than one raw data block are indexed with their block
+  //  count, though they aren't decoded. The reader itself isn't moved. Only fails if there's a gap between
+  //  frames too big to encode (4 GB within one interval).
+  bool build(AacAdtsFrameReader *reader, unsigned int interval = AAC_ADTS_INDEX_DEFAULT_INTERVAL);
+
+  // Writes the index to a sidecar file, fingerprinting the source file it
+  //  was built from
+  bool save(const char *indexFilename, const char *sourceFilename);
+
+  // Maps a sidecar file. Fails if it's missing, damaged, or doesn't match
+  //  the source file as it is now.
+  bool load(const char *indexFilename, const char *sourceFilename);
+
+  // Loads the sidecar file if it's still valid, otherwise builds the index
+  //  and tries to save it for next time
+  bool open(AacAdtsFrameReader *reader, const char *sourceFilename);
+
+  static std::string getSidecarFilename(const char *sourceFilename) { return std::string(sourceFilename) + ".idx"; };
+
+  bool              isValid(void) const { return m_header != NULL; };
+
+  size_t            getFrameCount(void) const { return m_header ? m_header->frameCount : 0; };
+  AacAdtsIndexEntry getEntry(size_t frame) const;
+
+  uint64_t          getSampleCount(void) const { return m_header ? m_header->sampleCount : 0; };
+
+  // Returns the frame containing the given sample, or getFrameCount() if it
+  //  is past the end
+  size_t            findFrame(uint64_t sample) const;
+};
+
+#endif
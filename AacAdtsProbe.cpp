@@ -0,0 +1,94 @@
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+
+#include "AacAdtsProbe.h"
+
+namespace AacAdtsProbe
+{
+  void probe(AacAdtsFrameReader *reader, AacAdtsProbeResult *result)
+  {
+    auto walker = *reader;
+
+    *result = AacAdtsProbeResult();
+
+    result->id3Size = walker.skipID3();
+
+    // The duration is summed a run of frames at a time, so that it's exact
+    //  until the sample rate changes
+    uint64_t     runSampleCount = 0;
+    unsigned int runSampleRate = 0;
+
+    while (!walker.isComplete())
+    {
+      size_t position = walker.getPosition();
+
+      AacAdtsFrameHeader header;
+      bool isValid = walker.readFrameHeader(&header);
+
+      size_t       frameSize  = isValid ? header.getFrameSize() : 0;
+      unsigned int sampleRate = isValid ? header.getSampleRate() : 0;
+
+      if ((frameSize < AAC_ADTS_FRAME_HEADER_SIZE) || (frameSize > walker.getRemainingSize()) || (sampleRate == 0))
+      {
+        size_t skipped = walker.findNextFrame();
+
+        // A frame header that turned out to be bad is part of the same
+        //  damage as the bytes around it
+        auto &regions = result->damagedRegions;
+        if (!regions.empty() && (regions.back().offset + regions.back().size == position))
+          regions.back().size += skipped;
+        else
+          regions.push_back({position, skipped});
+
+        continue;
+      }
+
+      uint64_t sampleCount = header.getDataBlockCount() * AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+
+      auto channelConfig = header.getChannelConfiguration();
+      unsigned int channelCount = channelConfig->fullChannelCount + channelConfig->subwooferChannelCount;
+
+      auto &parameters = result->parameters;
+      if (parameters.empty() || (parameters.back().sampleRate != sampleRate) || (parameters.back().channelCount != channelCount) || (parameters.back().profile != header.getProfile()))
+        parameters.push_back({position, result->sampleCount, sampleRate, channelCount, header.getProfile()});
+
+      if (sampleRate != runSampleRate)
+      {
+        if (runSampleRate)
+          result->duration += static_cast<double>(runSampleCount) / runSampleRate;
+
+        runSampleCount = 0;
+        runSampleRate = sampleRate;
+      }
+
+      runSampleCount += sampleCount;
+
+      double bitrate = (frameSize * 8.0 * sampleRate) / sampleCount;
+      if (result->frameCount == 0)
+      {
+        result->minBitrate = bitrate;
+        result->maxBitrate = bitrate;
+      }
+      else
+      {
+        result->minBitrate = std::min(result->minBitrate, bitrate);
+        result->maxBitrate = std::max(result->maxBitrate, bitrate);
+      }
+
+      result->frameCount++;
+      result->frameBytes += frameSize;
+      result->sampleCount += sampleCount;
+
+      walker.advance(frameSize);
+    }
+
+    if (runSampleRate)
+      result->duration += static_cast<double>(runSampleCount) / runSampleRate;
+
+    if (result->duration > 0.0)
+      result->averageBitrate = (result->frameBytes * 8.0) / result->duration;
+  }
+};
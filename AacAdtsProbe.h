@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "AacAdtsFrameHeader.h"
+
+#ifndef AAC_ADTS_PROBE_H
+#define AAC_ADTS_PROBE_H
+
+class AacAdtsFrameReader;
+
+// Where the stream parameters are first seen, and each place they change
+struct AacAdtsParameterChange
+{
+  uint64_t       offset;
+  uint64_t       sample;  // Samples per channel before this frame
+  unsigned int   sampleRate;
+  unsigned int   channelCount;  // Including any subwoofer; zero if set by a PCE
+  AacAdtsProfile profile;
+};
+
+// Bytes passed over looking for a frame header
+struct AacAdtsDamagedRegion
+{
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct AacAdtsProbeResult
+{
+  size_t                              id3Size;
+
+  uint64_t                            frameCount;
+  uint64_t                            frameBytes;  // Total size of all frames, headers included
+  uint64_t                            sampleCount;  // Per channel
+
+  double                              duration;  // In seconds, allowing for sample rate changes
+
+  // In bits per second. Each frame's rate is its size over the time it
+  //  covers; the average is all frames over the whole duration.
+  double                              minBitrate;
+  double                              averageBitrate;
+  double                              maxBitrate;
+
+  std::vector<AacAdtsParameterChange> parameters;
+  std::vector<AacAdtsDamagedRegion>   damagedRegions;
+};
+
+// Describes an ADTS stream from its frame headers alone, without parsing or
+//  decoding any audio, so the cost is little more than reading the input.
+namespace AacAdtsProbe
+{
+  // Walks from the reader's position to the end of its input, skipping an
+  //  ID3 tag at the start. The reader itself isn't moved.
+  extern void probe(AacAdtsFrameReader *reader, AacAdtsProbeResult *result);
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include <iterator>
+
+#include "AacBitReader.h"
+#include "AacConstants.h"
+#include "AacDecoder.h"
+#include "AacStructs.h"
+
+#include "AacAudioSpecificConfig.h"
+
+// Audio object types that put a core object type after the SBR sample rate
+#define AAC_OBJECT_TYPE_SBR 5
+#define AAC_OBJECT_TYPE_PS  29
+
+static unsigned int readObjectType(AacBitReader *reader)
+{
+  unsigned int objectType = reader->readUInt(5);
+  if (objectType == 31)
+    objectType = 32 + reader->readUInt(6);
+
+  return objectType;
+}
+
+static unsigned int readSampleRate(AacBitReader *reader)
+{
+  unsigned int index = reader->readUInt(4);
+  if (index == 0xF)
+    return reader->readUInt(24);  // Given explicitly
+
+  return AacConstants::getSampleRateByIndex(static_cast<AacSampleRateIndex>(index));
+}
+
+// Object types whose config continues with a GASpecificConfig
+static bool isGeneralAudio(unsigned int objectType)
+{
+  switch (objectType)
+  {
+  case 1: case 2: case 3: case 4: case 6: case 7:
+  case 17: case 19: case 20: case 21: case 22: case 23:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool AacAudioSpecificConfig::read(AacBitReader *reader)
+{
+  // A PCE's byte alignment is relative to the start of the config
+  AacBitReader config = reader->getSubReader();
+  size_t start = config.getBitPosition();
+
+  objectType = readObjectType(&config);
+  sampleRate = readSampleRate(&config);
+  channelConfiguration = config.readUInt(4);
+
+  // With explicit SBR signalling, the core follows. Like the ADTS path, the
+  //  decoder plays just the core.
+  if ((objectType == AAC_OBJECT_TYPE_SBR) || (objectType == AAC_OBJECT_TYPE_PS))
+  {
+    readSampleRate(&config);
+    objectType = readObjectType(&config);
+  }
+
+  if ((sampleRate == 0) || !isGeneralAudio(objectType))
+    return false;
+
+  // GASpecificConfig
+  bool isShortFrame = config.readBit();
+  if (isShortFrame)
+    return false;
+
+  bool dependsOnCoreCoder = config.readBit();
+  if (dependsOnCoreCoder)
+    config.skipBits(14);  // coreCoderDelay
+
+  bool hasExtension = config.readBit();
+
+  if (channelConfiguration == 0)
+  {
+    AacProgramConfigInfo pce;
+    if (!AacDecoder::readProgramConfigInfo(&config, &pce))
+      return false;
+  }
+
+  if ((objectType == 6) || (objectType == 20))
+    config.skipBits(3);  // layerNr
+
+  if (hasExtension)
+  {
+    if (objectType == 22)
+      config.skipBits(16);  // numOfSubFrame, layer_length
+    else if ((objectType == 17) || (objectType == 19) || (objectType == 20) || (objectType == 23))
+      config.skipBits(3);  // Error resilience flags
+
+    config.skipBits(1);  // extensionFlag3
+  }
+
+  reader->skipBits(config.getBitPosition() - start);
+
+  return true;
+}
+
+unsigned int AacAudioSpecificConfig::getChannelCount(void) const
+{
+  // Channel configurations 1 to 7, as in an ADTS header
+  static const unsigned int channelCounts[] = {0, 1, 2, 3, 4, 5, 6, 8};
+
+  if (channelConfiguration >= std::size(channelCounts))
+    return 0;
+
+  return channelCounts[channelConfiguration];
+}
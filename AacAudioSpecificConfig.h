@@ -0,0 +1,26 @@
+#include <stdint.h>
+
+#ifndef AAC_AUDIO_SPECIFIC_CONFIG_H
+#define AAC_AUDIO_SPECIFIC_CONFIG_H
+
+class AacBitReader;
+
+#define AAC_OBJECT_TYPE_LC 2  // Audio object type of AAC-LC
+
+// The AudioSpecificConfig that describes an AAC stream in MP4 and LATM,
+//  where ADTS would have a frame header
+struct AacAudioSpecificConfig
+{
+  unsigned int objectType;  // Of the core, if SBR is signalled explicitly
+  unsigned int sampleRate;
+  unsigned int channelConfiguration;  // Zero if set by a PCE
+
+  // Reads the whole config, including any PCE, leaving the reader just
+  //  after it. Fails on object types without a GASpecificConfig, and on
+  //  960-sample frames, which the decoder can't produce.
+  bool read(AacBitReader *reader);
+
+  unsigned int getChannelCount(void) const;  // Including any subwoofer; zero if set by a PCE
+};
+
+#endif
@@ -37,10 +37,7 @@ namespace AacAudioTools
     double iqfac   = ((1 << (bitCount - 1)) - 0.5) / (M_PI / 2.0);
     double iqfac_m = ((1 << (bitCount - 1)) + 0.5) / (M_PI / 2.0);
     for (unsigned int o = 0; o < order; o++)
-    {
       dequant[o] = sin(quant[o] / ((quant[o] >= 0) ? iqfac : iqfac_m));
-      DEBUGF("  TNS: coef[%d] %d  dequant %f\n", o, quant[o], dequant[o]);
-    }
 
     // Conversion to LPC
     // The standard is not very forthcoming about what is happening here. It
@@ -58,8 +55,6 @@ namespace AacAudioTools
     }
 
     // NOTE: We end up with 1 more LPC coefficient than our 'order'
-    for (unsigned int o = 0; o <= order; o++)
-     DEBUGF("  TNS: lpc[%d] %f\n", o, lpc[o]);
   }
 
   void tnsFilterUpwards(double *coefficients, unsigned int sampleCount, unsigned int order, const double lpc[])
@@ -0,0 +1,272 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <chrono>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameReader.h"
+#include "AacDecoder.h"
+#include "AacThreadPool.h"
+
+#include "AacBatchTranscoder.h"
+
+// Files up to this size are read into a reused buffer; larger ones are mapped
+#define AAC_BATCH_MMAP_THRESHOLD (4 * 1024 * 1024)
+
+// Consecutive files are grouped into one task until it has this much input
+#define AAC_BATCH_TASK_BYTES (1024 * 1024)
+
+AacBatchTranscoder::AacBatchTranscoder(AacThreadPool *pool)
+{
+  m_pool = pool;
+
+  for (unsigned int w = 0; w < pool->getThreadCount(); w++)
+  {
+    Worker *worker = new Worker;
+    worker->decoder = NULL;
+    m_workers.push_back(worker);
+  }
+}
+
+AacBatchTranscoder::~AacBatchTranscoder(void)
+{
+  for (auto worker : m_workers)
+  {
+    delete worker->decoder;
+    delete worker;
+  }
+}
+
+bool AacBatchTranscoder::addFile(const char *inputPath, const char *outputPath)
+{
+  struct stat st;
+  if (stat(inputPath, &st) < 0)
+    return false;
+
+  m_jobs.push_back({.inputPath = inputPath, .outputPath = outputPath, .inputSize = static_cast<size_t>(st.st_size), .isSuccess = false, .failure = NULL, .failureErrno = 0});
+  return true;
+}
+
+bool AacBatchTranscoder::run(AacBatchStats *stats)
+{
+  auto startTime = std::chrono::steady_clock::now();
+
+  for (auto worker : m_workers)
+    worker->stats = {};
+
+  // Group small files together so that each task has a worthwhile amount
+  //  of work in it
+  size_t first = 0;
+  size_t taskBytes = 0;
+  for (size_t j = 0; j < m_jobs.size(); j++)
+  {
+    taskBytes += m_jobs[j].inputSize;
+
+    if ((taskBytes >= AAC_BATCH_TASK_BYTES) || (j + 1 == m_jobs.size()))
+    {
+      size_t count = j + 1 - first;
+      m_pool->submit([this, first, count] (unsigned int worker) { transcodeJobs(worker, first, count); });
+
+      first = j + 1;
+      taskBytes = 0;
+    }
+  }
+
+  m_pool->wait();
+
+  // Gather the per-worker counts
+  *stats = {};
+  for (auto worker : m_workers)
+  {
+    stats->fileCount    += worker->stats.fileCount;
+    stats->failedCount  += worker->stats.failedCount;
+    stats->inputBytes   += worker->stats.inputBytes;
+    stats->outputBytes  += worker->stats.outputBytes;
+    stats->blockCount   += worker->stats.blockCount;
+    stats->audioSeconds += worker->stats.audioSeconds;
+  }
+
+  stats->elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  return stats->failedCount == 0;
+}
+
+void AacBatchTranscoder::transcodeJobs(unsigned int w, size_t first, size_t count)
+{
+  Worker *worker = m_workers[w];
+
+  for (size_t j = first; j < first + count; j++)
+  {
+    AacBatchJob *job = &m_jobs[j];
+
+    job->isSuccess = transcode(worker, job);
+
+    worker->stats.fileCount++;
+    if (!job->isSuccess)
+      worker->stats.failedCount++;
+  }
+}
+
+bool AacBatchTranscoder::transcode(Worker *worker, AacBatchJob *job)
+{
+  int fd = open(job->inputPath.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    job->failure = "Could not open input file";
+    job->failureErrno = errno;
+    return false;
+  }
+
+  const uint8_t *bytes;
+  size_t size = job->inputSize;
+  bool isMapped = (size > AAC_BATCH_MMAP_THRESHOLD);
+
+  if (isMapped)
+  {
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+      job->failure = "Could not map input file";
+      job->failureErrno = errno;
+      close(fd);
+      return false;
+    }
+
+    bytes = static_cast<const uint8_t *>(mapping);
+  }
+  else
+  {
+    if (worker->input.size() < size)
+      worker->input.resize(size);
+
+    size_t done = 0;
+    while (done < size)
+    {
+      ssize_t count = read(fd, worker->input.data() + done, size - done);
+      if (count < 0 && errno == EINTR)
+        continue;
+
+      if (count <= 0)
+      {
+        job->failure = "Could not read input file";
+        job->failureErrno = (count < 0) ? errno : 0;
+        close(fd);
+        return false;
+      }
+
+      done += count;
+    }
+
+    bytes = worker->input.data();
+  }
+
+  close(fd);
+
+  bool success = decode(worker, job, bytes, size);
+
+  if (isMapped)
+    munmap(const_cast<uint8_t *>(bytes), size);
+
+  worker->stats.inputBytes += size;
+
+  return success;
+}
+
+bool AacBatchTranscoder::decode(Worker *worker, AacBatchJob *job, const uint8_t *bytes, size_t size)
+{
+  auto reader = AacAdtsFrameReader(bytes, size);
+
+  // Skip over any initial ID3 tag
+  reader.skipID3();
+
+  // Position reader at first frame header
+  if (!reader.isAtFrameHeader())
+    reader.findNextFrame();
+
+  AacAdtsFrameHeader header;
+  if (!reader.readFrameHeader(&header))
+  {
+    job->failure = "Could not find initial frame header";
+    return false;
+  }
+
+  // Reuse the worker's decoder when we can
+  if (worker->decoder && (worker->decoder->getSampleRate() == header.getSampleRate()))
+    worker->decoder->reset();
+  else
+  {
+    delete worker->decoder;
+    worker->decoder = new AacDecoder(header.getSampleRate());
+  }
+
+  AacDecoder *decoder = worker->decoder;
+  AacAudioBlock *audio = &worker->audio;
+
+  while (!reader.isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!reader.readFrame(&frame))
+    {
+      reader.findNextFrame();
+      continue;
+    }
+
+    if (decoder->getSampleRate() != frame.getHeader()->getSampleRate())
+      *decoder = AacDecoder(frame.getHeader()->getSampleRate());
+
+    if (!decoder->decodeBlock(frame.getReader(), audio))
+    {
+      job->failure = "Failed to decode block";
+      worker->writer.close();
+      return false;
+    }
+
+    // Open output file, if not yet open
+    if (!worker->writer.isOpen())
+    {
+      uint64_t expectedSize = static_cast<uint64_t>(reader.countFrames()) * audio->getSampleCount() * sizeof(int16_t);
+
+      if (!worker->writer.open(job->outputPath.c_str(), audio->getChannelCount(), 16, audio->getSampleRate(), expectedSize))
+      {
+        job->failure = "Could not open output file";
+        job->failureErrno = errno;
+        return false;
+      }
+    }
+
+    // Ensure little-endian samples
+    audio->switchEndianness(std::endian::little);
+
+    // The writer gathers blocks into large writes
+    int16_t *buf;
+    auto blockSize = audio->getSampleBuffer(&buf);
+    if (!worker->writer.write(reinterpret_cast<const uint8_t *>(buf), blockSize))
+    {
+      job->failure = "Could not write to output file";
+      job->failureErrno = errno;
+      return false;
+    }
+
+    worker->stats.outputBytes += blockSize;
+    worker->stats.blockCount++;
+    worker->stats.audioSeconds += static_cast<double>(AAC_AUDIO_BLOCK_SAMPLE_COUNT) / audio->getSampleRate();
+
+    reader.advance(frame.getSize());
+  }
+
+  // Whatever is still buffered, and the sizes in the header, go out now
+  if (!worker->writer.close())
+  {
+    job->failure = "Could not write to output file";
+    job->failureErrno = errno;
+    return false;
+  }
+
+  return true;
+}
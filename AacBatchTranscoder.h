@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+#include "AacAudioBlock.h"
+#include "WavWriter.h"
+
+#ifndef AAC_BATCH_TRANSCODER_H
+#define AAC_BATCH_TRANSCODER_H
+
+class AacDecoder;
+class AacThreadPool;
+
+struct AacBatchJob
+{
+  std::string  inputPath;
+  std::string  outputPath;
+  size_t       inputSize;
+
+  bool         isSuccess;
+  const char  *failure;  // Why the job failed, if it did
+  int          failureErrno;  // Zero if not a system error
+};
+
+struct AacBatchStats
+{
+  unsigned int fileCount;
+  unsigned int failedCount;
+
+  uint64_t     inputBytes;
+  uint64_t     outputBytes;
+  uint64_t     blockCount;
+
+  double       audioSeconds;  // Duration of all decoded audio
+  double       elapsedSeconds;  // Wall-clock time for the whole batch
+};
+
+// Transcodes many ADTS files to WAV within one process, on a thread pool.
+// Each worker keeps its decoder, audio block and buffers from file to file,
+//  and small files are grouped into one task so that scheduling costs are
+//  spread over several files.
+class AacBatchTranscoder
+{
+  struct Worker
+  {
+    AacDecoder           *decoder;
+    AacAudioBlock         audio;
+    std::vector<uint8_t>  input;  // Small files are read into here instead of being mapped
+    WavWriter             writer;
+    AacBatchStats         stats;
+  };
+
+  AacThreadPool           *m_pool;
+
+  std::vector<AacBatchJob> m_jobs;
+  std::vector<Worker *>    m_workers;
+
+  void transcodeJobs(unsigned int worker, size_t first, size_t count);
+  bool transcode(Worker *worker, AacBatchJob *job);
+  bool decode(Worker *worker, AacBatchJob *job, const uint8_t *bytes, size_t size);
+
+public:
+  AacBatchTranscoder(AacThreadPool *pool);
+  ~AacBatchTranscoder(void);
+
+  AacBatchTranscoder(const AacBatchTranscoder &) = delete;
+  AacBatchTranscoder &operator=(const AacBatchTranscoder &) = delete;
+
+  // Returns false if the input file can't be examined
+  bool addFile(const char *inputPath, const char *outputPath);
+
+  // Returns false if any file failed
+  bool run(AacBatchStats *stats);
+
+  const std::vector<AacBatchJob> &getJobs(void) { return m_jobs; };
+
+  // Write the output files with O_DIRECT
+  void setDirect(bool isDirect) { for (auto worker : m_workers) worker->writer.setDirect(isDirect); };
+};
+
+#endif
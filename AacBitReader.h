@@ -12,12 +12,20 @@ class AacBitReader
   size_t         m_position;
   unsigned int   m_bit;  // Bit position counting from the left [0..7]
 
+  unsigned int   m_originBit;  // Bit of the first byte that reading began at
+
 public:
-  AacBitReader(void) : m_bytes(NULL), m_size(0), m_position(0), m_bit(0) {};
-  AacBitReader(const uint8_t *bytes, size_t size) : m_bytes(bytes), m_size(size), m_position(0), m_bit(0) {};
+  AacBitReader(void) : m_bytes(NULL), m_size(0), m_position(0), m_bit(0), m_originBit(0) {};
+  AacBitReader(const uint8_t *bytes, size_t size) : m_bytes(bytes), m_size(size), m_position(0), m_bit(0), m_originBit(0) {};
+  AacBitReader(const uint8_t *bytes, size_t size, unsigned int bit) : m_bytes(bytes), m_size(size), m_position(0), m_bit(bit), m_originBit(bit) {};
+
+  // A reader for what follows, starting from the current bit
+  AacBitReader getSubReader(void) { if (isComplete()) return AacBitReader(m_bytes + m_size, 0); return AacBitReader(m_bytes + m_position, m_size - m_position, m_bit); };
 
   bool         isComplete(void) { return m_position >= m_size; };
 
+  size_t       getBitPosition(void) { return (m_position * 8) + m_bit; };
+
   unsigned int readBit(void) { if (isComplete()) return 0; uint8_t byte = m_bytes[m_position]; unsigned int v = (byte >> (7 - m_bit)) & 0x01; if (++m_bit > 7) { m_bit = 0; m_position++; }; return v; };
   unsigned int readByte(void) { if (isComplete()) return 0; if (m_bit == 0) return m_bytes[m_position++]; else return readUInt(8); }
 
@@ -25,6 +33,10 @@ public:
 
   void         alignToBit(unsigned int bit) { if (bit > 7) abort(); if (m_bit == bit) return; else if (m_bit < bit) { m_bit = bit; return; } m_position++; m_bit = bit; };
 
+  // Byte alignment in the AAC syntax is relative to the start of the
+  //  enclosing structure, which needn't be byte aligned in LATM
+  void         byteAlign(void) { alignToBit(m_originBit); };
+
   void         skipBits(unsigned int count);
   void         skipBytes(unsigned int count) { m_position += count; if (m_position > m_size) m_position = m_size; };
 
@@ -0,0 +1,42 @@
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "AacBitWriter.h"
+
+void AacBitWriter::writeUInt(unsigned int bitCount, unsigned int value)
+{
+  unsigned int writtenCount = 0;
+
+  while (writtenCount < bitCount)
+  {
+    if (m_bit == 0)
+      m_bytes.push_back(0);
+
+    unsigned int bitsLeftInByte = 8 - m_bit;
+    unsigned int bitsLeftToWrite = bitCount - writtenCount;
+    unsigned int bitsToWrite = std::min(bitsLeftInByte, bitsLeftToWrite);
+
+    unsigned int readShift = bitsLeftToWrite - bitsToWrite;
+    unsigned int writeShift = bitsLeftInByte - bitsToWrite;
+
+    uint8_t bits = (value >> readShift) & ((1U << bitsToWrite) - 1);
+    m_bytes.back() |= bits << writeShift;
+
+    writtenCount += bitsToWrite;
+    m_bit = (m_bit + bitsToWrite) & 0x07;
+  }
+}
+
+void AacBitWriter::truncate(size_t bitPosition)
+{
+  if (bitPosition >= getBitPosition())
+    return;
+
+  m_bytes.resize((bitPosition + 7) / 8);
+  m_bit = bitPosition & 0x07;
+
+  // Clear the dropped bits of a partial last byte, as writes OR into it
+  if (m_bit)
+    m_bytes.back() &= 0xFF << (8 - m_bit);
+}
@@ -0,0 +1,36 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#ifndef AAC_BIT_WRITER_H
+#define AAC_BIT_WRITER_H
+
+// Appends bits most-significant first, the counterpart of AacBitReader
+class AacBitWriter
+{
+  std::vector<uint8_t> m_bytes;
+
+  unsigned int         m_bit;  // Bit position in the last byte counting from the left [0..7]
+
+public:
+  AacBitWriter(void) : m_bit(0) {};
+
+  size_t         getBitPosition(void) const { return (m_bit == 0) ? (m_bytes.size() * 8) : (((m_bytes.size() - 1) * 8) + m_bit); };
+
+  void           writeBit(unsigned int bit) { if (m_bit == 0) m_bytes.push_back(0); if (bit) m_bytes.back() |= 0x80 >> m_bit; m_bit = (m_bit + 1) & 0x07; };
+  void           writeUInt(unsigned int bitCount, unsigned int value);
+
+  // Pads with zero bits to the next byte boundary
+  void           byteAlign(void) { m_bit = 0; };
+
+  // Drops everything from a bit position onwards, to write it again
+  void           truncate(size_t bitPosition);
+
+  const uint8_t *getBytes(void) const { return m_bytes.data(); };
+  size_t         getSize(void) const { return m_bytes.size(); };  // Including a partly written last byte
+
+  void           clear(void) { m_bytes.clear(); m_bit = 0; };
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <iterator>
+
+#include "AacBitstreamStats.h"
+
+static const char *partNames[] =
+{
+  "element fields",
+  "ics_info",
+  "M/S mask",
+  "sections",
+  "scalefactors",
+  "pulse",
+  "TNS",
+  "spectral",
+  "fill",
+  "PCE",
+  "alignment",
+};
+
+static_assert(std::size(partNames) == AAC_BITS_PART_COUNT);
+
+void AacBitstreamStats::addBlock(const AacSpectralBlock *block)
+{
+  blockCount++;
+  channelCount += block->channelCount;
+
+  for (unsigned int ch = 0; ch < block->channelCount; ch++)
+  {
+    const AacSpectralChannel *channel = &block->channels[ch];
+
+    for (unsigned int g = 0; g < channel->ics.windowGroupCount; g++)
+    {
+      for (unsigned int sfb = 0; sfb < channel->ics.sfbCount; sfb++)
+        codebookBands[channel->info.section.sfbCodebooks[g][sfb]]++;
+    }
+
+    if (channel->info.tns.isEnabled)
+      tnsChannels++;
+
+    if (channel->info.pulse.pulseCount)
+      pulseChannels++;
+
+    if (channel->ics.windowSequence == AAC_WINSEQ_8_SHORT)
+      shortMaxSfbCounts[channel->ics.sfbCount]++;
+    else
+      longMaxSfbCounts[channel->ics.sfbCount]++;
+
+    if (ch < previousChannelCount)
+    {
+      windowSequenceTransitions[previousWindowSequences[ch]][channel->ics.windowSequence]++;
+      windowShapeTransitions[previousWindowShapes[ch]][channel->ics.windowShape]++;
+    }
+
+    previousWindowSequences[ch] = channel->ics.windowSequence;
+    previousWindowShapes[ch]    = channel->ics.windowShape;
+  }
+
+  previousChannelCount = block->channelCount;
+}
+
+void AacBitstreamStats::add(const AacBitstreamStats &other)
+{
+  blockCount   += other.blockCount;
+  channelCount += other.channelCount;
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_ELEMENT_COUNT; i++)
+    elementCounts[i] += other.elementCounts[i];
+
+  for (unsigned int i = 0; i < AAC_BITS_PART_COUNT; i++)
+    bits[i] += other.bits[i];
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_CODEBOOK_COUNT; i++)
+  {
+    codebookBands[i] += other.codebookBands[i];
+    codebookBits[i]  += other.codebookBits[i];
+  }
+
+  escapeCount += other.escapeCount;
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT; i++)
+  {
+    for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT; j++)
+      windowSequenceTransitions[i][j] += other.windowSequenceTransitions[i][j];
+  }
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_WINDOW_SHAPE_COUNT; i++)
+  {
+    for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SHAPE_COUNT; j++)
+      windowShapeTransitions[i][j] += other.windowShapeTransitions[i][j];
+  }
+
+  tnsChannels   += other.tnsChannels;
+  pulseChannels += other.pulseChannels;
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_MS_MASK_COUNT; i++)
+    msMaskCounts[i] += other.msMaskCounts[i];
+
+  for (unsigned int i = 0; i <= AAC_MAX_SFB_COUNT; i++)
+  {
+    longMaxSfbCounts[i]  += other.longMaxSfbCounts[i];
+    shortMaxSfbCounts[i] += other.shortMaxSfbCounts[i];
+  }
+}
+
+uint64_t AacBitstreamStats::getTotalBits(void) const
+{
+  uint64_t total = 0;
+  for (unsigned int i = 0; i < AAC_BITS_PART_COUNT; i++)
+    total += bits[i];
+
+  return total;
+}
+
+const char *AacBitstreamStats::getPartName(AacBitstreamPart part)
+{
+  if (part >= AAC_BITS_PART_COUNT)
+    return NULL;  // Out of range
+
+  return partNames[part];
+}
@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AacConstants.h"
+#include "AacStructs.h"
+
+#ifndef AAC_BITSTREAM_STATS_H
+#define AAC_BITSTREAM_STATS_H
+
+// The syntax elements that bits of a raw data block are counted against
+enum AacBitstreamPart
+{
+  AAC_BITS_ELEMENT,       // Element IDs, instance tags, global gain and other flags
+  AAC_BITS_ICS_INFO,
+  AAC_BITS_MS_MASK,
+  AAC_BITS_SECTIONS,
+  AAC_BITS_SCALEFACTORS,  // Including intensity positions and noise energies
+  AAC_BITS_PULSE,
+  AAC_BITS_TNS,
+  AAC_BITS_SPECTRAL,
+  AAC_BITS_FILL,          // Fill elements
+  AAC_BITS_PCE,
+  AAC_BITS_ALIGNMENT,     // Padding at the end of the block
+
+  AAC_BITS_PART_COUNT
+};
+
+#define AAC_BITSTREAM_ELEMENT_COUNT         (AAC_ID_END + 1)
+#define AAC_BITSTREAM_CODEBOOK_COUNT        (AAC_HCB_INTENSITY + 1)
+#define AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT (AAC_WINSEQ_LONG_STOP + 1)
+#define AAC_BITSTREAM_WINDOW_SHAPE_COUNT    (AAC_WINSHAPE_KBD + 1)
+#define AAC_BITSTREAM_MS_MASK_COUNT         (AAC_MS_MASK_RESERVED + 1)
+
+// What a stream is made of, gathered by a decoder given it with
+//  setBitstreamStats() as it parses. Unlike AacDecoderStats this costs
+//  nothing to build in, just a branch per syntax element when not in use.
+struct AacBitstreamStats
+{
+  uint64_t blockCount;
+  uint64_t channelCount;  // Channels parsed, summed over blocks
+  uint64_t elementCounts[AAC_BITSTREAM_ELEMENT_COUNT];
+
+  uint64_t bits[AAC_BITS_PART_COUNT];
+
+  uint64_t codebookBands[AAC_BITSTREAM_CODEBOOK_COUNT];  // Scalefactor bands coded with each codebook, per window group
+  uint64_t codebookBits[AAC_BITSTREAM_CODEBOOK_COUNT];  // Spectral data bits coded with each
+  uint64_t escapeCount;  // Escape sequences in the spectral data
+
+  // For each channel, its window sequence and shape against the previous
+  //  block's. The first block of a stream has no transitions.
+  uint64_t windowSequenceTransitions[AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT][AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT];
+  uint64_t windowShapeTransitions[AAC_BITSTREAM_WINDOW_SHAPE_COUNT][AAC_BITSTREAM_WINDOW_SHAPE_COUNT];
+
+  uint64_t tnsChannels;
+  uint64_t pulseChannels;
+  uint64_t msMaskCounts[AAC_BITSTREAM_MS_MASK_COUNT];  // CPEs with a common window, by ms_mask_present
+
+  uint64_t longMaxSfbCounts[AAC_MAX_SFB_COUNT + 1];  // Channels with each max_sfb, by window length
+  uint64_t shortMaxSfbCounts[AAC_MAX_SFB_COUNT + 1];
+
+  // The previous block's windows by channel position, for the transitions.
+  //  Not merged by add().
+  unsigned int previousChannelCount;
+  uint8_t      previousWindowSequences[AAC_MAX_BLOCK_CHANNELS];
+  uint8_t      previousWindowShapes[AAC_MAX_BLOCK_CHANNELS];
+
+  AacBitstreamStats(void) : blockCount(0), channelCount(0), elementCounts(), bits(), codebookBands(), codebookBits(), escapeCount(0),
+    windowSequenceTransitions(), windowShapeTransitions(), tnsChannels(0), pulseChannels(0), msMaskCounts(), longMaxSfbCounts(), shortMaxSfbCounts(),
+    previousChannelCount(0), previousWindowSequences(), previousWindowShapes() {};
+
+  // Tallies the per-channel side info of a parsed block
+  void addBlock(const AacSpectralBlock *block);
+
+  void add(const AacBitstreamStats &other);
+
+  uint64_t getTotalBits(void) const;
+
+  static const char *getPartName(AacBitstreamPart part);
+};
+
+#endif
@@ -3,6 +3,8 @@
 #include <math.h>
 #include <assert.h>
 
+#include <algorithm>
+
 #include "AacStructs.h"
 #include "AacWindows.h"
 #include "AacAudioTools.h"
@@ -10,6 +12,9 @@
 
 #include "AacChannelDecoder.h"
 
+// For scratch channel decoders, as in windowBlock(), which trace nothing
+static const AacTracer noTracer;
+
 AacChannelDecoder::AacChannelDecoder(AacChannelOrdinal ordinal, AacSampleRateIndex sampleRateIndex)
 {
   m_ordinal = ordinal;
@@ -17,6 +22,9 @@ AacChannelDecoder::AacChannelDecoder(AacChannelOrdinal ordinal, AacSampleRateInd
 
   m_scalefactorBandInfo = AacConstants::getScalefactorBandInfo(m_sampleRateIndex);
 
+  m_stats = NULL;
+  m_tracer = &noTracer;
+
   reset();
 }
 
@@ -27,10 +35,13 @@ void AacChannelDecoder::reset(void)
   m_blockCount = 0;
 }
 
-bool AacChannelDecoder::applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info)
+void AacChannelDecoder::setTracer(const AacTracer *tracer)
 {
-  DEBUGF("TNS for long window...\n");
+  m_tracer = tracer ? tracer : &noTracer;
+}
 
+bool AacChannelDecoder::applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info) const
+{
   unsigned int w = 0;  // TODO
 
   // NOTE: We start counting the filter's bands from here, even if this
@@ -49,7 +60,7 @@ bool AacChannelDecoder::applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMP
     unsigned int sampleEnd   = m_scalefactorBandInfo->longWindow->offsets[std::min(tnsMaxBand, std::min(sfbEnd, info->ics->sfbCount))];
     unsigned int sampleCount = sampleEnd - sampleStart;
 
-    DEBUGF("  filter %d  order %d  isDownward %s  sfbStart %d  sfbEnd %d  tnsMaxBand %d  sampleStart %d  sampleEnd %d  sampleCount %d\n", f, filter.order, (filter.isDownward ? "true" : "false"), sfbStart, sfbEnd, tnsMaxBand, sampleStart, sampleEnd, sampleCount);
+    AAC_TRACE(*m_tracer, AAC_TRACE_TNS_APPLY, w, f, filter.order, filter.isDownward, sfbStart, sfbEnd, sampleStart, sampleEnd);
 
     if (sampleCount == 0)
       continue;  // No work to do
@@ -72,10 +83,8 @@ bool AacChannelDecoder::applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMP
   return true;
 }
 
-bool AacChannelDecoder::applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_SHORT], const AacDecodeInfo *info)
+bool AacChannelDecoder::applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_SHORT], const AacDecodeInfo *info) const
 {
-  DEBUGF("TNS for short window...\n");
-
   for (unsigned int w = 0; w < info->ics->windowCount; w++)
   {
     // NOTE: We start counting the filter's bands from here, even if this
@@ -94,7 +103,7 @@ bool AacChannelDecoder::applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAM
       unsigned int sampleEnd   = m_scalefactorBandInfo->shortWindow->offsets[std::min(tnsMaxBand, std::min(sfbEnd, info->ics->sfbCount))];
       unsigned int sampleCount = sampleEnd - sampleStart;
 
-      DEBUGF("  filter %d  order %d  isDownward %s  sfbStart %d  sfbEnd %d  tnsMaxBand %d  sampleStart %d  sampleEnd %d  sampleCount %d\n", f, filter.order, (filter.isDownward ? "true" : "false"), sfbStart, sfbEnd, tnsMaxBand, sampleStart, sampleEnd, sampleCount);
+      AAC_TRACE(*m_tracer, AAC_TRACE_TNS_APPLY, w, f, filter.order, filter.isDownward, sfbStart, sfbEnd, sampleStart, sampleEnd);
 
       if (sampleCount == 0)
         continue;  // No work to do
@@ -118,26 +127,32 @@ bool AacChannelDecoder::applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAM
   return true;
 }
 
-bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
+// Temporal noise shaping, applied to the spectral samples in place
+bool AacChannelDecoder::applyTns(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG]) const
 {
+  if (!info->tns.isEnabled)
+    return true;
+
+  if (info->ics->windowSequence != AAC_WINSEQ_8_SHORT)
+    return applyTnsLongWindow(spec, info);
+  else
+    return applyTnsShortWindow(spec, info);
+}
+
+// Everything up to the overlap with the previous block: TNS, IMDCT and
+//  windowing. This only reads decoder state, so it may be called from several
+//  threads at once.
+bool AacChannelDecoder::transform(const AacDecodeInfo *info, AacWindowShape previousWindowShape, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], double samples[AAC_XFORM_WIN_SIZE_LONG]) const
+{
+  AAC_STATS_START(start);
+
   // TNS
-  if (info->tns.isEnabled)
-  {
-    if (info->ics->windowSequence != AAC_WINSEQ_8_SHORT)
-    {
-      if (!applyTnsLongWindow(spec, info))
-        return false;
-    }
-    else
-    {
-      if (!applyTnsShortWindow(spec, info))
-        return false;
-    }
-  }
+  if (!applyTns(info, spec))
+    return false;
+
+  AAC_STATS_LAP(m_stats, AAC_STAGE_TNS, start);
 
   // IMDCT
-  DEBUGF("Frame %d samples\n", m_blockCount);
-  double samples[AAC_XFORM_WIN_SIZE_LONG];
   if (info->ics->windowSequence != AAC_WINSEQ_8_SHORT)
   {
     // One long window
@@ -150,15 +165,14 @@ bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDec
       AacImdctShort(spec + (w * AAC_SPECTRAL_SAMPLE_SIZE_SHORT), samples + (w * AAC_XFORM_WIN_SIZE_SHORT));
   }
 
-  // Windowing (§ 15.3.2)
-  if (m_blockCount == 0)
-    m_previousWindowShape = info->ics->windowShape;
+  AAC_STATS_LAP(m_stats, AAC_STAGE_IMDCT, start);
 
+  // Windowing (§ 15.3.2)
   if (info->ics->windowSequence != AAC_WINSEQ_8_SHORT)
   {
     // Long windows
 
-    const double *leftWindow = AacWindows::getLeftWindow(m_previousWindowShape, info->ics->windowSequence);
+    const double *leftWindow = AacWindows::getLeftWindow(previousWindowShape, info->ics->windowSequence);
     AacAudioTools::window(leftWindow, samples, AAC_XFORM_HALFWIN_SIZE_LONG);
 
     const double *rightWindow = AacWindows::getRightWindow(info->ics->windowShape, info->ics->windowSequence);
@@ -169,7 +183,7 @@ bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDec
   {
     // Short windows
 
-    const double *leftWindow = AacWindows::getLeftWindow(m_previousWindowShape, info->ics->windowSequence);
+    const double *leftWindow = AacWindows::getLeftWindow(previousWindowShape, info->ics->windowSequence);
     AacAudioTools::window(leftWindow, samples, AAC_XFORM_HALFWIN_SIZE_SHORT);
 
     const double *rightWindow = AacWindows::getRightWindow(info->ics->windowShape, info->ics->windowSequence);
@@ -222,15 +236,24 @@ bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDec
 
   }
 
+  AAC_STATS_LAP(m_stats, AAC_STAGE_WINDOW, start);
+
+  return true;
+}
+
+// Overlap-add with the previous block (§ 15.3.3) and conversion to int16.
+// This must be called once per block, in order.
+void AacChannelDecoder::overlap(const AacDecodeInfo *info, double samples[AAC_XFORM_WIN_SIZE_LONG], int16_t *audio, size_t audioStride)
+{
   // TODO: Some window shapes leave samples[] with large regions of zeroes.
   // We could maybe take advantage of this when summing samples.
 
+  AAC_STATS_START(start);
+
   // Overlapping with previous samples (§ 15.3.3)
   for (unsigned int s = 0; s < AAC_XFORM_HALFWIN_SIZE_LONG; s++)
   {
-    auto tmp = samples[s];
     samples[s] += m_oldSamples[s];
-    //DEBUGF("  overlap[%d]: transform %.3f  old %.3f  sum %.3f\n", s, tmp, m_oldSamples[s], samples[s]);
   }
 
   // Save second half of previous samples for next time
@@ -238,6 +261,8 @@ bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDec
   for (unsigned int s = 0; s < 1024; s++)  // TODO: Constant
     m_oldSamples[s] = samples[s + 1024];
 
+  AAC_STATS_LAP(m_stats, AAC_STAGE_WINDOW, start);
+
   // Convert to int16
   for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
   {
@@ -259,25 +284,205 @@ bool AacChannelDecoder::decodeAudioLongWindow(AacBitReader *reader, const AacDec
     audio += audioStride;
   }
 
+  AAC_STATS_LAP(m_stats, AAC_STAGE_OUTPUT, start);
 
   // Remember window shape for next block
   m_previousWindowShape = info->ics->windowShape;
 
   m_blockCount++;
+}
+
+AacWindowShape AacChannelDecoder::getPreviousWindowShape(const AacDecodeInfo *info)
+{
+  // The first block has nothing to blend with, so it uses its own shape
+  if (m_blockCount == 0)
+    return info->ics->windowShape;
+
+  return m_previousWindowShape;
+}
+
+bool AacChannelDecoder::decodeAudioLongWindow(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
+{
+  AacWindowShape previousWindowShape = getPreviousWindowShape(info);
+
+  AAC_TRACE(*m_tracer, AAC_TRACE_TRANSFORM_BLOCK, m_ordinal, info->ics->windowSequence, info->ics->windowShape, previousWindowShape, m_blockCount);
+
+  double samples[AAC_XFORM_WIN_SIZE_LONG];
+  if (!transform(info, previousWindowShape, spec, samples))
+    return false;
+
+  overlap(info, samples, audio, audioStride);
 
   return true;
 }
 
-bool AacChannelDecoder::decodeAudioShortWindow(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
+bool AacChannelDecoder::decodeAudioShortWindow(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
 {
   // TODO
-  return decodeAudioLongWindow(reader, info, spec, audio, audioStride);
+  return decodeAudioLongWindow(info, spec, audio, audioStride);
 }
 
-bool AacChannelDecoder::decodeAudio(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
+bool AacChannelDecoder::decodeAudio(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride)
 {
   if (info->ics->isLongWindow)
-    return decodeAudioLongWindow(reader, info, spec, audio, audioStride);
+    return decodeAudioLongWindow(info, spec, audio, audioStride);
+  else
+    return decodeAudioShortWindow(info, spec, audio, audioStride);
+}
+
+// IEEE 754 binary16, rounding to nearest even. Anything too large for a
+//  half is clamped to the largest finite value rather than becoming infinite.
+static uint16_t toFloat16(double value)
+{
+  float single = static_cast<float>(value);
+
+  uint32_t bits;
+  memcpy(&bits, &single, sizeof(bits));
+
+  uint16_t sign = (bits >> 16) & 0x8000;
+  int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+  uint32_t mantissa = bits & 0x7FFFFF;
+
+  if (isnan(single))
+    return sign | 0x7E00;
+
+  if (exponent >= 31)
+    return sign | 0x7BFF;
+
+  if (exponent <= 0)
+  {
+    // Subnormal, or too small even for that
+    if (exponent < -10)
+      return sign;
+
+    mantissa |= 0x800000;
+    unsigned int shift = 14 - exponent;
+
+    uint32_t half = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+
+    if ((remainder > halfway) || ((remainder == halfway) && (half & 1)))
+      half++;
+
+    return sign | half;
+  }
+
+  uint32_t half = (exponent << 10) | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1FFF;
+
+  // A carry out of the mantissa correctly moves to the next exponent
+  if ((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1)))
+    half++;
+
+  if (half > 0x7BFF)
+    half = 0x7BFF;
+
+  return sign | half;
+}
+
+static double fromFloat16(uint16_t half)
+{
+  unsigned int exponent = (half >> 10) & 0x1F;
+  unsigned int mantissa = half & 0x3FF;
+
+  double value;
+  if (exponent == 0)
+    value = ldexp(mantissa, -24);
+  else if (exponent == 31)
+    value = mantissa ? NAN : INFINITY;
   else
-    return decodeAudioShortWindow(reader, info, spec, audio, audioStride);
+    value = ldexp(mantissa | 0x400, exponent - 25);
+
+  return (half & 0x8000) ? -value : value;
+}
+
+size_t AacChannelDecoder::getStateSize(AacStatePrecision precision)
+{
+  size_t sampleSize = (precision == AAC_STATE_FLOAT64) ? sizeof(double) : (precision == AAC_STATE_FLOAT32) ? sizeof(float) : sizeof(uint16_t);
+
+  return sizeof(AacChannelState) + (sampleSize * AAC_AUDIO_SAMPLE_OUTPUT_COUNT);
+}
+
+void AacChannelDecoder::saveState(uint8_t *bytes, AacStatePrecision precision) const
+{
+  AacChannelState state = {};
+  state.blockCount = m_blockCount;
+  state.previousWindowShape = (m_blockCount == 0) ? AAC_WINSHAPE_SIN : m_previousWindowShape;
+
+  memcpy(bytes, &state, sizeof(state));
+  bytes += sizeof(state);
+
+  switch (precision)
+  {
+  case AAC_STATE_FLOAT64:
+    memcpy(bytes, m_oldSamples, sizeof(m_oldSamples));
+    break;
+  case AAC_STATE_FLOAT32:
+    for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+    {
+      float sample = static_cast<float>(m_oldSamples[s] / AAC_STATE_SAMPLE_SCALE);
+      memcpy(bytes + (s * sizeof(sample)), &sample, sizeof(sample));
+    }
+    break;
+  default:
+    // At the int16 scale, overlap louder than two full scales would pass the
+    //  largest half
+    for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+    {
+      double normalized = std::clamp(m_oldSamples[s] / AAC_STATE_SAMPLE_SCALE, -AAC_STATE_FLOAT16_LIMIT, AAC_STATE_FLOAT16_LIMIT);
+
+      uint16_t sample = toFloat16(normalized);
+      memcpy(bytes + (s * sizeof(sample)), &sample, sizeof(sample));
+    }
+    break;
+  }
+}
+
+bool AacChannelDecoder::restoreState(const uint8_t *bytes, AacStatePrecision precision)
+{
+  AacChannelState state;
+  memcpy(&state, bytes, sizeof(state));
+  bytes += sizeof(state);
+
+  if (state.previousWindowShape >= AAC_WINSHAPE_COUNT)
+    return false;
+
+  double samples[AAC_AUDIO_SAMPLE_OUTPUT_COUNT];
+
+  switch (precision)
+  {
+  case AAC_STATE_FLOAT64:
+    memcpy(samples, bytes, sizeof(samples));
+    break;
+  case AAC_STATE_FLOAT32:
+    for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+    {
+      float sample;
+      memcpy(&sample, bytes + (s * sizeof(sample)), sizeof(sample));
+      samples[s] = sample * AAC_STATE_SAMPLE_SCALE;
+    }
+    break;
+  default:
+    for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+    {
+      uint16_t sample;
+      memcpy(&sample, bytes + (s * sizeof(sample)), sizeof(sample));
+      samples[s] = fromFloat16(sample) * AAC_STATE_SAMPLE_SCALE;
+    }
+    break;
+  }
+
+  // Samples that no decode could produce would make the output undefined
+  for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+  {
+    if (!isfinite(samples[s]))
+      return false;
+  }
+
+  memcpy(m_oldSamples, samples, sizeof(m_oldSamples));
+  m_previousWindowShape = static_cast<AacWindowShape>(state.previousWindowShape);
+  m_blockCount = state.blockCount;
+
+  return true;
 }
@@ -1,16 +1,28 @@
+#include <stdint.h>
+#include <stdlib.h>
+
 #include "AacConstants.h"
+#include "AacDecoderStats.h"
+#include "AacTrace.h"
 
 #ifndef AAC_CHANNEL_DECODER_H
 #define AAC_CHANNEL_DECODER_H
 
+// A channel's history in a decoder checkpoint, followed by its overlap
+//  samples in the checkpoint's precision
+struct AacChannelState
+{
+  uint32_t blockCount;
+  uint8_t  previousWindowShape;
+  uint8_t  reserved[3];
+};
+
 enum AacChannelOrdinal
 {
   AAC_CHANNEL_FIRST,   // Solo channel or first (left) channel of a stereo pair
   AAC_CHANNEL_SECOND,  // Second (right) channel of a stereo pair
 };
 
-class AacBitReader;
-
 class AacChannelDecoder
 {
   AacChannelOrdinal m_ordinal;
@@ -28,18 +40,43 @@ class AacChannelDecoder
 
   unsigned int m_blockCount;
 
-  bool applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info);
-  bool applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info);
+  AacDecoderStats *m_stats;  // Where to add stage timings, if anywhere
+
+  const AacTracer *m_tracer;  // The owning decoder's, never NULL
+
+  bool applyTnsLongWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info) const;
+  bool applyTnsShortWindow(double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], const AacDecodeInfo *info) const;
 
-  bool decodeAudioLongWindow(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
-  bool decodeAudioShortWindow(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
+  bool decodeAudioLongWindow(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
+  bool decodeAudioShortWindow(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
 
 public:
   AacChannelDecoder(AacChannelOrdinal ordinal, AacSampleRateIndex sampleRateIndex);
 
   void reset(void);
 
-  bool decodeAudio(AacBitReader *reader, const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
+  void setStats(AacDecoderStats *stats) { m_stats = stats; };
+  void setTracer(const AacTracer *tracer);
+
+  bool decodeAudio(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], int16_t *audio, size_t audioStride);
+
+  // The two halves of decodeAudio(), for decoding blocks in parallel
+  bool transform(const AacDecodeInfo *info, AacWindowShape previousWindowShape, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], double samples[AAC_XFORM_WIN_SIZE_LONG]) const;
+  void overlap(const AacDecodeInfo *info, double samples[AAC_XFORM_WIN_SIZE_LONG], int16_t *audio, size_t audioStride);
+
+  // The first step of transform(), for callers doing their own IMDCT
+  bool applyTns(const AacDecodeInfo *info, double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG]) const;
+
+  AacWindowShape getPreviousWindowShape(const AacDecodeInfo *info);
+
+  AacSampleRateIndex getSampleRateIndex(void) { return m_sampleRateIndex; };
+
+  // Checkpointing of everything carried from one block to the next, in
+  //  getStateSize() bytes. restoreState() fails, changing nothing, on a
+  //  window shape that can't be valid.
+  static size_t getStateSize(AacStatePrecision precision);
+  void saveState(uint8_t *bytes, AacStatePrecision precision) const;
+  bool restoreState(const uint8_t *bytes, AacStatePrecision precision);
 };
 
 #endif
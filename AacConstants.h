@@ -3,12 +3,6 @@
 #ifndef AAC_CONSTANTS_H
 #define AAC_CONSTANTS_H
 
-#if defined(DEBUG)
-#  define DEBUGF(...) fprintf(stderr, __VA_ARGS__)
-#else
-#  define DEBUGF(...)
-#endif
-
 #define AAC_MAX_SFB_COUNT     51
 
 #define AAC_MAX_WINDOW_COUNT  8
@@ -113,6 +107,25 @@ enum AacMsMaskType
   AAC_MS_MASK_RESERVED = 0x3,  // Reserved value
 };
 
+// How overlap samples are stored in a decoder checkpoint. Only full
+//  precision resumes with output identical to an uninterrupted decode. The
+//  narrower ones store samples scaled so that full scale is 1.0, keeping 24
+//  (single) or 11 (half) significant bits of each, and only the first block
+//  after a restore differs. Single precision has been off by at most one
+//  sample. Half is off by up to 16 per full scale of overlap, and clamps
+//  overlap beyond AAC_STATE_FLOAT16_LIMIT full scales.
+enum AacStatePrecision
+{
+  AAC_STATE_FLOAT64 = 0x0,
+  AAC_STATE_FLOAT32 = 0x1,
+  AAC_STATE_FLOAT16 = 0x2,
+
+  AAC_STATE_PRECISION_COUNT = 3
+};
+
+#define AAC_STATE_SAMPLE_SCALE  32768.0  // Full scale, stored as 1.0 by the narrower precisions
+#define AAC_STATE_FLOAT16_LIMIT 65504.0  // The largest finite half, in full scales
+
 // Spectral samples per window
 constexpr unsigned int AAC_SPECTRAL_SAMPLE_SIZE_LONG  = 1024;
 constexpr unsigned int AAC_SPECTRAL_SAMPLE_SIZE_SHORT = 128;
@@ -3,6 +3,9 @@
 #include <string.h>
 #include <math.h>
 
+#include <algorithm>
+#include <utility>
+
 #include "AacBitReader.h"
 #include "AacScalefactorDecoder.h"
 #include "AacSpectrumDecoder.h"
@@ -12,6 +15,7 @@
 #include "AacAudioBlock.h"
 #include "AacStructs.h"
 #include "AacChannelDecoder.h"
+#include "AacAdtsFrame.h"
 
 #include "AacDecoder.h"
 
@@ -23,6 +27,11 @@
 //  can share the storage with the scalefactors.
 #define AAC_STEREO_POSITION_BIAS 128
 
+// Bits of each channel element covered by an ADTS CRC, counting from just
+//  after the element ID, and bits of the second channel of a CPE
+#define AAC_CRC_ELEMENT_BITS        192
+#define AAC_CRC_SECOND_CHANNEL_BITS 128
+
 AacDecoder::AacDecoder(unsigned int sampleRate)
 {
   m_sampleRate = sampleRate;
@@ -31,6 +40,190 @@ AacDecoder::AacDecoder(unsigned int sampleRate)
   m_scalefactorBandInfo = AacConstants::getScalefactorBandInfo(m_sampleRateIndex);
 
   m_blockCount = 0;
+
+  m_block = NULL;
+
+  m_isCrcChecked = false;
+  m_crcErrorCount = 0;
+
+  m_crcFrame              = NULL;
+  m_crcChannelCount       = 0;
+  m_crcCheckedRegionCount = 0;
+  m_isCrcMismatched       = false;
+
+  m_statsPosition = 0;
+
+  m_bitstreamStats = NULL;
+  m_bitStatsPosition = 0;
+}
+
+AacDecoder::~AacDecoder(void)
+{
+  for (auto &item : m_sceDecoders)
+    delete item.second;
+
+  for (auto &item : m_cpeDecoders)
+  {
+    delete item.second[0];
+    delete item.second[1];
+  }
+
+  delete m_block;
+}
+
+void AacDecoder::reset(void)
+{
+  for (auto &item : m_sceDecoders)
+    item.second->reset();
+
+  for (auto &item : m_cpeDecoders)
+  {
+    item.second[0]->reset();
+    item.second[1]->reset();
+  }
+
+  m_blockCount = 0;
+}
+
+AacDecoder &AacDecoder::operator=(AacDecoder &&other)
+{
+  // Swapping hands our old channel decoders to the other decoder to free
+  std::swap(m_sampleRate, other.m_sampleRate);
+  std::swap(m_sampleRateIndex, other.m_sampleRateIndex);
+  std::swap(m_scalefactorBandInfo, other.m_scalefactorBandInfo);
+  std::swap(m_blockCount, other.m_blockCount);
+  std::swap(m_previousWindowShape, other.m_previousWindowShape);
+  std::swap(m_sceDecoders, other.m_sceDecoders);
+  std::swap(m_cpeDecoders, other.m_cpeDecoders);
+  std::swap(m_block, other.m_block);
+  std::swap(m_crcErrorCount, other.m_crcErrorCount);
+
+  // m_isCrcChecked and the trace settings are settings rather than state, so
+  //  they stay put, as do the stats. The channel decoders have to be pointed
+  //  at the right ones.
+  for (auto decoder : {this, &other})
+  {
+    for (auto &item : decoder->m_sceDecoders)
+    {
+      item.second->setStats(decoder->getStatsTarget());
+      item.second->setTracer(&decoder->m_tracer);
+    }
+
+    for (auto &item : decoder->m_cpeDecoders)
+    {
+      for (auto channelDecoder : item.second)
+      {
+        channelDecoder->setStats(decoder->getStatsTarget());
+        channelDecoder->setTracer(&decoder->m_tracer);
+      }
+    }
+  }
+
+  return *this;
+}
+
+void AacDecoder::saveState(std::vector<uint8_t> *state, AacStatePrecision precision)
+{
+  size_t channelSize = sizeof(AacDecoderStateChannel) + AacChannelDecoder::getStateSize(precision);
+  size_t channelCount = m_sceDecoders.size() + (m_cpeDecoders.size() * 2);
+
+  state->resize(sizeof(AacDecoderStateHeader) + (channelCount * channelSize));
+  uint8_t *bytes = state->data();
+
+  AacDecoderStateHeader header = {};
+  header.magic        = AAC_DECODER_STATE_MAGIC;
+  header.version      = AAC_DECODER_STATE_VERSION;
+  header.precision    = precision;
+  header.channelCount = channelCount;
+  header.sampleRate   = m_sampleRate;
+  header.blockCount   = m_blockCount;
+
+  memcpy(bytes, &header, sizeof(header));
+  bytes += sizeof(header);
+
+  auto addChannel = [&](AacElementId elementId, uint8_t instance, AacChannelOrdinal ordinal, const AacChannelDecoder *decoder)
+  {
+    AacDecoderStateChannel channel = {};
+    channel.elementId = elementId;
+    channel.instance  = instance;
+    channel.ordinal   = ordinal;
+
+    memcpy(bytes, &channel, sizeof(channel));
+    decoder->saveState(bytes + sizeof(channel), precision);
+    bytes += channelSize;
+  };
+
+  for (auto &item : m_sceDecoders)
+    addChannel(AAC_ID_SCE, item.first, AAC_CHANNEL_FIRST, item.second);
+
+  for (auto &item : m_cpeDecoders)
+  {
+    addChannel(AAC_ID_CPE, item.first, AAC_CHANNEL_FIRST, item.second[0]);
+    addChannel(AAC_ID_CPE, item.first, AAC_CHANNEL_SECOND, item.second[1]);
+  }
+}
+
+bool AacDecoder::restoreState(const uint8_t *state, size_t size)
+{
+  reset();
+
+  AacDecoderStateHeader header;
+  if (size < sizeof(header))
+    return false;
+
+  memcpy(&header, state, sizeof(header));
+
+  if ((header.magic != AAC_DECODER_STATE_MAGIC) || (header.version != AAC_DECODER_STATE_VERSION))
+    return false;
+
+  if ((header.precision >= AAC_STATE_PRECISION_COUNT) || (header.sampleRate != m_sampleRate))
+    return false;
+
+  auto precision = static_cast<AacStatePrecision>(header.precision);
+
+  size_t channelSize = sizeof(AacDecoderStateChannel) + AacChannelDecoder::getStateSize(precision);
+  if (size != sizeof(header) + (header.channelCount * channelSize))
+    return false;
+
+  const uint8_t *bytes = state + sizeof(header);
+
+  for (unsigned int i = 0; i < header.channelCount; i++, bytes += channelSize)
+  {
+    AacDecoderStateChannel channel;
+    memcpy(&channel, bytes, sizeof(channel));
+
+    if (channel.instance >= AAC_ELEMENT_INSTANCE_MAX)
+      break;
+
+    AacChannelDecoder *decoder;
+    if ((channel.elementId == AAC_ID_SCE) && (channel.ordinal == AAC_CHANNEL_FIRST))
+    {
+      decoder = getSceChannelDecoder(channel.instance);
+    }
+    else if ((channel.elementId == AAC_ID_CPE) && (channel.ordinal <= AAC_CHANNEL_SECOND))
+    {
+      AacChannelDecoder *decoders[2];
+      getCpeChannelDecoders(channel.instance, decoders);
+      decoder = decoders[channel.ordinal];
+    }
+    else
+    {
+      break;
+    }
+
+    if (!decoder->restoreState(bytes + sizeof(channel), precision))
+      break;
+  }
+
+  if (bytes != state + size)
+  {
+    reset();
+    return false;
+  }
+
+  m_blockCount = header.blockCount;
+
+  return true;
 }
 
 // program_config_element
@@ -41,22 +234,28 @@ bool AacDecoder::readProgramConfigInfo(AacBitReader *reader, AacProgramConfigInf
   pce->sampleRateIndex = reader->readUInt(4);
 
   pce->frontChannelElementCount = reader->readUInt(4);
-  assert(pce->frontChannelElementCount <= AAC_PCE_MAX_FRONT_CHANNEL_ELEMENTS);
+  if (pce->frontChannelElementCount > AAC_PCE_MAX_FRONT_CHANNEL_ELEMENTS)
+    return false;
 
   pce->sideChannelElementCount = reader->readUInt(4);
-  assert(pce->sideChannelElementCount <= AAC_PCE_MAX_SIDE_CHANNEL_ELEMENTS);
+  if (pce->sideChannelElementCount > AAC_PCE_MAX_SIDE_CHANNEL_ELEMENTS)
+    return false;
 
   pce->rearChannelElementCount = reader->readUInt(4);
-  assert(pce->rearChannelElementCount <= AAC_PCE_MAX_REAR_CHANNEL_ELEMENTS);
+  if (pce->rearChannelElementCount > AAC_PCE_MAX_REAR_CHANNEL_ELEMENTS)
+    return false;
 
   pce->lfeChannelElementCount = reader->readUInt(2);
-  assert(pce->lfeChannelElementCount <= AAC_PCE_MAX_LFES);
+  if (pce->lfeChannelElementCount > AAC_PCE_MAX_LFES)
+    return false;
 
   pce->dseElementCount = reader->readUInt(3);
-  assert(pce->dseElementCount <= AAC_PCE_MAX_DSES);
+  if (pce->dseElementCount > AAC_PCE_MAX_DSES)
+    return false;
 
   pce->channelCouplingElementCount = reader->readUInt(4);
-  assert(pce->channelCouplingElementCount <= AAC_PCE_MAX_CCES);
+  if (pce->channelCouplingElementCount > AAC_PCE_MAX_CCES)
+    return false;
 
   pce->hasMonoMixdown = reader->readBit();
   if (pce->hasMonoMixdown)
@@ -108,11 +307,18 @@ bool AacDecoder::readProgramConfigInfo(AacBitReader *reader, AacProgramConfigInf
     pce->lfeChannelElements[i] = reader->readUInt(4);
 
   // Identifiers for each DSE instance
-  for (unsigned int i = 0; i < pce->lfeChannelElementCount; i++)
-    pce->lfeChannelElements[i] = reader->readUInt(4);
+  for (unsigned int i = 0; i < pce->dseElementCount; i++)
+    pce->dseElements[i] = reader->readUInt(4);
+
+  // Identifiers for each CCE instance
+  for (unsigned int i = 0; i < pce->channelCouplingElementCount; i++)
+  {
+    pce->channelCouplingElements[i].isIndependentlySiwtched = reader->readBit();
+    pce->channelCouplingElements[i].instance = reader->readUInt(4);
+  }
 
   // Comment field
-  reader->alignToBit(0);
+  reader->byteAlign();
   unsigned int commentLength = reader->readUInt(8);
   for (unsigned int i = 0; i < commentLength; i++)
     pce->comment += reader->readByte();
@@ -124,7 +330,8 @@ bool AacDecoder::readProgramConfigInfo(AacBitReader *reader, AacProgramConfigInf
 bool AacDecoder::decodeIcsInfo(AacBitReader *reader, AacIcsInfo *ics)
 {
   unsigned int reserved = reader->readBit();
-  assert(reserved == 0);  // Always zero?
+  if (reserved != 0)  // Always zero
+    return false;
 
   ics->windowSequence = static_cast<AacWindowSequence>(reader->readUInt(2));
   ics->windowShape    = static_cast<AacWindowShape>(reader->readBit());
@@ -138,7 +345,8 @@ bool AacDecoder::decodeIcsInfo(AacBitReader *reader, AacIcsInfo *ics)
     // Short windows
 
     ics->sfbCount         = reader->readUInt(4);
-    assert(ics->sfbCount <= m_scalefactorBandInfo->shortWindow->swbCount);
+    if (ics->sfbCount > m_scalefactorBandInfo->shortWindow->swbCount)
+      return false;
     ics->samplesPerWindow = m_scalefactorBandInfo->shortWindow->offsets[ics->sfbCount];
 
     unsigned int windowGroupBits  = reader->readUInt(7);
@@ -168,11 +376,13 @@ bool AacDecoder::decodeIcsInfo(AacBitReader *reader, AacIcsInfo *ics)
     // Long windows
 
     ics->sfbCount = reader->readUInt(6);
-    assert(ics->sfbCount <= m_scalefactorBandInfo->longWindow->swbCount);
+    if (ics->sfbCount > m_scalefactorBandInfo->longWindow->swbCount)
+      return false;
     ics->samplesPerWindow = m_scalefactorBandInfo->longWindow->offsets[ics->sfbCount];
 
     bool predictorDataPresent = reader->readBit();
-    assert(predictorDataPresent == false);  // Not allowed in LC (low-complexity)
+    if (predictorDataPresent)  // Not allowed in LC (low-complexity)
+      return false;
 
     ics->windowCount = 1;
     ics->isLongWindow = true;
@@ -289,14 +499,17 @@ bool AacDecoder::decodeSectionInfo(AacBitReader *reader, AacDecodeInfo *info)
     info->section.windowGroupSections[g].count = sec;
   }
 
-  DEBUGF("Window groups: %d groups\n", info->ics->windowGroupCount);
-  for (unsigned int g = 0; g < info->ics->windowGroupCount; g++)
+  if (m_tracer.isEnabled(AAC_TRACE_WINDOW_GROUP) || m_tracer.isEnabled(AAC_TRACE_SECTION)) [[unlikely]]
   {
-    DEBUGF("  windowGroups[%d]: winStart %d  winLength %d  sampleCount %d\n", g, info->ics->windowGroups[g].winStart, info->ics->windowGroups[g].winLength, info->section.windowGroups[g].sampleCount);
-    for (unsigned int sec = 0; sec < info->section.windowGroupSections[g].count; sec++)
+    for (unsigned int g = 0; g < info->ics->windowGroupCount; g++)
     {
-      auto section = info->section.windowGroupSections[g].sections[sec];
-      DEBUGF("    group %d  section %d  codebook 0x%X  sfbStart %d  sfbLength %d  sampleStart %d  sampleCount %d  winSampleStart %d  winSampleCount %d\n", g, sec, info->section.sfbCodebooks[g][section.sfbStart], section.sfbStart, section.sfbLength, section.sampleStart, section.sampleCount, section.winSampleStart, section.winSampleCount);
+      AAC_TRACE(m_tracer, AAC_TRACE_WINDOW_GROUP, g, info->ics->windowGroups[g].winStart, info->ics->windowGroups[g].winLength, info->section.windowGroups[g].sampleCount);
+
+      for (unsigned int sec = 0; sec < info->section.windowGroupSections[g].count; sec++)
+      {
+        auto section = info->section.windowGroupSections[g].sections[sec];
+        AAC_TRACE(m_tracer, AAC_TRACE_SECTION, g, sec, section.codebook, section.sfbStart, section.sfbLength, section.sampleStart, section.sampleCount);
+      }
     }
   }
 
@@ -318,7 +531,6 @@ bool AacDecoder::decodeScalefactorInfo(AacBitReader *reader, AacDecodeInfo *info
   auto sfd = AacScalefactorDecoder(reader);
 
   // For each group, read scalefactors for each scalefactor band
-  DEBUGF("Scalefactors:\n");
   for (unsigned int g = 0; g < info->ics->windowGroupCount; g++)
   {
     for (unsigned int sfb = 0; sfb < info->ics->sfbCount; sfb++)
@@ -341,7 +553,7 @@ bool AacDecoder::decodeScalefactorInfo(AacBitReader *reader, AacDecodeInfo *info
 
         sp += offset;
         info->sf.scalefactors[g][sfb] = sp + AAC_STEREO_POSITION_BIAS;
-        DEBUGF("  g %d  hcb 0x%X  sfb %2d  type IS  spOffset %2d  sp %d\n", g, hcb, sfb, offset, sp);
+        AAC_TRACE(m_tracer, AAC_TRACE_SCALEFACTOR, g, sfb, hcb, offset, sp);
         hasIntensityStereo = true;
       }
       else if (hcb == AAC_HCB_NOISE)
@@ -352,6 +564,7 @@ bool AacDecoder::decodeScalefactorInfo(AacBitReader *reader, AacDecodeInfo *info
         {
           ne = reader->readUInt(9);  // Noise start point
           hasNoise = true;
+          AAC_TRACE(m_tracer, AAC_TRACE_SCALEFACTOR, g, sfb, hcb, 0, ne);
         }
         else
         {
@@ -360,8 +573,8 @@ bool AacDecoder::decodeScalefactorInfo(AacBitReader *reader, AacDecodeInfo *info
 
           ne += offset;
           //info->sf.scalefactors[g][sfb] = ne;
+          AAC_TRACE(m_tracer, AAC_TRACE_SCALEFACTOR, g, sfb, hcb, offset, ne);
         }
-        DEBUGF("  g %d  hcb 0x%X  sfb %2d  type PNS  ne %d\n", g, hcb, sfb, ne);
       }
       else if (AAC_IS_UNKNOWN_CODEBOOK(hcb))
       {
@@ -383,7 +596,7 @@ bool AacDecoder::decodeScalefactorInfo(AacBitReader *reader, AacDecodeInfo *info
 
         sf += offset;
         info->sf.scalefactors[g][sfb] = sf;
-        DEBUGF("  g %d  hcb 0x%X  sfb %2d  type SF  sfOffset %2d  sf %d\n", g, hcb, sfb, offset, sf);
+        AAC_TRACE(m_tracer, AAC_TRACE_SCALEFACTOR, g, sfb, hcb, offset, sf);
       }
     }
   }
@@ -408,12 +621,11 @@ bool AacDecoder::decodePulseInfo(AacBitReader *reader, AacDecodeInfo *info)
   unsigned int pulseCount = reader->readUInt(2) + 1;
   info->pulse.pulseCount = pulseCount;
 
-  DEBUGF("pulseCount %d\n", pulseCount);
   for (unsigned int p = 0; p < pulseCount; p++)
   {
     uint8_t offset = reader->readUInt(5);
     uint8_t amplitude = reader->readUInt(4);
-    DEBUGF("pulse %d  offset %d  amplitude %d\n", p, offset, amplitude);
+    AAC_TRACE(m_tracer, AAC_TRACE_PULSE, p, offset, amplitude);
     info->pulse.pulses[p].offset = offset;
     info->pulse.pulses[p].amplitude = amplitude;
   }
@@ -484,8 +696,6 @@ bool AacDecoder::decodeTnsInfo(AacBitReader *reader, AacDecodeInfo *info)
         for (unsigned int o = 0; o < order; o++)
         {
           int8_t coefficient = reader->readUInt(readBits);
-          DEBUGF("TNS coefficient %d readbits %d\n", (int) coefficient, readBits);
-
           if (coefficient & (1 << (readBits - 1)))
             coefficient = (int8_t) (((uint8_t) coefficient) | ~((1U << readBits) - 1));  // Sign extend
 
@@ -495,17 +705,21 @@ bool AacDecoder::decodeTnsInfo(AacBitReader *reader, AacDecodeInfo *info)
     }
   }
 
-  DEBUGF("TNS enabled:\n");
-  for (unsigned int w = 0; w < info->ics->windowCount; w++)
+  if (m_tracer.isEnabled(AAC_TRACE_TNS_FILTER)) [[unlikely]]
   {
-    DEBUGF("  window %d: %d filters\n", w, info->tns.filterCount[w]);
-    for (unsigned int f = 0; f < info->tns.filterCount[w]; f++)
+    for (unsigned int w = 0; w < info->ics->windowCount; w++)
     {
-      auto filter = info->tns.filters[w][f];
-      DEBUGF("    sfbCount %2d  order %2d  downward %s  coefficients ", filter.sfbCount, filter.order, (filter.isDownward ? "true" : "false"));
-      for (unsigned int o = 0; o < filter.order; o++)
-        DEBUGF("%2d  ", filter.coefficients[o]);
-      DEBUGF("\n");
+      for (unsigned int f = 0; f < info->tns.filterCount[w]; f++)
+      {
+        auto filter = info->tns.filters[w][f];
+
+        // Four coefficients to each argument, first in the low byte
+        uint32_t packed[3] = {};
+        for (unsigned int o = 0; o < std::min<unsigned int>(filter.order, AAC_MAX_TNS_ORDER_LONG_LC); o++)
+          packed[o / 4] |= static_cast<uint8_t>(filter.coefficients[o]) << ((o % 4) * 8);
+
+        m_tracer.record(AAC_TRACE_TNS_FILTER, w, f, filter.sfbCount, filter.order, filter.isDownward, info->tns.coefficientBits[w], packed[0], packed[1], packed[2]);
+      }
     }
   }
 
@@ -517,48 +731,44 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
 {
   auto sd = AacSpectrumDecoder(reader);
 
-  DEBUGF("--- FRAME %d ---\n", m_blockCount);
+  AAC_STATS_START(statsStart);
 
-  DEBUGF("decodeSpectralData():  windowSequence %s  sfbCount %d\n", AacConstants::getWindowSequenceName(info->ics->windowSequence), info->ics->sfbCount);
+  size_t spectralBitStart = reader->getBitPosition();
 
   int16_t quant[AAC_SPECTRAL_SAMPLE_SIZE_LONG] = {};  // Quantized spectal values  // TODO: Don't pre-zero. We can zero as we go.
   for (unsigned int g = 0; g < info->ics->windowGroupCount; g++)  // Groups
   {
-    DEBUGF("- group %d has %d sections\n", g, info->section.windowGroupSections[g].count);
-
     for (unsigned int sec = 0; sec < info->section.windowGroupSections[g].count; sec++)  // Sections
     {
       // Sections are ranges of one or more scalefactor bands that use the same codebook
 
       auto codebook = info->section.sfbCodebooks[g][info->section.windowGroupSections[g].sections[sec].sfbStart];
       if ((codebook == AAC_HCB_ZERO) || (codebook > AAC_HCB_ESC))
-      {
-        DEBUGF("  group %d  section %d  codebook %2d -- Skipping due to codebook\n", g, sec, codebook);
         continue;
-      }
 
       unsigned int sectionSfbStart = info->section.windowGroupSections[g].sections[sec].sfbStart;
       unsigned int sectionSfbEnd   = sectionSfbStart + info->section.windowGroupSections[g].sections[sec].sfbLength;
-      assert(sectionSfbEnd <= info->ics->sfbCount);
+      if (sectionSfbEnd > info->ics->sfbCount)
+        return false;
 
       unsigned int sectionSampleStart = info->section.windowGroupSections[g].sections[sec].sampleStart;
       unsigned int sectionSampleEnd = sectionSampleStart + info->section.windowGroupSections[g].sections[sec].sampleCount;
 
-      // TODO: Move these asserts back to the section decoding
+      // TODO: Move these checks back to the section decoding
       if (info->ics->windowSequence != AAC_WINSEQ_8_SHORT)
       {
         // One long window
-        assert(sectionSfbStart <  m_scalefactorBandInfo->longWindow->swbCount);
-        assert(sectionSfbEnd   <= m_scalefactorBandInfo->longWindow->swbCount);
+        if ((sectionSfbStart >= m_scalefactorBandInfo->longWindow->swbCount) || (sectionSfbEnd > m_scalefactorBandInfo->longWindow->swbCount))
+          return false;
       }
       else
       {
         // Eight short windows
-        assert(sectionSfbStart <  m_scalefactorBandInfo->shortWindow->swbCount);
-        assert(sectionSfbEnd   <= m_scalefactorBandInfo->shortWindow->swbCount);
+        if ((sectionSfbStart >= m_scalefactorBandInfo->shortWindow->swbCount) || (sectionSfbEnd > m_scalefactorBandInfo->shortWindow->swbCount))
+          return false;
       }
 
-      DEBUGF("  group %d  section %d  codebook %2d  sectionSfbStart %2u  sectionSfbEnd %2u  sectionSampleStart %4u  sectionSampleEnd %4u\n", g, sec, codebook, sectionSfbStart, sectionSfbEnd, sectionSampleStart, sectionSampleEnd);
+      size_t sectionBitStart = reader->getBitPosition();
 
       if (codebook < AAC_HCB_FIRST_PAIR)
       {
@@ -569,7 +779,6 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
           int v[4];
           sd.decode4(codebook, v);
           unsigned int dstIndex = k;
-          //DEBUGF("    dstIndex %d  sample %d: w %d  x %d  y %d  z %d\n", dstIndex, k, v[0], v[1], v[2], v[3]);
           quant[dstIndex++] = v[0];
           quant[dstIndex++] = v[1];
           quant[dstIndex++] = v[2];
@@ -585,14 +794,45 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
           int v[2];
           sd.decode2(codebook, v);
           unsigned int dstIndex = k;
-          //DEBUGF("    dstIndex %d  sample %d: y %d z %d\n", dstIndex, k, v[0], v[1]);
           quant[dstIndex++] = v[0];
           quant[dstIndex++] = v[1];
         }
       }
+
+      AAC_TRACE(m_tracer, AAC_TRACE_SPECTRAL_SECTION, g, sec, codebook, sectionSfbStart, sectionSfbEnd, sectionSampleStart, sectionSampleEnd, reader->getBitPosition() - sectionBitStart);
+
+      if (m_bitstreamStats)
+      {
+        m_bitstreamStats->codebookBits[codebook] += reader->getBitPosition() - sectionBitStart;
+
+        // Only the escape codebook goes past 15, and only by an escape sequence
+        if (codebook == AAC_HCB_ESC)
+        {
+          for (unsigned int k = sectionSampleStart; k < sectionSampleEnd; k++)
+          {
+            if (abs(quant[k]) >= 16)
+              m_bitstreamStats->escapeCount++;
+          }
+        }
+      }
     }
   }
 
+  AAC_STATS_LAP(&m_stats, AAC_STAGE_HUFFMAN, statsStart);
+
+  if (m_tracer.isEnabled(AAC_TRACE_SPECTRAL_DATA)) [[unlikely]]
+  {
+    unsigned int nonZeroCount = 0;
+    int maxAbs = 0;
+    for (unsigned int i = 0; i < AAC_SPECTRAL_SAMPLE_SIZE_LONG; i++)
+    {
+      nonZeroCount += (quant[i] != 0);
+      maxAbs = std::max(maxAbs, abs(quant[i]));
+    }
+
+    m_tracer.record(AAC_TRACE_SPECTRAL_DATA, reader->getBitPosition() - spectralBitStart, nonZeroCount, maxAbs);
+  }
+
   // TODO: Max abs(value) of each element of quant is 8191. Should we be saturating them?
   for (unsigned int i = 0; i < 1024; i++)
   {
@@ -630,16 +870,10 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
 
           unsigned int dstIndex = (win * AAC_SPECTRAL_SAMPLE_SIZE_SHORT) + sfbSampleStart;
           for (unsigned int s = 0; s < sfbSampleCount; s++)
-          {
-            DEBUGF("Deinterlace: group %d  winCount %d  winOffset %d  win  %d  sfb %d: %d ← %d\n", g, winCount, winOffset, win, sfb, dstIndex, srcIndex);
             quant[dstIndex++] = interlaced[srcIndex++];
-          }
         }
       }
     }
-
-    //for (unsigned int i = 0; i < 1024; i++)
-    //  DEBUGF("  deinterlaced[%d]: %d\n", i, quant[i]);
   }
 
   // Dequantize
@@ -675,7 +909,6 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
 
       // TODO: Since the scalefactors are limited to 8 bits, we could have a LUT for the gain
       double gain = pow(2, 0.25 * (info->sf.scalefactors[g][sfb] - 100));
-      DEBUGF("  Rescale group %d  sfb %d  sfbSampleStart %d  sfbSampleCount %d  gain %f\n", g, sfb, sfbSampleStart, sfbSampleCount, gain);
 
       for (unsigned int winOffset = 0; winOffset < winCount; winOffset++)
       {
@@ -686,10 +919,7 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
 
         unsigned int sampleBase = winSampleStart + sfbSampleStart;
         for (unsigned int k = 0; k < sfbSampleCount; k++)
-        {
           x_rescal[sampleBase + k] = dequant[sampleBase + k] * gain;
-          //DEBUGF("    x_rescal[%d] = %f  group %d  sfb %d  dequant %f  gain %f\n", sampleBase + k, x_rescal[sampleBase + k], g, sfb, dequant[sampleBase + k], gain);
-        }
       }
     }
   }
@@ -697,6 +927,8 @@ bool AacDecoder::decodeSpectralData(AacBitReader *reader, AacDecodeInfo *info, d
   // TODO: Remove
   memcpy(spec, x_rescal, sizeof(double) * AAC_SPECTRAL_SAMPLE_SIZE_LONG);
 
+  AAC_STATS_LAP(&m_stats, AAC_STAGE_DEQUANTIZE, statsStart);
+
   return true;
 }
 
@@ -706,6 +938,8 @@ AacChannelDecoder *AacDecoder::getSceChannelDecoder(uint8_t instance)
     return found->second;
 
   auto cd = new AacChannelDecoder(AAC_CHANNEL_FIRST, m_sampleRateIndex);
+  cd->setStats(getStatsTarget());
+  cd->setTracer(&m_tracer);
 
   m_sceDecoders[instance] = cd;
 
@@ -723,6 +957,10 @@ void AacDecoder::getCpeChannelDecoders(uint8_t instance, AacChannelDecoder *deco
 
   auto left  = new AacChannelDecoder(AAC_CHANNEL_FIRST, m_sampleRateIndex);
   auto right = new AacChannelDecoder(AAC_CHANNEL_SECOND, m_sampleRateIndex);
+  left->setStats(getStatsTarget());
+  right->setStats(getStatsTarget());
+  left->setTracer(&m_tracer);
+  right->setTracer(&m_tracer);
 
   auto item = m_cpeDecoders[instance];
   item[0] = left;
@@ -793,7 +1031,6 @@ bool AacDecoder::applyMsJointStereo(const AacDecodeInfo *info, const AacMsMaskIn
 
 bool AacDecoder::applyIntensityJointStereo(const AacDecodeInfo *info, const AacMsMaskInfo *msMask, const double leftSpec[AAC_SPECTRAL_SAMPLE_SIZE_LONG], double rightSpec[AAC_SPECTRAL_SAMPLE_SIZE_LONG])
 {
-  DEBUGF("Intensity stereo:\n");
   for (unsigned int g = 0; g < info->ics->windowGroupCount; g++)
   {
     unsigned int winCount = info->ics->windowGroups[g].winLength;  // Count of windows within group
@@ -832,7 +1069,7 @@ bool AacDecoder::applyIntensityJointStereo(const AacDecodeInfo *info, const AacM
           sampleCount = m_scalefactorBandInfo->shortWindow->offsets[sfb + 1] - sampleStart;
         }
 
-        DEBUGF("  g %d  win %d  sfb %d  stereoPosition %d  scale %f\n", g, win, sfb, stereoPosition, scale);
+        AAC_TRACE(m_tracer, AAC_TRACE_INTENSITY, g, win, sfb, stereoPosition);
 
         // NOTE: The win variable should always be 0 for a long window, so this should be safe.
         sampleStart = (win * AAC_SPECTRAL_SAMPLE_SIZE_SHORT) + sampleStart;
@@ -846,14 +1083,32 @@ bool AacDecoder::applyIntensityJointStereo(const AacDecodeInfo *info, const AacM
   return true;
 }
 
-bool AacDecoder::decodeBlock(AacBitReader *reader, AacAudioBlock *audio)
+bool AacDecoder::parseBlock(AacBitReader *reader, AacSpectralBlock *block)
 {
   bool done = false;
 
+  block->sampleRate     = m_sampleRate;
+  block->channelCount   = 0;
+  block->crcRegionCount = 0;
+
+  m_bitStatsPosition = reader->getBitPosition();
+
+  m_tracer.setBlock(m_blockCount);
+
   while (!done && !reader->isComplete())
   {
     AacElementId id = static_cast<AacElementId>(reader->readUInt(3));
-    DEBUGF("Element ID: 0x%X\n", id);
+    AAC_TRACE(m_tracer, AAC_TRACE_ELEMENT, id, reader->getBitPosition() - 3);
+
+    if (m_bitstreamStats)
+      m_bitstreamStats->elementCounts[id]++;
+
+    countBits(reader, AAC_BITS_ELEMENT);
+
+#if defined(AAC_STATS)
+    unsigned int firstChannel = block->channelCount;
+#endif
+    AAC_STATS_TIMESTAMP(elementStart);
 
     switch (id)
     {
@@ -863,32 +1118,361 @@ bool AacDecoder::decodeBlock(AacBitReader *reader, AacAudioBlock *audio)
     case AAC_ID_FIL:  // Fill element
       if (!decodeElementFIL(reader))
         return false;
+      countBits(reader, AAC_BITS_FILL);
       break;
     case AAC_ID_SCE:  // Single channel element
-      if (!decodeElementSCE(reader, audio))
+      if (!decodeElementSCE(reader, block))
         return false;
       break;
     case AAC_ID_CPE:  // Channel pair element
-      if (!decodeElementCPE(reader, audio))
+      if (!decodeElementCPE(reader, block))
         return false;
       break;
     case AAC_ID_PCE:  // Program config element
       if (!decodeElementPCE(reader))
         return false;
+      countBits(reader, AAC_BITS_PCE);
       break;
     default:
-      DEBUGF("Unhandled element ID %X (%s - %s)\n", id, AacConstants::getElementNameShort(id), AacConstants::getElementNameLong(id));
-      abort();
+      AAC_TRACE(m_tracer, AAC_TRACE_UNKNOWN_ELEMENT, id);
+      return false;
     }
+
+#if defined(AAC_STATS)
+    if (block->channelCount > firstChannel)
+      block->channels[firstChannel].elementTicks = AacDecoderStats::now() - elementStart;
+#endif
   }
 
   m_blockCount++;
 
+#if defined(AAC_STATS)
+  m_stats.blockCount++;
+
+  for (unsigned int ch = 0; ch < block->channelCount; ch++)
+  {
+    const AacSpectralChannel *channel = &block->channels[ch];
+
+    m_stats.windowSequenceCounts[channel->ics.windowSequence]++;
+
+    for (unsigned int g = 0; g < channel->ics.windowGroupCount; g++)
+    {
+      for (unsigned int sfb = 0; sfb < channel->ics.sfbCount; sfb++)
+        m_stats.codebookCounts[channel->info.section.sfbCodebooks[g][sfb]]++;
+    }
+  }
+#endif
+
   reader->alignToBit(0);
 
+  if (m_bitstreamStats)
+  {
+    countBits(reader, AAC_BITS_ALIGNMENT);
+    m_bitstreamStats->addBlock(block);
+  }
+
+  return true;
+}
+
+void AacDecoder::countBits(AacBitReader *reader, AacBitstreamPart part)
+{
+  if (!m_bitstreamStats)
+    return;
+
+  size_t position = reader->getBitPosition();
+
+  m_bitstreamStats->bits[part] += position - m_bitStatsPosition;
+  m_bitStatsPosition = position;
+}
+
+bool AacDecoder::transformBlock(AacSpectralBlock *block, AacAudioBlock *audio)
+{
+  unsigned int ch = 0;
+
+  while (ch < block->channelCount)
+  {
+    AacSpectralChannel *channel = &block->channels[ch];
+
+    int16_t *buf;
+
+    AAC_STATS_TIMESTAMP(elementStart);
+
+    if (channel->elementId == AAC_ID_SCE)
+    {
+      auto channelDecoder = getSceChannelDecoder(channel->instance);
+
+      audio->prepare(block->sampleRate, AAC_MONO_CHANNEL_COUNT);
+      audio->getSampleBuffer(&buf);
+
+      // NOTE: The block may have been copied since it was parsed
+      channel->info.ics = &channel->ics;
+
+      if (!channelDecoder->decodeAudio(&channel->info, channel->spec, buf, AAC_MONO_CHANNEL_COUNT))
+        return false;
+
+      ch += AAC_MONO_CHANNEL_COUNT;
+    }
+    else
+    {
+      AacChannelDecoder *channelDecoders[AAC_STEREO_CHANNEL_COUNT];
+      getCpeChannelDecoders(channel->instance, channelDecoders);
+
+      audio->prepare(block->sampleRate, AAC_STEREO_CHANNEL_COUNT);
+      audio->getSampleBuffer(&buf);
+
+      for (unsigned int c = 0; c < AAC_STEREO_CHANNEL_COUNT; c++)
+      {
+        channel[c].info.ics = &channel[c].ics;
+
+        if (!channelDecoders[c]->decodeAudio(&channel[c].info, channel[c].spec, buf + c, AAC_STEREO_CHANNEL_COUNT))
+          return false;
+      }
+
+      ch += AAC_STEREO_CHANNEL_COUNT;
+    }
+
+    // Moving the start back counts the parsing time carried in the block
+    AAC_STATS_RECORD(m_stats.elementLatency[channel->elementId], elementStart - channel->elementTicks, m_statsPosition);
+  }
+
+  return true;
+}
+
+bool AacDecoder::windowBlock(AacSpectralBlock *block, AacWindowedBlock *windowed)
+{
+  // Only the tables for the sample rate are needed here, not any channel's
+  //  history, so one scratch decoder serves every channel.
+  AacChannelDecoder transformer(AAC_CHANNEL_FIRST, AacConstants::getIndexBySampleRate(block->sampleRate));
+
+  for (unsigned int ch = 0; ch < block->channelCount; ch++)
+  {
+    AacSpectralChannel *channel = &block->channels[ch];
+
+    channel->info.ics = &channel->ics;
+
+    if (!transformer.transform(&channel->info, windowed->previousWindowShapes[ch], channel->spec, windowed->samples[ch]))
+      return false;
+  }
+
+  return true;
+}
+
+bool AacDecoder::overlapBlock(AacSpectralBlock *block, AacWindowedBlock *windowed, AacAudioBlock *audio)
+{
+  unsigned int ch = 0;
+
+  while (ch < block->channelCount)
+  {
+    AacSpectralChannel *channel = &block->channels[ch];
+
+    int16_t *buf;
+
+    if (channel->elementId == AAC_ID_SCE)
+    {
+      auto channelDecoder = getSceChannelDecoder(channel->instance);
+
+      audio->prepare(block->sampleRate, AAC_MONO_CHANNEL_COUNT);
+      audio->getSampleBuffer(&buf);
+
+      channel->info.ics = &channel->ics;
+      channelDecoder->overlap(&channel->info, windowed->samples[ch], buf, AAC_MONO_CHANNEL_COUNT);
+
+      ch += AAC_MONO_CHANNEL_COUNT;
+    }
+    else
+    {
+      AacChannelDecoder *channelDecoders[AAC_STEREO_CHANNEL_COUNT];
+      getCpeChannelDecoders(channel->instance, channelDecoders);
+
+      audio->prepare(block->sampleRate, AAC_STEREO_CHANNEL_COUNT);
+      audio->getSampleBuffer(&buf);
+
+      for (unsigned int c = 0; c < AAC_STEREO_CHANNEL_COUNT; c++)
+      {
+        channel[c].info.ics = &channel[c].ics;
+        channelDecoders[c]->overlap(&channel[c].info, windowed->samples[ch + c], buf + c, AAC_STEREO_CHANNEL_COUNT);
+      }
+
+      ch += AAC_STEREO_CHANNEL_COUNT;
+    }
+  }
+
+  return true;
+}
+
+void AacDecoder::getWindowShapes(AacSpectralBlock *block, AacWindowedBlock *windowed)
+{
+  unsigned int ch = 0;
+
+  while (ch < block->channelCount)
+  {
+    AacSpectralChannel *channel = &block->channels[ch];
+
+    if (channel->elementId == AAC_ID_SCE)
+    {
+      channel->info.ics = &channel->ics;
+      windowed->previousWindowShapes[ch] = getSceChannelDecoder(channel->instance)->getPreviousWindowShape(&channel->info);
+
+      ch += AAC_MONO_CHANNEL_COUNT;
+    }
+    else
+    {
+      AacChannelDecoder *channelDecoders[AAC_STEREO_CHANNEL_COUNT];
+      getCpeChannelDecoders(channel->instance, channelDecoders);
+
+      for (unsigned int c = 0; c < AAC_STEREO_CHANNEL_COUNT; c++)
+      {
+        channel[c].info.ics = &channel[c].ics;
+        windowed->previousWindowShapes[ch + c] = channelDecoders[c]->getPreviousWindowShape(&channel[c].info);
+      }
+
+      ch += AAC_STEREO_CHANNEL_COUNT;
+    }
+  }
+}
+
+// A spectral block is too big to build on the stack for every block
+AacSpectralBlock *AacDecoder::getScratchBlock(void)
+{
+  if (!m_block)
+    m_block = new AacSpectralBlock;
+
+  return m_block;
+}
+
+bool AacDecoder::decodeBlock(AacBitReader *reader, AacAudioBlock *audio)
+{
+  AAC_STATS_TIMESTAMP(blockStart);
+
+  AacSpectralBlock *block = getScratchBlock();
+
+  if (!parseBlock(reader, block))
+  {
+    AAC_TRACE(m_tracer, AAC_TRACE_PARSE_FAILED, reader->getBitPosition());
+    return false;
+  }
+
+  if (!transformBlock(block, audio))
+    return false;
+
+  AAC_STATS_RECORD(m_stats.blockLatency, blockStart, m_statsPosition);
+  return true;
+}
+
+bool AacDecoder::parseFrame(AacAdtsFrame *frame, AacSpectralBlock *block)
+{
+  if (m_tracer.isEnabled(AAC_TRACE_FRAME)) [[unlikely]]
+  {
+    auto header = frame->getHeader();
+    auto channelConfig = header->getChannelConfiguration();
+
+    m_tracer.setBlock(m_blockCount);
+    m_tracer.record(AAC_TRACE_FRAME, header->hasCrcProtection(), header->getProfile(), header->getSampleRate(), channelConfig->fullChannelCount + channelConfig->subwooferChannelCount, header->getFrameSize(), header->getDataBlockCount());
+  }
+
+  m_crcCheckedRegionCount = 0;
+  m_isCrcMismatched       = false;
+
+  if (m_isCrcChecked && frame->getHeader()->hasCrcProtection())
+  {
+    auto channelConfig = frame->getHeader()->getChannelConfiguration();
+
+    m_crcFrame        = frame;
+    m_crcChannelCount = channelConfig->fullChannelCount + channelConfig->subwooferChannelCount;
+  }
+
+  bool isParsed = parseBlock(frame->getReader(), block);
+
+  m_crcFrame = NULL;
+
+  if (!isParsed)
+  {
+    if (m_isCrcMismatched)
+    {
+      AAC_TRACE(m_tracer, AAC_TRACE_CRC_MISMATCH);
+    }
+    else
+    {
+      AAC_TRACE(m_tracer, AAC_TRACE_PARSE_FAILED, frame->getReader()->getBitPosition());
+    }
+
+    // The regions can't be found in a frame that won't parse, but if it has a
+    //  CRC then damage is the likely cause, so it counts as a mismatch
+    if (m_isCrcChecked && frame->getHeader()->hasCrcProtection())
+      m_crcErrorCount++;
+
+    return false;
+  }
+
+  // Unless an element followed the one checked early, every region is covered
+  bool isCheckedEarly = (m_crcCheckedRegionCount != 0) && (m_crcCheckedRegionCount == block->crcRegionCount);
+
+  if (m_isCrcChecked && !isCheckedEarly && !frame->checkCrc(block))
+  {
+    AAC_TRACE(m_tracer, AAC_TRACE_CRC_MISMATCH);
+    m_crcErrorCount++;
+    return false;
+  }
+
+  return true;
+}
+
+bool AacDecoder::decodeFrame(AacAdtsFrame *frame, AacAudioBlock *audio)
+{
+  AAC_STATS_TIMESTAMP(blockStart);
+
+  AacSpectralBlock *block = getScratchBlock();
+
+  if (!parseFrame(frame, block) || !transformBlock(block, audio))
+    return false;
+
+  AAC_STATS_RECORD(m_stats.blockLatency, blockStart, m_statsPosition);
   return true;
 }
 
+void AacDecoder::addCrcRegion(AacSpectralBlock *block, size_t start, size_t end, unsigned int protectedBits)
+{
+  AacCrcRegion *region = &block->crcRegions[block->crcRegionCount++];
+
+  region->start         = start;
+  region->bitCount      = std::min<size_t>(end - start, protectedBits);
+  region->protectedBits = protectedBits;
+}
+
+// Checks the CRC of the frame being parsed ahead of the spectral data of the
+//  last channel its header names, given the regions of the element that
+//  carries that channel. Those only stay open if the element could end within
+//  its protected bits, and then the check is left until the frame is parsed.
+//  Returns false on a mismatch.
+bool AacDecoder::checkCrcEarly(AacBitReader *reader, AacSpectralBlock *block, unsigned int elementChannelCount, const size_t starts[], const unsigned int protectedBits[], unsigned int regionCount)
+{
+  if (!m_crcFrame || (block->channelCount + elementChannelCount != m_crcChannelCount))
+    return true;
+
+  size_t position = reader->getBitPosition();
+
+  for (unsigned int i = 0; i < regionCount; i++)
+  {
+    if (position - starts[i] < protectedBits[i])
+      return true;
+  }
+
+  unsigned int elementRegionStart = block->crcRegionCount;
+
+  for (unsigned int i = 0; i < regionCount; i++)
+    addCrcRegion(block, starts[i], position, protectedBits[i]);
+
+  bool isMatched = m_crcFrame->checkCrc(block);
+
+  // The element adds the same regions again once it is parsed
+  block->crcRegionCount = elementRegionStart;
+
+  m_crcCheckedRegionCount = elementRegionStart + regionCount;
+  m_isCrcMismatched       = !isMatched;
+
+  return isMatched;
+}
+
 // Program config element
 bool AacDecoder::decodeElementPCE(AacBitReader *reader)
 {
@@ -897,14 +1481,7 @@ bool AacDecoder::decodeElementPCE(AacBitReader *reader)
   if (!readProgramConfigInfo(reader, &pce))
     return false;
 
-  DEBUGF("--- PCE ---\n");
-  DEBUGF("instance       : %d\n", pce.instance);
-  DEBUGF("profile        : %d\n", pce.profile);
-  DEBUGF("sampleRateIndex: %d\n", pce.sampleRateIndex);
-  DEBUGF("front channels : %d\n", pce.frontChannelElementCount);
-  DEBUGF("side channels  : %d\n", pce.sideChannelElementCount);
-  DEBUGF("rear channels  : %d\n", pce.rearChannelElementCount);
-  DEBUGF("comment        : %s\n", pce.comment.c_str());
+  AAC_TRACE(m_tracer, AAC_TRACE_PCE, pce.instance, pce.profile, pce.sampleRateIndex, pce.frontChannelElementCount, pce.sideChannelElementCount, pce.rearChannelElementCount);
 
   return true;
 }
@@ -920,135 +1497,200 @@ bool AacDecoder::decodeElementFIL(AacBitReader *reader)
     count += extra - 1;
   }
 
-  DEBUGF("FIL count %d\n", count);
+  AAC_TRACE(m_tracer, AAC_TRACE_FILL, count);
   reader->skipBytes(count);
 
   return true;
 }
 
 // Single channel element
-bool AacDecoder::decodeElementSCE(AacBitReader *reader, AacAudioBlock *audio)
+bool AacDecoder::decodeElementSCE(AacBitReader *reader, AacSpectralBlock *block)
 {
-  AacIcsInfo ics;
+  if (block->channelCount + AAC_MONO_CHANNEL_COUNT > AAC_MAX_BLOCK_CHANNELS)
+    return false;  // Too many channels in this block
+
+  AacSpectralChannel *channel = &block->channels[block->channelCount];
+
+  AacDecodeInfo &info = channel->info;
+  info.ics     = &channel->ics;
+
+  size_t start = reader->getBitPosition();
 
-  AacDecodeInfo info;
-  info.ics     = &ics;
+  AAC_STATS_START(statsStart);
 
   info.identifier = reader->readUInt(4);
-  auto channelDecoder = getSceChannelDecoder(info.identifier);
+
+  channel->elementId      = AAC_ID_SCE;
+  channel->instance       = info.identifier;
+  channel->elementChannel = 0;
 
   info.globalGain = reader->readUInt(8);
+  countBits(reader, AAC_BITS_ELEMENT);
 
-  if (!decodeIcsInfo(reader, &ics))
+  if (!decodeIcsInfo(reader, &channel->ics))
     return false;
+  countBits(reader, AAC_BITS_ICS_INFO);
+
+  AAC_STATS_LAP(&m_stats, AAC_STAGE_SIDE_INFO, statsStart);
 
   if (!decodeSectionInfo(reader, &info))
     return false;
+  countBits(reader, AAC_BITS_SECTIONS);
 
   if (!decodeScalefactorInfo(reader, &info))
     return false;
+  countBits(reader, AAC_BITS_SCALEFACTORS);
+
+  AAC_STATS_LAP(&m_stats, AAC_STAGE_SCALEFACTORS, statsStart);
 
   if (!decodePulseInfo(reader, &info))
     return false;
+  countBits(reader, AAC_BITS_PULSE);
 
   if (!decodeTnsInfo(reader, &info))
     return false;
+  countBits(reader, AAC_BITS_TNS);
 
   bool hasGainControl = reader->readBit();
   if (hasGainControl)
     return false;  // Not allowed in LC profile
+  countBits(reader, AAC_BITS_ELEMENT);
 
-  DEBUGF("-- SCE --\n");
-  dumpInfo(&info);
+  AAC_STATS_LAP(&m_stats, AAC_STAGE_SIDE_INFO, statsStart);
 
-  int16_t *buf;
-  audio->prepare(m_sampleRate, AAC_MONO_CHANNEL_COUNT);
-  audio->getSampleBuffer(&buf);
+  AAC_TRACE(m_tracer, AAC_TRACE_CHANNEL, AAC_ID_SCE, info.identifier, 0, info.globalGain, channel->ics.windowSequence, channel->ics.windowShape, channel->ics.sfbCount, channel->ics.windowGroupCount, info.pulse.pulseCount, info.tns.isEnabled);
 
-  double spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG];  // Spectal samples
-  if (!decodeSpectralData(reader, &info, spec))
+  const size_t       crcStarts[] = {start};
+  const unsigned int crcBits[]   = {AAC_CRC_ELEMENT_BITS};
+  if (!checkCrcEarly(reader, block, AAC_MONO_CHANNEL_COUNT, crcStarts, crcBits, 1))
     return false;
 
-  if (!channelDecoder->decodeAudio(reader, &info, spec, buf, AAC_MONO_CHANNEL_COUNT))
+  if (!decodeSpectralData(reader, &info, channel->spec))
     return false;
+  countBits(reader, AAC_BITS_SPECTRAL);
+
+  addCrcRegion(block, start, reader->getBitPosition(), AAC_CRC_ELEMENT_BITS);
+
+  block->channelCount += AAC_MONO_CHANNEL_COUNT;
 
   return true;
 }
 
 // Channel pair element
-bool AacDecoder::decodeElementCPE(AacBitReader *reader, AacAudioBlock *audio)
+bool AacDecoder::decodeElementCPE(AacBitReader *reader, AacSpectralBlock *block)
 {
-  AacChannelDecoder *channelDecoders[AAC_STEREO_CHANNEL_COUNT];
+  if (block->channelCount + AAC_STEREO_CHANNEL_COUNT > AAC_MAX_BLOCK_CHANNELS)
+    return false;  // Too many channels in this block
 
-  AacIcsInfo ics[AAC_STEREO_CHANNEL_COUNT];
+  AacSpectralChannel *channels = &block->channels[block->channelCount];
 
-  AacDecodeInfo info[AAC_STEREO_CHANNEL_COUNT];
+  AacDecodeInfo *info[AAC_STEREO_CHANNEL_COUNT] = {&channels[0].info, &channels[1].info};
 
   AacMsMaskInfo msMaskInfo;
 
+  size_t start = reader->getBitPosition();
+  size_t secondStart = 0;
+
+  AAC_STATS_START(statsStart);
+
   unsigned int identifier = reader->readUInt(4);
-  getCpeChannelDecoders(identifier, channelDecoders);
 
   bool commonWindow = reader->readBit();
+  countBits(reader, AAC_BITS_ELEMENT);
+
+  msMaskInfo.type = AAC_MS_MASK_ZERO;
 
   if (commonWindow)
   {
-    if (!decodeIcsInfo(reader, &ics[0]))
+    if (!decodeIcsInfo(reader, &channels[0].ics))
       return false;
+    countBits(reader, AAC_BITS_ICS_INFO);
 
-    if (!decodeMsMaskInfo(reader, &ics[0], &msMaskInfo))
+    if (!decodeMsMaskInfo(reader, &channels[0].ics, &msMaskInfo))
       return false;
-  }
+    countBits(reader, AAC_BITS_MS_MASK);
 
-  double spec[AAC_STEREO_CHANNEL_COUNT][AAC_SPECTRAL_SAMPLE_SIZE_LONG];  // Spectal samples
+    if (m_bitstreamStats)
+      m_bitstreamStats->msMaskCounts[msMaskInfo.type]++;
+
+    // Each channel keeps its own copy so that it can be transformed alone
+    channels[1].ics = channels[0].ics;
+  }
 
-  int16_t *buf;
-  audio->prepare(m_sampleRate, AAC_STEREO_CHANNEL_COUNT);
-  audio->getSampleBuffer(&buf);
+  AAC_TRACE(m_tracer, AAC_TRACE_COMMON_WINDOW, identifier, commonWindow, msMaskInfo.type);
 
   // Read per-channel settings
   for (unsigned int ch = 0; ch < AAC_STEREO_CHANNEL_COUNT; ch++)
   {
-    info[ch].identifier = identifier;
-    info[ch].globalGain = reader->readUInt(8);
+    channels[ch].elementId      = AAC_ID_CPE;
+    channels[ch].instance       = identifier;
+    channels[ch].elementChannel = ch;
 
-    if (commonWindow)
-      info[ch].ics = &ics[0];
-    else
+    if (ch == 1)
+      secondStart = reader->getBitPosition();
+
+    info[ch]->identifier = identifier;
+    info[ch]->globalGain = reader->readUInt(8);
+    countBits(reader, AAC_BITS_ELEMENT);
+
+    info[ch]->ics = &channels[ch].ics;
+    if (!commonWindow)
     {
-      if (!decodeIcsInfo(reader, &ics[ch]))
+      if (!decodeIcsInfo(reader, &channels[ch].ics))
         return false;
-
-      info[ch].ics = &ics[ch];
+      countBits(reader, AAC_BITS_ICS_INFO);
     }
 
-    if (!decodeSectionInfo(reader, &info[ch]))
+    AAC_STATS_LAP(&m_stats, AAC_STAGE_SIDE_INFO, statsStart);
+
+    if (!decodeSectionInfo(reader, info[ch]))
       return false;
+    countBits(reader, AAC_BITS_SECTIONS);
 
-    if (!decodeScalefactorInfo(reader, &info[ch]))
+    if (!decodeScalefactorInfo(reader, info[ch]))
       return false;
+    countBits(reader, AAC_BITS_SCALEFACTORS);
+
+    AAC_STATS_LAP(&m_stats, AAC_STAGE_SCALEFACTORS, statsStart);
 
-    if (!decodePulseInfo(reader, &info[ch]))
+    if (!decodePulseInfo(reader, info[ch]))
       return false;
+    countBits(reader, AAC_BITS_PULSE);
 
-    if (!decodeTnsInfo(reader, &info[ch]))
+    if (!decodeTnsInfo(reader, info[ch]))
       return false;
+    countBits(reader, AAC_BITS_TNS);
 
     bool hasGainControl = reader->readBit();
     if (hasGainControl)
       return false;  // Not allowed in LC profile
+    countBits(reader, AAC_BITS_ELEMENT);
+
+    AAC_STATS_LAP(&m_stats, AAC_STAGE_SIDE_INFO, statsStart);
+
+    AAC_TRACE(m_tracer, AAC_TRACE_CHANNEL, AAC_ID_CPE, identifier, ch, info[ch]->globalGain, channels[ch].ics.windowSequence, channels[ch].ics.windowShape, channels[ch].ics.sfbCount, channels[ch].ics.windowGroupCount, info[ch]->pulse.pulseCount, info[ch]->tns.isEnabled);
+
+    if (ch == 1)
+    {
+      const size_t       crcStarts[] = {start, secondStart};
+      const unsigned int crcBits[]   = {AAC_CRC_ELEMENT_BITS, AAC_CRC_SECOND_CHANNEL_BITS};
+      if (!checkCrcEarly(reader, block, AAC_STEREO_CHANNEL_COUNT, crcStarts, crcBits, 2))
+        return false;
+    }
 
-    if (!decodeSpectralData(reader, &info[ch], spec[ch]))
+    if (!decodeSpectralData(reader, info[ch], channels[ch].spec))
       return false;
-  }
+    countBits(reader, AAC_BITS_SPECTRAL);
 
-  DEBUGF("commonWindow      : %s\n", commonWindow ? "true" : "false");
+    // The spectral data times itself
+    AAC_STATS_RESTART(statsStart);
+  }
 
-  DEBUGF("-- CPE left --\n");
-  dumpInfo(&info[0]);
+  size_t end = reader->getBitPosition();
+  addCrcRegion(block, start, end, AAC_CRC_ELEMENT_BITS);
+  addCrcRegion(block, secondStart, end, AAC_CRC_SECOND_CHANNEL_BITS);
 
-  DEBUGF("-- CPE right --\n");
-  dumpInfo(&info[1]);
+  AAC_STATS_RESTART(statsStart);
 
   // Joint stereo
   if (commonWindow)
@@ -1056,35 +1698,18 @@ bool AacDecoder::decodeElementCPE(AacBitReader *reader, AacAudioBlock *audio)
     // M/S (main/side) joint stereo
     if (msMaskInfo.type != AAC_MS_MASK_ZERO)
     {
-      if (!applyMsJointStereo(&info[1], &msMaskInfo, spec[0], spec[1]))
+      if (!applyMsJointStereo(info[1], &msMaskInfo, channels[0].spec, channels[1].spec))
         return false;
     }
 
     // Intensity stereo
-    if (!applyIntensityJointStereo(&info[1], &msMaskInfo, spec[0], spec[1]))
+    if (!applyIntensityJointStereo(info[1], &msMaskInfo, channels[0].spec, channels[1].spec))
       return false;
-  }
 
-  // Decode audio
-  for (unsigned int ch = 0; ch < AAC_STEREO_CHANNEL_COUNT; ch++)
-  {
-    if (!channelDecoders[ch]->decodeAudio(reader, &info[ch], spec[ch], buf + ch, AAC_STEREO_CHANNEL_COUNT))
-      return false;
+    AAC_STATS_LAP(&m_stats, AAC_STAGE_STEREO, statsStart);
   }
 
-  return true;
-}
+  block->channelCount += AAC_STEREO_CHANNEL_COUNT;
 
-void AacDecoder::dumpInfo(AacDecodeInfo *info)
-{
-  printf("--- Block info ---\n");
-  printf("identifier        : %d\n", info->identifier);
-  printf("global gain       : %d\n", info->globalGain);
-  printf("window seq        : %d (%s)\n", info->ics->windowSequence, AacConstants::getWindowSequenceName(info->ics->windowSequence));
-  printf("window shape      : %d (%s)\n", info->ics->windowShape, AacConstants::getWindowShapeName(info->ics->windowShape));
-  printf("scalefactor bands : %d\n", info->ics->sfbCount);
-  printf("samples per window: %d\n", info->ics->samplesPerWindow);
-  printf("window count      : %d\n", info->ics->windowCount);
-  printf("pulse count       : %d\n", info->pulse.pulseCount);
-  printf("TNS enabled       : %s\n", info->tns.isEnabled ? "true" : "false");
+  return true;
 }
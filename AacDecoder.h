@@ -1,12 +1,47 @@
 #include <stdint.h>
 
 #include <unordered_map>
+#include <vector>
 
+#include "AacBitstreamStats.h"
 #include "AacConstants.h"
+#include "AacDecoderStats.h"
+#include "AacTrace.h"
 
 #ifndef AAC_DECODER_H
 #define AAC_DECODER_H
 
+#define AAC_DECODER_STATE_MAGIC   0x54534441  // "ADST" when stored little-endian
+#define AAC_DECODER_STATE_VERSION 2
+
+// A decoder checkpoint, as made by saveState(). As with the index sidecar,
+//  fields are in the writer's byte order, and a reader with the other order
+//  sees a bad magic number.
+//
+//   header
+//   for each channel decoder:
+//     AacDecoderStateChannel
+//     AacChannelState
+//     overlap samples[AAC_AUDIO_SAMPLE_OUTPUT_COUNT], in the given precision
+struct AacDecoderStateHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint8_t  precision;  // AacStatePrecision
+  uint8_t  channelCount;
+  uint32_t sampleRate;
+  uint32_t blockCount;
+};
+
+struct AacDecoderStateChannel
+{
+  uint8_t elementId;  // AAC_ID_SCE or AAC_ID_CPE
+  uint8_t instance;
+  uint8_t ordinal;  // AacChannelOrdinal
+  uint8_t reserved;
+};
+
+class AacAdtsFrame;
 class AacBitReader;
 class AacAudioBlock;
 class AacChannelDecoder;
@@ -17,6 +52,8 @@ struct AacMsMaskInfo;
 struct AacSectionInfo;
 struct AacTnsFilter;
 struct AacDecodeInfo;
+struct AacSpectralBlock;
+struct AacWindowedBlock;
 
 class AacDecoder
 {
@@ -29,11 +66,33 @@ class AacDecoder
 
   AacWindowShape m_previousWindowShape;
 
+  AacSpectralBlock *m_block;  // Scratch for decodeBlock() and decodeFrame(), made on first use
+
+  bool           m_isCrcChecked;
+  unsigned int   m_crcErrorCount;
+
+  // While parseFrame() parses a frame whose CRC is to be checked
+  const AacAdtsFrame *m_crcFrame;
+  unsigned int        m_crcChannelCount;  // Channels its header says it carries
+  unsigned int        m_crcCheckedRegionCount;  // Regions checked ahead of the last spectral data, or 0
+  bool                m_isCrcMismatched;  // Whether that early check failed
+
+  // Only built in with AAC_STATS, as its latency histograms are tens of KB
+  //  that every decoder, and every copy of one, would otherwise carry
+#if defined(AAC_STATS)
+  AacDecoderStats m_stats;
+#endif
+  uint64_t        m_statsPosition;  // Tag for latency samples
+
+  AacTracer m_tracer;
+
+  AacBitstreamStats *m_bitstreamStats;  // NULL unless gathering
+  size_t             m_bitStatsPosition;  // Where the bits not yet counted start
+
   // Channel decoders
   std::unordered_map<uint8_t, AacChannelDecoder *>    m_sceDecoders;
   std::unordered_map<uint8_t, AacChannelDecoder *[2]> m_cpeDecoders;
 
-  bool readProgramConfigInfo(AacBitReader *reader, AacProgramConfigInfo *programConfigInfo);
   bool decodeIcsInfo(AacBitReader *reader, AacIcsInfo *info);
   bool decodeMsMaskInfo(AacBitReader *reader, const AacIcsInfo *ics, AacMsMaskInfo *msMask);
   bool decodeSectionInfo(AacBitReader *reader, AacDecodeInfo *info);
@@ -51,18 +110,100 @@ class AacDecoder
 
   bool decodeElementPCE(AacBitReader *reader);
   bool decodeElementFIL(AacBitReader *reader);
-  bool decodeElementSCE(AacBitReader *reader, AacAudioBlock *audio);
-  bool decodeElementCPE(AacBitReader *reader, AacAudioBlock *audio);
+  bool decodeElementSCE(AacBitReader *reader, AacSpectralBlock *block);
+  bool decodeElementCPE(AacBitReader *reader, AacSpectralBlock *block);
+
+  static void addCrcRegion(AacSpectralBlock *block, size_t start, size_t end, unsigned int protectedBits);
+  bool        checkCrcEarly(AacBitReader *reader, AacSpectralBlock *block, unsigned int elementChannelCount, const size_t starts[], const unsigned int protectedBits[], unsigned int regionCount);
 
-  void dumpInfo(AacDecodeInfo *info);
+  // Counts the bits read since the last call against a part of the stream
+  void countBits(AacBitReader *reader, AacBitstreamPart part);
+
+  AacSpectralBlock *getScratchBlock(void);
+
+  // Where the channel decoders add their stage timings, if anywhere
+#if defined(AAC_STATS)
+  AacDecoderStats *getStatsTarget(void) { return &m_stats; };
+#else
+  AacDecoderStats *getStatsTarget(void) { return NULL; };
+#endif
 
 public:
   AacDecoder(unsigned int sampleRate);
-  // TODO: Destructor
+  ~AacDecoder(void);
+
+  // The decoder owns its channel decoders, so it can be moved but not copied
+  AacDecoder(const AacDecoder &) = delete;
+  AacDecoder &operator=(const AacDecoder &) = delete;
+  AacDecoder &operator=(AacDecoder &&other);
+
+  // Forgets all history, as if newly constructed, but keeps allocations
+  void reset(void);
 
   bool decodeBlock(AacBitReader *reader, AacAudioBlock *audio);
 
+  // The two halves of decodeBlock(). Parsing only depends on the bitstream,
+  //  while transforming carries the overlap state from block to block, so
+  //  the two can be run by separate decoder instances.
+  bool parseBlock(AacBitReader *reader, AacSpectralBlock *block);
+  bool transformBlock(AacSpectralBlock *block, AacAudioBlock *audio);
+
+  // As decodeBlock() and parseBlock(), for the raw data block of an ADTS
+  //  frame. With CRC checking on, a frame carrying a CRC that doesn't match
+  //  fails before any of the transform work, and where its header names the
+  //  channels it carries, before the spectral data of the last of them.
+  bool decodeFrame(AacAdtsFrame *frame, AacAudioBlock *audio);
+  bool parseFrame(AacAdtsFrame *frame, AacSpectralBlock *block);
+
+  void setCrcCheck(bool isCrcChecked) { m_isCrcChecked = isCrcChecked; };
+
+  // Frames that have failed the CRC check, to tell them from other failures
+  unsigned int getCrcErrorCount(void) { return m_crcErrorCount; };
+
+  // Stage timings and stream statistics, or NULL unless built with AAC_STATS.
+  //  Unlike the decoding state, they carry over when another decoder is moved
+  //  into this one at a sample rate change, so they cover the whole stream.
+  const AacDecoderStats *getStats(void) { return getStatsTarget(); };
+
+  // Where the next frame or block to be decoded starts in its file or stream.
+  //  Latency samples and trace records are tagged with it, so the maximum
+  //  can be traced back.
+  void setStatsPosition(uint64_t position) { m_statsPosition = position; m_tracer.setPosition(position); };
+
+  // Records trace events at the level given and below, in the categories
+  //  given as a mask of 1 << AacTraceCategory, or stops with AAC_TRACE_OFF.
+  //  Like CRC checking, this is a setting, so it stays with this decoder
+  //  when another is moved into it.
+  void setTrace(AacTraceLevel level, unsigned int categories = AAC_TRACE_ALL_CATEGORIES) { m_tracer.enable(level, categories); };
+
+  // Gathers bit allocation, codebook, window and coding tool statistics from
+  //  each block parsed from now on, or stops if stats is NULL. The stats stay
+  //  with this decoder when another is moved into it.
+  void setBitstreamStats(AacBitstreamStats *stats) { m_bitstreamStats = stats; };
+
+  // transformBlock() split once more for frame-parallel decoding.
+  //  windowBlock() keeps no state, so any number of blocks can be windowed
+  //  at once, given each channel's previous window shape. overlapBlock()
+  //  must then be called on each block in stream order.
+  static bool windowBlock(AacSpectralBlock *block, AacWindowedBlock *windowed);
+  bool overlapBlock(AacSpectralBlock *block, AacWindowedBlock *windowed, AacAudioBlock *audio);
+
+  // Fills in windowed->previousWindowShapes from this decoder's history, for
+  //  windowing the next block of the stream.
+  void getWindowShapes(AacSpectralBlock *block, AacWindowedBlock *windowed);
+
   unsigned int getSampleRate(void) { return m_sampleRate; };
+
+  // Checkpointing of the history carried from block to block, so a stream
+  //  can resume in another decoder, or another process, without re-decoding
+  //  a frame to prime the overlap. The state is replaced, not appended to.
+  //  Restoring fails on a damaged checkpoint or one from a decoder at another
+  //  sample rate, and then leaves the decoder reset.
+  void saveState(std::vector<uint8_t> *state, AacStatePrecision precision = AAC_STATE_FLOAT64);
+  bool restoreState(const uint8_t *state, size_t size);
+
+  // Also used for the PCE of an AudioSpecificConfig
+  static bool readProgramConfigInfo(AacBitReader *reader, AacProgramConfigInfo *programConfigInfo);
 };
 
 #endif
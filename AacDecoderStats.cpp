@@ -0,0 +1,100 @@
+#include <time.h>
+
+#include <iterator>
+
+#include "AacDecoderStats.h"
+
+static const char *stageNames[] =
+{
+  "side info",
+  "scalefactors",
+  "huffman",
+  "dequantize",
+  "stereo",
+  "TNS",
+  "IMDCT",
+  "window/overlap",
+  "output",
+};
+
+static_assert(std::size(stageNames) == AAC_STAGE_COUNT);
+
+void AacDecoderStats::add(const AacDecoderStats &other)
+{
+  for (unsigned int i = 0; i < AAC_STAGE_COUNT; i++)
+  {
+    ticks[i] += other.ticks[i];
+
+    for (unsigned int j = 0; j < AAC_PERF_EVENT_COUNT; j++)
+      events[i][j] += other.events[i][j];
+  }
+
+  blockCount += other.blockCount;
+
+  for (unsigned int i = 0; i < AAC_STATS_WINDOW_SEQUENCE_COUNT; i++)
+    windowSequenceCounts[i] += other.windowSequenceCounts[i];
+
+  for (unsigned int i = 0; i < AAC_STATS_CODEBOOK_COUNT; i++)
+    codebookCounts[i] += other.codebookCounts[i];
+
+  blockLatency.add(other.blockLatency);
+
+  for (unsigned int i = 0; i < AAC_STATS_ELEMENT_COUNT; i++)
+    elementLatency[i].add(other.elementLatency[i]);
+}
+
+uint64_t AacDecoderStats::getTotalTicks(void) const
+{
+  uint64_t total = 0;
+  for (unsigned int i = 0; i < AAC_STAGE_COUNT; i++)
+    total += ticks[i];
+
+  return total;
+}
+
+const char *AacDecoderStats::getTickUnit(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Counts TSC cycles across 20 ms of the monotonic clock
+static double measureTicksPerSecond(void)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  uint64_t startTicks = AacDecoderStats::now();
+
+  struct timespec delay = {0, 20000000};
+  nanosleep(&delay, NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  uint64_t endTicks = AacDecoderStats::now();
+
+  double seconds = (end.tv_sec - start.tv_sec) + ((end.tv_nsec - start.tv_nsec) / 1e9);
+
+  return (endTicks - startTicks) / seconds;
+}
+#endif
+
+double AacDecoderStats::getTicksPerSecond(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  static const double ticksPerSecond = measureTicksPerSecond();
+  return ticksPerSecond;
+#else
+  return 1e9;
+#endif
+}
+
+const char *AacDecoderStats::getStageName(AacDecoderStage stage)
+{
+  if (stage >= AAC_STAGE_COUNT)
+    return NULL;  // Out of range
+
+  return stageNames[stage];
+}
@@ -0,0 +1,92 @@
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+#include "AacConstants.h"
+#include "AacLatencyHistogram.h"
+#include "AacPerfCounters.h"
+
+#ifndef AAC_DECODER_STATS_H
+#define AAC_DECODER_STATS_H
+
+// Per-stage timing costs a clock read at every stage boundary, so it's only
+//  built in when AAC_STATS is defined (make STATS=1). Without it the macros
+//  below compile to nothing and the stats stay at zero. Stage boundaries also
+//  read the performance counters, if started on this thread.
+#if defined(AAC_STATS)
+#  define AAC_STATS_START(start)              uint64_t start = (AacPerfCounters::mark(), AacDecoderStats::now())
+#  define AAC_STATS_LAP(stats, stage, start)  do { uint64_t lapEnd = AacDecoderStats::now(); if (stats) { (stats)->ticks[stage] += lapEnd - (start); AacPerfCounters::lap((stats)->events[stage]); } else AacPerfCounters::mark(); (start) = lapEnd; } while (0)
+#  define AAC_STATS_RESTART(start)            ((start) = (AacPerfCounters::mark(), AacDecoderStats::now()))
+#  define AAC_STATS_TIMESTAMP(start)          uint64_t start = AacDecoderStats::now()
+#  define AAC_STATS_RECORD(histogram, start, tag)  ((histogram).record(AacDecoderStats::now() - (start), tag))
+#else
+#  define AAC_STATS_START(start)
+#  define AAC_STATS_LAP(stats, stage, start)
+#  define AAC_STATS_RESTART(start)
+#  define AAC_STATS_TIMESTAMP(start)
+#  define AAC_STATS_RECORD(histogram, start, tag)
+#endif
+
+enum AacDecoderStage
+{
+  AAC_STAGE_SIDE_INFO,     // ics_info, M/S mask, pulse and TNS data
+  AAC_STAGE_SCALEFACTORS,  // Section data and scalefactors
+  AAC_STAGE_HUFFMAN,       // Spectral data
+  AAC_STAGE_DEQUANTIZE,    // Inverse quantization, deinterleaving and rescaling
+  AAC_STAGE_STEREO,        // M/S and intensity stereo
+  AAC_STAGE_TNS,
+  AAC_STAGE_IMDCT,
+  AAC_STAGE_WINDOW,        // Windowing and overlap-add
+  AAC_STAGE_OUTPUT,        // Conversion to int16
+
+  AAC_STAGE_COUNT
+};
+
+#define AAC_STATS_WINDOW_SEQUENCE_COUNT (AAC_WINSEQ_LONG_STOP + 1)
+#define AAC_STATS_CODEBOOK_COUNT        (AAC_HCB_INTENSITY + 1)
+#define AAC_STATS_ELEMENT_COUNT         (AAC_ID_CPE + 1)
+
+// Where a decoder's time goes, and what kind of stream it's spending it on.
+//  Ticks are TSC cycles on x86 and nanoseconds elsewhere. Only the serial
+//  decodeBlock() path is timed; frame-parallel windowing isn't.
+struct AacDecoderStats
+{
+  uint64_t ticks[AAC_STAGE_COUNT];
+  uint64_t events[AAC_STAGE_COUNT][AAC_PERF_EVENT_COUNT];  // Performance counter totals, if counting
+
+  uint64_t blockCount;  // Raw data blocks parsed
+  uint64_t windowSequenceCounts[AAC_STATS_WINDOW_SEQUENCE_COUNT];  // Channels parsed with each sequence
+  uint64_t codebookCounts[AAC_STATS_CODEBOOK_COUNT];  // Scalefactor bands coded with each codebook, per window group
+
+  // Ticks to decode each block, from parsing to output, and each SCE or CPE
+  //  within it. Samples are tagged with the position given to the decoder's
+  //  setStatsPosition(), so the slowest frame can be found again.
+  AacLatencyHistogram blockLatency;
+  AacLatencyHistogram elementLatency[AAC_STATS_ELEMENT_COUNT];
+
+  AacDecoderStats(void) : ticks(), events(), blockCount(0), windowSequenceCounts(), codebookCounts() {};
+
+  void add(const AacDecoderStats &other);
+
+  uint64_t getTotalTicks(void) const;
+
+  static inline uint64_t now(void)
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000) + ts.tv_nsec;
+#endif
+  };
+
+  static const char *getTickUnit(void);
+  static double      getTicksPerSecond(void);  // Measured once on first use where ticks are cycles
+  static const char *getStageName(AacDecoderStage stage);
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+#include "AacThreadPool.h"
+
+#include "AacFrameParallelDecoder.h"
+
+// Frames per batch for each pool thread, when not specified
+#define AAC_FRAME_PARALLEL_FRAMES_PER_THREAD 8
+
+AacFrameParallelDecoder::AacFrameParallelDecoder(AacAdtsFrameReader *reader, AacThreadPool *pool, unsigned int batchSize)
+{
+  m_reader = reader;
+  m_pool = pool;
+
+  if (batchSize == 0)
+    batchSize = pool->getThreadCount() * AAC_FRAME_PARALLEL_FRAMES_PER_THREAD;
+
+  m_batchSize = batchSize;
+
+  for (auto &batch : m_batches)
+  {
+    batch.frames = new AacParallelFrame[m_batchSize];
+    batch.count = 0;
+  }
+
+  m_parser = NULL;
+  m_decoder = NULL;
+
+  m_position = 0;
+  m_skippedSize = 0;
+  m_parsedSkippedSize = 0;
+
+  // Start the first batch, and mark it as already consumed so that the
+  //  first decodeBlock() moves onto it and starts the second.
+  m_current = 1;
+  m_index = 0;
+  fillBatch(&m_batches[0]);
+}
+
+AacFrameParallelDecoder::~AacFrameParallelDecoder(void)
+{
+  // The pool may still be windowing frames we own
+  for (auto &batch : m_batches)
+  {
+    drainBatch(&batch);
+    delete [] batch.frames;
+  }
+
+  delete m_parser;
+  delete m_decoder;
+}
+
+// Parses up to a batch of frames, then queues their windowing on the pool
+void AacFrameParallelDecoder::fillBatch(Batch *batch)
+{
+  batch->count = 0;
+
+  while ((batch->count < m_batchSize) && !m_reader->isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!m_reader->readFrame(&frame))
+    {
+      m_parsedSkippedSize += m_reader->findNextFrame();
+      continue;
+    }
+
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+    if (!m_parser || (m_parser->getSampleRate() != sampleRate))
+    {
+      // A serial decode starts over at a sample rate change, so we do too
+      delete m_parser;
+      m_parser = new AacDecoder(sampleRate);
+      m_windowShapes.clear();
+    }
+
+    AacParallelFrame *f = &batch->frames[batch->count++];
+
+    f->position    = m_reader->getPosition();
+    f->skippedSize = m_parsedSkippedSize;
+    f->isValid     = m_parser->parseBlock(frame.getReader(), &f->block);
+    f->isWindowed.store(false, std::memory_order_relaxed);
+
+    m_reader->advance(frame.getSize());
+
+    if (!f->isValid)
+      continue;
+
+    // Work out the left-hand window shape each channel will need. This is
+    //  the only thing the windowing takes from earlier blocks.
+    for (unsigned int ch = 0; ch < f->block.channelCount; ch++)
+    {
+      const AacSpectralChannel *channel = &f->block.channels[ch];
+
+      unsigned int key = (channel->elementId << 8) | (channel->instance << 1) | channel->elementChannel;
+
+      auto found = m_windowShapes.find(key);
+      f->windowed.previousWindowShapes[ch] = (found != m_windowShapes.end()) ? found->second : channel->ics.windowShape;
+
+      m_windowShapes[key] = channel->ics.windowShape;
+    }
+  }
+
+  for (unsigned int i = 0; i < batch->count; i++)
+  {
+    AacParallelFrame *f = &batch->frames[i];
+
+    if (!f->isValid)
+    {
+      f->isWindowed.store(true, std::memory_order_release);
+      continue;
+    }
+
+    m_pool->submit([f] (unsigned int)
+    {
+      if (!AacDecoder::windowBlock(&f->block, &f->windowed))
+        f->isValid = false;
+
+      f->isWindowed.store(true, std::memory_order_release);
+      f->isWindowed.notify_one();
+    });
+  }
+}
+
+// Waits for the pool to finish with every frame in a batch
+void AacFrameParallelDecoder::drainBatch(Batch *batch)
+{
+  for (unsigned int i = 0; i < batch->count; i++)
+    batch->frames[i].isWindowed.wait(false, std::memory_order_acquire);
+}
+
+bool AacFrameParallelDecoder::isComplete(void)
+{
+  if (m_index < m_batches[m_current].count)
+    return false;
+
+  if (m_batches[m_current ^ 1].count)
+    return false;
+
+  // Every batch has been parsed, so this covers the whole stream
+  m_skippedSize = m_parsedSkippedSize;
+  return true;
+}
+
+bool AacFrameParallelDecoder::decodeBlock(AacAudioBlock *audio)
+{
+  if (m_index >= m_batches[m_current].count)
+  {
+    // Move on to the batch that is already being windowed, and parse the
+    //  one after it while we wait.
+    m_current ^= 1;
+    m_index = 0;
+
+    if (m_batches[m_current].count == 0)
+      return false;  // End of stream
+
+    fillBatch(&m_batches[m_current ^ 1]);
+  }
+
+  AacParallelFrame *f = &m_batches[m_current].frames[m_index++];
+
+  f->isWindowed.wait(false, std::memory_order_acquire);
+
+  m_position = f->position;
+  m_skippedSize = f->skippedSize;
+
+  if (!f->isValid)
+    return false;
+
+  if (!m_decoder || (m_decoder->getSampleRate() != f->block.sampleRate))
+  {
+    delete m_decoder;
+    m_decoder = new AacDecoder(f->block.sampleRate);
+  }
+
+  return m_decoder->overlapBlock(&f->block, &f->windowed, audio);
+}
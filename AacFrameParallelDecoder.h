@@ -0,0 +1,80 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <unordered_map>
+
+#include "AacStructs.h"
+
+#ifndef AAC_FRAME_PARALLEL_DECODER_H
+#define AAC_FRAME_PARALLEL_DECODER_H
+
+class AacAdtsFrameReader;
+class AacAudioBlock;
+class AacDecoder;
+class AacThreadPool;
+
+struct AacParallelFrame
+{
+  bool              isValid;  // False if the block failed to parse or window
+  size_t            position;  // Offset of the frame within the input
+  size_t            skippedSize;  // Bytes passed over looking for frame headers, up to this frame
+  AacSpectralBlock  block;
+  AacWindowedBlock  windowed;
+  std::atomic<bool> isWindowed;
+};
+
+// Decodes a single stream using a thread pool. Frames are parsed serially in
+//  batches, the IMDCT and windowing of every frame in a batch is handed to
+//  the pool, and the overlap-add and int16 conversion are done in order by
+//  the caller as each frame becomes ready. The next batch is parsed while
+//  the pool works on the current one.
+class AacFrameParallelDecoder
+{
+  struct Batch
+  {
+    AacParallelFrame *frames;
+    unsigned int      count;
+  };
+
+  AacAdtsFrameReader *m_reader;
+  AacThreadPool      *m_pool;
+
+  unsigned int        m_batchSize;
+  Batch               m_batches[2];
+  unsigned int        m_current;  // Batch being consumed
+  unsigned int        m_index;  // Next frame to consume within it
+
+  AacDecoder         *m_parser;
+  AacDecoder         *m_decoder;  // Overlap stage
+
+  // Window shape each channel ended its last parsed block with, keyed by
+  //  element type, instance and channel within the element.
+  std::unordered_map<unsigned int, AacWindowShape> m_windowShapes;
+
+  size_t              m_position;
+  size_t              m_skippedSize;
+  size_t              m_parsedSkippedSize;  // Up to the end of the last batch parsed
+
+  void fillBatch(Batch *batch);
+  void drainBatch(Batch *batch);
+
+public:
+  AacFrameParallelDecoder(AacAdtsFrameReader *reader, AacThreadPool *pool, unsigned int batchSize = 0);  // Zero picks a size based on the pool
+  ~AacFrameParallelDecoder(void);
+
+  AacFrameParallelDecoder(const AacFrameParallelDecoder &) = delete;
+  AacFrameParallelDecoder &operator=(const AacFrameParallelDecoder &) = delete;
+
+  bool   isComplete(void);
+
+  bool   decodeBlock(AacAudioBlock *audio);
+
+  size_t getPosition(void) { return m_position; };  // Offset of the most recently decoded frame
+
+  // Bytes passed over looking for frame headers, up to the most recently
+  //  decoded frame, or once isComplete(), in the whole stream
+  size_t getSkippedSize(void) { return m_skippedSize; };
+};
+
+#endif
@@ -0,0 +1,276 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <array>
+
+#include "AacConstants.h"
+#include "AacBitWriter.h"
+
+#include "AacHuffmanEncoder.h"
+
+#define AAC_SPECTRUM_ESC_VALUE     16
+#define AAC_SPECTRUM_MAX_ESC_VALUE 8191
+#define AAC_SCALEFACTOR_MAX_OFFSET 60
+
+// The decoders' table layouts, as generated by format-huffman-table.pl
+struct AacScalefactorHuffman
+{
+  unsigned int count;  // Number of entries
+  unsigned int maxBits;  // Bit length of longest codeword
+  struct { unsigned int len; unsigned int codeword; int8_t index; } entries[];
+};
+
+struct AacSpectrumHuffman2
+{
+  unsigned int count;  // Number of entries
+  unsigned int maxBits;  // Bit length of longest codeword
+  struct { unsigned int len; unsigned int codeword; int8_t v0; int8_t v1; } entries[];
+};
+
+struct AacSpectrumHuffman4
+{
+  unsigned int count;  // Number of entries
+  unsigned int maxBits;  // Bit length of longest codeword
+  struct { unsigned int len; unsigned int codeword; int8_t v0; int8_t v1; int8_t v2; int8_t v3; } entries[];
+};
+
+static const AacScalefactorHuffman scalefactorTable =
+#include "tables/huffman-table-scalefactor.c"
+
+static const AacSpectrumHuffman4 codebook1 =
+#include "tables/huffman-table-spectrum-1.c"
+
+static const AacSpectrumHuffman4 codebook2 =
+#include "tables/huffman-table-spectrum-2.c"
+
+static const AacSpectrumHuffman4 codebook3 =
+#include "tables/huffman-table-spectrum-3.c"
+
+static const AacSpectrumHuffman4 codebook4 =
+#include "tables/huffman-table-spectrum-4.c"
+
+static const AacSpectrumHuffman2 codebook5 =
+#include "tables/huffman-table-spectrum-5.c"
+
+static const AacSpectrumHuffman2 codebook6 =
+#include "tables/huffman-table-spectrum-6.c"
+
+static const AacSpectrumHuffman2 codebook7 =
+#include "tables/huffman-table-spectrum-7.c"
+
+static const AacSpectrumHuffman2 codebook8 =
+#include "tables/huffman-table-spectrum-8.c"
+
+static const AacSpectrumHuffman2 codebook9 =
+#include "tables/huffman-table-spectrum-9.c"
+
+static const AacSpectrumHuffman2 codebook10 =
+#include "tables/huffman-table-spectrum-10.c"
+
+static const AacSpectrumHuffman2 codebook11 =
+#include "tables/huffman-table-spectrum-11.c"
+
+// The tables are sorted for decoding. For encoding, each codeword is found
+//  by the index its values fold into, as in the tables' .txt sources.
+static const struct
+{
+  bool         isSigned;
+  unsigned int dimension;
+  unsigned int maxValue;  // Largest magnitude, the escape marker for ESC_HCB
+  const void  *codebook;
+} codebooks[] =
+{
+  {false, 0, 0,  NULL},
+
+  {true,  4, 1,  &codebook1},
+  {true,  4, 1,  &codebook2},
+  {false, 4, 2,  &codebook3},
+  {false, 4, 2,  &codebook4},
+
+  {true,  2, 4,  &codebook5},
+  {true,  2, 4,  &codebook6},
+  {false, 2, 7,  &codebook7},
+  {false, 2, 7,  &codebook8},
+  {false, 2, 12, &codebook9},
+  {false, 2, 12, &codebook10},
+
+  {false, 2, 16, &codebook11},
+};
+
+constexpr unsigned int codebookCount = std::size(codebooks);
+
+constexpr unsigned int maxIndexCount = 17 * 17;  // ESC_HCB's pairs of 0 to 16
+
+struct AacHuffmanCode
+{
+  uint8_t  len;
+  uint32_t codeword;
+};
+
+struct AacHuffmanEncodeTables
+{
+  std::array<AacHuffmanCode, (AAC_SCALEFACTOR_MAX_OFFSET * 2) + 1> scalefactor;
+  std::array<AacHuffmanCode, maxIndexCount> spectrum[codebookCount];
+};
+
+static unsigned int getModulus(unsigned int tableNum)
+{
+  return codebooks[tableNum].isSigned ? ((codebooks[tableNum].maxValue * 2) + 1) : (codebooks[tableNum].maxValue + 1);
+}
+
+static unsigned int getIndex(unsigned int tableNum, const int *values)
+{
+  unsigned int mod = getModulus(tableNum);
+  int offset = codebooks[tableNum].isSigned ? codebooks[tableNum].maxValue : 0;
+
+  unsigned int index = 0;
+  for (unsigned int i = 0; i < codebooks[tableNum].dimension; i++)
+    index = (index * mod) + (values[i] + offset);
+
+  return index;
+}
+
+static AacHuffmanEncodeTables *buildTables(void)
+{
+  auto tables = new AacHuffmanEncodeTables();
+
+  for (unsigned int i = 0; i < scalefactorTable.count; i++)
+  {
+    auto &entry = scalefactorTable.entries[i];
+    tables->scalefactor[entry.index + AAC_SCALEFACTOR_MAX_OFFSET] = {static_cast<uint8_t>(entry.len), entry.codeword};
+  }
+
+  for (unsigned int tableNum = 1; tableNum < codebookCount; tableNum++)
+  {
+    if (codebooks[tableNum].dimension == 4)
+    {
+      auto table = static_cast<const AacSpectrumHuffman4 *>(codebooks[tableNum].codebook);
+      for (unsigned int i = 0; i < table->count; i++)
+      {
+        auto &entry = table->entries[i];
+        int values[4] = {entry.v0, entry.v1, entry.v2, entry.v3};
+        tables->spectrum[tableNum][getIndex(tableNum, values)] = {static_cast<uint8_t>(entry.len), entry.codeword};
+      }
+    }
+    else
+    {
+      auto table = static_cast<const AacSpectrumHuffman2 *>(codebooks[tableNum].codebook);
+      for (unsigned int i = 0; i < table->count; i++)
+      {
+        auto &entry = table->entries[i];
+        int values[2] = {entry.v0, entry.v1};
+        tables->spectrum[tableNum][getIndex(tableNum, values)] = {static_cast<uint8_t>(entry.len), entry.codeword};
+      }
+    }
+  }
+
+  return tables;
+}
+
+static const AacHuffmanEncodeTables *getTables(void)
+{
+  static const AacHuffmanEncodeTables *tables = buildTables();
+  return tables;
+}
+
+bool AacHuffmanEncoder::encodeScalefactor(int offset)
+{
+  if ((offset < -AAC_SCALEFACTOR_MAX_OFFSET) || (offset > AAC_SCALEFACTOR_MAX_OFFSET))
+    return false;
+
+  auto code = getTables()->scalefactor[offset + AAC_SCALEFACTOR_MAX_OFFSET];
+  m_writer->writeUInt(code.len, code.codeword);
+
+  return true;
+}
+
+// Writes the codeword for a tuple, then the sign bits and escapes that
+//  follow it, in the order that AacSpectrumDecoder reads them
+static bool encodeTuple(AacBitWriter *writer, unsigned int tableNum, const int *values, unsigned int dimension, AacHuffmanEncoder *encoder)
+{
+  assert(tableNum < codebookCount);
+  assert(codebooks[tableNum].dimension == dimension);
+
+  bool isSigned = codebooks[tableNum].isSigned;
+  int maxValue = codebooks[tableNum].maxValue;
+
+  int coded[4];
+  for (unsigned int i = 0; i < dimension; i++)
+  {
+    int magnitude = abs(values[i]);
+
+    if ((tableNum == AAC_HCB_ESC) && (magnitude >= AAC_SPECTRUM_ESC_VALUE))
+    {
+      if (magnitude > AAC_SPECTRUM_MAX_ESC_VALUE)
+        return false;
+
+      magnitude = AAC_SPECTRUM_ESC_VALUE;
+    }
+    else if (magnitude > maxValue)
+      return false;
+
+    coded[i] = isSigned ? values[i] : magnitude;
+  }
+
+  auto code = getTables()->spectrum[tableNum][getIndex(tableNum, coded)];
+  writer->writeUInt(code.len, code.codeword);
+
+  if (!isSigned)
+  {
+    for (unsigned int i = 0; i < dimension; i++)
+    {
+      if (values[i] != 0)
+        writer->writeBit(values[i] < 0);
+    }
+  }
+
+  if (tableNum == AAC_HCB_ESC)
+  {
+    for (unsigned int i = 0; i < dimension; i++)
+    {
+      if (coded[i] == AAC_SPECTRUM_ESC_VALUE)
+        encoder->encodeEscape(abs(values[i]));
+    }
+  }
+
+  return true;
+}
+
+bool AacHuffmanEncoder::encode2(unsigned int tableNum, const int values[2])
+{
+  return encodeTuple(m_writer, tableNum, values, 2, this);
+}
+
+bool AacHuffmanEncoder::encode4(unsigned int tableNum, const int values[4])
+{
+  return encodeTuple(m_writer, tableNum, values, 4, this);
+}
+
+// The inverse of AacSpectrumDecoder::decodeEscape(): a run of 1 bits, a 0,
+//  then the value less its leading 1 bit
+void AacHuffmanEncoder::encodeEscape(unsigned int value)
+{
+  assert((value >= AAC_SPECTRUM_ESC_VALUE) && (value <= AAC_SPECTRUM_MAX_ESC_VALUE));
+
+  unsigned int len = 0;
+  while ((value >> (len + 5)) != 0)
+    len++;
+
+  for (unsigned int i = 0; i < len; i++)
+    m_writer->writeBit(1);
+  m_writer->writeBit(0);
+
+  m_writer->writeUInt(len + 4, value & ((1U << (len + 4)) - 1));
+}
+
+unsigned int AacHuffmanEncoder::getLargestValue(unsigned int tableNum)
+{
+  if ((tableNum == AAC_HCB_ZERO) || (tableNum >= codebookCount))
+    return 0;
+
+  if (tableNum == AAC_HCB_ESC)
+    return AAC_SPECTRUM_MAX_ESC_VALUE;
+
+  return codebooks[tableNum].maxValue;
+}
@@ -0,0 +1,29 @@
+#ifndef AAC_HUFFMAN_ENCODER_H
+#define AAC_HUFFMAN_ENCODER_H
+
+class AacBitWriter;
+
+// Writes scalefactor and spectral codewords from the same tables that
+//  AacScalefactorDecoder and AacSpectrumDecoder read them with
+class AacHuffmanEncoder
+{
+  AacBitWriter *m_writer;
+
+public:
+  AacHuffmanEncoder(AacBitWriter *writer) : m_writer(writer) {};
+
+  // A scalefactor, intensity position or noise energy difference, -60 to 60
+  bool encodeScalefactor(int offset);
+
+  // Fail if a value is out of range for the codebook
+  bool encode2(unsigned int tableNum, const int values[2]);
+  bool encode4(unsigned int tableNum, const int values[4]);
+
+  // An escape sequence for a magnitude from 16 to 8191
+  void encodeEscape(unsigned int value);
+
+  // The largest magnitude a codebook can hold, counting escapes for ESC_HCB
+  static unsigned int getLargestValue(unsigned int tableNum);
+};
+
+#endif
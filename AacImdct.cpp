@@ -4,6 +4,7 @@
 #include <math.h>
 
 #include "AacConstants.h"
+#include "AacImdct.h"
 
 #define restrict __restrict
 
@@ -78,15 +79,26 @@ static void imdct_naive(const double *restrict input, double *restrict output, u
 //   of length N, with some pre-processing and post-processing.
 // • DCT-II of length N can be recursively broken down into two DCT-IIs of
 //   length N/2. When N reaches 2, the two-point DCT is easy to calculate.
-
-static void dct_ii_zhijin(const double *restrict input, double *restrict output, const unsigned int N);
+//
+// The fast path is a template over the sample type, so that it can run either
+//  on plain doubles or on AacImdctLanes, which hold the same coefficient of
+//  several independent channels. Each lane goes through exactly the same
+//  arithmetic as the scalar version, and the trigonometry is shared by all
+//  lanes.
+//
+// Intermediate results go in a scratch buffer supplied by the caller, of
+//  AAC_IMDCT_SCRATCH_SIZE(N) elements, rather than on the stack. For the
+//  lanes that would come to a quarter of a megabyte.
 
 // Recursive DCT-II.
 // Based on "Recursive Algorithms for Discrete Cosine Transform" by Zhijin
 //  & Huisheng.
 // N must be a power of two because we're subdividing the problem into halves
 //  at each step, and the base case is length 2.
-static void dct_ii_zhijin(const double *restrict input, double *restrict output, const unsigned int N)
+// Uses less than 5N elements of scratch: five arrays of N/2 at this level,
+//  plus whatever the transforms of length N/2 use.
+template <typename T>
+static void dct_ii_zhijin(const T *restrict input, T *restrict output, const unsigned int N, T *restrict scratch)
 {
   if (N == 2)
   {
@@ -100,9 +112,16 @@ static void dct_ii_zhijin(const double *restrict input, double *restrict output,
 
   const unsigned int halfN = N >> 1;
 
+  T *g = scratch;
+  T *h = g + halfN;
+  T *G = h + halfN;
+  T *b = G + halfN;
+  T *B = b + halfN;
+
+  // The smaller transforms can share what's left, as they're done in turn
+  T *next = B + halfN;
+
   // Generate g[] and h[]
-  double g[halfN];
-  double h[halfN];
   for (unsigned int n = 0; n < halfN; n++)
   {
     g[n] = input[n] + input[N - n - 1];
@@ -110,23 +129,20 @@ static void dct_ii_zhijin(const double *restrict input, double *restrict output,
   }
 
   // Calculate G[] from g[], which gives us the even indices
-  double G[halfN];
-  dct_ii_zhijin(g, G, halfN);
+  dct_ii_zhijin(g, G, halfN, next);
 
   // Copy even results to output
   for (unsigned int k = 0; k < halfN; k++)
     output[k * 2] = G[k];
 
   // generate b[]
-  double b[halfN];
   for (unsigned int n = 0; n < halfN; n++)
   {
     b[n] = h[n] * 2.0 * cos((M_PI / (2 * N)) * (2 * n + 1));
   }
 
   // Calculate B[] from b[], which gives us the odd indices
-  double B[halfN];
-  dct_ii_zhijin(b, B, halfN);
+  dct_ii_zhijin(b, B, halfN, next);
 
   // Copy odd results to output
   output[1] = B[0] / 2.0;
@@ -138,16 +154,19 @@ static void dct_ii_zhijin(const double *restrict input, double *restrict output,
 // This technique is from "A unified computing kernel for MDCT/IMDCT in
 //  modern audio coding standards" by Tan Li, R. Zhang, R. Yang, Heyun
 //  Huang, and Fuhuei Lin.
-static void dct_iv_via_dct_ii(const double *restrict input, double *restrict output, const unsigned int N)
+// Uses less than 7N elements of scratch.
+template <typename T>
+static void dct_iv_via_dct_ii(const T *restrict input, T *restrict output, const unsigned int N, T *restrict scratch)
 {
+  T *input2 = scratch;
+  T *output2 = input2 + N;
+
   // Transform input for DCT-II
-  double input2[N];
   for (unsigned int n = 0; n < N; n++)
     input2[n] = 2.0 * cos((M_PI * (2 * n + 1)) / (4 * N)) * input[n];
 
   // Run the DCT-II
-  double output2[N];
-  dct_ii_zhijin(input2, output2, N);
+  dct_ii_zhijin(input2, output2, N, output2 + N);
 
   // Transform output for DCT-IV
   output[0] = output2[0] * 0.5;
@@ -157,7 +176,8 @@ static void dct_iv_via_dct_ii(const double *restrict input, double *restrict out
 
 // Perform IMDCT based on DCT-IV.
 // The output is twice the length of the input.
-static void imdctViaDctIV(const double *restrict input, double *restrict output, unsigned int inputCount)
+template <typename T>
+static void imdctViaDctIV(const T *restrict input, T *restrict output, unsigned int inputCount, T *restrict scratch)
 {
   const unsigned int outputCount = inputCount << 1;
 
@@ -166,10 +186,9 @@ static void imdctViaDctIV(const double *restrict input, double *restrict output,
   const unsigned int q2 = outputCount >> 1;
   const unsigned int q3 = q1 + q2;
 
-  // TODO: Fixed size?
-  double dct[inputCount];
+  T *dct = scratch;
 
-  dct_iv_via_dct_ii(input, dct, inputCount);
+  dct_iv_via_dct_ii(input, dct, inputCount, dct + inputCount);
 
   // Use first quarter of DCT-IV to derive last quarter of IMDCT
   for (unsigned int n = 0; n < q1; n++)
@@ -196,11 +215,21 @@ static void imdctViaDctIV(const double *restrict input, double *restrict output,
 // IMDCT for long windows
 void AacImdctLong(const double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], double samples[AAC_XFORM_WIN_SIZE_LONG])
 {
-  imdctViaDctIV(coefficients, samples, AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  double scratch[AAC_IMDCT_SCRATCH_SIZE(AAC_SPECTRAL_SAMPLE_SIZE_LONG)];
+
+  imdctViaDctIV(coefficients, samples, AAC_SPECTRAL_SAMPLE_SIZE_LONG, scratch);
 }
 
 // IMDCT for short windows
 void AacImdctShort(const double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_SHORT], double samples[AAC_XFORM_WIN_SIZE_SHORT])
 {
-  imdctViaDctIV(coefficients, samples, AAC_SPECTRAL_SAMPLE_SIZE_SHORT);
+  double scratch[AAC_IMDCT_SCRATCH_SIZE(AAC_SPECTRAL_SAMPLE_SIZE_SHORT)];
+
+  imdctViaDctIV(coefficients, samples, AAC_SPECTRAL_SAMPLE_SIZE_SHORT, scratch);
+}
+
+// IMDCT for long windows, AAC_IMDCT_LANE_COUNT channels at once
+void AacImdctLongLanes(const AacImdctLanes coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], AacImdctLanes samples[AAC_XFORM_WIN_SIZE_LONG], AacImdctLanes scratch[AAC_IMDCT_LANES_SCRATCH_SIZE])
+{
+  imdctViaDctIV(coefficients, samples, AAC_SPECTRAL_SAMPLE_SIZE_LONG, scratch);
 }
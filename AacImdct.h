@@ -1,7 +1,22 @@
 #ifndef AAC_IMDCT_H
 #define AAC_IMDCT_H
 
+// Channels transformed together by AacImdctLongLanes(). Four doubles fill an
+//  AVX register, or a pair of SSE2 registers.
+#define AAC_IMDCT_LANE_COUNT 4
+
+// One sample from each of AAC_IMDCT_LANE_COUNT channels (structure-of-arrays)
+typedef double AacImdctLanes __attribute__((vector_size(sizeof(double) * AAC_IMDCT_LANE_COUNT)));
+
+// Working space for an IMDCT of n coefficients, in samples
+#define AAC_IMDCT_SCRATCH_SIZE(n) (8 * (n))
+
+// The lanes take too much working space for the stack, so the caller keeps it
+#define AAC_IMDCT_LANES_SCRATCH_SIZE AAC_IMDCT_SCRATCH_SIZE(AAC_SPECTRAL_SAMPLE_SIZE_LONG)
+
 void AacImdctLong(const double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], double samples[AAC_XFORM_WIN_SIZE_LONG]);
 void AacImdctShort(const double coefficients[AAC_SPECTRAL_SAMPLE_SIZE_SHORT], double samples[AAC_XFORM_WIN_SIZE_SHORT]);
 
+void AacImdctLongLanes(const AacImdctLanes coefficients[AAC_SPECTRAL_SAMPLE_SIZE_LONG], AacImdctLanes samples[AAC_XFORM_WIN_SIZE_LONG], AacImdctLanes scratch[AAC_IMDCT_LANES_SCRATCH_SIZE]);
+
 #endif
@@ -0,0 +1,83 @@
+#include <math.h>
+
+#include <algorithm>
+
+#include "AacLatencyHistogram.h"
+
+// Values below two sub-bucket counts have a bucket each. Above that, the
+//  bits below the top AAC_LATENCY_SUB_BUCKET_BITS + 1 are dropped, and each
+//  power of two gets AAC_LATENCY_SUB_BUCKET_COUNT buckets.
+unsigned int AacLatencyHistogram::getBucket(uint64_t value)
+{
+  if (value < (2 * AAC_LATENCY_SUB_BUCKET_COUNT))
+    return value;
+
+  unsigned int magnitude = 63 - __builtin_clzll(value);
+  if (magnitude >= AAC_LATENCY_VALUE_BITS)
+    return AAC_LATENCY_BUCKET_COUNT - 1;
+
+  unsigned int shift = magnitude - AAC_LATENCY_SUB_BUCKET_BITS;
+
+  return ((shift + 1) * AAC_LATENCY_SUB_BUCKET_COUNT) + (value >> shift) - AAC_LATENCY_SUB_BUCKET_COUNT;
+}
+
+uint64_t AacLatencyHistogram::getBucketHighest(unsigned int bucket)
+{
+  if (bucket < (2 * AAC_LATENCY_SUB_BUCKET_COUNT))
+    return bucket;
+
+  unsigned int shift = (bucket / AAC_LATENCY_SUB_BUCKET_COUNT) - 1;
+  uint64_t top = (bucket % AAC_LATENCY_SUB_BUCKET_COUNT) + AAC_LATENCY_SUB_BUCKET_COUNT;
+
+  return ((top + 1) << shift) - 1;
+}
+
+void AacLatencyHistogram::record(uint64_t value, uint64_t tag)
+{
+  m_counts[getBucket(value)]++;
+
+  m_count++;
+  m_total += value;
+
+  if (value > m_max)
+  {
+    m_max = value;
+    m_maxTag = tag;
+  }
+}
+
+void AacLatencyHistogram::add(const AacLatencyHistogram &other)
+{
+  for (unsigned int i = 0; i < AAC_LATENCY_BUCKET_COUNT; i++)
+    m_counts[i] += other.m_counts[i];
+
+  m_count += other.m_count;
+  m_total += other.m_total;
+
+  if (other.m_max > m_max)
+  {
+    m_max = other.m_max;
+    m_maxTag = other.m_maxTag;
+  }
+}
+
+uint64_t AacLatencyHistogram::getPercentile(double percent) const
+{
+  if (m_count == 0)
+    return 0;
+
+  percent = std::clamp(percent, 0.0, 100.0);
+
+  // The rank of the value wanted, counting from one
+  uint64_t rank = std::max<uint64_t>(ceil(percent / 100.0 * m_count), 1);
+  uint64_t seen = 0;
+
+  for (unsigned int i = 0; i < AAC_LATENCY_BUCKET_COUNT; i++)
+  {
+    seen += m_counts[i];
+    if (seen >= rank)
+      return (i == AAC_LATENCY_BUCKET_COUNT - 1) ? m_max : std::min(getBucketHighest(i), m_max);
+  }
+
+  return m_max;
+}
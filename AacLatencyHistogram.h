@@ -0,0 +1,50 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef AAC_LATENCY_HISTOGRAM_H
+#define AAC_LATENCY_HISTOGRAM_H
+
+// Each power of two is split into this many buckets, so a value is known to
+//  within 1/32 (about 3%) whatever its size
+#define AAC_LATENCY_SUB_BUCKET_BITS  5
+#define AAC_LATENCY_SUB_BUCKET_COUNT (1 << AAC_LATENCY_SUB_BUCKET_BITS)
+
+// Values of 2^40 ticks or more (minutes, even in cycles) land in the last bucket
+#define AAC_LATENCY_VALUE_BITS       40
+#define AAC_LATENCY_BUCKET_COUNT     ((AAC_LATENCY_VALUE_BITS - AAC_LATENCY_SUB_BUCKET_BITS + 1) * AAC_LATENCY_SUB_BUCKET_COUNT)
+
+// A log-linear histogram of latencies, in the manner of HdrHistogram: a
+//  fixed array of buckets with constant relative precision, so recording is
+//  a few instructions and never allocates. Histograms filled on different
+//  threads are merged with add(). The maximum is kept exactly, along with a
+//  caller-supplied tag (such as the frame's byte offset) to say where it
+//  happened.
+class AacLatencyHistogram
+{
+  uint64_t m_counts[AAC_LATENCY_BUCKET_COUNT];
+
+  uint64_t m_count;
+  uint64_t m_total;
+  uint64_t m_max;
+  uint64_t m_maxTag;
+
+  static unsigned int getBucket(uint64_t value);
+  static uint64_t     getBucketHighest(unsigned int bucket);
+
+public:
+  AacLatencyHistogram(void) : m_counts(), m_count(0), m_total(0), m_max(0), m_maxTag(0) {};
+
+  void record(uint64_t value, uint64_t tag);
+  void add(const AacLatencyHistogram &other);
+
+  uint64_t getCount(void) const { return m_count; };
+  uint64_t getMax(void) const { return m_max; };
+  uint64_t getMaxTag(void) const { return m_maxTag; };
+  double   getMean(void) const { return m_count ? (static_cast<double>(m_total) / m_count) : 0.0; };
+
+  // The smallest value that percent of the recorded values are at or below,
+  //  to the histogram's precision. Zero if nothing has been recorded.
+  uint64_t getPercentile(double percent) const;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#include "AacLoasFrame.h"
+
+bool AacLoasFrame::addPayload(size_t bitOffset, size_t bitCount)
+{
+  if ((m_payloadCount >= AAC_LATM_MAX_SUBFRAMES) || (bitOffset + bitCount > m_size * 8))
+    return false;
+
+  m_payloads[m_payloadCount++] = {bitOffset, bitCount};
+  return true;
+}
+
+AacBitReader AacLoasFrame::getPayloadReader(unsigned int index) const
+{
+  const AacLoasPayload *payload = &m_payloads[index];
+
+  // Payloads needn't start or end on a byte boundary
+  size_t firstByte = payload->bitOffset / 8;
+  size_t endByte = (payload->bitOffset + payload->bitCount + 7) / 8;
+
+  return AacBitReader(m_bytes + firstByte, endByte - firstByte, payload->bitOffset % 8);
+}
@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AacAudioSpecificConfig.h"
+#include "AacBitReader.h"
+
+#ifndef AAC_LOAS_FRAME_H
+#define AAC_LOAS_FRAME_H
+
+#define AAC_LOAS_HEADER_SIZE     3  // 11-bit syncword and 13-bit length
+#define AAC_LOAS_MAX_FRAME_SIZE  (AAC_LOAS_HEADER_SIZE + 8191)
+
+#define AAC_LATM_MAX_SUBFRAMES   64  // 6-bit numSubFrames, plus one
+
+// The parts of a StreamMuxConfig that matter for a single AAC stream
+struct AacLatmConfig
+{
+  unsigned int           audioMuxVersion;
+  unsigned int           subFrameCount;  // Payloads per AudioMuxElement
+
+  AacAudioSpecificConfig audio;
+};
+
+// Where one raw data block lies, in bits from the start of the frame
+struct AacLoasPayload
+{
+  size_t bitOffset;
+  size_t bitCount;
+};
+
+// An AudioSyncStream frame holding one AudioMuxElement
+class AacLoasFrame
+{
+  const uint8_t       *m_bytes;
+  size_t               m_size;
+
+  const AacLatmConfig *m_config;
+
+  unsigned int         m_payloadCount;
+  AacLoasPayload       m_payloads[AAC_LATM_MAX_SUBFRAMES];
+
+public:
+  AacLoasFrame(void) : m_bytes(NULL), m_size(0), m_config(NULL), m_payloadCount(0) {};
+
+  void                 set(const uint8_t *bytes, size_t size, const AacLatmConfig *config) { m_bytes = bytes; m_size = size; m_config = config; m_payloadCount = 0; };
+  bool                 addPayload(size_t bitOffset, size_t bitCount);
+
+  size_t               getSize(void) const { return m_size; };
+
+  // The config in force for this frame. It belongs to the reader, and is
+  //  only valid until the reader reads another frame.
+  const AacLatmConfig *getConfig(void) const { return m_config; };
+
+  unsigned int         getPayloadCount(void) const { return m_payloadCount; };
+
+  // A reader over one payload, in place, for AacDecoder::decodeBlock()
+  AacBitReader         getPayloadReader(unsigned int index) const;
+};
+
+#endif
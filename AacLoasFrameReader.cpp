@@ -0,0 +1,281 @@
+#include <string.h>
+
+#include <algorithm>
+
+#include "AacBitReader.h"
+#include "AacSyncwordScanner.h"
+
+#include "AacLoasFrameReader.h"
+
+// The 11-bit syncword 0x2B7
+#define AAC_LOAS_SYNC_FIRST_BYTE  0x56
+#define AAC_LOAS_SYNC_SECOND_MASK 0xE0
+
+// Frames that must follow a candidate exactly, where there's room, before
+//  it's taken. An 11-bit syncword is too easily matched by chance for one
+//  to be enough.
+#define AAC_LOAS_CHAIN_LENGTH 2
+
+static bool isSyncword(const uint8_t *bytes)
+{
+  return (bytes[0] == AAC_LOAS_SYNC_FIRST_BYTE) && ((bytes[1] & AAC_LOAS_SYNC_SECOND_MASK) == AAC_LOAS_SYNC_SECOND_MASK);
+}
+
+static size_t getFrameSize(const uint8_t *bytes)
+{
+  return AAC_LOAS_HEADER_SIZE + (((bytes[1] & 0x1F) << 8) | bytes[2]);
+}
+
+// LatmGetValue(): a count of bytes, then the value in that many bytes
+static uint64_t readLatmValue(AacBitReader *reader)
+{
+  unsigned int byteCount = reader->readUInt(2) + 1;
+
+  uint64_t value = 0;
+  for (unsigned int i = 0; i < byteCount; i++)
+    value = (value << 8) | reader->readUInt(8);
+
+  return value;
+}
+
+bool AacLoasFrameReader::isLoas(const uint8_t *bytes, size_t size)
+{
+  auto reader = AacLoasFrameReader(bytes, size);
+
+  // Only the start is searched, so other data isn't scanned from end to end
+  size_t end = std::min<size_t>(size, AAC_LOAS_MAX_FRAME_SIZE);
+
+  return scanSyncwords(bytes, 0, end, AAC_LOAS_SYNC_FIRST_BYTE, AAC_LOAS_SYNC_SECOND_MASK, [&](size_t candidate) { return reader.isChained(candidate); }) < end;
+}
+
+bool AacLoasFrameReader::isAtFrameHeader(void)
+{
+  if ((m_position + AAC_LOAS_HEADER_SIZE) >= m_size)
+    return false;  // Not enough room for a frame header
+
+  return isSyncword(m_bytes + m_position);
+}
+
+// Returns the size of the frame whose header is at position, or zero if it
+//  doesn't look like a usable frame header
+size_t AacLoasFrameReader::getPlausibleFrameSize(size_t position)
+{
+  if ((position + AAC_LOAS_HEADER_SIZE) >= m_size)
+    return 0;
+
+  if (!isSyncword(m_bytes + position))
+    return 0;
+
+  size_t frameSize = getFrameSize(m_bytes + position);
+  if (frameSize <= AAC_LOAS_HEADER_SIZE)
+    return 0;  // No room for an AudioMuxElement
+
+  return frameSize;
+}
+
+// True if the frame at position is followed by AAC_LOAS_CHAIN_LENGTH more,
+//  or by fewer and then the end of the data
+bool AacLoasFrameReader::isChained(size_t position)
+{
+  for (unsigned int i = 0; i <= AAC_LOAS_CHAIN_LENGTH; i++)
+  {
+    size_t frameSize = getPlausibleFrameSize(position);
+    if (frameSize == 0)
+      return false;
+
+    position += frameSize;
+    if ((position + AAC_LOAS_HEADER_SIZE) >= m_size)
+      return true;  // The data ends first
+  }
+
+  return true;
+}
+
+// A repeated config is recognised by comparing its bits, which always
+//  start one bit into the AudioMuxElement, with those of the cached one
+bool AacLoasFrameReader::isCachedConfig(const uint8_t *bytes, size_t size)
+{
+  if (!m_hasConfig || (size < m_configBytes.size()))
+    return false;
+
+  size_t bitCount = 1 + m_configBitCount;
+  size_t fullByteCount = bitCount / 8;
+
+  if (memcmp(bytes, m_configBytes.data(), fullByteCount))
+    return false;
+
+  unsigned int tailBitCount = bitCount % 8;
+  if (tailBitCount == 0)
+    return true;
+
+  uint8_t mask = 0xFF << (8 - tailBitCount);
+  return ((bytes[fullByteCount] ^ m_configBytes[fullByteCount]) & mask) == 0;
+}
+
+// StreamMuxConfig()
+bool AacLoasFrameReader::readStreamMuxConfig(AacBitReader *reader, AacLatmConfig *config)
+{
+  config->audioMuxVersion = reader->readBit();
+
+  unsigned int audioMuxVersionA = config->audioMuxVersion ? reader->readBit() : 0;
+  if (audioMuxVersionA)
+    return false;  // Reserved
+
+  if (config->audioMuxVersion)
+    readLatmValue(reader);  // taraBufferFullness
+
+  bool allStreamsSameTimeFraming = reader->readBit();
+
+  config->subFrameCount = reader->readUInt(6) + 1;
+
+  unsigned int programCount = reader->readUInt(4) + 1;
+  unsigned int layerCount = reader->readUInt(3) + 1;
+
+  if (!allStreamsSameTimeFraming || (programCount != 1) || (layerCount != 1))
+    return false;
+
+  // The first layer of the first program always has a config of its own
+  if (config->audioMuxVersion == 0)
+  {
+    if (!config->audio.read(reader))
+      return false;
+  }
+  else
+  {
+    // Its length is given, so anything after it can be skipped
+    uint64_t length = readLatmValue(reader);
+    if (length > AAC_LOAS_MAX_FRAME_SIZE * 8)
+      return false;
+
+    size_t start = reader->getBitPosition();
+    if (!config->audio.read(reader))
+      return false;
+
+    size_t used = reader->getBitPosition() - start;
+    if (used > length)
+      return false;
+
+    reader->skipBits(length - used);
+  }
+
+  unsigned int frameLengthType = reader->readUInt(3);
+  if (frameLengthType != 0)
+    return false;  // Only variable-length payloads are used for AAC
+
+  reader->skipBits(8);  // latmBufferFullness
+
+  bool hasOtherData = reader->readBit();
+  if (hasOtherData)
+  {
+    // otherDataLenBits. The other data itself comes after the payloads,
+    //  where it can be left alone.
+    if (config->audioMuxVersion)
+    {
+      readLatmValue(reader);
+    }
+    else
+    {
+      bool isEscaped;
+      do
+      {
+        isEscaped = reader->readBit();
+        reader->skipBits(8);
+      } while (isEscaped && !reader->isComplete());
+    }
+  }
+
+  bool hasCrc = reader->readBit();
+  if (hasCrc)
+    reader->skipBits(8);  // crcCheckSum
+
+  // The payloads must follow
+  return !reader->isComplete();
+}
+
+bool AacLoasFrameReader::readFrame(AacLoasFrame *frame)
+{
+  if (!isAtFrameHeader())
+    return false;
+
+  const uint8_t *bytes = m_bytes + m_position;
+
+  size_t frameSize = getFrameSize(bytes);
+  if ((m_position + frameSize) > m_size)
+    return false;  // Not enough space left for entire frame
+
+  // AudioMuxElement(1)
+  const uint8_t *element = bytes + AAC_LOAS_HEADER_SIZE;
+  size_t elementSize = frameSize - AAC_LOAS_HEADER_SIZE;
+
+  AacBitReader reader(element, elementSize);
+
+  bool useSameStreamMux = reader.readBit();
+  if (!useSameStreamMux)
+  {
+    if (isCachedConfig(element, elementSize))
+    {
+      reader.skipBits(m_configBitCount);
+    }
+    else
+    {
+      // A damaged config leaves the cached one in place
+      AacLatmConfig config;
+      if (!readStreamMuxConfig(&reader, &config))
+        return false;
+
+      m_config = config;
+      m_hasConfig = true;
+      m_configBitCount = reader.getBitPosition() - 1;
+      m_configBytes.assign(element, element + ((reader.getBitPosition() + 7) / 8));
+    }
+  }
+  else if (!m_hasConfig)
+  {
+    return false;  // Nothing to decode it with yet
+  }
+
+  frame->set(bytes, frameSize, &m_config);
+
+  for (unsigned int i = 0; i < m_config.subFrameCount; i++)
+  {
+    // PayloadLengthInfo(), in bytes, with 255 meaning there's more
+    size_t length = 0;
+    unsigned int part;
+    do
+    {
+      part = reader.readUInt(8);
+      length += part;
+    } while ((part == 255) && !reader.isComplete());
+
+    // PayloadMux()
+    if (!frame->addPayload((AAC_LOAS_HEADER_SIZE * 8) + reader.getBitPosition(), length * 8))
+      return false;
+
+    reader.skipBits(length * 8);
+  }
+
+  return true;
+}
+
+// Moves to the next frame header after the current position. A candidate
+//  is only taken if more frames follow it exactly, which rules out stray
+//  syncwords and the intact headers of frames cut short by damage.
+size_t AacLoasFrameReader::findNextFrame(void)
+{
+  size_t remainingSize = getRemainingSize();
+  if (remainingSize == 0)
+    return 0;  // EOF
+
+  size_t initialPosition = m_position;
+
+  // Start looking from the next byte in the stream
+  m_position = scanSyncwords(m_bytes, m_position + 1, m_size, AAC_LOAS_SYNC_FIRST_BYTE, AAC_LOAS_SYNC_SECOND_MASK, [&](size_t candidate)
+  {
+    if (candidate + AAC_LOAS_HEADER_SIZE >= m_size)
+      return true;  // Not enough remaining space
+
+    return isChained(candidate);
+  });
+
+  return m_position - initialPosition;
+}
@@ -0,0 +1,60 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "AacLoasFrame.h"
+
+#ifndef AAC_LOAS_FRAME_READER_H
+#define AAC_LOAS_FRAME_READER_H
+
+class AacBitReader;
+
+// Reads LOAS (AudioSyncStream) framing of LATM, as carried in DVB. Only
+//  a single program with a single layer of AAC is supported, with every
+//  payload in an AudioMuxElement framed the same way.
+// The payloads are left in place; each frame describes where they lie.
+class AacLoasFrameReader
+{
+  const uint8_t       *m_bytes;
+  size_t               m_size;
+
+  size_t               m_position;
+
+  // The StreamMuxConfig is repeated in many frames, but seldom changes, so
+  //  it's parsed once and then recognised by its bits
+  AacLatmConfig        m_config;
+  bool                 m_hasConfig;
+  std::vector<uint8_t> m_configBytes;  // From the start of the AudioMuxElement
+  size_t               m_configBitCount;  // Not counting useSameStreamMux
+
+  size_t getPlausibleFrameSize(size_t position);
+  bool   isChained(size_t position);
+
+  bool   isCachedConfig(const uint8_t *bytes, size_t size);
+  bool   readStreamMuxConfig(AacBitReader *reader, AacLatmConfig *config);
+
+public:
+  AacLoasFrameReader(const uint8_t *bytes, size_t size) : m_bytes(bytes), m_size(size), m_position(0), m_config(), m_hasConfig(false), m_configBitCount(0) {};
+
+  // True if the data holds LOAS frames from the start, or after at most one
+  //  partial frame, as in a capture that began mid-stream
+  static bool isLoas(const uint8_t *bytes, size_t size);
+
+  size_t getPosition(void) { return m_position; };
+
+  bool   advance(size_t count) { if (m_position + count > m_size) { m_position = m_size; return false; } m_position += count; return true; };
+
+  bool   isAtFrameHeader(void);
+  bool   isComplete(void) { return m_position >= m_size; };
+
+  // Fails on frames that are damaged, that don't match the supported form,
+  //  or that rely on a config before one has been seen
+  bool   readFrame(AacLoasFrame *frame);
+
+  size_t findNextFrame(void);
+
+  size_t getRemainingSize(void) { if (m_position >= m_size) return 0; return m_size - m_position; };
+};
+
+#endif
@@ -0,0 +1,427 @@
+#include "AacBitReader.h"
+
+#include "AacMp4Demuxer.h"
+
+#define BOX_TYPE(a, b, c, d) ((static_cast<uint32_t>(a) << 24) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(c) << 8) | static_cast<uint32_t>(d))
+
+#define BOX_FTYP BOX_TYPE('f', 't', 'y', 'p')
+#define BOX_MOOV BOX_TYPE('m', 'o', 'o', 'v')
+#define BOX_TRAK BOX_TYPE('t', 'r', 'a', 'k')
+#define BOX_MDIA BOX_TYPE('m', 'd', 'i', 'a')
+#define BOX_MINF BOX_TYPE('m', 'i', 'n', 'f')
+#define BOX_STBL BOX_TYPE('s', 't', 'b', 'l')
+#define BOX_STSD BOX_TYPE('s', 't', 's', 'd')
+#define BOX_STSZ BOX_TYPE('s', 't', 's', 'z')
+#define BOX_STCO BOX_TYPE('s', 't', 'c', 'o')
+#define BOX_CO64 BOX_TYPE('c', 'o', '6', '4')
+#define BOX_STSC BOX_TYPE('s', 't', 's', 'c')
+#define BOX_MP4A BOX_TYPE('m', 'p', '4', 'a')
+#define BOX_ESDS BOX_TYPE('e', 's', 'd', 's')
+#define BOX_WAVE BOX_TYPE('w', 'a', 'v', 'e')
+
+// MPEG-4 systems descriptor tags
+#define ES_DESCRIPTOR_TAG            0x03
+#define DECODER_CONFIG_TAG           0x04
+#define DECODER_SPECIFIC_INFO_TAG    0x05
+
+#define DECODER_CONFIG_FIELDS_SIZE   13  // Before the DecoderSpecificInfo
+
+// Object type indications for AAC
+#define OBJECT_TYPE_MPEG4_AUDIO      0x40
+#define OBJECT_TYPE_MPEG2_AAC_MAIN   0x66
+#define OBJECT_TYPE_MPEG2_AAC_SSR    0x68
+
+#define STSC_ENTRY_SIZE 12
+
+static uint32_t readU16(const uint8_t *bytes)
+{
+  return (bytes[0] << 8) | bytes[1];
+}
+
+static uint32_t readU32(const uint8_t *bytes)
+{
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (bytes[1] << 16) | (bytes[2] << 8) | bytes[3];
+}
+
+static uint64_t readU64(const uint8_t *bytes)
+{
+  return (static_cast<uint64_t>(readU32(bytes)) << 32) | readU32(bytes + 4);
+}
+
+// Splits the first box off the front of a buffer. Fails at the end of the
+//  buffer, or on a box that overruns it.
+static bool nextBox(const uint8_t **bytes, size_t *size, uint32_t *type, const uint8_t **body, size_t *bodySize)
+{
+  if (*size < 8)
+    return false;
+
+  uint64_t boxSize = readU32(*bytes);
+  size_t headerSize = 8;
+
+  *type = readU32(*bytes + 4);
+
+  if (boxSize == 1)
+  {
+    // 64-bit size
+    if (*size < 16)
+      return false;
+
+    boxSize = readU64(*bytes + 8);
+    headerSize = 16;
+  }
+  else if (boxSize == 0)
+  {
+    boxSize = *size;  // Runs to the end of its parent
+  }
+
+  if ((boxSize < headerSize) || (boxSize > *size))
+    return false;
+
+  *body = *bytes + headerSize;
+  *bodySize = boxSize - headerSize;
+
+  *bytes += boxSize;
+  *size -= boxSize;
+
+  return true;
+}
+
+// Finds the first box of a type among those in a buffer
+static bool findBox(const uint8_t *bytes, size_t size, uint32_t wanted, const uint8_t **body, size_t *bodySize)
+{
+  uint32_t type;
+  while (nextBox(&bytes, &size, &type, body, bodySize))
+  {
+    if (type == wanted)
+      return true;
+  }
+
+  return false;
+}
+
+// Splits the first descriptor off the front of a buffer. The size takes one
+//  to four bytes, 7 bits in each.
+static bool nextDescriptor(const uint8_t **bytes, size_t *size, unsigned int *tag, const uint8_t **body, size_t *bodySize)
+{
+  if (*size < 2)
+    return false;
+
+  *tag = (*bytes)[0];
+
+  size_t length = 0;
+  size_t i = 1;
+  do
+  {
+    if ((i >= *size) || (i > 4))
+      return false;
+
+    length = (length << 7) | ((*bytes)[i] & 0x7F);
+  } while ((*bytes)[i++] & 0x80);
+
+  if (length > *size - i)
+    return false;
+
+  *body = *bytes + i;
+  *bodySize = length;
+
+  *bytes += i + length;
+  *size -= i + length;
+
+  return true;
+}
+
+AacMp4Demuxer::AacMp4Demuxer(void)
+{
+  m_bytes = NULL;
+  m_size = 0;
+
+  m_config = {};
+
+  m_sampleSizes = NULL;
+  m_fixedSampleSize = 0;
+  m_sampleCount = 0;
+
+  m_chunkOffsets = NULL;
+  m_chunkOffsetSize = 4;
+  m_chunkCount = 0;
+
+  m_sampleToChunk = NULL;
+  m_sampleToChunkCount = 0;
+
+  m_sample = 0;
+  m_chunk = 0;
+  m_sampleToChunkEntry = 0;
+  m_chunkSamplesLeft = 0;
+  m_offset = 0;
+}
+
+bool AacMp4Demuxer::isMp4(const uint8_t *bytes, size_t size)
+{
+  return (size >= 8) && (readU32(bytes + 4) == BOX_FTYP);
+}
+
+bool AacMp4Demuxer::open(const uint8_t *bytes, size_t size)
+{
+  *this = AacMp4Demuxer();
+
+  m_bytes = bytes;
+  m_size = size;
+
+  // The movie box may come before or after the media data
+  const uint8_t *movie;
+  size_t movieSize;
+  if (!findBox(bytes, size, BOX_MOOV, &movie, &movieSize))
+    return false;
+
+  return parseMovie(movie, movieSize);
+}
+
+bool AacMp4Demuxer::parseMovie(const uint8_t *bytes, size_t size)
+{
+  uint32_t type;
+  const uint8_t *track;
+  size_t trackSize;
+
+  while (nextBox(&bytes, &size, &type, &track, &trackSize))
+  {
+    if ((type == BOX_TRAK) && parseTrack(track, trackSize))
+      return true;
+  }
+
+  return false;
+}
+
+bool AacMp4Demuxer::parseTrack(const uint8_t *bytes, size_t size)
+{
+  const uint8_t *media, *mediaInfo, *sampleTable;
+  size_t mediaSize, mediaInfoSize, sampleTableSize;
+
+  if (!findBox(bytes, size, BOX_MDIA, &media, &mediaSize) || !findBox(media, mediaSize, BOX_MINF, &mediaInfo, &mediaInfoSize) || !findBox(mediaInfo, mediaInfoSize, BOX_STBL, &sampleTable, &sampleTableSize))
+    return false;
+
+  const uint8_t *box;
+  size_t boxSize;
+
+  if (!findBox(sampleTable, sampleTableSize, BOX_STSD, &box, &boxSize) || !parseSampleDescription(box, boxSize))
+    return false;
+
+  // Sample sizes: version and flags, fixed size, count, then a size per sample
+  //  unless they are all the fixed size
+  if (!findBox(sampleTable, sampleTableSize, BOX_STSZ, &box, &boxSize) || (boxSize < 12))
+    return false;
+
+  m_fixedSampleSize = readU32(box + 4);
+  m_sampleCount = readU32(box + 8);
+  m_sampleSizes = NULL;
+
+  if (m_fixedSampleSize == 0)
+  {
+    if ((boxSize - 12) / 4 < m_sampleCount)
+      return false;
+
+    m_sampleSizes = box + 12;
+  }
+
+  // Chunk offsets: version and flags, count, then an offset per chunk
+  if (findBox(sampleTable, sampleTableSize, BOX_STCO, &box, &boxSize))
+    m_chunkOffsetSize = 4;
+  else if (findBox(sampleTable, sampleTableSize, BOX_CO64, &box, &boxSize))
+    m_chunkOffsetSize = 8;
+  else
+    return false;
+
+  if (boxSize < 8)
+    return false;
+
+  m_chunkCount = readU32(box + 4);
+  if ((boxSize - 8) / m_chunkOffsetSize < m_chunkCount)
+    return false;
+
+  m_chunkOffsets = box + 8;
+
+  // Sample to chunk: version and flags, count, then runs of chunks with the
+  //  same number of samples
+  if (!findBox(sampleTable, sampleTableSize, BOX_STSC, &box, &boxSize) || (boxSize < 8))
+    return false;
+
+  m_sampleToChunkCount = readU32(box + 4);
+  if ((boxSize - 8) / STSC_ENTRY_SIZE < m_sampleToChunkCount)
+    return false;
+
+  m_sampleToChunk = box + 8;
+
+  if (m_sampleCount && (!m_chunkCount || !m_sampleToChunkCount))
+    return false;
+
+  return true;
+}
+
+// Only the first sample description is used, as tracks that switch between
+//  several are rare
+bool AacMp4Demuxer::parseSampleDescription(const uint8_t *bytes, size_t size)
+{
+  if ((size < 8) || (readU32(bytes + 4) < 1))
+    return false;
+
+  bytes += 8;
+  size -= 8;
+
+  uint32_t type;
+  const uint8_t *entry;
+  size_t entrySize;
+
+  if (!nextBox(&bytes, &size, &type, &entry, &entrySize) || (type != BOX_MP4A))
+    return false;
+
+  // The audio sample entry's fields, whose length QuickTime's sound
+  //  description version extends, come before its child boxes
+  if (entrySize < 10)
+    return false;
+
+  size_t fieldsSize;
+  switch (readU16(entry + 8))
+  {
+  case 0:
+    fieldsSize = 28;
+    break;
+  case 1:
+    fieldsSize = 44;
+    break;
+  case 2:
+    fieldsSize = 64;
+    break;
+  default:
+    return false;
+  }
+
+  if (entrySize < fieldsSize)
+    return false;
+
+  const uint8_t *children = entry + fieldsSize;
+  size_t childrenSize = entrySize - fieldsSize;
+
+  const uint8_t *esds, *wave;
+  size_t esdsSize, waveSize;
+
+  // QuickTime files may wrap it in a wave box
+  if (!findBox(children, childrenSize, BOX_ESDS, &esds, &esdsSize))
+  {
+    if (!findBox(children, childrenSize, BOX_WAVE, &wave, &waveSize) || !findBox(wave, waveSize, BOX_ESDS, &esds, &esdsSize))
+      return false;
+  }
+
+  return parseElementaryStreamDescriptor(esds, esdsSize);
+}
+
+bool AacMp4Demuxer::parseElementaryStreamDescriptor(const uint8_t *bytes, size_t size)
+{
+  // Version and flags
+  if (size < 4)
+    return false;
+
+  bytes += 4;
+  size -= 4;
+
+  unsigned int tag;
+  const uint8_t *es;
+  size_t esSize;
+
+  if (!nextDescriptor(&bytes, &size, &tag, &es, &esSize) || (tag != ES_DESCRIPTOR_TAG) || (esSize < 3))
+    return false;
+
+  // ES_ID, then flags for the optional fields before the decoder config
+  uint8_t flags = es[2];
+  size_t skip = 3;
+
+  if (flags & 0x80)
+    skip += 2;  // dependsOn_ES_ID
+
+  if (flags & 0x40)
+  {
+    // URL
+    if (skip >= esSize)
+      return false;
+
+    skip += 1 + es[skip];
+  }
+
+  if (flags & 0x20)
+    skip += 2;  // OCR_ES_Id
+
+  if (skip > esSize)
+    return false;
+
+  es += skip;
+  esSize -= skip;
+
+  const uint8_t *config;
+  size_t configSize;
+
+  if (!nextDescriptor(&es, &esSize, &tag, &config, &configSize) || (tag != DECODER_CONFIG_TAG) || (configSize < DECODER_CONFIG_FIELDS_SIZE))
+    return false;
+
+  unsigned int objectTypeIndication = config[0];
+  if ((objectTypeIndication != OBJECT_TYPE_MPEG4_AUDIO) && ((objectTypeIndication < OBJECT_TYPE_MPEG2_AAC_MAIN) || (objectTypeIndication > OBJECT_TYPE_MPEG2_AAC_SSR)))
+    return false;
+
+  config += DECODER_CONFIG_FIELDS_SIZE;
+  configSize -= DECODER_CONFIG_FIELDS_SIZE;
+
+  const uint8_t *info;
+  size_t infoSize;
+
+  if (!nextDescriptor(&config, &configSize, &tag, &info, &infoSize) || (tag != DECODER_SPECIFIC_INFO_TAG))
+    return false;
+
+  AacBitReader reader(info, infoSize);
+  return m_config.read(&reader);
+}
+
+// Moves on to the next chunk that holds any samples
+bool AacMp4Demuxer::startChunk(void)
+{
+  while (m_chunk < m_chunkCount)
+  {
+    // The stsc entries number chunks from one
+    while ((m_sampleToChunkEntry + 1 < m_sampleToChunkCount) && (readU32(m_sampleToChunk + ((m_sampleToChunkEntry + 1) * STSC_ENTRY_SIZE)) <= m_chunk + 1))
+      m_sampleToChunkEntry++;
+
+    m_chunkSamplesLeft = readU32(m_sampleToChunk + (m_sampleToChunkEntry * STSC_ENTRY_SIZE) + 4);
+
+    if (m_chunkOffsetSize == 8)
+      m_offset = readU64(m_chunkOffsets + (m_chunk * 8));
+    else
+      m_offset = readU32(m_chunkOffsets + (m_chunk * 4));
+
+    m_chunk++;
+
+    if (m_chunkSamplesLeft)
+      return true;
+  }
+
+  return false;
+}
+
+bool AacMp4Demuxer::readAccessUnit(AacMp4AccessUnit *unit)
+{
+  if (isComplete())
+    return false;
+
+  if (!m_chunkSamplesLeft && !startChunk())
+    return false;
+
+  uint32_t size = m_sampleSizes ? readU32(m_sampleSizes + (m_sample * 4)) : m_fixedSampleSize;
+
+  if ((m_offset > m_size) || (size > m_size - m_offset))
+    return false;
+
+  unit->bytes  = m_bytes + m_offset;
+  unit->size   = size;
+  unit->offset = m_offset;
+
+  m_offset += size;
+  m_sample++;
+  m_chunkSamplesLeft--;
+
+  return true;
+}
@@ -0,0 +1,76 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AacAudioSpecificConfig.h"
+
+#ifndef AAC_MP4_DEMUXER_H
+#define AAC_MP4_DEMUXER_H
+
+// One raw data block, as stored in the file
+struct AacMp4AccessUnit
+{
+  const uint8_t *bytes;  // Within the buffer given to open()
+  uint32_t       size;
+  uint64_t       offset;
+};
+
+// Finds the AAC track of an ISO base media (MP4/M4A) file and walks its
+//  samples in decode order.
+// Nothing is copied: the sample tables are read where they lie in the buffer,
+//  and each access unit points at its bytes there, ready for an AacBitReader.
+//  The buffer must outlive the demuxer. Fragmented files (moof) aren't
+//  supported.
+class AacMp4Demuxer
+{
+  const uint8_t *m_bytes;
+  size_t         m_size;
+
+  AacAudioSpecificConfig m_config;
+
+  // Sample tables, big-endian as in the file
+  const uint8_t *m_sampleSizes;  // stsz entries, or NULL if every sample is m_fixedSampleSize
+  uint32_t       m_fixedSampleSize;
+  uint32_t       m_sampleCount;
+
+  const uint8_t *m_chunkOffsets;  // stco or co64 entries
+  unsigned int   m_chunkOffsetSize;  // 4 or 8 bytes per entry
+  uint32_t       m_chunkCount;
+
+  const uint8_t *m_sampleToChunk;  // stsc entries
+  uint32_t       m_sampleToChunkCount;
+
+  // Walk state
+  uint32_t       m_sample;  // Next sample to read
+  uint32_t       m_chunk;  // Next chunk to start
+  uint32_t       m_sampleToChunkEntry;  // stsc entry covering the current chunk
+  uint32_t       m_chunkSamplesLeft;  // Samples still to read from the current chunk
+  uint64_t       m_offset;  // Of the next sample
+
+  bool parseMovie(const uint8_t *bytes, size_t size);
+  bool parseTrack(const uint8_t *bytes, size_t size);
+  bool parseSampleDescription(const uint8_t *bytes, size_t size);
+  bool parseElementaryStreamDescriptor(const uint8_t *bytes, size_t size);
+
+  bool startChunk(void);
+
+public:
+  AacMp4Demuxer(void);
+
+  // True if the buffer starts with an ftyp box
+  static bool isMp4(const uint8_t *bytes, size_t size);
+
+  // Finds the first AAC track. Fails if there is none, or its tables don't
+  //  fit in the buffer.
+  bool open(const uint8_t *bytes, size_t size);
+
+  const AacAudioSpecificConfig *getConfig(void) { return &m_config; };
+
+  uint32_t                      getSampleCount(void) { return m_sampleCount; };  // Access units, not audio samples
+
+  bool                          isComplete(void) { return m_sample >= m_sampleCount; };
+
+  // Returns the next access unit. Fails if it lies outside the buffer.
+  bool                          readAccessUnit(AacMp4AccessUnit *unit);
+};
+
+#endif
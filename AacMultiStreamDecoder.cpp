@@ -0,0 +1,203 @@
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAudioBlock.h"
+#include "AacStructs.h"
+#include "AacChannelDecoder.h"
+#include "AacDecoder.h"
+#include "AacWindows.h"
+
+#include "AacMultiStreamDecoder.h"
+
+AacMultiStreamDecoder::AacMultiStreamDecoder(unsigned int streamCount)
+{
+  m_streamCount = streamCount;
+  m_streams = new Stream[m_streamCount];
+
+  for (unsigned int s = 0; s < m_streamCount; s++)
+  {
+    m_streams[s].decoder = NULL;
+    m_streams[s].isValid = false;
+  }
+
+  m_laneCount = 0;
+  m_laneSpec = new AacImdctLanes[AAC_SPECTRAL_SAMPLE_SIZE_LONG];
+  m_laneSamples = new AacImdctLanes[AAC_XFORM_WIN_SIZE_LONG];
+  m_laneScratch = new AacImdctLanes[AAC_IMDCT_LANES_SCRATCH_SIZE];
+
+  m_transformer = NULL;
+}
+
+AacMultiStreamDecoder::~AacMultiStreamDecoder(void)
+{
+  for (unsigned int s = 0; s < m_streamCount; s++)
+    delete m_streams[s].decoder;
+
+  delete [] m_streams;
+  delete [] m_laneSpec;
+  delete [] m_laneSamples;
+  delete [] m_laneScratch;
+
+  delete m_transformer;
+}
+
+void AacMultiStreamDecoder::resetStream(unsigned int stream)
+{
+  if (m_streams[stream].decoder)
+    m_streams[stream].decoder->reset();
+}
+
+// Runs the IMDCT and windowing for the channels waiting in m_lanes
+void AacMultiStreamDecoder::transformLanes(void)
+{
+  if (m_laneCount == 0)
+    return;
+
+  // Any unused lanes are transformed as silence and thrown away
+  for (unsigned int l = m_laneCount; l < AAC_IMDCT_LANE_COUNT; l++)
+  {
+    m_lanes[l].leftWindow = m_lanes[0].leftWindow;
+    m_lanes[l].rightWindow = m_lanes[0].rightWindow;
+  }
+
+  // Gather
+  for (unsigned int n = 0; n < AAC_SPECTRAL_SAMPLE_SIZE_LONG; n++)
+  {
+    for (unsigned int l = 0; l < AAC_IMDCT_LANE_COUNT; l++)
+      m_laneSpec[n][l] = (l < m_laneCount) ? m_lanes[l].spec[n] : 0.0;
+  }
+
+  AacImdctLongLanes(m_laneSpec, m_laneSamples, m_laneScratch);
+
+  // Windowing (§ 15.3.2), each lane with its own pair of windows
+  for (unsigned int n = 0; n < AAC_XFORM_HALFWIN_SIZE_LONG; n++)
+  {
+    AacImdctLanes left, right;
+
+    for (unsigned int l = 0; l < AAC_IMDCT_LANE_COUNT; l++)
+    {
+      left[l] = m_lanes[l].leftWindow[n];
+      right[l] = m_lanes[l].rightWindow[n];
+    }
+
+    m_laneSamples[n] *= left;
+    m_laneSamples[n + AAC_XFORM_HALFWIN_SIZE_LONG] *= right;
+  }
+
+  // Scatter
+  for (unsigned int l = 0; l < m_laneCount; l++)
+  {
+    double *samples = m_lanes[l].samples;
+
+    for (unsigned int n = 0; n < AAC_XFORM_WIN_SIZE_LONG; n++)
+      samples[n] = m_laneSamples[n][l];
+  }
+
+  m_laneCount = 0;
+}
+
+AacChannelDecoder *AacMultiStreamDecoder::getTransformer(unsigned int sampleRate)
+{
+  AacSampleRateIndex sampleRateIndex = AacConstants::getIndexBySampleRate(sampleRate);
+
+  if (!m_transformer || (m_transformer->getSampleRateIndex() != sampleRateIndex))
+  {
+    delete m_transformer;
+    m_transformer = new AacChannelDecoder(AAC_CHANNEL_FIRST, sampleRateIndex);
+  }
+
+  return m_transformer;
+}
+
+// Transforms the short-window channels of a stream straight away, and queues
+//  its long-window channels for transformLanes()
+void AacMultiStreamDecoder::transformStream(Stream *stream)
+{
+  AacSpectralBlock *block = &stream->block;
+  AacWindowedBlock *windowed = &stream->windowed;
+
+  stream->decoder->getWindowShapes(block, windowed);
+
+  AacChannelDecoder *transformer = getTransformer(block->sampleRate);
+
+  for (unsigned int ch = 0; ch < block->channelCount; ch++)
+  {
+    AacSpectralChannel *channel = &block->channels[ch];
+    AacWindowSequence sequence = channel->ics.windowSequence;
+
+    channel->info.ics = &channel->ics;
+
+    if (sequence == AAC_WINSEQ_8_SHORT)
+    {
+      if (!transformer->transform(&channel->info, windowed->previousWindowShapes[ch], channel->spec, windowed->samples[ch]))
+        stream->isValid = false;
+
+      continue;
+    }
+
+    if (!transformer->applyTns(&channel->info, channel->spec))
+    {
+      stream->isValid = false;
+      continue;
+    }
+
+    Lane *lane = &m_lanes[m_laneCount++];
+    lane->spec = channel->spec;
+    lane->samples = windowed->samples[ch];
+    lane->leftWindow = AacWindows::getLeftWindow(windowed->previousWindowShapes[ch], sequence);
+    lane->rightWindow = AacWindows::getRightWindow(channel->ics.windowShape, sequence);
+
+    if (m_laneCount == AAC_IMDCT_LANE_COUNT)
+      transformLanes();
+  }
+}
+
+unsigned int AacMultiStreamDecoder::decodeBlocks(AacAdtsFrame *frames[], AacAudioBlock audio[], bool isDecoded[])
+{
+  // Parse each stream on its own
+  for (unsigned int s = 0; s < m_streamCount; s++)
+  {
+    Stream *stream = &m_streams[s];
+
+    stream->isValid = false;
+
+    if (!frames[s])
+      continue;
+
+    unsigned int sampleRate = frames[s]->getHeader()->getSampleRate();
+
+    if (!stream->decoder)
+      stream->decoder = new AacDecoder(sampleRate);
+    else if (stream->decoder->getSampleRate() != sampleRate)
+      *stream->decoder = AacDecoder(sampleRate);
+
+    stream->isValid = stream->decoder->parseBlock(frames[s]->getReader(), &stream->block);
+  }
+
+  // Transform the channels of every stream together
+  for (unsigned int s = 0; s < m_streamCount; s++)
+  {
+    if (m_streams[s].isValid)
+      transformStream(&m_streams[s]);
+  }
+
+  transformLanes();
+
+  // Overlap each stream with its own history
+  unsigned int decodedCount = 0;
+
+  for (unsigned int s = 0; s < m_streamCount; s++)
+  {
+    Stream *stream = &m_streams[s];
+
+    if (stream->isValid)
+      stream->isValid = stream->decoder->overlapBlock(&stream->block, &stream->windowed, &audio[s]);
+
+    if (stream->isValid)
+      decodedCount++;
+
+    if (isDecoded)
+      isDecoded[s] = stream->isValid;
+  }
+
+  return decodedCount;
+}
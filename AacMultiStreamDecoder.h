@@ -0,0 +1,78 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AacStructs.h"
+#include "AacImdct.h"
+
+#ifndef AAC_MULTI_STREAM_DECODER_H
+#define AAC_MULTI_STREAM_DECODER_H
+
+class AacAdtsFrame;
+class AacAudioBlock;
+class AacChannelDecoder;
+class AacDecoder;
+
+// Decodes one frame from each of several independent streams at once. Every
+//  stream is parsed and overlapped by its own decoder, but the IMDCT and
+//  windowing of long-window channels are batched across all of the streams,
+//  AAC_IMDCT_LANE_COUNT channels at a time, with each channel in its own
+//  vector lane. Channels using eight short windows go through the ordinary
+//  per-channel transform instead.
+class AacMultiStreamDecoder
+{
+  struct Stream
+  {
+    AacDecoder       *decoder;
+    bool              isValid;  // False if this round's frame failed to decode
+    AacSpectralBlock  block;
+    AacWindowedBlock  windowed;
+  };
+
+  // A long-window channel waiting for a free lane
+  struct Lane
+  {
+    double       *spec;
+    double       *samples;
+    const double *leftWindow;
+    const double *rightWindow;
+  };
+
+  Stream        *m_streams;
+  unsigned int   m_streamCount;
+
+  Lane           m_lanes[AAC_IMDCT_LANE_COUNT];
+  unsigned int   m_laneCount;
+
+  AacImdctLanes *m_laneSpec;  // Structure-of-arrays buffers for m_lanes
+  AacImdctLanes *m_laneSamples;
+  AacImdctLanes *m_laneScratch;
+
+  // Only the tables for the sample rate are needed for the short windows and
+  //  TNS, as in AacDecoder::windowBlock(), so one decoder serves every
+  //  channel. It's replaced when a stream with another sample rate comes by.
+  AacChannelDecoder *m_transformer;
+
+  AacChannelDecoder *getTransformer(unsigned int sampleRate);
+
+  void transformStream(Stream *stream);
+  void transformLanes(void);
+
+public:
+  AacMultiStreamDecoder(unsigned int streamCount);
+  ~AacMultiStreamDecoder(void);
+
+  AacMultiStreamDecoder(const AacMultiStreamDecoder &) = delete;
+  AacMultiStreamDecoder &operator=(const AacMultiStreamDecoder &) = delete;
+
+  // Decodes frames[s] into audio[s] for each stream s. A NULL frame leaves
+  //  that stream out of this round. Returns the number of streams decoded;
+  //  if isDecoded is given, it is set to say which ones.
+  unsigned int decodeBlocks(AacAdtsFrame *frames[], AacAudioBlock audio[], bool isDecoded[] = NULL);
+
+  // Forgets the history of one stream, e.g. before starting a new file on it
+  void         resetStream(unsigned int stream);
+
+  unsigned int getStreamCount(void) { return m_streamCount; };
+};
+
+#endif
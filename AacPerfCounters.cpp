@@ -0,0 +1,211 @@
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <iterator>
+
+#include "AacPerfCounters.h"
+
+thread_local AacPerfCounters *AacPerfCounters::t_current = NULL;
+
+struct AacPerfEventConfig
+{
+  uint32_t    type;
+  uint64_t    config;
+  const char *name;
+};
+
+static const AacPerfEventConfig eventConfigs[] =
+{
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,   "cycles"},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+  {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), "L1D misses"},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, "branch misses"},
+};
+
+static_assert(std::size(eventConfigs) == AAC_PERF_EVENT_COUNT);
+
+// A group read: the event count, the times the group was enabled and
+//  actually counting, then a value for each event in the order opened
+struct AacPerfGroupRead
+{
+  uint64_t count;
+  uint64_t timeEnabled;
+  uint64_t timeRunning;
+  uint64_t values[AAC_PERF_EVENT_COUNT];
+};
+
+AacPerfCounters::AacPerfCounters(void)
+{
+  for (unsigned int i = 0; i < AAC_PERF_EVENT_COUNT; i++)
+  {
+    m_fds[i] = -1;
+    m_groupSlots[i] = 0;
+    m_last[i] = 0;
+  }
+
+  m_leaderFd = -1;
+  m_isMultiplexed = false;
+  m_error[0] = '\0';
+}
+
+AacPerfCounters::~AacPerfCounters(void)
+{
+  close();
+}
+
+static int readParanoidLevel(void)
+{
+  FILE *file = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+  if (!file)
+    return -100;  // Unknown
+
+  int level;
+  if (fscanf(file, "%d", &level) != 1)
+    level = -100;
+
+  fclose(file);
+  return level;
+}
+
+bool AacPerfCounters::open(void)
+{
+  close();
+
+  int firstErrno = 0;
+  unsigned int slot = 0;
+
+  for (unsigned int i = 0; i < AAC_PERF_EVENT_COUNT; i++)
+  {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size           = sizeof(attr);
+    attr.type           = eventConfigs[i].type;
+    attr.config         = eventConfigs[i].config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    // The first event to open leads the group, which is read as a whole
+    bool isLeader = (m_leaderFd < 0);
+    if (isLeader)
+    {
+      attr.disabled    = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    }
+
+    int fd = syscall(SYS_perf_event_open, &attr, 0, -1, m_leaderFd, 0);
+    if (fd < 0)
+    {
+      if (!firstErrno)
+        firstErrno = errno;
+
+      continue;
+    }
+
+    if (isLeader)
+      m_leaderFd = fd;
+
+    m_fds[i] = fd;
+    m_groupSlots[i] = slot++;
+  }
+
+  if (m_leaderFd < 0)
+  {
+    int level = readParanoidLevel();
+
+    if ((firstErrno == EACCES) || (firstErrno == EPERM))
+      snprintf(m_error, sizeof(m_error), "Not permitted with kernel.perf_event_paranoid at %d. It needs to be 2 or less, or the process needs CAP_PERFMON.", level);
+    else if ((firstErrno == ENOENT) || (firstErrno == EOPNOTSUPP) || (firstErrno == ENODEV))
+      snprintf(m_error, sizeof(m_error), "This CPU has no usable hardware counters (%s). Virtual machines often hide them.", strerror(firstErrno));
+    else if (firstErrno == ENOSYS)
+      snprintf(m_error, sizeof(m_error), "This kernel doesn't support perf_event_open().");
+    else
+      snprintf(m_error, sizeof(m_error), "perf_event_open(): %s", strerror(firstErrno));
+
+    return false;
+  }
+
+  ioctl(m_leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(m_leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+  return true;
+}
+
+void AacPerfCounters::close(void)
+{
+  stop();
+
+  // Members are closed before the leader
+  for (unsigned int i = AAC_PERF_EVENT_COUNT; i-- > 0; )
+  {
+    if (m_fds[i] >= 0)
+      ::close(m_fds[i]);
+
+    m_fds[i] = -1;
+  }
+
+  m_leaderFd = -1;
+}
+
+bool AacPerfCounters::read(uint64_t values[AAC_PERF_EVENT_COUNT])
+{
+  AacPerfGroupRead group;
+
+  ssize_t size = ::read(m_leaderFd, &group, sizeof(group));
+  if (size < static_cast<ssize_t>(offsetof(AacPerfGroupRead, values)))
+    return false;
+
+  if (static_cast<size_t>(size) < offsetof(AacPerfGroupRead, values) + (group.count * sizeof(uint64_t)))
+    return false;
+
+  if (group.timeRunning < group.timeEnabled)
+    m_isMultiplexed = true;
+
+  for (unsigned int i = 0; i < AAC_PERF_EVENT_COUNT; i++)
+    values[i] = (m_fds[i] >= 0) ? group.values[m_groupSlots[i]] : 0;
+
+  return true;
+}
+
+void AacPerfCounters::addDifference(uint64_t counts[AAC_PERF_EVENT_COUNT])
+{
+  uint64_t values[AAC_PERF_EVENT_COUNT];
+  if (!read(values))
+    return;
+
+  for (unsigned int i = 0; i < AAC_PERF_EVENT_COUNT; i++)
+  {
+    counts[i] += values[i] - m_last[i];
+    m_last[i] = values[i];
+  }
+}
+
+void AacPerfCounters::start(void)
+{
+  if (!isOpen())
+    return;
+
+  read(m_last);
+  t_current = this;
+}
+
+void AacPerfCounters::stop(void)
+{
+  if (t_current == this)
+    t_current = NULL;
+}
+
+const char *AacPerfCounters::getEventName(AacPerfEvent event)
+{
+  if (event >= AAC_PERF_EVENT_COUNT)
+    return NULL;  // Out of range
+
+  return eventConfigs[event].name;
+}
@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef AAC_PERF_COUNTERS_H
+#define AAC_PERF_COUNTERS_H
+
+enum AacPerfEvent
+{
+  AAC_PERF_CYCLES,
+  AAC_PERF_INSTRUCTIONS,
+  AAC_PERF_L1D_MISSES,      // L1 data cache read misses
+  AAC_PERF_BRANCH_MISSES,
+
+  AAC_PERF_EVENT_COUNT
+};
+
+// Hardware performance counters for the calling thread, read through one
+//  Linux perf_event_open() group so the events are counted over the same
+//  instructions. Only user-space work is counted, which any process may do
+//  to itself while kernel.perf_event_paranoid is 2 or less.
+//
+// While started, the AAC_STATS stage macros read the group at each stage
+//  boundary on this thread and add the differences to the stage's counts.
+//  Each read is a system call, so decoding slows down, but the kernel side
+//  of it isn't counted.
+class AacPerfCounters
+{
+  static thread_local AacPerfCounters *t_current;
+
+  int          m_fds[AAC_PERF_EVENT_COUNT];  // -1 where the event couldn't be opened
+  int          m_leaderFd;
+  unsigned int m_groupSlots[AAC_PERF_EVENT_COUNT];  // Position of each open event in a group read
+
+  uint64_t     m_last[AAC_PERF_EVENT_COUNT];
+  bool         m_isMultiplexed;  // The group didn't always fit on the PMU
+
+  char         m_error[160];
+
+  bool read(uint64_t values[AAC_PERF_EVENT_COUNT]);
+  void addDifference(uint64_t counts[AAC_PERF_EVENT_COUNT]);
+
+public:
+  AacPerfCounters(void);
+  ~AacPerfCounters(void);
+
+  AacPerfCounters(const AacPerfCounters &) = delete;
+  AacPerfCounters &operator=(const AacPerfCounters &) = delete;
+
+  // Opens whichever events the CPU and kernel allow. Fails only if none
+  //  could be opened, with getError() saying why.
+  bool open(void);
+  void close(void);
+
+  bool isOpen(void) { return m_leaderFd >= 0; };
+  bool isAvailable(AacPerfEvent event) const { return m_fds[event] >= 0; };
+  bool isMultiplexed(void) const { return m_isMultiplexed; };
+
+  const char *getError(void) const { return m_error; };
+
+  // Counting by the stage macros is per thread, from start() to stop()
+  void start(void);
+  void stop(void);
+
+  // Called by the AAC_STATS macros. mark() sets where the next lap starts,
+  //  and lap() adds the counts since then and moves the mark.
+  static inline void mark(void)
+  {
+    if (t_current)
+      t_current->read(t_current->m_last);
+  };
+
+  static inline void lap(uint64_t counts[AAC_PERF_EVENT_COUNT])
+  {
+    if (t_current)
+      t_current->addDifference(counts);
+  };
+
+  static const char *getEventName(AacPerfEvent event);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+
+#include "AacPipelinedDecoder.h"
+
+AacPipelinedDecoder::AacPipelinedDecoder(AacAdtsFrameReader *reader, bool isCrcChecked, unsigned int depth) : m_queue(depth)
+{
+  m_reader = reader;
+  m_decoder = NULL;
+  m_isCrcChecked = isCrcChecked;
+  m_crcErrorCount = 0;
+  m_position = 0;
+  m_skippedSize = 0;
+  m_finalSkippedSize = 0;
+
+  m_parseThread = std::thread(&AacPipelinedDecoder::parse, this);
+}
+
+AacPipelinedDecoder::~AacPipelinedDecoder(void)
+{
+  // Wakes the parse thread if it is waiting for a free slot
+  m_queue.close();
+
+  if (m_parseThread.joinable())
+    m_parseThread.join();
+
+  delete m_decoder;
+}
+
+// Runs on the parse thread
+void AacPipelinedDecoder::parse(void)
+{
+  AacDecoder *decoder = NULL;
+
+  size_t skippedSize = 0;
+
+  while (!m_reader->isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!m_reader->readFrame(&frame))
+    {
+      skippedSize += m_reader->findNextFrame();
+      continue;
+    }
+
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+    if (!decoder || (decoder->getSampleRate() != sampleRate))
+    {
+      delete decoder;
+      decoder = new AacDecoder(sampleRate);
+      decoder->setCrcCheck(m_isCrcChecked);
+    }
+
+    AacPipelineSlot *slot = m_queue.beginPush();
+    if (!slot)
+      break;  // The consumer has gone away
+
+    unsigned int crcErrorCount = decoder->getCrcErrorCount();
+
+    slot->position        = m_reader->getPosition();
+    slot->skippedSize     = skippedSize;
+    slot->isValid         = decoder->parseFrame(&frame, &slot->block);
+    slot->isCrcMismatched = (decoder->getCrcErrorCount() != crcErrorCount);
+
+    m_queue.commitPush();
+
+    m_reader->advance(frame.getSize());
+  }
+
+  delete decoder;
+
+  m_finalSkippedSize = skippedSize;
+
+  m_queue.close();
+}
+
+bool AacPipelinedDecoder::isComplete(void)
+{
+  // Waits until there is either another block or the end of the stream
+  if (m_queue.beginPop())
+    return false;
+
+  // The parse thread has finished, and closing the queue published this
+  m_skippedSize = m_finalSkippedSize;
+  return true;
+}
+
+bool AacPipelinedDecoder::decodeBlock(AacAudioBlock *audio)
+{
+  AacPipelineSlot *slot = m_queue.beginPop();
+  if (!slot)
+    return false;  // End of stream
+
+  m_position = slot->position;
+  m_skippedSize = slot->skippedSize;
+
+  if (slot->isCrcMismatched)
+    m_crcErrorCount++;
+
+  bool success = slot->isValid;
+  if (success)
+  {
+    // The transform decoder holds the overlap state, so it is only replaced
+    //  when the sample rate changes, as with a serial decode.
+    if (!m_decoder || (m_decoder->getSampleRate() != slot->block.sampleRate))
+    {
+      delete m_decoder;
+      m_decoder = new AacDecoder(slot->block.sampleRate);
+    }
+
+    success = m_decoder->transformBlock(&slot->block, audio);
+  }
+
+  m_queue.commitPop();
+
+  return success;
+}
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <thread>
+
+#include "AacStructs.h"
+#include "AacSpscQueue.h"
+
+#ifndef AAC_PIPELINED_DECODER_H
+#define AAC_PIPELINED_DECODER_H
+
+#define AAC_PIPELINE_DEFAULT_DEPTH 4
+
+class AacAdtsFrameReader;
+class AacAudioBlock;
+class AacDecoder;
+
+struct AacPipelineSlot
+{
+  bool             isValid;  // False if the block failed to parse
+  bool             isCrcMismatched;  // Whether that was down to its CRC
+  size_t           position;  // Offset of the frame within the input
+  size_t           skippedSize;  // Bytes passed over looking for frame headers, up to this frame
+  AacSpectralBlock block;
+};
+
+// Decodes a stream using two threads. A background thread walks the frames
+//  and does all of the bitstream parsing (side info, scalefactors and
+//  spectral data), while the caller's thread runs the IMDCT, windowing and
+//  overlap for the previous block.
+class AacPipelinedDecoder
+{
+  AacAdtsFrameReader            *m_reader;  // Owned by the parse thread once started
+
+  AacSpscQueue<AacPipelineSlot>  m_queue;
+
+  std::thread                    m_parseThread;
+
+  AacDecoder                    *m_decoder;  // Transform stage
+
+  bool                           m_isCrcChecked;  // Fixed before the parse thread starts
+  unsigned int                   m_crcErrorCount;
+
+  size_t                         m_position;
+  size_t                         m_skippedSize;
+  size_t                         m_finalSkippedSize;  // Written by the parse thread before it closes the queue
+
+  void parse(void);
+
+public:
+  // With isCrcChecked, frames are checked as by AacDecoder::setCrcCheck(), on
+  //  the parse thread, so a damaged frame is never transformed
+  AacPipelinedDecoder(AacAdtsFrameReader *reader, bool isCrcChecked = false, unsigned int depth = AAC_PIPELINE_DEFAULT_DEPTH);
+  ~AacPipelinedDecoder(void);
+
+  AacPipelinedDecoder(const AacPipelinedDecoder &) = delete;
+  AacPipelinedDecoder &operator=(const AacPipelinedDecoder &) = delete;
+
+  bool   isComplete(void);
+
+  bool   decodeBlock(AacAudioBlock *audio);
+
+  size_t getPosition(void) { return m_position; };  // Offset of the most recently decoded frame
+
+  // Bytes passed over looking for frame headers, up to the most recently
+  //  decoded frame, or once isComplete(), in the whole stream
+  size_t getSkippedSize(void) { return m_skippedSize; };
+
+  // Frames decoded so far that have failed the CRC check
+  unsigned int getCrcErrorCount(void) { return m_crcErrorCount; };
+};
+
+#endif
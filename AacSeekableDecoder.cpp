@@ -0,0 +1,126 @@
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsIndex.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+
+#include "AacSeekableDecoder.h"
+
+AacSeekableDecoder::AacSeekableDecoder(const uint8_t *bytes, const AacAdtsIndex *index)
+{
+  m_bytes = bytes;
+  m_index = index;
+
+  m_decoder = NULL;
+
+  m_frame = 0;
+  m_trimCount = 0;
+  m_position = 0;
+}
+
+AacSeekableDecoder::~AacSeekableDecoder(void)
+{
+  delete m_decoder;
+}
+
+// Starts over at a sample rate change, as a serial decode does
+AacDecoder *AacSeekableDecoder::getDecoder(unsigned int sampleRate)
+{
+  if (!m_decoder)
+    m_decoder = new AacDecoder(sampleRate);
+  else if (m_decoder->getSampleRate() != sampleRate)
+    *m_decoder = AacDecoder(sampleRate);
+
+  return m_decoder;
+}
+
+bool AacSeekableDecoder::decodeFrame(size_t frame, AacAudioBlock *audio)
+{
+  AacAdtsIndexEntry entry = m_index->getEntry(frame);
+
+  auto header = AacAdtsFrameHeader(m_bytes + entry.offset);
+
+  if (header.getDataBlockCount() != 1)
+    return false;  // Not supported
+
+  auto adtsFrame = AacAdtsFrame();
+  adtsFrame.setHeader(&header);
+
+  return getDecoder(header.getSampleRate())->decodeBlock(adtsFrame.getReader(), audio);
+}
+
+bool AacSeekableDecoder::seekToSample(uint64_t sample)
+{
+  size_t frame = m_index->findFrame(sample);
+  if (frame >= m_index->getFrameCount())
+    return false;
+
+  m_frame = frame;
+  m_trimCount = sample - m_index->getEntry(frame).sample;
+
+  if (m_decoder)
+    m_decoder->reset();
+
+  if (frame == 0)
+    return true;
+
+  // A serial decode starts from scratch at a sample rate change, so the
+  //  previous frame is only decoded if it's at the same rate
+  unsigned int sampleRate = AacAdtsFrameHeader(m_bytes + m_index->getEntry(frame).offset).getSampleRate();
+  unsigned int previousSampleRate = AacAdtsFrameHeader(m_bytes + m_index->getEntry(frame - 1).offset).getSampleRate();
+
+  if (sampleRate == previousSampleRate)
+  {
+    // The pre-roll output is discarded, successful or not
+    AacAudioBlock audio;
+    if (!decodeFrame(frame - 1, &audio) && m_decoder)
+      m_decoder->reset();
+  }
+
+  return true;
+}
+
+bool AacSeekableDecoder::isComplete(void)
+{
+  return m_frame >= m_index->getFrameCount();
+}
+
+bool AacSeekableDecoder::decodeBlock(AacAudioBlock *audio, unsigned int *startSample)
+{
+  if (isComplete())
+    return false;
+
+  m_position = m_index->getEntry(m_frame).offset;
+
+  *startSample = m_trimCount;
+  m_trimCount = 0;
+
+  return decodeFrame(m_frame++, audio);
+}
+
+bool AacSeekableDecoder::saveState(std::vector<uint8_t> *state, AacStatePrecision precision)
+{
+  if (isComplete())
+    return false;
+
+  unsigned int sampleRate = AacAdtsFrameHeader(m_bytes + m_index->getEntry(m_frame).offset).getSampleRate();
+
+  getDecoder(sampleRate)->saveState(state, precision);
+  return true;
+}
+
+bool AacSeekableDecoder::restoreState(size_t frame, const uint8_t *state, size_t size)
+{
+  if (frame >= m_index->getFrameCount())
+    return false;
+
+  unsigned int sampleRate = AacAdtsFrameHeader(m_bytes + m_index->getEntry(frame).offset).getSampleRate();
+
+  if (!getDecoder(sampleRate)->restoreState(state, size))
+    return false;
+
+  m_frame = frame;
+  m_trimCount = 0;
+
+  return true;
+}
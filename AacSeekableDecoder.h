@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "AacConstants.h"
+
+#ifndef AAC_SEEKABLE_DECODER_H
+#define AAC_SEEKABLE_DECODER_H
+
+class AacAdtsIndex;
+class AacAudioBlock;
+class AacDecoder;
+
+// Decodes an indexed ADTS buffer starting from any sample.
+// A seek positions one frame before the target and decodes that frame only
+//  to prime the overlap, so from the target onwards the output is identical
+//  to a serial decode of the whole stream. The first block after a seek is
+//  trimmed to start at the exact sample asked for.
+class AacSeekableDecoder
+{
+  const uint8_t      *m_bytes;
+  const AacAdtsIndex *m_index;
+
+  AacDecoder         *m_decoder;
+
+  size_t              m_frame;  // Next frame to decode
+  unsigned int        m_trimCount;  // Samples per channel to drop from the next block
+  size_t              m_position;
+
+  AacDecoder *getDecoder(unsigned int sampleRate);
+  bool decodeFrame(size_t frame, AacAudioBlock *audio);
+
+public:
+  // The index must have been built from the same bytes
+  AacSeekableDecoder(const uint8_t *bytes, const AacAdtsIndex *index);
+  ~AacSeekableDecoder(void);
+
+  AacSeekableDecoder(const AacSeekableDecoder &) = delete;
+  AacSeekableDecoder &operator=(const AacSeekableDecoder &) = delete;
+
+  // Returns false if the sample is past the end of the stream
+  bool   seekToSample(uint64_t sample);
+
+  bool   isComplete(void);
+
+  // startSample is set to the first sample per channel of the block to keep.
+  //  It is only non-zero for the first block after a seek.
+  bool   decodeBlock(AacAudioBlock *audio, unsigned int *startSample);
+
+  size_t getPosition(void) { return m_position; };  // Offset of the most recently decoded frame
+
+  size_t getNextFrame(void) { return m_frame; };
+
+  // A checkpoint of the decoder ahead of getNextFrame(). Restoring it there
+  //  resumes with no pre-roll, so seek points can keep one each, and a
+  //  stream can move to another process mid-way. Saving fails at the end of
+  //  the stream. Restoring fails past the end or with a checkpoint from a
+  //  stream at another sample rate, after which only seekToSample() will do.
+  bool   saveState(std::vector<uint8_t> *state, AacStatePrecision precision = AAC_STATE_FLOAT64);
+  bool   restoreState(size_t frame, const uint8_t *state, size_t size);
+};
+
+#endif
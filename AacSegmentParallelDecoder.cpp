@@ -0,0 +1,221 @@
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+#include "AacThreadPool.h"
+
+#include "AacSegmentParallelDecoder.h"
+
+// Segments decoded ahead of the caller, per pool thread
+#define AAC_SEGMENT_IN_FLIGHT_PER_THREAD 2
+
+AacSegmentParallelDecoder::AacSegmentParallelDecoder(AacAdtsFrameReader *reader, AacThreadPool *pool, unsigned int framesPerSegment, std::endian endianness)
+{
+  m_pool = pool;
+  m_endianness = endianness;
+
+  m_segments = NULL;
+  m_segmentCount = 0;
+
+  split(reader, std::max(1U, framesPerSegment));
+
+  m_nextSubmit = 0;
+  m_nextReturn = 0;
+  m_maxInFlight = pool->getThreadCount() * AAC_SEGMENT_IN_FLIGHT_PER_THREAD;
+
+  submit();
+}
+
+AacSegmentParallelDecoder::~AacSegmentParallelDecoder(void)
+{
+  // The pool may still be decoding segments we own
+  for (unsigned int s = m_nextReturn; s < m_nextSubmit; s++)
+    m_segments[s].isDone.wait(false, std::memory_order_acquire);
+
+  delete [] m_segments;
+}
+
+// Finds the segment boundaries with a header-only walk of the stream. This
+//  follows the same path through the input as a serial decode does,
+//  including resyncing after damage.
+void AacSegmentParallelDecoder::split(AacAdtsFrameReader *reader, unsigned int framesPerSegment)
+{
+  struct Boundary { size_t prerollPosition; size_t startPosition; };
+  std::vector<Boundary> boundaries;
+
+  AacAdtsFrameReader walker = *reader;
+
+  m_bytes = walker.getBytes();
+  m_size  = walker.getSize();
+
+  size_t       firstPosition = walker.getPosition();
+  size_t       previousPosition = AAC_SEGMENT_NO_PREROLL;
+  unsigned int previousSampleRate = 0;
+  unsigned int frameCount = 0;
+
+  while (!walker.isComplete())
+  {
+    // Only header fields are needed. Frames a serial decode would pass over,
+    //  being cut short, too short, or of more than one raw data block, are
+    //  passed over here too, so none becomes a boundary or a pre-roll.
+    AacAdtsFrameHeader header;
+    bool isValid = walker.readFrameHeader(&header);
+    size_t frameSize = isValid ? header.getFrameSize() : 0;
+    if (!isValid || (frameSize < AAC_ADTS_FRAME_HEADER_SIZE + (header.hasCrcProtection() ? 2 : 0)) || (frameSize > walker.getRemainingSize()) ||
+        (header.getDataBlockCount() != 1))
+    {
+      walker.findNextFrame();
+      continue;
+    }
+
+    size_t position = walker.getPosition();
+    unsigned int sampleRate = header.getSampleRate();
+
+    if ((frameCount % framesPerSegment) == 0)
+    {
+      // A serial decode starts from scratch at a sample rate change, so a
+      //  pre-roll frame would only be wrong there.
+      // The first segment takes in anything skipped before its first frame.
+      size_t preroll = (sampleRate == previousSampleRate) ? previousPosition : AAC_SEGMENT_NO_PREROLL;
+      boundaries.push_back({preroll, boundaries.empty() ? firstPosition : position});
+    }
+
+    previousPosition = position;
+    previousSampleRate = sampleRate;
+    frameCount++;
+
+    walker.advance(frameSize);
+  }
+
+  m_segmentCount = boundaries.size();
+  m_segments = new AacDecodedSegment[m_segmentCount];
+
+  for (unsigned int s = 0; s < m_segmentCount; s++)
+  {
+    AacDecodedSegment *segment = &m_segments[s];
+
+    segment->prerollPosition = boundaries[s].prerollPosition;
+    segment->startPosition   = boundaries[s].startPosition;
+    segment->endPosition     = (s + 1 < m_segmentCount) ? boundaries[s + 1].startPosition : walker.getPosition();
+
+    segment->isValid = true;
+    segment->failedPosition = 0;
+    segment->sampleRate = 0;
+    segment->channelCount = 0;
+    segment->isDone.store(false, std::memory_order_relaxed);
+  }
+}
+
+// Keeps up to m_maxInFlight segments queued or decoding
+void AacSegmentParallelDecoder::submit(void)
+{
+  while ((m_nextSubmit < m_segmentCount) && (m_nextSubmit - m_nextReturn < m_maxInFlight))
+  {
+    AacDecodedSegment *segment = &m_segments[m_nextSubmit++];
+
+    m_pool->submit([this, segment] (unsigned int)
+    {
+      decodeSegment(segment);
+
+      segment->isDone.store(true, std::memory_order_release);
+      segment->isDone.notify_one();
+    });
+  }
+}
+
+// Runs on a pool thread
+void AacSegmentParallelDecoder::decodeSegment(AacDecodedSegment *segment)
+{
+  auto reader = AacAdtsFrameReader(m_bytes, m_size);
+
+  bool hasPreroll = (segment->prerollPosition != AAC_SEGMENT_NO_PREROLL);
+  reader.advance(hasPreroll ? segment->prerollPosition : segment->startPosition);
+
+  AacDecoder *decoder = NULL;
+  AacAudioBlock audio;
+
+  size_t skippedSize = 0;
+
+  while (!reader.isComplete() && (reader.getPosition() < segment->endPosition))
+  {
+    auto frame = AacAdtsFrame();
+    if (!reader.readFrame(&frame))
+    {
+      // Anything skipped after the pre-roll frame belongs to the segment before
+      bool isKept = (reader.getPosition() >= segment->startPosition);
+
+      size_t skipped = reader.findNextFrame();
+      if (isKept)
+        skippedSize += skipped;
+
+      continue;
+    }
+
+    if (skippedSize)
+    {
+      segment->skippedSizes.push_back(skippedSize);
+      skippedSize = 0;
+    }
+
+    size_t position = reader.getPosition();
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+
+    if (!decoder || (decoder->getSampleRate() != sampleRate))
+    {
+      delete decoder;
+      decoder = new AacDecoder(sampleRate);
+    }
+
+    bool success = decoder->decodeBlock(frame.getReader(), &audio);
+
+    reader.advance(frame.getSize());
+
+    if (position < segment->startPosition)
+      continue;  // Pre-roll output is discarded, successful or not
+
+    if (!success)
+    {
+      segment->isValid = false;
+      segment->failedPosition = position;
+      break;
+    }
+
+    if (segment->channelCount == 0)
+    {
+      segment->sampleRate = audio.getSampleRate();
+      segment->channelCount = audio.getChannelCount();
+    }
+
+    audio.switchEndianness(m_endianness);
+
+    const int16_t *samples = audio.getSamples();
+    segment->samples.insert(segment->samples.end(), samples, samples + audio.getSampleCount());
+  }
+
+  if (skippedSize)
+    segment->skippedSizes.push_back(skippedSize);
+
+  delete decoder;
+}
+
+const AacDecodedSegment *AacSegmentParallelDecoder::nextSegment(void)
+{
+  // Release the previous segment's output
+  if (m_nextReturn > 0)
+    std::vector<int16_t>().swap(m_segments[m_nextReturn - 1].samples);
+
+  if (m_nextReturn >= m_segmentCount)
+    return NULL;
+
+  AacDecodedSegment *segment = &m_segments[m_nextReturn++];
+
+  // Top up the pool before we block, so it never runs dry
+  submit();
+
+  segment->isDone.wait(false, std::memory_order_acquire);
+
+  return segment;
+}
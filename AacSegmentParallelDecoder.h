@@ -0,0 +1,81 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <bit>
+#include <vector>
+
+#ifndef AAC_SEGMENT_PARALLEL_DECODER_H
+#define AAC_SEGMENT_PARALLEL_DECODER_H
+
+#define AAC_SEGMENT_DEFAULT_FRAME_COUNT 1024
+
+// Marks a segment with no pre-roll frame
+#define AAC_SEGMENT_NO_PREROLL SIZE_MAX
+
+class AacAdtsFrameReader;
+class AacThreadPool;
+
+struct AacDecodedSegment
+{
+  size_t               prerollPosition;  // Frame decoded only to prime the overlap, or AAC_SEGMENT_NO_PREROLL
+  size_t               startPosition;  // First frame whose output is kept, or for the first segment, the start of the input
+  size_t               endPosition;  // Just past the last frame
+
+  bool                 isValid;  // False if a frame failed to decode
+  size_t               failedPosition;  // Offset of the frame that failed
+
+  std::vector<size_t>  skippedSizes;  // Bytes passed over looking for each frame header found, in order
+
+  unsigned int         sampleRate;  // Of the first decoded block
+  unsigned int         channelCount;
+  std::vector<int16_t> samples;  // Interleaved output of every block, in order
+
+  std::atomic<bool>    isDone;
+};
+
+// Decodes a whole ADTS stream by splitting it into segments at frame
+//  boundaries and decoding the segments concurrently, each with its own
+//  AacDecoder. The only state carried between blocks is one block's worth of
+//  overlap, so each segment first decodes the frame before it and throws the
+//  result away. The concatenated output is identical to a serial decode.
+// Segments are handed back in order. Only a limited number are decoded ahead
+//  of the caller, which bounds memory use on large inputs.
+class AacSegmentParallelDecoder
+{
+  const uint8_t     *m_bytes;
+  size_t             m_size;
+
+  AacThreadPool     *m_pool;
+
+  std::endian        m_endianness;
+
+  AacDecodedSegment *m_segments;
+  unsigned int       m_segmentCount;
+
+  unsigned int       m_nextSubmit;  // Next segment to hand to the pool
+  unsigned int       m_nextReturn;  // Next segment to hand to the caller
+  unsigned int       m_maxInFlight;
+
+  void split(AacAdtsFrameReader *reader, unsigned int framesPerSegment);
+  void submit(void);
+  void decodeSegment(AacDecodedSegment *segment);
+
+public:
+  // The reader should already be positioned at the first frame
+  AacSegmentParallelDecoder(AacAdtsFrameReader *reader, AacThreadPool *pool, unsigned int framesPerSegment = AAC_SEGMENT_DEFAULT_FRAME_COUNT, std::endian endianness = std::endian::native);
+  ~AacSegmentParallelDecoder(void);
+
+  AacSegmentParallelDecoder(const AacSegmentParallelDecoder &) = delete;
+  AacSegmentParallelDecoder &operator=(const AacSegmentParallelDecoder &) = delete;
+
+  unsigned int getSegmentCount(void) { return m_segmentCount; };
+
+  bool isComplete(void) { return m_nextReturn >= m_segmentCount; };
+
+  // Waits for the next segment in order. The previous segment's samples are
+  //  released. Returns NULL after the last segment.
+  const AacDecodedSegment *nextSegment(void);
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#ifndef AAC_SPSC_QUEUE_H
+#define AAC_SPSC_QUEUE_H
+
+#define AAC_CACHE_LINE_SIZE 64
+
+// A bounded single-producer/single-consumer ring of preallocated slots.
+// Slots are filled and drained in place, so nothing is copied through the
+//  queue. The indexes are plain atomics; a thread only sleeps (via
+//  std::atomic::wait()) when the ring is full or empty.
+template <typename T>
+class AacSpscQueue
+{
+  T            *m_slots;
+  size_t        m_mask;  // Capacity is a power of two
+
+  alignas(AAC_CACHE_LINE_SIZE) std::atomic<size_t>   m_head;  // Next slot to push, written by the producer
+  alignas(AAC_CACHE_LINE_SIZE) std::atomic<size_t>   m_tail;  // Next slot to pop, written by the consumer
+
+  // Bumped on every state change, so either side can sleep on it
+  alignas(AAC_CACHE_LINE_SIZE) std::atomic<uint32_t> m_events;
+  std::atomic<bool>                                  m_closed;
+
+  void signal(void) { m_events.fetch_add(1, std::memory_order_release); m_events.notify_all(); };
+
+public:
+  AacSpscQueue(size_t capacity) : m_head(0), m_tail(0), m_events(0), m_closed(false)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    m_slots = new T[size];
+    m_mask = size - 1;
+  };
+
+  ~AacSpscQueue(void) { delete [] m_slots; };
+
+  AacSpscQueue(const AacSpscQueue &) = delete;
+  AacSpscQueue &operator=(const AacSpscQueue &) = delete;
+
+  size_t getCapacity(void) { return m_mask + 1; };
+
+  // Producer: returns the next free slot, waiting for one if the ring is
+  //  full. Returns NULL once the queue is closed.
+  T *beginPush(void)
+  {
+    while (true)
+    {
+      uint32_t events = m_events.load(std::memory_order_acquire);
+
+      if (m_closed.load(std::memory_order_acquire))
+        return NULL;
+
+      size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) <= m_mask)
+        return &m_slots[head & m_mask];
+
+      m_events.wait(events, std::memory_order_acquire);
+    }
+  };
+
+  // Producer: publishes the slot returned by beginPush()
+  void commitPush(void) { m_head.fetch_add(1, std::memory_order_release); signal(); };
+
+  // Consumer: returns the oldest filled slot, waiting for one if the ring is
+  //  empty. Returns NULL once the queue is closed and drained.
+  T *beginPop(void)
+  {
+    while (true)
+    {
+      uint32_t events = m_events.load(std::memory_order_acquire);
+
+      bool closed = m_closed.load(std::memory_order_acquire);
+
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (m_head.load(std::memory_order_acquire) != tail)
+        return &m_slots[tail & m_mask];
+
+      if (closed)
+        return NULL;
+
+      m_events.wait(events, std::memory_order_acquire);
+    }
+  };
+
+  // Consumer: releases the slot returned by beginPop()
+  void commitPop(void) { m_tail.fetch_add(1, std::memory_order_release); signal(); };
+
+  // Either side: no further slots will be pushed. Anything already pushed
+  //  can still be popped.
+  void close(void) { m_closed.store(true, std::memory_order_release); signal(); };
+
+  bool isClosed(void) { return m_closed.load(std::memory_order_acquire); };
+};
+
+#endif
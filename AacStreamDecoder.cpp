@@ -0,0 +1,254 @@
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+
+#include "AacStreamDecoder.h"
+
+AacStreamDecoder::AacStreamDecoder(void)
+{
+  m_decoder = NULL;
+
+  m_chunk = NULL;
+  m_chunkSize = 0;
+  m_chunkPosition = 0;
+  m_chunkOffset = 0;
+
+  m_partialSize = 0;
+  m_partialOffset = 0;
+
+  m_discardSize = 0;
+  m_isAtStart = true;
+
+  m_position = 0;
+  m_skippedSize = 0;
+
+  m_isCrcChecked = false;
+
+  m_traceLevel = AAC_TRACE_OFF;
+  m_traceCategories = AAC_TRACE_ALL_CATEGORIES;
+}
+
+AacStreamDecoder::~AacStreamDecoder(void)
+{
+  delete m_decoder;
+}
+
+void AacStreamDecoder::feed(const uint8_t *bytes, size_t size)
+{
+  assert(m_chunkPosition == m_chunkSize);  // The previous chunk must be used up
+
+  m_chunkOffset += m_chunkSize;
+
+  m_chunk = bytes;
+  m_chunkSize = size;
+  m_chunkPosition = 0;
+}
+
+// Returns the size of the frame whose header is at bytes, or zero if it
+//  doesn't look like a usable frame header
+size_t AacStreamDecoder::getFrameSize(const uint8_t *bytes)
+{
+  if (!AacAdtsFrameHeader::isFrameHeader(bytes))
+    return 0;
+
+  auto header = AacAdtsFrameHeader(bytes);
+
+  size_t frameSize = header.getFrameSize();
+  if (frameSize <= AAC_ADTS_FRAME_HEADER_SIZE + (header.hasCrcProtection() ? 2 : 0))
+    return 0;  // No room for a payload
+
+  return frameSize;
+}
+
+// Moves bytes from the chunk onto the held partial frame until it is at
+//  least size bytes long. Returns false if the chunk ran out first.
+bool AacStreamDecoder::fillPartial(size_t size)
+{
+  if (m_partialSize < size)
+  {
+    size_t count = std::min(size - m_partialSize, m_chunkSize - m_chunkPosition);
+
+    memcpy(m_partial + m_partialSize, m_chunk + m_chunkPosition, count);
+    m_partialSize += count;
+    m_chunkPosition += count;
+  }
+
+  return (m_partialSize >= size);
+}
+
+// Removes bytes from the front of the held partial frame
+void AacStreamDecoder::dropPartial(size_t size)
+{
+  m_partialSize -= size;
+  m_partialOffset += size;
+
+  memmove(m_partial, m_partial + size, m_partialSize);
+}
+
+// An ID3v2 tag may come before the first frame. Returns false if more input
+//  is needed to tell.
+bool AacStreamDecoder::skipID3(void)
+{
+  size_t available = m_chunkSize - m_chunkPosition;
+
+  if ((m_partialSize == 0) && (available >= ID3_HEADER_SIZE))
+  {
+    // Look in place
+    m_discardSize = AacAdtsFrameReader::getID3Size(m_chunk + m_chunkPosition, available);
+  }
+  else
+  {
+    // The chunks are tiny, so gather up the tag header first
+    if (!fillPartial(ID3_HEADER_SIZE))
+      return false;
+
+    if (size_t tagSize = AacAdtsFrameReader::getID3Size(m_partial, m_partialSize))
+    {
+      dropPartial(ID3_HEADER_SIZE);
+      m_discardSize = tagSize - ID3_HEADER_SIZE;
+    }
+  }
+
+  m_isAtStart = false;
+  return true;
+}
+
+AacStreamStatus AacStreamDecoder::decodeFrame(const uint8_t *bytes, AacAudioBlock *audio)
+{
+  auto header = AacAdtsFrameHeader(bytes);
+
+  if (header.getDataBlockCount() != 1)
+    return AAC_STREAM_FAILED;  // Not supported
+
+  auto frame = AacAdtsFrame();
+  frame.setHeader(&header);
+
+  unsigned int sampleRate = header.getSampleRate();
+
+  if (!m_decoder)
+    m_decoder = new AacDecoder(sampleRate);
+  else if (m_decoder->getSampleRate() != sampleRate)
+    *m_decoder = AacDecoder(sampleRate);
+
+  m_decoder->setCrcCheck(m_isCrcChecked);
+  m_decoder->setTrace(m_traceLevel, m_traceCategories);
+
+  unsigned int crcErrorCount = m_decoder->getCrcErrorCount();
+
+  m_decoder->setStatsPosition(m_position);
+
+  if (!m_decoder->decodeFrame(&frame, audio))
+    return (m_decoder->getCrcErrorCount() != crcErrorCount) ? AAC_STREAM_CRC_ERROR : AAC_STREAM_FAILED;
+
+  return AAC_STREAM_BLOCK;
+}
+
+AacStreamStatus AacStreamDecoder::decodeBlock(AacAudioBlock *audio)
+{
+  while (true)
+  {
+    // Pass over the rest of anything being skipped
+    if (m_discardSize > 0)
+    {
+      size_t count = std::min(m_discardSize, m_chunkSize - m_chunkPosition);
+      m_chunkPosition += count;
+      m_discardSize -= count;
+
+      if (m_discardSize > 0)
+        return AAC_STREAM_NEED_INPUT;
+
+      continue;
+    }
+
+    if (m_isAtStart)
+    {
+      if (!skipID3())
+        return AAC_STREAM_NEED_INPUT;
+
+      continue;
+    }
+
+    if (m_partialSize > 0)
+    {
+      // Complete the frame held back from earlier chunks
+      if (!fillPartial(AAC_ADTS_FRAME_HEADER_SIZE))
+        return AAC_STREAM_NEED_INPUT;
+
+      size_t frameSize = getFrameSize(m_partial);
+      if (frameSize == 0)
+      {
+        // Not a frame after all, so look for the next syncword
+        auto found = static_cast<const uint8_t *>(memchr(m_partial + 1, 0xFF, m_partialSize - 1));
+        size_t count = found ? (found - m_partial) : m_partialSize;
+
+        dropPartial(count);
+        m_skippedSize += count;
+        continue;
+      }
+
+      if (!fillPartial(frameSize))
+        return AAC_STREAM_NEED_INPUT;
+
+      m_position = m_partialOffset;
+
+      AacStreamStatus status = decodeFrame(m_partial, audio);
+      dropPartial(frameSize);
+      return status;
+    }
+
+    size_t available = m_chunkSize - m_chunkPosition;
+    if (available == 0)
+      return AAC_STREAM_NEED_INPUT;
+
+    const uint8_t *bytes = m_chunk + m_chunkPosition;
+
+    // Scan for first byte of syncword
+    if (bytes[0] != 0xFF)
+    {
+      auto found = static_cast<const uint8_t *>(memchr(bytes, 0xFF, available));
+      size_t count = found ? (found - bytes) : available;
+
+      m_chunkPosition += count;
+      m_skippedSize += count;
+      continue;
+    }
+
+    size_t frameSize = 0;
+    if (available >= AAC_ADTS_FRAME_HEADER_SIZE)
+    {
+      frameSize = getFrameSize(bytes);
+      if (frameSize == 0)
+      {
+        m_chunkPosition++;
+        m_skippedSize++;
+        continue;
+      }
+    }
+
+    if ((frameSize == 0) || (available < frameSize))
+    {
+      // The frame runs past the end of the chunk, so hold on to its start
+      m_partialOffset = m_chunkOffset + m_chunkPosition;
+      fillPartial(available);
+      return AAC_STREAM_NEED_INPUT;
+    }
+
+    // Decode the frame in place
+    m_position = m_chunkOffset + m_chunkPosition;
+    m_chunkPosition += frameSize;
+
+    return decodeFrame(bytes, audio);
+  }
+}
+
+const AacDecoderStats *AacStreamDecoder::getStats(void)
+{
+  return m_decoder ? m_decoder->getStats() : NULL;
+}
@@ -0,0 +1,86 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacTrace.h"
+
+#ifndef AAC_STREAM_DECODER_H
+#define AAC_STREAM_DECODER_H
+
+class AacAudioBlock;
+class AacDecoder;
+
+struct AacDecoderStats;
+
+enum AacStreamStatus
+{
+  AAC_STREAM_BLOCK,       // A block was decoded
+  AAC_STREAM_NEED_INPUT,  // Everything fed so far has been used
+  AAC_STREAM_FAILED,      // A frame failed to decode. It has been skipped.
+  AAC_STREAM_CRC_ERROR,   // A frame failed its CRC check. It has been skipped.
+};
+
+// Decodes an ADTS stream that arrives in arbitrary pieces, such as from a
+//  pipe or socket, rather than as one buffer. Frames lying entirely within a
+//  chunk are decoded where they are. Only a frame that straddles two chunks
+//  is copied, so the decoder never holds more than one partial frame.
+//
+// Usage: feed() a chunk, then call decodeBlock() until it returns
+//  AAC_STREAM_NEED_INPUT. The chunk must stay valid until then.
+class AacStreamDecoder
+{
+  AacDecoder    *m_decoder;
+
+  const uint8_t *m_chunk;
+  size_t         m_chunkSize;
+  size_t         m_chunkPosition;
+  size_t         m_chunkOffset;  // Offset of the chunk within the stream
+
+  uint8_t        m_partial[AAC_ADTS_MAX_FRAME_SIZE];  // Start of a frame from earlier chunks
+  size_t         m_partialSize;
+  size_t         m_partialOffset;  // Offset of m_partial[0] within the stream
+
+  size_t         m_discardSize;  // Bytes still to skip over, e.g. the rest of an ID3 tag
+  bool           m_isAtStart;
+
+  size_t         m_position;
+  size_t         m_skippedSize;
+
+  bool           m_isCrcChecked;
+
+  AacTraceLevel  m_traceLevel;
+  unsigned int   m_traceCategories;
+
+  static size_t   getFrameSize(const uint8_t *bytes);
+
+  bool            fillPartial(size_t size);
+  void            dropPartial(size_t size);
+  bool            skipID3(void);
+  AacStreamStatus decodeFrame(const uint8_t *bytes, AacAudioBlock *audio);
+
+public:
+  AacStreamDecoder(void);
+  ~AacStreamDecoder(void);
+
+  AacStreamDecoder(const AacStreamDecoder &) = delete;
+  AacStreamDecoder &operator=(const AacStreamDecoder &) = delete;
+
+  void            feed(const uint8_t *bytes, size_t size);
+
+  // Check the CRC of frames that carry one
+  void            setCrcCheck(bool isCrcChecked) { m_isCrcChecked = isCrcChecked; };
+
+  // As AacDecoder::setTrace()
+  void            setTrace(AacTraceLevel level, unsigned int categories = AAC_TRACE_ALL_CATEGORIES) { m_traceLevel = level; m_traceCategories = categories; };
+
+  AacStreamStatus decodeBlock(AacAudioBlock *audio);
+
+  size_t          getPosition(void) { return m_position; };  // Offset of the most recently decoded frame
+  size_t          getSkippedSize(void) { return m_skippedSize; };  // Bytes passed over looking for frame headers
+  size_t          getBufferedSize(void) { return m_partialSize; };  // Bytes of an incomplete frame held back
+
+  // NULL until the first frame has been decoded
+  const AacDecoderStats *getStats(void);
+};
+
+#endif
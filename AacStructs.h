@@ -137,4 +137,52 @@ struct AacDecodeInfo
   AacTnsInfo          tns;
 };
 
+// Enough for a 7.1 channel configuration
+#define AAC_MAX_BLOCK_CHANNELS 8
+
+// One channel of a parsed raw data block, with joint stereo already applied.
+struct AacSpectralChannel
+{
+  AacElementId        elementId;  // AAC_ID_SCE or AAC_ID_CPE
+  uint8_t             instance;
+  uint8_t             elementChannel;  // Index of this channel within its element
+
+  AacIcsInfo          ics;
+  AacDecodeInfo       info;  // NOTE: info.ics points at ics above
+
+  uint64_t            elementTicks;  // With AAC_STATS, time spent parsing the element, on its first channel only
+
+  double              spec[AAC_SPECTRAL_SAMPLE_SIZE_LONG];  // Spectral samples
+};
+
+// Bits of a raw data block covered by an ADTS CRC: the first protectedBits
+//  bits from start, where any past the end of the element count as zeroes.
+struct AacCrcRegion
+{
+  uint32_t            start;  // Bit position within the raw data block
+  uint32_t            bitCount;  // Bits of the element actually covered
+  uint32_t            protectedBits;
+};
+
+// A raw data block after bitstream parsing, but before the IMDCT. Channels
+//  belonging to a CPE are stored next to each other.
+struct AacSpectralBlock
+{
+  unsigned int        sampleRate;
+  unsigned int        channelCount;
+
+  AacSpectralChannel  channels[AAC_MAX_BLOCK_CHANNELS];
+
+  // One region for each channel, in the order they are added to the CRC
+  AacCrcRegion        crcRegions[AAC_MAX_BLOCK_CHANNELS];
+  unsigned int        crcRegionCount;
+};
+
+// The windowed (but not yet overlapped) output of each channel of a block.
+struct AacWindowedBlock
+{
+  AacWindowShape      previousWindowShapes[AAC_MAX_BLOCK_CHANNELS];  // Shape each channel ended the previous block with
+  double              samples[AAC_MAX_BLOCK_CHANNELS][AAC_XFORM_WIN_SIZE_LONG];
+};
+
 #endif
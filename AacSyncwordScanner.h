@@ -0,0 +1,64 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <bit>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifndef AAC_SYNCWORD_SCANNER_H
+#define AAC_SYNCWORD_SCANNER_H
+
+// Calls accept() on each possible syncword in bytes[start, end), in order,
+//  until it returns true. Returns the offset it accepted, or end if none.
+// A syncword is a first byte, then a second whose top bits are all set:
+//  0xFF 0xFx for ADTS, or 0x56 0xEx for LOAS.
+// Candidates are found 64 bytes at a time, as a bitmask of positions.
+template <typename F>
+static size_t scanSyncwords(const uint8_t *bytes, size_t start, size_t end, uint8_t firstByte, uint8_t secondMask, F accept)
+{
+  size_t position = start;
+
+#if defined(__SSE2__)
+  const __m128i first  = _mm_set1_epi8(static_cast<char>(firstByte));
+  const __m128i second = _mm_set1_epi8(static_cast<char>(secondMask));
+
+  // Each stride also looks at the byte after it
+  while (position + 65 <= end)
+  {
+    uint64_t mask = 0;
+
+    for (unsigned int k = 0; k < 4; k++)
+    {
+      __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + position + (k * 16)));
+      __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + position + (k * 16) + 1));
+
+      __m128i match = _mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(_mm_and_si128(b, second), second));
+
+      mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(match))) << (k * 16);
+    }
+
+    while (mask)
+    {
+      size_t candidate = position + std::countr_zero(mask);
+      if (accept(candidate))
+        return candidate;
+
+      mask &= mask - 1;
+    }
+
+    position += 64;
+  }
+#endif
+
+  for (; position + 1 < end; position++)
+  {
+    if ((bytes[position] == firstByte) && ((bytes[position + 1] & secondMask) == secondMask) && accept(position))
+      return position;
+  }
+
+  return end;
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <algorithm>
+
+#include "AacThreadPool.h"
+
+// Lets tasks that submit more work push onto their own deque
+static thread_local AacThreadPool *currentPool = NULL;
+static thread_local unsigned int   currentWorker = 0;
+
+AacThreadPool::AacThreadPool(unsigned int threadCount) : m_queuedCount(0), m_pendingCount(0), m_nextWorker(0), m_isStopping(false)
+{
+  if (threadCount == 0)
+    threadCount = std::max(1U, std::thread::hardware_concurrency());
+
+  for (unsigned int w = 0; w < threadCount; w++)
+    m_workers.push_back(new Worker);
+
+  // Only start the threads once every deque exists, since they steal
+  for (unsigned int w = 0; w < threadCount; w++)
+    m_workers[w]->thread = std::thread(&AacThreadPool::run, this, w);
+}
+
+AacThreadPool::~AacThreadPool(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isStopping = true;
+  }
+  m_wakeCondition.notify_all();
+
+  for (auto worker : m_workers)
+  {
+    worker->thread.join();
+    delete worker;
+  }
+}
+
+void AacThreadPool::submit(Task task)
+{
+  unsigned int w;
+  if (currentPool == this)
+    w = currentWorker;
+  else
+    w = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+  m_pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+  {
+    std::lock_guard<std::mutex> lock(m_workers[w]->mutex);
+    m_workers[w]->tasks.push_back(std::move(task));
+  }
+
+  m_queuedCount.fetch_add(1, std::memory_order_release);
+
+  // Taking the lock orders us against a worker that is about to sleep
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+  }
+  m_wakeCondition.notify_one();
+}
+
+bool AacThreadPool::takeTask(unsigned int worker, Task *task)
+{
+  if (m_queuedCount.load(std::memory_order_acquire) == 0)
+    return false;  // Nothing anywhere
+
+  unsigned int count = m_workers.size();
+
+  for (unsigned int i = 0; i < count; i++)
+  {
+    Worker *victim = m_workers[(worker + i) % count];
+
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (victim->tasks.empty())
+      continue;
+
+    if (i == 0)
+    {
+      // Our own deque: newest first, as its data is most likely still cached
+      *task = std::move(victim->tasks.back());
+      victim->tasks.pop_back();
+    }
+    else
+    {
+      // Someone else's: oldest first, to leave them their hot work
+      *task = std::move(victim->tasks.front());
+      victim->tasks.pop_front();
+    }
+
+    m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  return false;
+}
+
+void AacThreadPool::run(unsigned int worker)
+{
+  currentPool = this;
+  currentWorker = worker;
+
+  Task task;
+
+  while (true)
+  {
+    if (!takeTask(worker, &task))
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeCondition.wait(lock, [this] { return m_isStopping || (m_queuedCount.load(std::memory_order_acquire) > 0); });
+
+      if (m_isStopping && (m_queuedCount.load(std::memory_order_acquire) == 0))
+        break;
+
+      continue;
+    }
+
+    task(worker);
+    task = nullptr;
+
+    if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_idleCondition.notify_all();
+    }
+  }
+}
+
+void AacThreadPool::wait(void)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idleCondition.wait(lock, [this] { return m_pendingCount.load(std::memory_order_acquire) == 0; });
+}
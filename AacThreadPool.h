@@ -0,0 +1,62 @@
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef AAC_THREAD_POOL_H
+#define AAC_THREAD_POOL_H
+
+// A fixed-size pool of worker threads. Each worker has its own task deque;
+//  it takes the newest task from its own deque, and when that runs dry it
+//  steals the oldest task from another worker.
+// Tasks are passed the index of the worker running them, so callers can
+//  keep per-worker scratch state in an array.
+class AacThreadPool
+{
+public:
+  typedef std::function<void(unsigned int worker)> Task;
+
+private:
+  struct Worker
+  {
+    std::mutex       mutex;
+    std::deque<Task> tasks;
+    std::thread      thread;
+  };
+
+  std::vector<Worker *>     m_workers;
+
+  std::mutex                m_mutex;
+  std::condition_variable   m_wakeCondition;  // Work was queued, or we are stopping
+  std::condition_variable   m_idleCondition;  // Every task has finished
+
+  std::atomic<unsigned int> m_queuedCount;  // Tasks waiting in a deque
+  std::atomic<unsigned int> m_pendingCount;  // Tasks queued or running
+  std::atomic<unsigned int> m_nextWorker;  // Round-robin target for outside submissions
+
+  bool                      m_isStopping;
+
+  bool takeTask(unsigned int worker, Task *task);
+  void run(unsigned int worker);
+
+public:
+  AacThreadPool(unsigned int threadCount = 0);  // Zero means one per core
+  ~AacThreadPool(void);
+
+  AacThreadPool(const AacThreadPool &) = delete;
+  AacThreadPool &operator=(const AacThreadPool &) = delete;
+
+  unsigned int getThreadCount(void) { return m_workers.size(); };
+
+  void submit(Task task);
+
+  // Waits for every submitted task to finish. Must not be called by a task.
+  void wait(void);
+};
+
+#endif
@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "AacConstants.h"
+#include "AacDecoderStats.h"
+#include "AacAdtsFrameHeader.h"
+
+#include "AacTrace.h"
+
+#define AAC_TRACE_RING_SIZE 4096  // Records per thread; a power of two
+
+enum AacTraceFieldType
+{
+  AAC_TRACE_FIELD_INT,
+  AAC_TRACE_FIELD_BOOL,
+  AAC_TRACE_FIELD_ELEMENT,
+  AAC_TRACE_FIELD_PROFILE,
+  AAC_TRACE_FIELD_WINDOW_SEQUENCE,
+  AAC_TRACE_FIELD_WINDOW_SHAPE,
+  AAC_TRACE_FIELD_BYTES,  // Four int8_t values, first in the low byte
+};
+
+struct AacTraceField
+{
+  const char       *name;
+  AacTraceFieldType type;
+};
+
+// The fields of each event, in the order AAC_TRACE() is given them
+static const struct
+{
+  uint16_t      event;
+  const char   *name;
+  AacTraceField fields[AAC_TRACE_MAX_ARGS];
+} events[] =
+{
+  {AAC_TRACE_FRAME, "frame", {{"crc", AAC_TRACE_FIELD_BOOL}, {"profile", AAC_TRACE_FIELD_PROFILE}, {"sampleRate", AAC_TRACE_FIELD_INT}, {"channels", AAC_TRACE_FIELD_INT}, {"size", AAC_TRACE_FIELD_INT}, {"blocks", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_ELEMENT, "element", {{"id", AAC_TRACE_FIELD_ELEMENT}, {"bit", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_FILL, "fill", {{"bytes", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_PCE, "pce", {{"instance", AAC_TRACE_FIELD_INT}, {"profile", AAC_TRACE_FIELD_PROFILE}, {"sampleRateIndex", AAC_TRACE_FIELD_INT}, {"front", AAC_TRACE_FIELD_INT}, {"side", AAC_TRACE_FIELD_INT}, {"rear", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_UNKNOWN_ELEMENT, "unknown-element", {{"id", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_PARSE_FAILED, "parse-failed", {{"bit", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_CRC_MISMATCH, "crc-mismatch", {}},
+
+  {AAC_TRACE_CHANNEL, "channel", {{"element", AAC_TRACE_FIELD_ELEMENT}, {"instance", AAC_TRACE_FIELD_INT}, {"channel", AAC_TRACE_FIELD_INT}, {"globalGain", AAC_TRACE_FIELD_INT}, {"windowSequence", AAC_TRACE_FIELD_WINDOW_SEQUENCE}, {"windowShape", AAC_TRACE_FIELD_WINDOW_SHAPE}, {"maxSfb", AAC_TRACE_FIELD_INT}, {"windowGroups", AAC_TRACE_FIELD_INT}, {"pulses", AAC_TRACE_FIELD_INT}, {"tns", AAC_TRACE_FIELD_BOOL}}},
+  {AAC_TRACE_COMMON_WINDOW, "common-window", {{"instance", AAC_TRACE_FIELD_INT}, {"commonWindow", AAC_TRACE_FIELD_BOOL}, {"msMask", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_WINDOW_GROUP, "window-group", {{"group", AAC_TRACE_FIELD_INT}, {"winStart", AAC_TRACE_FIELD_INT}, {"winLength", AAC_TRACE_FIELD_INT}, {"samples", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_SECTION, "section", {{"group", AAC_TRACE_FIELD_INT}, {"section", AAC_TRACE_FIELD_INT}, {"codebook", AAC_TRACE_FIELD_INT}, {"sfbStart", AAC_TRACE_FIELD_INT}, {"sfbLength", AAC_TRACE_FIELD_INT}, {"sampleStart", AAC_TRACE_FIELD_INT}, {"samples", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_SCALEFACTOR, "scalefactor", {{"group", AAC_TRACE_FIELD_INT}, {"sfb", AAC_TRACE_FIELD_INT}, {"codebook", AAC_TRACE_FIELD_INT}, {"offset", AAC_TRACE_FIELD_INT}, {"value", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_PULSE, "pulse", {{"pulse", AAC_TRACE_FIELD_INT}, {"offset", AAC_TRACE_FIELD_INT}, {"amplitude", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_TNS_FILTER, "tns-filter", {{"window", AAC_TRACE_FIELD_INT}, {"filter", AAC_TRACE_FIELD_INT}, {"bands", AAC_TRACE_FIELD_INT}, {"order", AAC_TRACE_FIELD_INT}, {"downward", AAC_TRACE_FIELD_BOOL}, {"coefficientBits", AAC_TRACE_FIELD_INT}, {"coefficients", AAC_TRACE_FIELD_BYTES}, {"", AAC_TRACE_FIELD_BYTES}, {"", AAC_TRACE_FIELD_BYTES}}},
+
+  {AAC_TRACE_SPECTRAL_DATA, "spectral", {{"bits", AAC_TRACE_FIELD_INT}, {"nonZero", AAC_TRACE_FIELD_INT}, {"maxAbs", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_SPECTRAL_SECTION, "spectral-section", {{"group", AAC_TRACE_FIELD_INT}, {"section", AAC_TRACE_FIELD_INT}, {"codebook", AAC_TRACE_FIELD_INT}, {"sfbStart", AAC_TRACE_FIELD_INT}, {"sfbEnd", AAC_TRACE_FIELD_INT}, {"sampleStart", AAC_TRACE_FIELD_INT}, {"sampleEnd", AAC_TRACE_FIELD_INT}, {"bits", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_INTENSITY, "intensity", {{"group", AAC_TRACE_FIELD_INT}, {"window", AAC_TRACE_FIELD_INT}, {"sfb", AAC_TRACE_FIELD_INT}, {"position", AAC_TRACE_FIELD_INT}}},
+
+  {AAC_TRACE_TRANSFORM_BLOCK, "transform", {{"channel", AAC_TRACE_FIELD_INT}, {"windowSequence", AAC_TRACE_FIELD_WINDOW_SEQUENCE}, {"windowShape", AAC_TRACE_FIELD_WINDOW_SHAPE}, {"previousShape", AAC_TRACE_FIELD_WINDOW_SHAPE}, {"blocks", AAC_TRACE_FIELD_INT}}},
+  {AAC_TRACE_TNS_APPLY, "tns-apply", {{"window", AAC_TRACE_FIELD_INT}, {"filter", AAC_TRACE_FIELD_INT}, {"order", AAC_TRACE_FIELD_INT}, {"downward", AAC_TRACE_FIELD_BOOL}, {"sfbStart", AAC_TRACE_FIELD_INT}, {"sfbEnd", AAC_TRACE_FIELD_INT}, {"sampleStart", AAC_TRACE_FIELD_INT}, {"sampleEnd", AAC_TRACE_FIELD_INT}}},
+};
+
+static const char *categoryNames[] =
+{
+  "framing",
+  "side-info",
+  "spectral",
+  "transform",
+};
+
+static const char *levelNames[] =
+{
+  "off",
+  "error",
+  "info",
+  "debug",
+};
+
+struct AacTraceRing
+{
+  AacTraceRecord        records[AAC_TRACE_RING_SIZE];
+  std::atomic<uint64_t> head;  // Records ever made, only stored by the owning thread
+  std::atomic<uint64_t> flushed;  // Records written out or lost, only stored with traceMutex held
+
+  AacTraceRing(void) : head(0), flushed(0) {};
+};
+
+// Guards the file, the list of rings and the lost count. Rings outlive their
+//  threads, so that close() can still write out what they hold.
+static std::mutex traceMutex;
+static FILE *traceFile = NULL;
+static std::atomic<bool> isFileOpen(false);
+static std::vector<AacTraceRing *> rings;
+static uint64_t lostCount = 0;
+
+static thread_local AacTraceRing *threadRing = NULL;
+
+static std::atomic<uint16_t> nextSource(1);
+
+static AacTraceRing *getRing(void)
+{
+  if (!threadRing)
+  {
+    threadRing = new AacTraceRing();
+
+    std::lock_guard<std::mutex> lock(traceMutex);
+    rings.push_back(threadRing);
+  }
+
+  return threadRing;
+}
+
+// Writes out the records not yet written, with traceMutex held. Any that
+//  have been overwritten are counted as lost.
+static bool flushRing(AacTraceRing *ring)
+{
+  uint64_t head = ring->head.load(std::memory_order_acquire);
+  uint64_t flushed = ring->flushed.load(std::memory_order_relaxed);
+
+  if (head - flushed > AAC_TRACE_RING_SIZE)
+  {
+    lostCount += head - flushed - AAC_TRACE_RING_SIZE;
+    flushed = head - AAC_TRACE_RING_SIZE;
+  }
+
+  bool isWritten = true;
+
+  if (traceFile)
+  {
+    // At most two runs, either side of the end of the ring
+    while (flushed < head)
+    {
+      size_t start = flushed & (AAC_TRACE_RING_SIZE - 1);
+      size_t count = std::min<uint64_t>(head - flushed, AAC_TRACE_RING_SIZE - start);
+
+      if (fwrite(&ring->records[start], sizeof(AacTraceRecord), count, traceFile) != count)
+        isWritten = false;
+
+      flushed += count;
+    }
+  }
+
+  ring->flushed.store(flushed, std::memory_order_relaxed);
+
+  return isWritten;
+}
+
+bool AacTrace::open(const char *filename)
+{
+  std::lock_guard<std::mutex> lock(traceMutex);
+
+  if (traceFile)
+    return false;  // Already open
+
+  traceFile = fopen(filename, "wb");
+  if (!traceFile)
+    return false;
+
+  AacTraceFileHeader header = {};
+  header.magic          = AAC_TRACE_FILE_MAGIC;
+  header.version        = AAC_TRACE_FILE_VERSION;
+  header.recordSize     = sizeof(AacTraceRecord);
+  header.ticksPerSecond = AacDecoderStats::getTicksPerSecond();
+
+  if (fwrite(&header, sizeof(header), 1, traceFile) != 1)
+  {
+    fclose(traceFile);
+    traceFile = NULL;
+    return false;
+  }
+
+  isFileOpen.store(true, std::memory_order_release);
+
+  return true;
+}
+
+bool AacTrace::close(void)
+{
+  std::lock_guard<std::mutex> lock(traceMutex);
+
+  if (!traceFile)
+    return false;
+
+  bool isWritten = true;
+  for (auto ring : rings)
+    isWritten = flushRing(ring) && isWritten;
+
+  isFileOpen.store(false, std::memory_order_release);
+
+  isWritten = (fclose(traceFile) == 0) && isWritten;
+  traceFile = NULL;
+
+  return isWritten;
+}
+
+uint64_t AacTrace::getLostCount(void)
+{
+  std::lock_guard<std::mutex> lock(traceMutex);
+
+  return lostCount;
+}
+
+void AacTrace::write(const AacTracer *tracer, AacTraceEvent event, const int32_t *args, unsigned int argCount)
+{
+  AacTraceRing *ring = getRing();
+
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+
+  // A full ring is written out by its own thread. Without a file, the oldest
+  //  record is overwritten instead.
+  if ((head - ring->flushed.load(std::memory_order_relaxed) >= AAC_TRACE_RING_SIZE) && isFileOpen.load(std::memory_order_acquire))
+  {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    flushRing(ring);
+  }
+
+  AacTraceRecord *record = &ring->records[head & (AAC_TRACE_RING_SIZE - 1)];
+
+  record->timestamp = AacDecoderStats::now();
+  record->position  = tracer->m_position;
+  record->block     = tracer->m_block;
+  record->source    = tracer->m_source;
+  record->event     = event;
+
+  memcpy(record->args, args, sizeof(int32_t) * argCount);
+  memset(record->args + argCount, 0, sizeof(int32_t) * (AAC_TRACE_MAX_ARGS - argCount));
+
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+uint16_t AacTrace::newSource(void)
+{
+  return nextSource.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char *AacTrace::getEventName(uint16_t event)
+{
+  for (auto &info : events)
+  {
+    if (info.event == event)
+      return info.name;
+  }
+
+  return NULL;
+}
+
+const char *AacTrace::getCategoryName(AacTraceCategory category)
+{
+  if (category >= std::size(categoryNames))
+    return NULL;  // Out of range
+
+  return categoryNames[category];
+}
+
+const char *AacTrace::getLevelName(AacTraceLevel level)
+{
+  if (level >= std::size(levelNames))
+    return NULL;  // Out of range
+
+  return levelNames[level];
+}
+
+bool AacTrace::parseLevel(const char *text, AacTraceLevel *level)
+{
+  for (unsigned int l = 0; l < std::size(levelNames); l++)
+  {
+    if (!strcasecmp(text, levelNames[l]))
+    {
+      *level = static_cast<AacTraceLevel>(l);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool AacTrace::parseCategories(const char *text, unsigned int *categories)
+{
+  unsigned int parsed = 0;
+
+  const char *p = text;
+  while (*p)
+  {
+    size_t length = strcspn(p, ",");
+
+    if ((length == 3) && !strncasecmp(p, "all", length))
+      parsed |= AAC_TRACE_ALL_CATEGORIES;
+    else
+    {
+      unsigned int c = 0;
+      while ((c < std::size(categoryNames)) && ((strlen(categoryNames[c]) != length) || strncasecmp(p, categoryNames[c], length)))
+        c++;
+
+      if (c == std::size(categoryNames))
+        return false;  // Unknown category
+
+      parsed |= 1U << c;
+    }
+
+    p += length;
+    if (*p == ',')
+      p++;
+  }
+
+  if (!parsed)
+    return false;
+
+  *categories = parsed;
+  return true;
+}
+
+// Appends to text, keeping track of what's left of it
+static void append(char **text, size_t *size, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+static void append(char **text, size_t *size, const char *format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(*text, *size, format, args);
+  va_end(args);
+
+  size_t used = (length < 0) ? 0 : std::min<size_t>(length, *size ? *size - 1 : 0);
+  *text += used;
+  *size -= used;
+}
+
+static void appendName(char **text, size_t *size, const char *name, int32_t value)
+{
+  if (name)
+    append(text, size, "%s", name);
+  else
+    append(text, size, "%d", value);
+}
+
+bool AacTrace::format(const AacTraceRecord *record, char *text, size_t size)
+{
+  unsigned int e = 0;
+  while ((e < std::size(events)) && (events[e].event != record->event))
+    e++;
+
+  if (e == std::size(events))
+    return false;  // Unknown event
+
+  if (size)
+    text[0] = '\0';
+
+  append(&text, &size, "%s", events[e].name);
+
+  for (unsigned int a = 0; (a < AAC_TRACE_MAX_ARGS) && events[e].fields[a].name; a++)
+  {
+    const AacTraceField &field = events[e].fields[a];
+    int32_t value = record->args[a];
+
+    // A run of byte fields reads as one list
+    if (field.name[0])
+      append(&text, &size, " %s=", field.name);
+    else
+      append(&text, &size, ",");
+
+    switch (field.type)
+    {
+    case AAC_TRACE_FIELD_INT:
+      append(&text, &size, "%d", value);
+      break;
+    case AAC_TRACE_FIELD_BOOL:
+      append(&text, &size, "%s", value ? "yes" : "no");
+      break;
+    case AAC_TRACE_FIELD_ELEMENT:
+      appendName(&text, &size, AacConstants::getElementNameShort(static_cast<AacElementId>(value)), value);
+      break;
+    case AAC_TRACE_FIELD_PROFILE:
+      appendName(&text, &size, AacAdtsFrameHeader::getProfileName(static_cast<AacAdtsProfile>(value)), value);
+      break;
+    case AAC_TRACE_FIELD_WINDOW_SEQUENCE:
+      appendName(&text, &size, AacConstants::getWindowSequenceName(static_cast<AacWindowSequence>(value)), value);
+      break;
+    case AAC_TRACE_FIELD_WINDOW_SHAPE:
+      appendName(&text, &size, AacConstants::getWindowShapeName(static_cast<AacWindowShape>(value)), value);
+      break;
+    case AAC_TRACE_FIELD_BYTES:
+      for (unsigned int b = 0; b < 4; b++)
+        append(&text, &size, (b == 0) ? "%d" : ",%d", static_cast<int8_t>(value >> (b * 8)));
+      break;
+    }
+  }
+
+  return true;
+}
+
+void AacTracer::enable(AacTraceLevel level, unsigned int categories)
+{
+  m_flags = 0;
+
+  for (unsigned int c = 0; c < AAC_TRACE_CATEGORY_COUNT; c++)
+  {
+    if (!(categories & (1U << c)))
+      continue;
+
+    for (unsigned int l = AAC_TRACE_ERROR; (l <= level) && (l < AAC_TRACE_LEVEL_COUNT); l++)
+      m_flags |= AacTrace::getFlag(AAC_TRACE_EVENT(c, l, 0));
+  }
+
+  if (m_flags && !m_source)
+    m_source = AacTrace::newSource();
+}
@@ -0,0 +1,167 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef AAC_TRACE_H
+#define AAC_TRACE_H
+
+#define AAC_TRACE_FILE_MAGIC   0x43525441  // "ATRC" when stored little-endian
+#define AAC_TRACE_FILE_VERSION 1
+
+#define AAC_TRACE_MAX_ARGS 10
+
+// How much is traced. Each level includes the ones before it.
+enum AacTraceLevel
+{
+  AAC_TRACE_OFF,
+  AAC_TRACE_ERROR,  // Damage and decode failures
+  AAC_TRACE_INFO,   // One record per frame, element or channel
+  AAC_TRACE_DEBUG,  // Every section, scalefactor, pulse and filter
+
+  AAC_TRACE_LEVEL_COUNT
+};
+
+enum AacTraceCategory
+{
+  AAC_TRACE_FRAMING,    // Frame headers, elements, CRCs
+  AAC_TRACE_SIDE_INFO,  // ics_info, sections, scalefactors, pulses and TNS data
+  AAC_TRACE_SPECTRAL,   // Spectral data and stereo processing
+  AAC_TRACE_TRANSFORM,  // TNS filtering, IMDCT and windowing
+
+  AAC_TRACE_CATEGORY_COUNT
+};
+
+#define AAC_TRACE_ALL_CATEGORIES ((1U << AAC_TRACE_CATEGORY_COUNT) - 1)
+
+// Each event carries its category and level, so whether it's enabled is one
+//  test of a decoder's flags against a constant.
+#define AAC_TRACE_EVENT(category, level, number) (((category) << 12) | ((level) << 8) | (number))
+
+enum AacTraceEvent : uint16_t
+{
+  AAC_TRACE_FRAME            = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_INFO,  0),
+  AAC_TRACE_ELEMENT          = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_DEBUG, 1),
+  AAC_TRACE_FILL             = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_DEBUG, 2),
+  AAC_TRACE_PCE              = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_INFO,  3),
+  AAC_TRACE_UNKNOWN_ELEMENT  = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_ERROR, 4),
+  AAC_TRACE_PARSE_FAILED     = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_ERROR, 5),
+  AAC_TRACE_CRC_MISMATCH     = AAC_TRACE_EVENT(AAC_TRACE_FRAMING,    AAC_TRACE_ERROR, 6),
+
+  AAC_TRACE_CHANNEL          = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_INFO,  0),
+  AAC_TRACE_COMMON_WINDOW    = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 1),
+  AAC_TRACE_WINDOW_GROUP     = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 2),
+  AAC_TRACE_SECTION          = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 3),
+  AAC_TRACE_SCALEFACTOR      = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 4),
+  AAC_TRACE_PULSE            = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 5),
+  AAC_TRACE_TNS_FILTER       = AAC_TRACE_EVENT(AAC_TRACE_SIDE_INFO,  AAC_TRACE_DEBUG, 6),
+
+  AAC_TRACE_SPECTRAL_DATA    = AAC_TRACE_EVENT(AAC_TRACE_SPECTRAL,   AAC_TRACE_INFO,  0),
+  AAC_TRACE_SPECTRAL_SECTION = AAC_TRACE_EVENT(AAC_TRACE_SPECTRAL,   AAC_TRACE_DEBUG, 1),
+  AAC_TRACE_INTENSITY        = AAC_TRACE_EVENT(AAC_TRACE_SPECTRAL,   AAC_TRACE_DEBUG, 2),
+
+  AAC_TRACE_TRANSFORM_BLOCK  = AAC_TRACE_EVENT(AAC_TRACE_TRANSFORM,  AAC_TRACE_INFO,  0),
+  AAC_TRACE_TNS_APPLY        = AAC_TRACE_EVENT(AAC_TRACE_TRANSFORM,  AAC_TRACE_DEBUG, 1),
+};
+
+// One traced event, as held in the rings and written to trace files. A trace
+//  file is an AacTraceFileHeader followed by records, grouped by the thread
+//  that made them. As with decoder checkpoints, fields are in the writer's
+//  byte order.
+struct AacTraceRecord
+{
+  uint64_t timestamp;  // AacDecoderStats::now() ticks
+  uint64_t position;   // As given to the decoder's setStatsPosition()
+  uint32_t block;      // Blocks the decoder had parsed before this one
+  uint16_t source;     // Which decoder, numbered from 1
+  uint16_t event;      // AacTraceEvent
+  int32_t  args[AAC_TRACE_MAX_ARGS];  // Unused ones are zero
+};
+
+struct AacTraceFileHeader
+{
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recordSize;
+  double   ticksPerSecond;
+};
+
+class AacTracer;
+
+// The process-wide side of tracing. Each thread that records gets a ring of
+//  its own, which only that thread writes, so recording takes no locks. With
+//  a file open, a full ring is written out by its own thread. Without one,
+//  rings keep the latest records, flight recorder style, until a file is
+//  opened or close() is called.
+class AacTrace
+{
+public:
+  // Starts writing records to a file, beginning with those already held
+  static bool open(const char *filename);
+
+  // Writes out what's left in every thread's ring and closes the file.
+  //  Threads must have finished tracing first.
+  static bool close(void);
+
+  // Records that were overwritten before they could be written out
+  static uint64_t getLostCount(void);
+
+  static void write(const AacTracer *tracer, AacTraceEvent event, const int32_t *args, unsigned int argCount);
+
+  // For telling decoders' records apart
+  static uint16_t newSource(void);
+
+  static AacTraceCategory getCategory(uint16_t event) { return static_cast<AacTraceCategory>(event >> 12); };
+  static AacTraceLevel    getLevel(uint16_t event) { return static_cast<AacTraceLevel>((event >> 8) & 0x0F); };
+
+  static constexpr uint32_t getFlag(uint16_t event) { return 1U << (((event >> 12) * AAC_TRACE_LEVEL_COUNT) + ((event >> 8) & 0x0F)); };
+
+  static const char *getEventName(uint16_t event);
+  static const char *getCategoryName(AacTraceCategory category);
+  static const char *getLevelName(AacTraceLevel level);
+
+  // A level name, or a comma-separated list of category names or "all"
+  static bool parseLevel(const char *text, AacTraceLevel *level);
+  static bool parseCategories(const char *text, unsigned int *categories);
+
+  // The record's event and arguments as "name field=value ...", for the
+  //  formatter. Fails on an event this build doesn't know.
+  static bool format(const AacTraceRecord *record, char *text, size_t size);
+};
+
+// A decoder's trace settings. With tracing off, each AAC_TRACE() costs a
+//  test of m_flags and a branch that's never taken; the arguments aren't
+//  even evaluated.
+class AacTracer
+{
+  uint32_t m_flags;  // AacTrace::getFlag() of each enabled category and level
+  uint16_t m_source;
+  uint32_t m_block;
+  uint64_t m_position;
+
+  friend class AacTrace;
+
+public:
+  AacTracer(void) : m_flags(0), m_source(0), m_block(0), m_position(0) {};
+
+  // Traces the categories given, as a mask of 1 << AacTraceCategory, at the
+  //  level given and below
+  void enable(AacTraceLevel level, unsigned int categories);
+
+  bool isEnabled(AacTraceEvent event) const { return m_flags & AacTrace::getFlag(event); };
+  bool isEnabled(void) const { return m_flags; };
+
+  void setBlock(uint32_t block) { m_block = block; };
+  void setPosition(uint64_t position) { m_position = position; };
+
+  template <typename... Args>
+  void record(AacTraceEvent event, Args... args) const
+  {
+    static_assert(sizeof...(args) <= AAC_TRACE_MAX_ARGS, "Too many trace arguments");
+
+    int32_t values[sizeof...(args) + 1] = {static_cast<int32_t>(args)...};
+    AacTrace::write(this, event, values, sizeof...(args));
+  }
+};
+
+#define AAC_TRACE(tracer, event, ...)  do { if ((tracer).isEnabled(event)) [[unlikely]] (tracer).record(event, ##__VA_ARGS__); } while (0)
+
+#endif
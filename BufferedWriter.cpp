@@ -0,0 +1,299 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+
+#include <algorithm>
+
+#include "BufferedWriter.h"
+
+BufferedWriter::~BufferedWriter(void)
+{
+  close();
+
+  // The buffers are mapped rather than allocated, because a pipe may still
+  //  hold pages spliced from them. Unmapping leaves those pages to the pipe,
+  //  whereas freed heap memory could be reused and overwritten.
+  for (auto &buffer : m_buffers)
+  {
+    if (buffer)
+      munmap(buffer, m_capacity);
+  }
+}
+
+bool BufferedWriter::setup(int fd, bool isOwned)
+{
+  struct stat st;
+  if (fstat(fd, &st))
+    return false;
+
+  m_fd = fd;
+  m_isOwned = isOwned;
+  m_isPreallocated = false;
+
+  m_current = 0;
+  m_size = 0;
+  m_offset = 0;
+
+  // We can only go back and patch regular files. Writes to a file opened
+  //  for appending always go to the end, whatever offset is asked for.
+  off_t position = lseek(fd, 0, SEEK_CUR);
+  int flags = fcntl(fd, F_GETFL);
+
+  m_isSeekable = S_ISREG(st.st_mode) && (position >= 0) && (flags >= 0) && !(flags & O_APPEND);
+  m_startOffset = m_isSeekable ? position : 0;
+
+  // Splicing is only safe while the pipe is no bigger than one buffer: once
+  //  a whole buffer has been spliced, the pipe can't still be holding pages
+  //  from the buffer before it, which is the next to be refilled.
+  m_isSpliceable = false;
+  if (S_ISFIFO(st.st_mode))
+  {
+    fcntl(fd, F_SETPIPE_SZ, static_cast<int>(m_capacity));  // Best effort
+
+    int pipeSize = fcntl(fd, F_GETPIPE_SZ);
+    m_isSpliceable = (pipeSize > 0) && (static_cast<size_t>(pipeSize) <= m_capacity);
+  }
+
+  for (unsigned int b = 0; b < (m_isSpliceable ? 2 : 1); b++)
+  {
+    if (m_buffers[b])
+      continue;
+
+    void *buffer = mmap(NULL, m_capacity, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+    {
+      m_fd = -1;
+      return false;
+    }
+
+    m_buffers[b] = static_cast<uint8_t *>(buffer);
+  }
+
+  return true;
+}
+
+bool BufferedWriter::open(const char *filename, bool isDirect)
+{
+  if (isOpen())
+    close();
+
+  m_isDirect = false;
+
+  int fd = -1;
+
+  if (isDirect && ((m_capacity % BUFFERED_WRITER_DIRECT_ALIGNMENT) == 0))
+  {
+    fd = ::open(filename, O_WRONLY|O_CREAT|O_TRUNC|O_DIRECT, 0666);
+    m_isDirect = (fd >= 0);
+  }
+
+  if (fd < 0)
+    fd = ::open(filename, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+
+  if (fd < 0)
+    return false;
+
+  if (!setup(fd, true))
+  {
+    int error = errno;
+    ::close(fd);
+    errno = error;
+    return false;
+  }
+
+  return true;
+}
+
+bool BufferedWriter::open(int fd)
+{
+  if (isOpen())
+    close();
+
+  m_isDirect = false;
+
+  return setup(fd, false);
+}
+
+bool BufferedWriter::close(void)
+{
+  if (!isOpen())
+    return true;
+
+  bool success = flush();
+
+  // Give back any preallocated space that wasn't needed
+  if (m_isPreallocated && ftruncate(m_fd, m_startOffset + m_offset))
+    success = false;
+
+  if (m_isOwned && ::close(m_fd))
+    success = false;
+
+  m_fd = -1;
+  return success;
+}
+
+bool BufferedWriter::writeOut(const uint8_t *bytes, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t count = ::write(m_fd, bytes, size);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    bytes += count;
+    size -= count;
+    m_offset += count;
+  }
+
+  return true;
+}
+
+bool BufferedWriter::spliceOut(const uint8_t *bytes, size_t size)
+{
+  while (size > 0)
+  {
+    struct iovec iov = { const_cast<uint8_t *>(bytes), size };
+
+    ssize_t count = vmsplice(m_fd, &iov, 1, 0);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    bytes += count;
+    size -= count;
+    m_offset += count;
+  }
+
+  return true;
+}
+
+// Drops O_DIRECT for writes that can't meet its alignment rules
+void BufferedWriter::endDirect(void)
+{
+  if (!m_isDirect)
+    return;
+
+  int flags = fcntl(m_fd, F_GETFL);
+  if (flags >= 0)
+    fcntl(m_fd, F_SETFL, flags & ~O_DIRECT);
+
+  m_isDirect = false;
+}
+
+bool BufferedWriter::flush(void)
+{
+  if (!isOpen() || (m_size == 0))
+    return true;
+
+  // Only the final, partial buffer should be unaligned
+  if (m_size % BUFFERED_WRITER_DIRECT_ALIGNMENT)
+    endDirect();
+
+  bool success;
+
+  if (m_isSpliceable)
+  {
+    success = spliceOut(m_buffers[m_current], m_size);
+    m_current ^= 1;
+  }
+  else
+  {
+    success = writeOut(m_buffers[m_current], m_size);
+  }
+
+  m_size = 0;
+  return success;
+}
+
+bool BufferedWriter::write(const uint8_t *bytes, size_t size)
+{
+  while (size > 0)
+  {
+    // Whole buffers' worth can go straight out when nothing is waiting,
+    //  unless they're being spliced, as the caller will reuse its memory, or
+    //  O_DIRECT needs them aligned.
+    if ((m_size == 0) && (size >= m_capacity) && !m_isSpliceable && !m_isDirect)
+    {
+      size_t count = size - (size % m_capacity);
+      if (!writeOut(bytes, count))
+        return false;
+
+      bytes += count;
+      size -= count;
+      continue;
+    }
+
+    size_t count = std::min(m_capacity - m_size, size);
+    memcpy(m_buffers[m_current] + m_size, bytes, count);
+
+    m_size += count;
+    bytes += count;
+    size -= count;
+
+    if ((m_size == m_capacity) && !flush())
+      return false;
+  }
+
+  return true;
+}
+
+bool BufferedWriter::patch(const uint8_t *bytes, size_t size, uint64_t offset)
+{
+  if (!m_isSeekable || (offset + size > m_offset))
+  {
+    errno = ESPIPE;
+    return false;
+  }
+
+  endDirect();
+
+  while (size > 0)
+  {
+    ssize_t count = pwrite(m_fd, bytes, size, m_startOffset + offset);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return false;
+    }
+
+    bytes += count;
+    size -= count;
+    offset += count;
+  }
+
+  return true;
+}
+
+bool BufferedWriter::preallocate(uint64_t size)
+{
+  if (!m_isSeekable)
+  {
+    errno = ESPIPE;
+    return false;
+  }
+
+  // Keep the file's size as it is, so that a short output doesn't end up
+  //  padded with zeroes
+  if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE, m_startOffset, size))
+    return false;
+
+  m_isPreallocated = true;
+  return true;
+}
@@ -0,0 +1,71 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#define BUFFERED_WRITER_DEFAULT_CAPACITY (1024 * 1024)
+
+// Alignment O_DIRECT needs for buffer addresses, lengths and file offsets
+#define BUFFERED_WRITER_DIRECT_ALIGNMENT 4096
+
+// Gathers small writes into large page-aligned ones, so that each block of
+//  audio doesn't cost a system call. When the output is a pipe, full buffers
+//  are handed to the kernel with vmsplice() instead of being copied by
+//  write(), alternating between two buffers so that neither is refilled
+//  while the pipe may still be reading from it.
+class BufferedWriter
+{
+  int          m_fd = -1;
+  bool         m_isOwned = false;  // Whether close() should close m_fd
+  bool         m_isSeekable = false;
+  bool         m_isSpliceable = false;
+  bool         m_isDirect = false;
+  bool         m_isPreallocated = false;
+
+  size_t       m_capacity;
+  uint8_t     *m_buffers[2] = {};
+  unsigned int m_current = 0;
+  size_t       m_size = 0;  // Bytes waiting in the current buffer
+
+  uint64_t     m_startOffset = 0;  // File offset the output began at
+  uint64_t     m_offset = 0;  // Bytes passed to the kernel so far
+
+  bool setup(int fd, bool isOwned);
+  void endDirect(void);
+  bool writeOut(const uint8_t *bytes, size_t size);
+  bool spliceOut(const uint8_t *bytes, size_t size);
+
+public:
+  BufferedWriter(size_t capacity = BUFFERED_WRITER_DEFAULT_CAPACITY) : m_capacity(capacity) {};
+  ~BufferedWriter(void);
+
+  BufferedWriter(const BufferedWriter &) = delete;
+  BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+  // On failure, these return false and leave errno set
+  bool open(const char *filename, bool isDirect = false);  // Falls back to buffered I/O if O_DIRECT isn't supported
+  bool open(int fd);  // The descriptor is not closed by close()
+  bool close(void);
+
+  bool write(const uint8_t *bytes, size_t size);
+  bool flush(void);
+
+  // Overwrites bytes that have already been flushed, such as a header whose
+  //  sizes weren't known at the start. Only possible if isSeekable().
+  bool patch(const uint8_t *bytes, size_t size, uint64_t offset);
+
+  // Reserves disk space for a total output of size bytes, to keep the file
+  //  contiguous. Anything unused is given back by close().
+  bool preallocate(uint64_t size);
+
+  bool isOpen(void) { return (m_fd >= 0); };
+  bool isSeekable(void) { return m_isSeekable; };  // False for pipes, sockets, terminals and appends
+  bool isDirect(void) { return m_isDirect; };
+
+  uint64_t getSize(void) { return m_offset + m_size; };
+
+  int  getFd(void) { return m_fd; };
+};
+
+#endif
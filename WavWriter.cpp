@@ -2,25 +2,61 @@
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
-#include <limits.h>
 
 #include "WavWriter.h"
 
 #define WAV_HEADER_SIZE 44
 
-bool WavWriter::open(const char *filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate)
+// Room reserved after the RIFF header for a ds64 chunk (EBU Tech 3306), as
+//  a JUNK chunk until it turns out to be needed.
+#define WAV_DS64_CHUNK_SIZE 36
+
+// Largest size a plain RIFF header can describe
+#define WAV_MAX_RIFF_SIZE UINT32_MAX
+
+static void storeLittleEndian(uint8_t *bytes, uint64_t value, unsigned int size)
+{
+  for (unsigned int i = 0; i < size; i++)
+    bytes[i] = (value >> (i * 8)) & 0xFF;
+}
+
+bool WavWriter::open(const char *filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize)
+{
+  if (m_output.isOpen())
+    close();
+
+  if (!m_output.open(filename, m_isDirect))
+    return false;
+
+  return begin(channelCount, bitsPerSample, sampleRate, expectedSize);
+}
+
+bool WavWriter::open(int fd, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize)
 {
-  if (m_file)
+  if (m_output.isOpen())
     close();
 
-  m_file = fopen(filename, "w");
-  if (!m_file)
+  if (!m_output.open(fd))
     return false;
 
+  return begin(channelCount, bitsPerSample, sampleRate, expectedSize);
+}
+
+bool WavWriter::begin(unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize)
+{
   m_channelCount = channelCount;
   m_bitsPerSample = bitsPerSample;
   m_sampleRate = sampleRate;
 
+  // Sizes can only be fixed up afterwards in a file we can go back to. If
+  //  the data might outgrow 32 bits (with room for a poor estimate), keep
+  //  space for switching to RF64.
+  m_hasDs64Space = m_output.isSeekable() && ((expectedSize == 0) || (expectedSize > WAV_MAX_RIFF_SIZE / 2));
+  m_headerSize = WAV_HEADER_SIZE + (m_hasDs64Space ? WAV_DS64_CHUNK_SIZE : 0);
+
+  if (expectedSize)
+    m_output.preallocate(m_headerSize + expectedSize);  // Best effort
+
   if (!writeHeader())
     return false;
 
@@ -29,16 +65,15 @@ bool WavWriter::open(const char *filename, unsigned int channelCount, unsigned i
   return true;
 }
 
-void WavWriter::close(void)
+bool WavWriter::close(void)
 {
-  if (m_file && m_valid)
-    writeLength();
+  bool success = true;
 
-  if (m_file)
-  {
-    fclose(m_file);
-    m_file = NULL;
-  }
+  if (m_output.isOpen() && m_valid)
+    success = writeLength();
+
+  if (!m_output.close())
+    success = false;
 
   m_channelCount = 0;
   m_bitsPerSample = 0;
@@ -46,53 +81,53 @@ void WavWriter::close(void)
 
   m_valid = false;
   m_bytesWritten = 0;
+
+  return success;
 }
 
 bool WavWriter::writeHeader(void)
 {
-  uint8_t header[WAV_HEADER_SIZE] = {};
+  uint8_t header[WAV_HEADER_SIZE + WAV_DS64_CHUNK_SIZE] = {};
+  uint8_t *chunk = header + 12;
 
   memcpy(header + 0,  "RIFF", 4);
   memcpy(header + 8,  "WAVE", 4);
 
-  // Start fmt chunk
-  memcpy(header + 12, "fmt ", 4);
+  // The sizes aren't known yet. Until writeLength() fills them in, they hold
+  //  the maximum, which is the usual convention for a stream of unknown
+  //  length and is all a pipe will ever get.
+  storeLittleEndian(header + 4, UINT32_MAX, 4);
 
-  header[16] = 16;  // Length of fmt payload
-  header[20] = 1;  // PCM
+  // Placeholder for a ds64 chunk
+  if (m_hasDs64Space)
+  {
+    memcpy(chunk, "JUNK", 4);
+    storeLittleEndian(chunk + 4, WAV_DS64_CHUNK_SIZE - 8, 4);
+    chunk += WAV_DS64_CHUNK_SIZE;
+  }
+
+  // Start fmt chunk
+  memcpy(chunk, "fmt ", 4);
 
-  // Channel count
-  header[22] = m_channelCount & 0xFF;
-  header[23] = m_channelCount >> 8;
+  storeLittleEndian(chunk + 4, 16, 4);  // Length of fmt payload
+  storeLittleEndian(chunk + 8, 1, 2);  // PCM
 
-  // Sample rate
-  header[24] = m_sampleRate & 0xFF;
-  header[25] = (m_sampleRate >> 8) & 0xFF;
-  header[26] = (m_sampleRate >> 16) & 0xFF;
-  header[27] = (m_sampleRate >> 24) & 0xFF;
+  storeLittleEndian(chunk + 10, m_channelCount, 2);
+  storeLittleEndian(chunk + 12, m_sampleRate, 4);
 
-  // Bytes per second
   unsigned int bytesPerSecond = (m_sampleRate * m_bitsPerSample * m_channelCount) >> 3;
-  header[28] = bytesPerSecond & 0xFF;
-  header[29] = (bytesPerSecond >> 8) & 0xFF;
-  header[30] = (bytesPerSecond >> 16) & 0xFF;
-  header[31] = (bytesPerSecond >> 24) & 0xFF;
+  storeLittleEndian(chunk + 16, bytesPerSecond, 4);
 
-  // Bytes per sampling interval
   unsigned int bytesPerSamplingInterval = (m_bitsPerSample * m_channelCount) >> 3;
-  header[32] = bytesPerSamplingInterval & 0xFF;
-  header[33] = (bytesPerSamplingInterval >> 8) & 0xFF;
+  storeLittleEndian(chunk + 20, bytesPerSamplingInterval, 2);
 
-  // Bits per sample
-  unsigned int bitsPerSample = 16;
-  header[34] = bitsPerSample & 0xFF;
-  header[35] = (bitsPerSample >> 8) & 0xFF;
+  storeLittleEndian(chunk + 22, m_bitsPerSample, 2);
 
   // Start data chunk
-  memcpy(header + 36, "data", 4);
+  memcpy(chunk + 24, "data", 4);
+  storeLittleEndian(chunk + 28, UINT32_MAX, 4);
 
-  size_t count = fwrite(header, 1, WAV_HEADER_SIZE, m_file);
-  if (count != WAV_HEADER_SIZE)
+  if (!m_output.write(header, m_headerSize))
   {
     close();
     return false;
@@ -103,44 +138,58 @@ bool WavWriter::writeHeader(void)
 
 bool WavWriter::writeLength(void)
 {
-  if (!(m_file && m_valid))
+  if (!(m_output.isOpen() && m_valid))
     return false;
 
-  if (fseek(m_file, WAV_HEADER_SIZE - 4, SEEK_SET))
+  if (!m_output.isSeekable())
+    return true;  // Streaming, so the sizes stay as they are
+
+  if (!m_output.flush())
   {
     m_valid = false;
     return false;
   }
 
-  uint8_t size[4];
-  size_t count;
+  uint64_t riffSize = m_bytesWritten + m_headerSize - 8;
 
-  size[0] = m_bytesWritten & 0xFF;
-  size[1] = (m_bytesWritten >> 8) & 0xFF;
-  size[2] = (m_bytesWritten >> 16) & 0xFF;
-  size[3] = (m_bytesWritten >> 24) & 0xFF;
+  uint8_t size[4];
 
-  count = fwrite(size, 1, 4, m_file);
-  if (count != 4)
+  if (riffSize <= WAV_MAX_RIFF_SIZE)
   {
-    m_valid = false;
-    return false;
+    storeLittleEndian(size, m_bytesWritten, 4);
+    if (!m_output.patch(size, 4, m_headerSize - 4))
+    {
+      m_valid = false;
+      return false;
+    }
+
+    storeLittleEndian(size, riffSize, 4);
+    if (!m_output.patch(size, 4, 4))
+    {
+      m_valid = false;
+      return false;
+    }
+
+    return true;
   }
 
-  if (fseek(m_file, 4, SEEK_SET))
-  {
-    m_valid = false;
-    return false;
-  }
+  // Too big for RIFF. Without room for a ds64 chunk, the sizes are left
+  //  saying "unknown", which most readers take as "until the end of file".
+  if (!m_hasDs64Space)
+    return true;
+
+  // Switch to RF64, with the real sizes in the ds64 chunk (EBU Tech 3306).
+  //  The 32-bit sizes stay at their maximum.
+  uint8_t ds64[WAV_DS64_CHUNK_SIZE] = {};
 
-  unsigned int riffSize = m_bytesWritten + WAV_HEADER_SIZE - 8;
-  size[0] = riffSize & 0xFF;
-  size[1] = (riffSize >> 8) & 0xFF;
-  size[2] = (riffSize >> 16) & 0xFF;
-  size[3] = (riffSize >> 24) & 0xFF;
+  memcpy(ds64, "ds64", 4);
+  storeLittleEndian(ds64 + 4, WAV_DS64_CHUNK_SIZE - 8, 4);
+  storeLittleEndian(ds64 + 8, riffSize, 8);
+  storeLittleEndian(ds64 + 16, m_bytesWritten, 8);
+  storeLittleEndian(ds64 + 24, m_bytesWritten / ((m_bitsPerSample * m_channelCount) >> 3), 8);  // Sample count
+  // Zero-length table of other chunk sizes
 
-  count = fwrite(size, 1, 4, m_file);
-  if (count != 4)
+  if (!m_output.patch(ds64, WAV_DS64_CHUNK_SIZE, 12) || !m_output.patch(reinterpret_cast<const uint8_t *>("RF64"), 4, 0))
   {
     m_valid = false;
     return false;
@@ -149,19 +198,17 @@ bool WavWriter::writeLength(void)
   return true;
 }
 
-bool WavWriter::write(uint8_t *samples, size_t size)
+bool WavWriter::write(const uint8_t *samples, size_t size)
 {
   assert(m_valid);
 
-  size_t count = fwrite(samples, 1, size, m_file);
-  if (count != size)
+  if (!m_output.write(samples, size))
   {
     close();
     return false;
   }
 
   m_bytesWritten += size;
-  assert(m_bytesWritten < INT_MAX);
 
   return true;
 }
@@ -1,31 +1,47 @@
 #include <stdio.h>
+#include <stdint.h>
 #include <stdbool.h>
 
+#include "BufferedWriter.h"
+
 #ifndef WAV_WRITER_H
 #define WAV_WRITER_H
 
 class WavWriter
 {
-  FILE        *m_file = NULL;
+  BufferedWriter m_output;
   bool         m_valid = false;
+  bool         m_isDirect = false;
 
   unsigned int m_channelCount = 0;
   unsigned int m_bitsPerSample = 0;
   unsigned int m_sampleRate = 0;
 
-  unsigned int m_bytesWritten = 0;
+  size_t       m_headerSize = 0;
+  bool         m_hasDs64Space = false;  // Whether the header can become RF64
+
+  uint64_t     m_bytesWritten = 0;
 
+  bool begin(unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize);
   bool writeHeader(void);
 
   bool writeLength(void);
 
 public:
-  bool open(const char *filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate);
-  void close(void);
+  // expectedSize is the number of bytes of samples that will be written, or
+  //  zero if not known. It's used to preallocate the file, and to decide
+  //  whether to leave room in the header for outgrowing 32-bit sizes.
+  bool open(const char *filename, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize = 0);
+  bool open(int fd, unsigned int channelCount, unsigned int bitsPerSample, unsigned int sampleRate, uint64_t expectedSize = 0);  // e.g. STDOUT_FILENO
+  bool close(void);  // Fails if the data or the final sizes couldn't be written
+
+  // Use O_DIRECT for files opened by name from now on, bypassing the page
+  //  cache, where the filesystem supports it
+  void setDirect(bool isDirect) { m_isDirect = isDirect; };
 
-  bool write(uint8_t *samples, size_t size);
+  bool write(const uint8_t *samples, size_t size);
 
-  bool isOpen(void) { return (m_file && m_valid); };
+  bool isOpen(void) { return (m_output.isOpen() && m_valid); };
 };
 
 #endif
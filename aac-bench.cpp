@@ -0,0 +1,1082 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AacAdtsFrame.h"
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAdtsIndex.h"
+#include "AacAudioBlock.h"
+#include "AacDecoder.h"
+#include "AacMultiStreamDecoder.h"
+#include "AacSeekableDecoder.h"
+#include "AacStructs.h"
+#include "AacChannelDecoder.h"
+
+#define DEFAULT_REPEAT_COUNT 3
+#define DEFAULT_THRESHOLD_PERCENT 5.0
+
+#define MAX_STREAM_COUNT 256
+
+// FNV-1a, over every decoded sample
+#define OUTPUT_HASH_OFFSET 0xCBF29CE484222325ULL
+#define OUTPUT_HASH_PRIME  0x100000001B3ULL
+
+// How far a checkpoint may move an overlap sample: half a unit in the last
+//  place, relative to the sample, with half rounded by way of single, plus
+//  half the smallest subnormal of the precision, at the int16 scale
+static const double stateRelativeErrors[AAC_STATE_PRECISION_COUNT] = {0.0, 0x1p-24, 0x1p-11 + 0x1p-24};
+static const double stateAbsoluteErrors[AAC_STATE_PRECISION_COUNT] = {0.0, 0x1p-150 * AAC_STATE_SAMPLE_SCALE, 0x1p-25 * AAC_STATE_SAMPLE_SCALE};
+
+// One file of the corpus, held in memory so that only decoding is timed
+struct BenchFile
+{
+  std::string          path;
+  std::vector<uint8_t> bytes;
+
+  uint64_t             frameCount;
+  uint64_t             failedCount;  // Frames that could not be decoded
+  double               audioSeconds;
+
+  uint64_t             channelBlockCount;
+  uint64_t             switchedBlockCount;  // Channel blocks with a short or transition window sequence
+
+  double               wallSeconds;  // Of the fastest pass
+  double               cpuSeconds;
+
+  uint64_t             outputHash;  // With --multi-stream, of the serial decode's output
+};
+
+// With --check-state, how checkpoints at each precision compare with an
+//  uninterrupted decode
+struct StateCheck
+{
+  uint64_t checkpointCount;
+
+  uint64_t failedCount[AAC_STATE_PRECISION_COUNT];  // Checkpoints that didn't restore within the precision
+  uint64_t differingCount[AAC_STATE_PRECISION_COUNT];  // Blocks whose output changed
+  int      maxError[AAC_STATE_PRECISION_COUNT];  // In output samples
+};
+
+// With --check-seek, how seeks into each frame compare with an uninterrupted
+//  decode
+struct SeekCheck
+{
+  uint64_t seekCount;
+
+  uint64_t failedCount;  // Seeks that didn't decode, or an index that didn't build
+  uint64_t differingCount;  // Seeks whose output changed
+};
+
+// A block of the uninterrupted decode, for --check-seek
+struct SeekReference
+{
+  size_t               previousOffset;  // Of the frame the decoder had decoded before this one
+  std::vector<int16_t> samples;
+};
+
+// The decoder behind a reference block was new, or had failed a frame
+#define SEEK_REFERENCE_FRESH   SIZE_MAX
+#define SEEK_REFERENCE_UNKNOWN (SIZE_MAX - 1)
+
+struct BenchTotals
+{
+  uint64_t inputBytes;
+  uint64_t frameCount;
+  uint64_t failedCount;
+  double   audioSeconds;
+
+  double   wallSeconds;
+  double   cpuSeconds;
+};
+
+// Keeps the decoded samples alive, so no part of the decode is optimized away
+static volatile uint32_t sinkChecksum;
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--repeat <n>] [--per-file | --multi-stream <n>] [--json] [--baseline <file>] [--threshold <percent>] <file-or-directory>...\n", name);
+  fprintf(stderr, "       %s --check-state <file-or-directory>...\n", name);
+  fprintf(stderr, "       %s --check-seek <file-or-directory>...\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Decodes a corpus of ADTS files from memory, discarding the output, and reports\n");
+  fprintf(stderr, "the throughput of the fastest of --repeat passes (default %d). A directory\n", DEFAULT_REPEAT_COUNT);
+  fprintf(stderr, "stands for every .aac file in it. --per-file breaks the results down by file,\n");
+  fprintf(stderr, "with each one's bitrate and share of switched windows. --json prints the\n");
+  fprintf(stderr, "results as JSON, which can later be given to --baseline: the run then fails\n");
+  fprintf(stderr, "with status 2 if realtime per core is more than --threshold percent (default\n");
+  fprintf(stderr, "%g) below the baseline's.\n", DEFAULT_THRESHOLD_PERCENT);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "--multi-stream decodes n files at a time instead, a frame from each in turn,\n");
+  fprintf(stderr, "with their long windows transformed together. Each file's output is checked\n");
+  fprintf(stderr, "against a serial decode, and the run fails if any differ.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "--check-state times nothing. Ahead of every frame it saves the decoder state\n");
+  fprintf(stderr, "at each precision and restores it into a second decoder. It fails unless each\n");
+  fprintf(stderr, "overlap sample comes back within the rounding of its precision, and full\n");
+  fprintf(stderr, "precision decodes the next block exactly. How far the block is off at the\n");
+  fprintf(stderr, "other precisions is reported.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "--check-seek times nothing either. It indexes each file and seeks to a sample\n");
+  fprintf(stderr, "in every frame, at a different place in each. It fails unless the trimmed\n");
+  fprintf(stderr, "block and the one after it match the uninterrupted decode exactly.\n");
+  exit(1);
+}
+
+static bool readWholeFile(const char *filename, std::vector<uint8_t> *bytes)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st))
+  {
+    close(fd);
+    return false;
+  }
+
+  bytes->resize(st.st_size);
+
+  size_t position = 0;
+  while (position < bytes->size())
+  {
+    ssize_t count = read(fd, bytes->data() + position, bytes->size() - position);
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      close(fd);
+      return false;
+    }
+
+    if (count == 0)
+      break;
+
+    position += count;
+  }
+
+  bytes->resize(position);
+  close(fd);
+  return true;
+}
+
+// Adds a file, or every .aac file in a directory in name order
+static bool addInput(const char *path, std::vector<std::string> *paths)
+{
+  struct stat st;
+  if (stat(path, &st))
+    return false;
+
+  if (!S_ISDIR(st.st_mode))
+  {
+    paths->push_back(path);
+    return true;
+  }
+
+  DIR *dir = opendir(path);
+  if (!dir)
+    return false;
+
+  std::vector<std::string> names;
+
+  struct dirent *entry;
+  while ((entry = readdir(dir)))
+  {
+    size_t length = strlen(entry->d_name);
+    if ((length > 4) && !strcmp(entry->d_name + length - 4, ".aac"))
+      names.push_back(entry->d_name);
+  }
+
+  closedir(dir);
+
+  std::sort(names.begin(), names.end());
+
+  for (const auto &name : names)
+    paths->push_back(std::string(path) + "/" + name);
+
+  return true;
+}
+
+static double getCpuSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+  return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static uint64_t hashOutput(uint64_t hash, AacAudioBlock *audio)
+{
+  const int16_t *samples = audio->getSamples();
+
+  for (unsigned int i = 0; i < audio->getSampleCount(); i++)
+  {
+    hash ^= static_cast<uint16_t>(samples[i]);
+    hash *= OUTPUT_HASH_PRIME;
+  }
+
+  return hash;
+}
+
+// Decodes one file start to finish with a fresh decoder, as a transcode
+//  would, and records what it contained. If outputHash is given, every
+//  sample decoded goes into it.
+static void decodeFile(BenchFile *file, AacSpectralBlock *block, AacAudioBlock *audio, uint64_t *outputHash = NULL)
+{
+  auto reader = AacAdtsFrameReader(file->bytes.data(), file->bytes.size());
+  reader.skipID3();
+
+  file->frameCount = 0;
+  file->failedCount = 0;
+  file->audioSeconds = 0.0;
+  file->channelBlockCount = 0;
+  file->switchedBlockCount = 0;
+
+  std::unique_ptr<AacDecoder> decoder;
+  uint32_t checksum = 0;
+
+  while (!reader.isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!reader.readFrame(&frame))
+    {
+      reader.findNextFrame();
+      continue;
+    }
+
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+    if (!decoder || (decoder->getSampleRate() != sampleRate))
+      decoder = std::make_unique<AacDecoder>(sampleRate);
+
+    if (decoder->parseFrame(&frame, block) && decoder->transformBlock(block, audio))
+    {
+      file->frameCount++;
+      file->audioSeconds += static_cast<double>(AAC_AUDIO_BLOCK_SAMPLE_COUNT) / sampleRate;
+
+      for (unsigned int i = 0; i < block->channelCount; i++)
+      {
+        if (block->channels[i].ics.windowSequence != AAC_WINSEQ_LONG)
+          file->switchedBlockCount++;
+      }
+
+      file->channelBlockCount += block->channelCount;
+
+      const int16_t *samples = audio->getSamples();
+      checksum += samples[0] + samples[audio->getSampleCount() - 1];
+
+      if (outputHash)
+        *outputHash = hashOutput(*outputHash, audio);
+    }
+    else
+    {
+      file->failedCount++;
+    }
+
+    reader.advance(frame.getSize());
+  }
+
+  sinkChecksum = sinkChecksum + checksum;
+}
+
+// Decodes the whole corpus a frame from each of several files at a time, as
+//  a server handling many streams would, hashing each file's output into
+//  hashes. A stream moves on to the next file as soon as it finishes one.
+static void decodeMultiStream(std::vector<BenchFile> *files, AacMultiStreamDecoder *decoder, std::vector<uint64_t> *hashes)
+{
+  unsigned int streamCount = decoder->getStreamCount();
+
+  std::vector<std::unique_ptr<AacAdtsFrameReader>> readers(streamCount);
+  std::vector<size_t> fileIndexes(streamCount);
+
+  std::vector<AacAdtsFrame> frames(streamCount);
+  std::vector<AacAdtsFrame *> framePointers(streamCount);
+  std::vector<AacAudioBlock> audio(streamCount);
+  auto isDecoded = std::make_unique<bool[]>(streamCount);
+
+  hashes->assign(files->size(), OUTPUT_HASH_OFFSET);
+
+  size_t nextFile = 0;
+
+  while (true)
+  {
+    unsigned int activeCount = 0;
+
+    for (unsigned int s = 0; s < streamCount; s++)
+    {
+      framePointers[s] = NULL;
+
+      while (true)
+      {
+        if (!readers[s])
+        {
+          if (nextFile == files->size())
+            break;
+
+          BenchFile *file = &(*files)[nextFile];
+
+          fileIndexes[s] = nextFile++;
+          readers[s] = std::make_unique<AacAdtsFrameReader>(file->bytes.data(), file->bytes.size());
+          readers[s]->skipID3();
+
+          decoder->resetStream(s);
+        }
+
+        if (readers[s]->isComplete())
+        {
+          readers[s].reset();
+          continue;
+        }
+
+        frames[s] = AacAdtsFrame();
+        if (!readers[s]->readFrame(&frames[s]))
+        {
+          readers[s]->findNextFrame();
+          continue;
+        }
+
+        framePointers[s] = &frames[s];
+        activeCount++;
+        break;
+      }
+    }
+
+    if (activeCount == 0)
+      break;
+
+    decoder->decodeBlocks(framePointers.data(), audio.data(), isDecoded.get());
+
+    for (unsigned int s = 0; s < streamCount; s++)
+    {
+      if (!framePointers[s])
+        continue;
+
+      if (isDecoded[s])
+        (*hashes)[fileIndexes[s]] = hashOutput((*hashes)[fileIndexes[s]], &audio[s]);
+
+      readers[s]->advance(frames[s].getSize());
+    }
+  }
+}
+
+// The channels of a full precision checkpoint, laid out as in AacDecoder.h,
+//  keyed by element, instance and ordinal
+static std::map<uint32_t, const uint8_t *> getStateChannels(const std::vector<uint8_t> &state)
+{
+  std::map<uint32_t, const uint8_t *> channels;
+
+  size_t channelSize = sizeof(AacDecoderStateChannel) + AacChannelDecoder::getStateSize(AAC_STATE_FLOAT64);
+
+  for (size_t offset = sizeof(AacDecoderStateHeader); offset + channelSize <= state.size(); offset += channelSize)
+  {
+    AacDecoderStateChannel channel;
+    memcpy(&channel, &state[offset], sizeof(channel));
+
+    channels[(channel.elementId << 16) | (channel.instance << 8) | channel.ordinal] = &state[offset + sizeof(channel)];
+  }
+
+  return channels;
+}
+
+// Whether every channel of a checkpoint came back from a round trip through
+//  the given precision with the same history, and its overlap samples within
+//  the rounding of the precision. Restoring keeps the restored decoder's
+//  other channel decoders, reset, so those must come back empty.
+static bool isStateRestored(const std::vector<uint8_t> &original, const std::vector<uint8_t> &restored, AacStatePrecision precision)
+{
+  auto originalChannels = getStateChannels(original);
+  auto restoredChannels = getStateChannels(restored);
+
+  static const uint8_t emptyChannel[sizeof(AacChannelState) + (sizeof(double) * AAC_AUDIO_SAMPLE_OUTPUT_COUNT)] = {};
+
+  for (auto &item : restoredChannels)
+  {
+    auto match = originalChannels.find(item.first);
+    if (match == originalChannels.end())
+    {
+      AacChannelState state;
+      memcpy(&state, item.second, sizeof(state));
+
+      if ((state.blockCount != 0) || memcmp(item.second + sizeof(state), emptyChannel + sizeof(state), sizeof(emptyChannel) - sizeof(state)))
+        return false;
+
+      continue;
+    }
+
+    if (memcmp(match->second, item.second, sizeof(AacChannelState)))
+      return false;
+
+    double expected[AAC_AUDIO_SAMPLE_OUTPUT_COUNT];
+    double actual[AAC_AUDIO_SAMPLE_OUTPUT_COUNT];
+    memcpy(expected, match->second + sizeof(AacChannelState), sizeof(expected));
+    memcpy(actual, item.second + sizeof(AacChannelState), sizeof(actual));
+
+    double limit = AAC_STATE_FLOAT16_LIMIT * AAC_STATE_SAMPLE_SCALE;
+
+    for (unsigned int s = 0; s < AAC_AUDIO_SAMPLE_OUTPUT_COUNT; s++)
+    {
+      double sample = (precision == AAC_STATE_FLOAT16) ? std::clamp(expected[s], -limit, limit) : expected[s];
+      double allowed = (fabs(sample) * stateRelativeErrors[precision]) + stateAbsoluteErrors[precision];
+
+      if (!(fabs(actual[s] - sample) <= allowed))
+        return false;
+    }
+  }
+
+  // Restoring may only add channels
+  return restoredChannels.size() >= originalChannels.size();
+}
+
+// Checkpoints the decoder ahead of every frame of a file at each precision,
+//  and checks the round trip and the next block decoded from the restored
+//  state against the uninterrupted decode
+static void checkState(BenchFile *file, AacAudioBlock *audio, StateCheck *check)
+{
+  auto reader = AacAdtsFrameReader(file->bytes.data(), file->bytes.size());
+  reader.skipID3();
+
+  std::unique_ptr<AacDecoder> decoder;
+  std::unique_ptr<AacDecoder> restored;
+
+  std::vector<uint8_t> states[AAC_STATE_PRECISION_COUNT];
+  std::vector<uint8_t> roundTrip;
+  AacAudioBlock restoredAudio;
+
+  while (!reader.isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!reader.readFrame(&frame))
+    {
+      reader.findNextFrame();
+      continue;
+    }
+
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+    if (!decoder || (decoder->getSampleRate() != sampleRate))
+    {
+      decoder = std::make_unique<AacDecoder>(sampleRate);
+      restored = std::make_unique<AacDecoder>(sampleRate);
+    }
+
+    for (unsigned int p = 0; p < AAC_STATE_PRECISION_COUNT; p++)
+      decoder->saveState(&states[p], static_cast<AacStatePrecision>(p));
+
+    if (!decoder->decodeFrame(&frame, audio))
+    {
+      reader.advance(frame.getSize());
+      continue;
+    }
+
+    check->checkpointCount++;
+
+    for (unsigned int p = 0; p < AAC_STATE_PRECISION_COUNT; p++)
+    {
+      if (!restored->restoreState(states[p].data(), states[p].size()))
+      {
+        check->failedCount[p]++;
+        continue;
+      }
+
+      restored->saveState(&roundTrip, AAC_STATE_FLOAT64);
+
+      // The frame's bit reader has been used up, so it's read again
+      auto again = AacAdtsFrame();
+      reader.readFrame(&again);
+
+      if (!isStateRestored(states[AAC_STATE_FLOAT64], roundTrip, static_cast<AacStatePrecision>(p)) || !restored->decodeFrame(&again, &restoredAudio) ||
+          (restoredAudio.getSampleCount() != audio->getSampleCount()))
+      {
+        check->failedCount[p]++;
+        continue;
+      }
+
+      const int16_t *expected = audio->getSamples();
+      const int16_t *actual = restoredAudio.getSamples();
+
+      int maxError = 0;
+      for (unsigned int i = 0; i < audio->getSampleCount(); i++)
+        maxError = std::max(maxError, abs(actual[i] - expected[i]));
+
+      if (maxError)
+        check->differingCount[p]++;
+
+      check->maxError[p] = std::max(check->maxError[p], maxError);
+    }
+
+    reader.advance(frame.getSize());
+  }
+}
+
+// Whether a seek into the frame at an index entry starts from the same
+//  decoder state as the uninterrupted decode did: either both decoded the
+//  frame before, or both start afresh at a sample rate change
+static bool isSeekComparable(const AacAdtsIndex &index, const uint8_t *bytes, size_t frame, const SeekReference &reference)
+{
+  if (reference.previousOffset == SEEK_REFERENCE_UNKNOWN)
+    return false;
+
+  if (frame == 0)
+    return reference.previousOffset == SEEK_REFERENCE_FRESH;
+
+  size_t previousOffset = index.getEntry(frame - 1).offset;
+  if (reference.previousOffset == previousOffset)
+    return true;
+
+  unsigned int sampleRate = AacAdtsFrameHeader(bytes + index.getEntry(frame).offset).getSampleRate();
+  unsigned int previousSampleRate = AacAdtsFrameHeader(bytes + previousOffset).getSampleRate();
+
+  return (reference.previousOffset == SEEK_REFERENCE_FRESH) && (sampleRate != previousSampleRate);
+}
+
+// Indexes a file and seeks into every frame that the uninterrupted decode
+//  decoded, checking the trimmed block and the one after it against that
+//  decode
+static void checkSeek(BenchFile *file, AacAudioBlock *audio, SeekCheck *check)
+{
+  auto reader = AacAdtsFrameReader(file->bytes.data(), file->bytes.size());
+  reader.skipID3();
+
+  AacAdtsIndex index;
+  if (!index.build(&reader))
+  {
+    check->failedCount++;
+    return;
+  }
+
+  // The uninterrupted decode, by frame offset
+  std::map<size_t, SeekReference> references;
+  std::unique_ptr<AacDecoder> decoder;
+  size_t previousOffset = SEEK_REFERENCE_FRESH;
+
+  while (!reader.isComplete())
+  {
+    auto frame = AacAdtsFrame();
+    if (!reader.readFrame(&frame))
+    {
+      reader.findNextFrame();
+      continue;
+    }
+
+    unsigned int sampleRate = frame.getHeader()->getSampleRate();
+    if (!decoder || (decoder->getSampleRate() != sampleRate))
+    {
+      decoder = std::make_unique<AacDecoder>(sampleRate);
+      previousOffset = SEEK_REFERENCE_FRESH;
+    }
+
+    size_t offset = reader.getPosition();
+    if (decoder->decodeFrame(&frame, audio))
+    {
+      references[offset] = {previousOffset, std::vector<int16_t>(audio->getSamples(), audio->getSamples() + audio->getSampleCount())};
+      previousOffset = offset;
+    }
+    else
+    {
+      previousOffset = SEEK_REFERENCE_UNKNOWN;
+    }
+
+    reader.advance(frame.getSize());
+  }
+
+  auto seeker = AacSeekableDecoder(file->bytes.data(), &index);
+
+  // Past the end there's nothing to seek to
+  if (seeker.seekToSample(index.getSampleCount()))
+    check->failedCount++;
+
+  for (size_t i = 0; i < index.getFrameCount(); i++)
+  {
+    AacAdtsIndexEntry entry = index.getEntry(i);
+
+    auto reference = references.find(entry.offset);
+    if ((reference == references.end()) || !isSeekComparable(index, file->bytes.data(), i, reference->second))
+      continue;
+
+    check->seekCount++;
+
+    // Spread the seeks over every part of a block
+    unsigned int trimCount = (i * 397) % AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+
+    unsigned int startSample;
+    if (!seeker.seekToSample(entry.sample + trimCount) || !seeker.decodeBlock(audio, &startSample))
+    {
+      check->failedCount++;
+      continue;
+    }
+
+    const std::vector<int16_t> &expected = reference->second.samples;
+    size_t start = static_cast<size_t>(trimCount) * audio->getChannelCount();
+
+    if ((startSample != trimCount) || (audio->getSampleCount() != expected.size()) ||
+        memcmp(audio->getSamples() + start, expected.data() + start, (expected.size() - start) * sizeof(int16_t)))
+    {
+      check->differingCount++;
+      continue;
+    }
+
+    // The next block carries on from the seek's, as it did serially
+    if (i + 1 == index.getFrameCount())
+      continue;
+
+    auto next = references.find(index.getEntry(i + 1).offset);
+    if ((next == references.end()) || (next->second.previousOffset != entry.offset))
+      continue;
+
+    if (!seeker.decodeBlock(audio, &startSample))
+    {
+      check->failedCount++;
+      continue;
+    }
+
+    if ((startSample != 0) || (audio->getSampleCount() != next->second.samples.size()) ||
+        memcmp(audio->getSamples(), next->second.samples.data(), next->second.samples.size() * sizeof(int16_t)))
+    {
+      check->differingCount++;
+    }
+  }
+}
+
+static void addTotals(BenchTotals *totals, const BenchFile *file)
+{
+  totals->inputBytes   += file->bytes.size();
+  totals->frameCount   += file->frameCount;
+  totals->failedCount  += file->failedCount;
+  totals->audioSeconds += file->audioSeconds;
+  totals->wallSeconds  += file->wallSeconds;
+  totals->cpuSeconds   += file->cpuSeconds;
+}
+
+static double getRealtimePerCore(double audioSeconds, double cpuSeconds)
+{
+  return (cpuSeconds > 0.0) ? (audioSeconds / cpuSeconds) : 0.0;
+}
+
+static double getBitrateKbps(const BenchFile *file)
+{
+  return (file->audioSeconds > 0.0) ? (file->bytes.size() * 8.0 / file->audioSeconds / 1000.0) : 0.0;
+}
+
+static double getSwitchingPercent(const BenchFile *file)
+{
+  return file->channelBlockCount ? (100.0 * file->switchedBlockCount / file->channelBlockCount) : 0.0;
+}
+
+static void printJsonString(const char *text)
+{
+  putchar('"');
+
+  for (const char *p = text; *p; p++)
+  {
+    if ((*p == '"') || (*p == '\\'))
+      printf("\\%c", *p);
+    else if (static_cast<unsigned char>(*p) < 0x20)
+      printf("\\u%04x", *p);
+    else
+      putchar(*p);
+  }
+
+  putchar('"');
+}
+
+static void printJson(const BenchTotals *totals, long peakRssKb, unsigned int repeatCount, unsigned int streamCount, const std::vector<BenchFile> &files, bool isPerFile)
+{
+  printf("{\n");
+  printf("  \"files\": %zu,\n", files.size());
+  printf("  \"repeat\": %u,\n", repeatCount);
+
+  if (streamCount)
+    printf("  \"streams\": %u,\n", streamCount);
+
+  printf("  \"input_bytes\": %llu,\n", static_cast<unsigned long long>(totals->inputBytes));
+  printf("  \"frames\": %llu,\n", static_cast<unsigned long long>(totals->frameCount));
+  printf("  \"failed_frames\": %llu,\n", static_cast<unsigned long long>(totals->failedCount));
+  printf("  \"audio_seconds\": %.3f,\n", totals->audioSeconds);
+  printf("  \"wall_seconds\": %.6f,\n", totals->wallSeconds);
+  printf("  \"cpu_seconds\": %.6f,\n", totals->cpuSeconds);
+  printf("  \"mb_per_s\": %.3f,\n", totals->inputBytes / totals->wallSeconds / 1e6);
+  printf("  \"frames_per_s\": %.1f,\n", totals->frameCount / totals->wallSeconds);
+  printf("  \"realtime_per_core\": %.2f,\n", getRealtimePerCore(totals->audioSeconds, totals->cpuSeconds));
+  printf("  \"peak_rss_kb\": %ld", peakRssKb);
+
+  if (isPerFile)
+  {
+    printf(",\n  \"per_file\": [\n");
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      const BenchFile *file = &files[i];
+
+      printf("    {\"path\": ");
+      printJsonString(file->path.c_str());
+      printf(", \"frames\": %llu, \"failed_frames\": %llu, \"kbps\": %.1f, \"window_switching_percent\": %.2f, \"realtime_per_core\": %.2f}%s\n",
+             static_cast<unsigned long long>(file->frameCount), static_cast<unsigned long long>(file->failedCount), getBitrateKbps(file), getSwitchingPercent(file),
+             getRealtimePerCore(file->audioSeconds, file->cpuSeconds), (i + 1 < files.size()) ? "," : "");
+    }
+
+    printf("  ]");
+  }
+
+  printf("\n}\n");
+}
+
+static void printText(const BenchTotals *totals, long peakRssKb, unsigned int repeatCount, unsigned int streamCount, const std::vector<BenchFile> &files, bool isPerFile)
+{
+  printf("Files:       %zu, %.1f MB held in memory\n", files.size(), totals->inputBytes / 1e6);
+  printf("Frames:      %llu (%llu failed)\n", static_cast<unsigned long long>(totals->frameCount), static_cast<unsigned long long>(totals->failedCount));
+  printf("Audio:       %.1f s\n", totals->audioSeconds);
+  printf("Decode:      %.3f s wall, %.3f s CPU (fastest of %u)\n", totals->wallSeconds, totals->cpuSeconds, repeatCount);
+
+  if (streamCount)
+    printf("Streams:     %u at once\n", streamCount);
+  printf("Throughput:  %.2f MB/s, %.0f frames/s\n", totals->inputBytes / totals->wallSeconds / 1e6, totals->frameCount / totals->wallSeconds);
+  printf("Realtime:    %.1fx per core\n", getRealtimePerCore(totals->audioSeconds, totals->cpuSeconds));
+  printf("Peak RSS:    %.1f MB\n", peakRssKb / 1024.0);
+
+  if (!isPerFile)
+    return;
+
+  printf("\n%8s %8s %10s %10s  %s\n", "frames", "kbps", "switching", "realtime", "file");
+
+  for (const auto &file : files)
+  {
+    printf("%8llu %8.1f %9.2f%% %9.1fx  %s\n", static_cast<unsigned long long>(file.frameCount), getBitrateKbps(&file), getSwitchingPercent(&file),
+           getRealtimePerCore(file.audioSeconds, file.cpuSeconds), file.path.c_str());
+  }
+}
+
+// Finds a top-level number in JSON written by --json. The totals come before
+//  the per-file entries, so the first match is the right one.
+static bool findJsonNumber(const std::string &json, const char *key, double *value)
+{
+  std::string quoted = std::string("\"") + key + "\"";
+
+  size_t position = json.find(quoted);
+  if (position == std::string::npos)
+    return false;
+
+  const char *p = json.c_str() + position + quoted.size();
+  while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))
+    p++;
+
+  if (*p++ != ':')
+    return false;
+
+  char *end;
+  *value = strtod(p, &end);
+
+  return end != p;
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"repeat",       required_argument, NULL, 'r'},
+    {"per-file",     no_argument,       NULL, 'p'},
+    {"json",         no_argument,       NULL, 'j'},
+    {"baseline",     required_argument, NULL, 'b'},
+    {"threshold",    required_argument, NULL, 't'},
+    {"multi-stream", required_argument, NULL, 'm'},
+    {"check-state",  no_argument,       NULL, 's'},
+    {"check-seek",   no_argument,       NULL, 'k'},
+    {NULL,           0,                 NULL, 0},
+  };
+
+  unsigned int repeatCount = DEFAULT_REPEAT_COUNT;
+  bool isPerFile = false;
+  bool isJson = false;
+  const char *baselineFilename = NULL;
+  double thresholdPercent = DEFAULT_THRESHOLD_PERCENT;
+  unsigned int streamCount = 0;
+  bool isStateChecked = false;
+  bool isSeekChecked = false;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "r:pjb:t:m:sk", options, NULL)) != -1)
+  {
+    char *end;
+
+    switch (opt)
+    {
+    case 'r':
+      repeatCount = strtoul(optarg, &end, 10);
+      if (*end || (repeatCount == 0))
+        usage(argv[0]);
+      break;
+    case 'p':
+      isPerFile = true;
+      break;
+    case 'j':
+      isJson = true;
+      break;
+    case 'b':
+      baselineFilename = optarg;
+      break;
+    case 't':
+      thresholdPercent = strtod(optarg, &end);
+      if (*end || (thresholdPercent < 0.0))
+        usage(argv[0]);
+      break;
+    case 'm':
+      streamCount = strtoul(optarg, &end, 10);
+      if (*end || (streamCount == 0) || (streamCount > MAX_STREAM_COUNT))
+        usage(argv[0]);
+      break;
+    case 's':
+      isStateChecked = true;
+      break;
+    case 'k':
+      isSeekChecked = true;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  // Files are decoded together, so there are no times for each one
+  if ((optind == argc) || (isPerFile && streamCount))
+    usage(argv[0]);
+
+  if ((isStateChecked || isSeekChecked) && (isPerFile || streamCount || isJson || baselineFilename))
+    usage(argv[0]);
+
+  if (isStateChecked && isSeekChecked)
+    usage(argv[0]);
+
+  std::vector<std::string> paths;
+  for (int i = optind; i < argc; i++)
+  {
+    if (!addInput(argv[i], &paths))
+    {
+      fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+      exit(1);
+    }
+  }
+
+  if (paths.empty())
+  {
+    fprintf(stderr, "No .aac files found\n");
+    exit(1);
+  }
+
+  // Read the baseline first, so a bad path fails before the long part
+  double baselineRealtime = 0.0;
+  if (baselineFilename)
+  {
+    std::vector<uint8_t> bytes;
+    if (!readWholeFile(baselineFilename, &bytes))
+    {
+      fprintf(stderr, "%s: %s\n", baselineFilename, strerror(errno));
+      exit(1);
+    }
+
+    if (!findJsonNumber(std::string(bytes.begin(), bytes.end()), "realtime_per_core", &baselineRealtime) || (baselineRealtime <= 0.0))
+    {
+      fprintf(stderr, "%s: No realtime_per_core result found\n", baselineFilename);
+      exit(1);
+    }
+  }
+
+  std::vector<BenchFile> files(paths.size());
+  for (size_t i = 0; i < paths.size(); i++)
+  {
+    files[i].path = paths[i];
+
+    if (!readWholeFile(paths[i].c_str(), &files[i].bytes))
+    {
+      fprintf(stderr, "%s: %s\n", paths[i].c_str(), strerror(errno));
+      exit(1);
+    }
+  }
+
+  auto block = std::make_unique<AacSpectralBlock>();
+  AacAudioBlock audio;
+
+  if (isStateChecked)
+  {
+    static const char *precisionNames[AAC_STATE_PRECISION_COUNT] = {"float64", "float32", "float16"};
+
+    StateCheck check = {};
+    for (auto &file : files)
+      checkState(&file, &audio, &check);
+
+    if (check.checkpointCount == 0)
+    {
+      fprintf(stderr, "No frames could be decoded\n");
+      exit(1);
+    }
+
+    printf("Checkpoints: %llu\n", static_cast<unsigned long long>(check.checkpointCount));
+
+    bool isPassed = true;
+    for (unsigned int p = 0; p < AAC_STATE_PRECISION_COUNT; p++)
+    {
+      bool isRestored = (check.failedCount[p] == 0) && ((p != AAC_STATE_FLOAT64) || (check.maxError[p] == 0));
+
+      printf("%s:     %llu failed, %llu blocks differ, by up to %d: %s\n", precisionNames[p], static_cast<unsigned long long>(check.failedCount[p]),
+             static_cast<unsigned long long>(check.differingCount[p]), check.maxError[p], isRestored ? "ok" : "FAILED");
+
+      isPassed = isPassed && isRestored;
+    }
+
+    return isPassed ? 0 : 1;
+  }
+
+  if (isSeekChecked)
+  {
+    SeekCheck check = {};
+    for (auto &file : files)
+      checkSeek(&file, &audio, &check);
+
+    if ((check.seekCount == 0) && (check.failedCount == 0))
+    {
+      fprintf(stderr, "No frames could be decoded\n");
+      exit(1);
+    }
+
+    bool isPassed = (check.failedCount == 0) && (check.differingCount == 0);
+
+    printf("Seeks: %llu, %llu failed, %llu differ: %s\n", static_cast<unsigned long long>(check.seekCount), static_cast<unsigned long long>(check.failedCount),
+           static_cast<unsigned long long>(check.differingCount), isPassed ? "ok" : "FAILED");
+
+    return isPassed ? 0 : 1;
+  }
+
+  // Every file's fastest pass counts; a slow pass is nearly always
+  //  interference from elsewhere on the machine
+  std::vector<double> bestWall(files.size(), 0.0);
+  std::vector<double> bestCpu(files.size(), 0.0);
+
+  for (unsigned int pass = 0; (pass < repeatCount) && !streamCount; pass++)
+  {
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      auto wallStart = std::chrono::steady_clock::now();
+      double cpuStart = getCpuSeconds();
+
+      decodeFile(&files[i], block.get(), &audio);
+
+      double cpuSeconds = getCpuSeconds() - cpuStart;
+      double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+      if ((pass == 0) || (cpuSeconds < bestCpu[i]))
+      {
+        bestCpu[i] = cpuSeconds;
+        bestWall[i] = wallSeconds;
+      }
+    }
+  }
+
+  // With --multi-stream, the serial decode is only the reference for the
+  //  output, and gives what each file contains, so it isn't timed
+  unsigned int mismatchCount = 0;
+  double bestStreamWall = 0.0;
+  double bestStreamCpu = 0.0;
+
+  if (streamCount)
+  {
+    for (auto &file : files)
+    {
+      file.outputHash = OUTPUT_HASH_OFFSET;
+      decodeFile(&file, block.get(), &audio, &file.outputHash);
+    }
+
+    AacMultiStreamDecoder decoder(streamCount);
+    std::vector<uint64_t> hashes;
+
+    for (unsigned int pass = 0; pass < repeatCount; pass++)
+    {
+      auto wallStart = std::chrono::steady_clock::now();
+      double cpuStart = getCpuSeconds();
+
+      decodeMultiStream(&files, &decoder, &hashes);
+
+      double cpuSeconds = getCpuSeconds() - cpuStart;
+      double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+      if ((pass == 0) || (cpuSeconds < bestStreamCpu))
+      {
+        bestStreamCpu = cpuSeconds;
+        bestStreamWall = wallSeconds;
+      }
+    }
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+      if (hashes[i] != files[i].outputHash)
+      {
+        fprintf(stderr, "%s: Multi-stream output differs from the serial decode\n", files[i].path.c_str());
+        mismatchCount++;
+      }
+    }
+  }
+
+  BenchTotals totals = {};
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    files[i].cpuSeconds = bestCpu[i];
+    files[i].wallSeconds = bestWall[i];
+
+    addTotals(&totals, &files[i]);
+  }
+
+  if (streamCount)
+  {
+    totals.wallSeconds = bestStreamWall;
+    totals.cpuSeconds = bestStreamCpu;
+  }
+
+  if (totals.frameCount == 0)
+  {
+    fprintf(stderr, "No frames could be decoded\n");
+    exit(1);
+  }
+
+  struct rusage resources;
+  getrusage(RUSAGE_SELF, &resources);
+  long peakRssKb = resources.ru_maxrss;
+
+  if (isJson)
+    printJson(&totals, peakRssKb, repeatCount, streamCount, files, isPerFile);
+  else
+    printText(&totals, peakRssKb, repeatCount, streamCount, files, isPerFile);
+
+  if (mismatchCount)
+  {
+    fprintf(stderr, "%u of %zu files decoded differently\n", mismatchCount, files.size());
+    exit(1);
+  }
+
+  if (!baselineFilename)
+    return 0;
+
+  // Reported on stderr, which keeps --json output clean
+  double realtime = getRealtimePerCore(totals.audioSeconds, totals.cpuSeconds);
+  double changePercent = 100.0 * (realtime - baselineRealtime) / baselineRealtime;
+  bool isRegression = changePercent < -thresholdPercent;
+
+  fprintf(stderr, "Baseline:    %.1fx per core, now %.1fx (%+.1f%%, threshold -%g%%): %s\n", baselineRealtime, realtime, changePercent, thresholdPercent,
+          isRegression ? "REGRESSION" : "ok");
+
+  return isRegression ? 2 : 0;
+}
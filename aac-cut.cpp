@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <getopt.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+#include "AacAdtsFrameHeader.h"
+#include "AacAdtsFrameReader.h"
+#include "AacAdtsIndex.h"
+#include "AacAudioBlock.h"
+#include "AacAdtsCutter.h"
+
+// An input file, opened once however many ranges are taken from it
+struct Source
+{
+  int          fd;
+  uint8_t     *bytes;
+  size_t       size;
+  unsigned int sampleRate;  // Of the first frame, for converting times
+  AacAdtsIndex index;
+};
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--pre-roll] [--force] [--output <file>] <input> <start> <end> [<input> <start> <end>]...\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Copies whole ADTS frames from each range in turn, without decoding them, so\n");
+  fprintf(stderr, "several ranges concatenate or splice streams. Start and end are in seconds,\n");
+  fprintf(stderr, "and end may be \"end\". The output defaults to out.aac, and may be - for stdout.\n");
+  fprintf(stderr, "--pre-roll copies one extra frame before each range, to prime the decoder.\n");
+  fprintf(stderr, "--force writes splices between streams with different parameters.\n");
+  exit(1);
+}
+
+static Source *openSource(const char *filename)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) || (st.st_size == 0))
+  {
+    close(fd);
+    return NULL;
+  }
+
+  void *bytes = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (bytes == MAP_FAILED)
+  {
+    close(fd);
+    return NULL;
+  }
+
+  auto source = new Source;
+  source->fd = fd;
+  source->bytes = static_cast<uint8_t *>(bytes);
+  source->size = st.st_size;
+
+  auto reader = AacAdtsFrameReader(source->bytes, source->size);
+  reader.skipID3();
+
+  if (!source->index.open(&reader, filename) || (source->index.getFrameCount() == 0))
+  {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  source->sampleRate = AacAdtsFrameHeader(source->bytes + source->index.getEntry(0).offset).getSampleRate();
+
+  return source;
+}
+
+static bool parseTime(const char *text, const Source *source, uint64_t *sample)
+{
+  if (!strcmp(text, "end"))
+  {
+    *sample = source->index.getSampleCount();
+    return true;
+  }
+
+  char *end;
+  double seconds = strtod(text, &end);
+  if ((end == text) || *end || (seconds < 0.0))
+    return false;
+
+  *sample = llround(seconds * source->sampleRate);
+  return true;
+}
+
+static void describeSegment(unsigned int number, const char *filename, const AacAdtsCutSegment *segment, unsigned int sampleRate)
+{
+  size_t preRollCount = segment->hasPreRoll ? 1 : 0;
+  size_t wantedFirst = segment->firstFrame + preRollCount;
+
+  uint64_t firstSample = segment->index->getEntry(wantedFirst).sample;
+  uint64_t copiedSamples = (segment->frameCount - preRollCount) * AAC_AUDIO_BLOCK_SAMPLE_COUNT;
+
+  fprintf(stderr, "Range %u: %s, frames %zu to %zu, %llu bytes, %.3f s from %.3f s\n", number, filename, segment->firstFrame, segment->firstFrame + segment->frameCount - 1,
+          static_cast<unsigned long long>(segment->size), static_cast<double>(copiedSamples) / sampleRate, static_cast<double>(firstSample) / sampleRate);
+
+  if (segment->leadingSamples || segment->trailingSamples)
+    fprintf(stderr, "  Rounded out to whole frames: %u samples before the start, %u after the end\n", segment->leadingSamples, segment->trailingSamples);
+
+  if (wantedFirst == 0)
+    fprintf(stderr, "  Starts the source stream, so it keeps the encoder's priming samples\n");
+  else if (segment->hasPreRoll)
+    fprintf(stderr, "  Pre-roll: frame %zu is copied first; drop its %u samples after decoding\n", segment->firstFrame, AAC_AUDIO_BLOCK_SAMPLE_COUNT);
+  else
+    fprintf(stderr, "  No pre-roll: its first %u samples decode without the overlap from before the cut\n", AAC_AUDIO_BLOCK_SAMPLE_COUNT);
+}
+
+static void describeSplice(unsigned int number, const AacAdtsCutSegment *segment)
+{
+  if (!segment->spliceMismatches)
+  {
+    fprintf(stderr, "Splice %u: parameters match; expect a brief transient where the blocks overlap\n", number);
+    return;
+  }
+
+  fprintf(stderr, "Splice %u: mismatched%s%s%s\n", number,
+          (segment->spliceMismatches & AAC_SPLICE_PROFILE) ? " profile" : "",
+          (segment->spliceMismatches & AAC_SPLICE_SAMPLE_RATE) ? " sample-rate" : "",
+          (segment->spliceMismatches & AAC_SPLICE_CHANNEL_CONFIG) ? " channel-configuration" : "");
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"pre-roll", no_argument,       NULL, 'p'},
+    {"force",    no_argument,       NULL, 'f'},
+    {"output",   required_argument, NULL, 'o'},
+    {NULL,       0,                 NULL, 0},
+  };
+
+  const char *outputFilename = "out.aac";
+  bool isForced = false;
+
+  AacAdtsCutter cutter;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "pfo:", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+    case 'p':
+      cutter.setPreRoll(true);
+      break;
+    case 'f':
+      isForced = true;
+      break;
+    case 'o':
+      outputFilename = optarg;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if ((optind == argc) || ((argc - optind) % 3))
+    usage(argv[0]);
+
+  std::map<std::string, Source *> sources;
+  std::vector<const char *> rangeFilenames;
+
+  for (int i = optind; i < argc; i += 3)
+  {
+    const char *filename = argv[i];
+
+    Source *&source = sources[filename];
+    if (!source && !(source = openSource(filename)))
+    {
+      fprintf(stderr, "%s: %s\n", filename, (errno == EINVAL) ? "No ADTS frames found" : strerror(errno));
+      exit(1);
+    }
+
+    uint64_t startSample, endSample;
+    if (!parseTime(argv[i + 1], source, &startSample) || !parseTime(argv[i + 2], source, &endSample))
+      usage(argv[0]);
+
+    if (!cutter.addRange(source->fd, source->bytes, &source->index, startSample, endSample))
+    {
+      fprintf(stderr, "%s: Range %s to %s is empty or past the end\n", filename, argv[i + 1], argv[i + 2]);
+      exit(1);
+    }
+
+    rangeFilenames.push_back(filename);
+  }
+
+  auto &segments = cutter.getSegments();
+  for (size_t i = 0; i < segments.size(); i++)
+  {
+    if (i > 0)
+      describeSplice(i, &segments[i]);
+
+    describeSegment(i + 1, rangeFilenames[i], &segments[i], sources[rangeFilenames[i]]->sampleRate);
+  }
+
+  if (!cutter.isCompatible() && !isForced)
+  {
+    fprintf(stderr, "Not writing a stream whose parameters change mid-way. Use --force to write it anyway.\n");
+    exit(1);
+  }
+
+  int outputFd = STDOUT_FILENO;
+  if (strcmp(outputFilename, "-"))
+  {
+    outputFd = open(outputFilename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outputFd < 0)
+    {
+      fprintf(stderr, "%s: %s\n", outputFilename, strerror(errno));
+      exit(1);
+    }
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  if (!cutter.write(outputFd))
+  {
+    fprintf(stderr, "Could not write output: %s\n", strerror(errno));
+    exit(1);
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+  uint64_t totalSize = 0;
+  for (const auto &segment : segments)
+    totalSize += segment.size;
+
+  fprintf(stderr, "Copied %llu bytes in %.0f us\n", static_cast<unsigned long long>(totalSize), seconds * 1e6);
+
+  if ((outputFd != STDOUT_FILENO) && close(outputFd))
+  {
+    fprintf(stderr, "%s: %s\n", outputFilename, strerror(errno));
+    exit(1);
+  }
+
+  return 0;
+}
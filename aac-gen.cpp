@@ -0,0 +1,325 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "AacAudioBlock.h"
+#include "AacAdtsGenerator.h"
+
+#define DEFAULT_DURATION 60.0
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [options] [<output>]\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Writes a synthetic AAC-LC ADTS stream of random content, by default to out.aac.\n");
+  fprintf(stderr, "The output may be - for stdout. The same options and seed always give the same\n");
+  fprintf(stderr, "bytes. Percentages are chances per block, channel or element.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "  --duration <s>         Length in seconds (default %.0f)\n", DEFAULT_DURATION);
+  fprintf(stderr, "  --frames <n>           Length in frames instead\n");
+  fprintf(stderr, "  --seed <n>             Random seed (default 1)\n");
+  fprintf(stderr, "  --sample-rate <Hz>     An ADTS sample rate (default 44100)\n");
+  fprintf(stderr, "  --channels <n>         Channel configuration 1 to 5 (default 2)\n");
+  fprintf(stderr, "  --bitrate <kbps>       Over all channels (default 128)\n");
+  fprintf(stderr, "  --bandwidth <Hz>       Highest frequency coded (default 16000)\n");
+  fprintf(stderr, "  --short <pct>          Blocks with eight short windows (default 5)\n");
+  fprintf(stderr, "  --kbd <pct>            Blocks with the KBD window shape (default 10)\n");
+  fprintf(stderr, "  --codebooks <list>     Section codebook weights as cb:weight,... for codebooks\n");
+  fprintf(stderr, "                         0 (zero) to 11 (escape); unlisted ones aren't used\n");
+  fprintf(stderr, "  --escapes <pct>        Non-zero escape codebook values that escape (default 1)\n");
+  fprintf(stderr, "  --tns <pct>            Channels with TNS (default 20)\n");
+  fprintf(stderr, "  --tns-order <n>        TNS filter order, at most 12, or 7 in short windows (default 8)\n");
+  fprintf(stderr, "  --ms <pct>             Channel pairs with M/S stereo (default 50)\n");
+  fprintf(stderr, "  --intensity <pct>      Channel pairs with intensity stereo (default 0)\n");
+  fprintf(stderr, "  --preset <name>        typical: the defaults above\n");
+  fprintf(stderr, "                         worst: full bandwidth at the highest bitrate, escape\n");
+  fprintf(stderr, "                         codebook only with 25%% escapes, half the blocks short,\n");
+  fprintf(stderr, "                         and order 12 TNS and M/S everywhere\n");
+  fprintf(stderr, "                         Options after --preset override it.\n");
+  exit(1);
+}
+
+static bool parseUnsigned(const char *text, unsigned int *value)
+{
+  char *end;
+  errno = 0;
+  unsigned long v = strtoul(text, &end, 10);
+  if ((end == text) || *end || errno || (v > UINT32_MAX))
+    return false;
+
+  *value = v;
+  return true;
+}
+
+static bool parsePercent(const char *text, double *value)
+{
+  char *end;
+  *value = strtod(text, &end);
+  return (end != text) && !*end && (*value >= 0.0) && (*value <= 100.0);
+}
+
+// A list of codebook:weight pairs
+static bool parseCodebookWeights(const char *text, unsigned int weights[AAC_GENERATOR_CODEBOOK_COUNT])
+{
+  unsigned int parsed[AAC_GENERATOR_CODEBOOK_COUNT] = {};
+
+  const char *p = text;
+  while (*p)
+  {
+    char *end;
+    unsigned long codebook = strtoul(p, &end, 10);
+    if ((end == p) || (*end != ':') || (codebook >= AAC_GENERATOR_CODEBOOK_COUNT))
+      return false;
+
+    p = end + 1;
+    unsigned long weight = strtoul(p, &end, 10);
+    if ((end == p) || ((*end != ',') && *end) || (weight > 1000000))
+      return false;
+
+    parsed[codebook] = weight;
+
+    p = (*end == ',') ? end + 1 : end;
+  }
+
+  memcpy(weights, parsed, sizeof(parsed));
+  return true;
+}
+
+static bool applyPreset(const char *name, AacAdtsGeneratorSettings *settings)
+{
+  if (!strcmp(name, "typical"))
+  {
+    uint32_t seed = settings->seed;
+    *settings = AacAdtsGeneratorSettings();
+    settings->seed = seed;
+    return true;
+  }
+
+  if (!strcmp(name, "worst"))
+  {
+    settings->bandwidth = settings->sampleRate / 2;
+    settings->bitrate = AacAdtsGenerator::getMaxBitrate(settings->sampleRate, settings->channelConfiguration);
+    settings->shortPercent = 50.0;
+    settings->kbdPercent = 50.0;
+
+    memset(settings->codebookWeights, 0, sizeof(settings->codebookWeights));
+    settings->codebookWeights[AAC_HCB_ESC] = 1;
+    settings->escapePercent = 25.0;
+
+    settings->tnsPercent = 100.0;
+    settings->tnsOrder = AAC_MAX_TNS_ORDER_LONG_LC;
+    settings->msPercent = 100.0;
+    settings->intensityPercent = 0.0;
+    return true;
+  }
+
+  return false;
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"duration",    required_argument, NULL, 'd'},
+    {"frames",      required_argument, NULL, 'f'},
+    {"seed",        required_argument, NULL, 'S'},
+    {"sample-rate", required_argument, NULL, 'r'},
+    {"channels",    required_argument, NULL, 'c'},
+    {"bitrate",     required_argument, NULL, 'b'},
+    {"bandwidth",   required_argument, NULL, 'w'},
+    {"short",       required_argument, NULL, 's'},
+    {"kbd",         required_argument, NULL, 'k'},
+    {"codebooks",   required_argument, NULL, 'C'},
+    {"escapes",     required_argument, NULL, 'e'},
+    {"tns",         required_argument, NULL, 't'},
+    {"tns-order",   required_argument, NULL, 'o'},
+    {"ms",          required_argument, NULL, 'm'},
+    {"intensity",   required_argument, NULL, 'i'},
+    {"preset",      required_argument, NULL, 'p'},
+    {NULL,          0,                 NULL, 0},
+  };
+
+  AacAdtsGeneratorSettings settings;
+  double duration = DEFAULT_DURATION;
+  unsigned int frameCount = 0;
+  unsigned int kbps;
+  bool isBitrateSet = false;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "d:f:S:r:c:b:w:s:k:C:e:t:o:m:i:p:", options, NULL)) != -1)
+  {
+    char *end;
+
+    switch (opt)
+    {
+    case 'd':
+      duration = strtod(optarg, &end);
+      if (*end || !(duration > 0.0))
+        usage(argv[0]);
+      frameCount = 0;
+      break;
+    case 'f':
+      if (!parseUnsigned(optarg, &frameCount) || (frameCount == 0))
+        usage(argv[0]);
+      break;
+    case 'S':
+      if (!parseUnsigned(optarg, &settings.seed))
+        usage(argv[0]);
+      break;
+    case 'r':
+      if (!parseUnsigned(optarg, &settings.sampleRate))
+        usage(argv[0]);
+      break;
+    case 'c':
+      if (!parseUnsigned(optarg, &settings.channelConfiguration))
+        usage(argv[0]);
+      break;
+    case 'b':
+      if (!parseUnsigned(optarg, &kbps) || (kbps == 0) || (kbps > UINT32_MAX / 1000))
+        usage(argv[0]);
+      settings.bitrate = kbps * 1000;
+      isBitrateSet = true;
+      break;
+    case 'w':
+      if (!parseUnsigned(optarg, &settings.bandwidth))
+        usage(argv[0]);
+      break;
+    case 's':
+      if (!parsePercent(optarg, &settings.shortPercent))
+        usage(argv[0]);
+      break;
+    case 'k':
+      if (!parsePercent(optarg, &settings.kbdPercent))
+        usage(argv[0]);
+      break;
+    case 'C':
+      if (!parseCodebookWeights(optarg, settings.codebookWeights))
+        usage(argv[0]);
+      break;
+    case 'e':
+      if (!parsePercent(optarg, &settings.escapePercent))
+        usage(argv[0]);
+      break;
+    case 't':
+      if (!parsePercent(optarg, &settings.tnsPercent))
+        usage(argv[0]);
+      break;
+    case 'o':
+      if (!parseUnsigned(optarg, &settings.tnsOrder) || (settings.tnsOrder > AAC_MAX_TNS_ORDER_LONG_LC))
+        usage(argv[0]);
+      break;
+    case 'm':
+      if (!parsePercent(optarg, &settings.msPercent))
+        usage(argv[0]);
+      break;
+    case 'i':
+      if (!parsePercent(optarg, &settings.intensityPercent))
+        usage(argv[0]);
+      break;
+    case 'p':
+      if (!applyPreset(optarg, &settings))
+        usage(argv[0]);
+      isBitrateSet = false;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (argc - optind > 1)
+    usage(argv[0]);
+
+  const char *outputFilename = (optind < argc) ? argv[optind] : "out.aac";
+
+  if (!AacAdtsGenerator::isSampleRateSupported(settings.sampleRate))
+  {
+    fprintf(stderr, "%u Hz isn't a supported sample rate; it must be one of", settings.sampleRate);
+    for (unsigned int i = AAC_SAMPLE_RATE_96000; i <= AAC_SAMPLE_RATE_8000; i++)
+      fprintf(stderr, "%s %u", (i == AAC_SAMPLE_RATE_8000) ? " or" : "", AacConstants::getSampleRateByIndex(static_cast<AacSampleRateIndex>(i)));
+    fprintf(stderr, "\n");
+    exit(1);
+  }
+
+  unsigned int maxBitrate = AacAdtsGenerator::getMaxBitrate(settings.sampleRate, settings.channelConfiguration);
+  if (isBitrateSet && (settings.bitrate > maxBitrate))
+  {
+    fprintf(stderr, "A bitrate of at most %u kbps fits %u channels at %u Hz\n", maxBitrate / 1000, settings.channelConfiguration, settings.sampleRate);
+    exit(1);
+  }
+
+  settings.bitrate = std::min(settings.bitrate, maxBitrate);
+
+  AacAdtsGenerator generator;
+  if (!generator.init(settings))
+  {
+    if (!maxBitrate)
+      fprintf(stderr, "Channel configuration %u isn't supported; it must be 1 to 5\n", settings.channelConfiguration);
+    else
+      fprintf(stderr, "No codebook has a weight above zero, so there is nothing to generate\n");
+    exit(1);
+  }
+
+  if (!frameCount)
+    frameCount = ceil(duration * settings.sampleRate / AAC_AUDIO_BLOCK_SAMPLE_COUNT);
+
+  FILE *output = stdout;
+  if (strcmp(outputFilename, "-"))
+  {
+    output = fopen(outputFilename, "wb");
+    if (!output)
+    {
+      fprintf(stderr, "%s: %s\n", outputFilename, strerror(errno));
+      exit(1);
+    }
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  uint64_t totalSize = 0;
+  std::vector<uint8_t> frame;
+  for (unsigned int i = 0; i < frameCount; i++)
+  {
+    frame.clear();
+    if (!generator.generateFrame(&frame))
+    {
+      fprintf(stderr, "Frame %u doesn't fit in an ADTS frame; try a lower bandwidth\n", i);
+      exit(1);
+    }
+
+    if (fwrite(frame.data(), 1, frame.size(), output) != frame.size())
+    {
+      fprintf(stderr, "%s: %s\n", outputFilename, strerror(errno));
+      exit(1);
+    }
+
+    totalSize += frame.size();
+  }
+
+  if ((output != stdout) ? fclose(output) : fflush(output))
+  {
+    fprintf(stderr, "%s: %s\n", outputFilename, strerror(errno));
+    exit(1);
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  double audioSeconds = static_cast<double>(frameCount) * AAC_AUDIO_BLOCK_SAMPLE_COUNT / settings.sampleRate;
+
+  double bitrate = totalSize * 8.0 / audioSeconds;
+
+  fprintf(stderr, "Wrote %u frames, %llu bytes, %.3f s at %.1f kbps in %.2f s\n", frameCount, static_cast<unsigned long long>(totalSize), audioSeconds, bitrate / 1000.0, seconds);
+
+  // Only the spectral values give way to the bitrate
+  if (bitrate > settings.bitrate * 1.05)
+    fprintf(stderr, "The side info alone is over %u kbps; a lower --bandwidth brings it down\n", settings.bitrate / 1000);
+
+  return 0;
+}
@@ -0,0 +1,481 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AacConstants.h"
+#include "AacStructs.h"
+#include "AacBitReader.h"
+#include "AacSpectrumDecoder.h"
+#include "AacScalefactorDecoder.h"
+#include "AacAudioTools.h"
+#include "AacImdct.h"
+#include "AacWindows.h"
+#include "AacChannelDecoder.h"
+
+// Micro-benchmarks of the decoder's numeric kernels, each run on the same
+//  inputs every time so that builds and machines can be compared.
+//
+// Each kernel is first run until it's warm, then timed in batches large
+//  enough to dwarf the clock's overhead. The median and 99th percentile of
+//  the per-call time across batches are reported.
+
+#define BENCH_SEED 1
+
+// Random bits for the Huffman benchmarks. Every AAC codebook is a complete
+//  prefix code, so random bits decode without error, with each codeword
+//  turning up as often as its length implies.
+#define BENCH_BITSTREAM_SIZE (1024 * 1024)
+
+// Time each batch should take, and how long to warm up for
+#define BENCH_BATCH_NS  50000
+#define BENCH_WARMUP_NS 50000000
+
+#define BENCH_DEFAULT_SAMPLE_COUNT 200
+#define BENCH_MAX_SAMPLE_COUNT     1000000
+
+struct Benchmark
+{
+  std::string               name;
+  unsigned int              itemCount;  // Items, e.g. samples or codewords, processed per call
+  const char               *itemName;
+  std::function<void(void)> run;
+};
+
+struct BenchmarkResult
+{
+  const Benchmark *benchmark;
+  unsigned int     batchSize;  // Calls per timed batch
+  double           medianNs;  // Per call
+  double           p99Ns;
+  double           minNs;
+};
+
+// Keeps results alive so the compiler can't drop the work
+static volatile double sink;
+
+static std::vector<uint8_t> makeRandomBytes(size_t size, unsigned int seed)
+{
+  std::mt19937 random(seed);
+
+  std::vector<uint8_t> bytes(size);
+  for (auto &byte : bytes)
+    byte = random();
+
+  return bytes;
+}
+
+static void fillRandom(double *values, size_t count, double scale, unsigned int seed)
+{
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<double> distribution(-scale, scale);
+
+  for (size_t i = 0; i < count; i++)
+    values[i] = distribution(random);
+}
+
+// Walks a buffer of random bits, starting over before it runs out
+class BitSource
+{
+  std::vector<uint8_t> m_bytes;
+  size_t               m_position;
+
+public:
+  BitSource(unsigned int seed) : m_bytes(makeRandomBytes(BENCH_BITSTREAM_SIZE, seed)), m_position(0) {};
+
+  AacBitReader getReader(void)
+  {
+    // No call reads anywhere near this much
+    if (m_position > m_bytes.size() - 65536)
+      m_position = 0;
+
+    return AacBitReader(m_bytes.data() + m_position, m_bytes.size() - m_position);
+  }
+
+  void consumed(AacBitReader *reader) { m_position += (reader->getBitPosition() + 7) / 8; };
+};
+
+static void addHuffmanBenchmarks(std::vector<Benchmark> *benchmarks)
+{
+  for (unsigned int codebook = 1; codebook <= AAC_HCB_ESC; codebook++)
+  {
+    auto source = std::make_shared<BitSource>(BENCH_SEED + codebook);
+
+    // One long window's worth of values per call
+    benchmarks->push_back({"huffman/codebook-" + std::to_string(codebook), AAC_SPECTRAL_SAMPLE_SIZE_LONG, "values", [source, codebook]()
+    {
+      AacBitReader reader = source->getReader();
+      AacSpectrumDecoder decoder(&reader);
+
+      int sum = 0;
+      if (codebook < AAC_HCB_FIRST_PAIR)
+      {
+        for (unsigned int i = 0; i < AAC_SPECTRAL_SAMPLE_SIZE_LONG; i += 4)
+        {
+          int v[4];
+          decoder.decode4(codebook, v);
+          sum += v[0] + v[3];
+        }
+      }
+      else
+      {
+        for (unsigned int i = 0; i < AAC_SPECTRAL_SAMPLE_SIZE_LONG; i += 2)
+        {
+          int v[2];
+          decoder.decode2(codebook, v);
+          sum += v[0] + v[1];
+        }
+      }
+
+      source->consumed(&reader);
+      sink = sum;
+    }});
+  }
+}
+
+static void addScalefactorBenchmark(std::vector<Benchmark> *benchmarks)
+{
+  auto source = std::make_shared<BitSource>(BENCH_SEED + 100);
+
+  benchmarks->push_back({"scalefactor", AAC_MAX_SFB_COUNT, "values", [source]()
+  {
+    AacBitReader reader = source->getReader();
+    AacScalefactorDecoder decoder(&reader);
+
+    int sum = 0;
+    for (unsigned int sfb = 0; sfb < AAC_MAX_SFB_COUNT; sfb++)
+    {
+      int value;
+      decoder.decode(&value);
+      sum += value;
+    }
+
+    source->consumed(&reader);
+    sink = sum;
+  }});
+}
+
+static void addDequantizeBenchmark(std::vector<Benchmark> *benchmarks)
+{
+  // Quantized values cluster around zero, as in real spectra
+  auto quant = std::make_shared<std::vector<int16_t>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  auto dequant = std::make_shared<std::vector<double>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+
+  std::mt19937 random(BENCH_SEED + 200);
+  std::geometric_distribution<int> magnitude(0.3);
+  for (auto &value : *quant)
+    value = std::min(magnitude(random), 8191) * ((random() & 1) ? 1 : -1);
+
+  benchmarks->push_back({"dequantize", AAC_SPECTRAL_SAMPLE_SIZE_LONG, "samples", [quant, dequant]()
+  {
+    AacAudioTools::dequantize(quant->data(), dequant->data());
+    sink = (*dequant)[0];
+  }});
+}
+
+static void addImdctBenchmarks(std::vector<Benchmark> *benchmarks)
+{
+  auto longInput = std::make_shared<std::vector<double>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  auto longOutput = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_LONG);
+  fillRandom(longInput->data(), longInput->size(), 1000.0, BENCH_SEED + 300);
+
+  benchmarks->push_back({"imdct/long", AAC_SPECTRAL_SAMPLE_SIZE_LONG, "samples", [longInput, longOutput]()
+  {
+    AacImdctLong(longInput->data(), longOutput->data());
+    sink = (*longOutput)[0];
+  }});
+
+  // All eight windows of a short block per call
+  auto shortInput = std::make_shared<std::vector<double>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  auto shortOutput = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_SHORT * 8);
+  fillRandom(shortInput->data(), shortInput->size(), 1000.0, BENCH_SEED + 301);
+
+  benchmarks->push_back({"imdct/short", AAC_SPECTRAL_SAMPLE_SIZE_LONG, "samples", [shortInput, shortOutput]()
+  {
+    for (unsigned int w = 0; w < 8; w++)
+      AacImdctShort(shortInput->data() + (w * AAC_SPECTRAL_SAMPLE_SIZE_SHORT), shortOutput->data() + (w * AAC_XFORM_WIN_SIZE_SHORT));
+
+    sink = (*shortOutput)[0];
+  }});
+
+  // AAC_IMDCT_LANE_COUNT channels per call
+  auto laneInput = std::make_shared<std::vector<AacImdctLanes>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  auto laneOutput = std::make_shared<std::vector<AacImdctLanes>>(AAC_XFORM_WIN_SIZE_LONG);
+  auto laneScratch = std::make_shared<std::vector<AacImdctLanes>>(AAC_IMDCT_LANES_SCRATCH_SIZE);
+
+  std::vector<double> lane(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  for (unsigned int l = 0; l < AAC_IMDCT_LANE_COUNT; l++)
+  {
+    fillRandom(lane.data(), lane.size(), 1000.0, BENCH_SEED + 302 + l);
+    for (unsigned int s = 0; s < AAC_SPECTRAL_SAMPLE_SIZE_LONG; s++)
+      (*laneInput)[s][l] = lane[s];
+  }
+
+  benchmarks->push_back({"imdct/long-lanes", AAC_SPECTRAL_SAMPLE_SIZE_LONG * AAC_IMDCT_LANE_COUNT, "samples", [laneInput, laneOutput, laneScratch]()
+  {
+    AacImdctLongLanes(laneInput->data(), laneOutput->data(), laneScratch->data());
+    sink = (*laneOutput)[0][0];
+  }});
+}
+
+static void addTnsBenchmarks(std::vector<Benchmark> *benchmarks)
+{
+  // The longest filter allowed in LC, over most of a long window
+  const unsigned int order = AAC_MAX_TNS_ORDER_LONG_LC;
+  const unsigned int sampleCount = 960;
+
+  std::mt19937 random(BENCH_SEED + 400);
+  std::uniform_int_distribution<int> coefficient(-8, 7);
+
+  int8_t quant[AAC_MAX_TNS_ORDER_LONG_MAIN];
+  for (unsigned int o = 0; o < order; o++)
+    quant[o] = coefficient(random);
+
+  auto lpc = std::make_shared<std::vector<double>>(AAC_MAX_TNS_ORDER_LONG_MAIN + 1);
+  AacAudioTools::transformTnsCoefficients(quant, lpc->data(), 4, order);
+
+  auto input = std::make_shared<std::vector<double>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  auto samples = std::make_shared<std::vector<double>>(AAC_SPECTRAL_SAMPLE_SIZE_LONG);
+  fillRandom(input->data(), input->size(), 1000.0, BENCH_SEED + 401);
+
+  // Filtering is in place, so each call starts from a fresh copy
+  benchmarks->push_back({"tns/upwards", sampleCount, "samples", [=]()
+  {
+    std::copy(input->begin(), input->end(), samples->begin());
+    AacAudioTools::tnsFilterUpwards(samples->data(), sampleCount, order, lpc->data());
+    sink = (*samples)[sampleCount - 1];
+  }});
+
+  benchmarks->push_back({"tns/downwards", sampleCount, "samples", [=]()
+  {
+    std::copy(input->begin(), input->end(), samples->begin());
+    AacAudioTools::tnsFilterDownwards(samples->data() + sampleCount - 1, sampleCount, order, lpc->data());
+    sink = (*samples)[0];
+  }});
+}
+
+static void addWindowBenchmarks(std::vector<Benchmark> *benchmarks)
+{
+  auto input = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_LONG);
+  auto samples = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_LONG);
+  fillRandom(input->data(), input->size(), 1000.0, BENCH_SEED + 500);
+
+  for (unsigned int shape = 0; shape < AAC_WINSHAPE_COUNT; shape++)
+  {
+    const double *left = AacWindows::getLeftWindow(static_cast<AacWindowShape>(shape), AAC_WINSEQ_LONG);
+    const double *right = AacWindows::getRightWindow(static_cast<AacWindowShape>(shape), AAC_WINSEQ_LONG);
+
+    std::string name = std::string("window/long-") + ((shape == AAC_WINSHAPE_SIN) ? "sine" : "kbd");
+
+    // Windowing is in place too, and repeated calls would soon shrink the
+    //  samples to subnormals
+    benchmarks->push_back({name, AAC_XFORM_WIN_SIZE_LONG, "samples", [input, samples, left, right]()
+    {
+      std::copy(input->begin(), input->end(), samples->begin());
+      AacAudioTools::window(left, samples->data(), AAC_XFORM_HALFWIN_SIZE_LONG);
+      AacAudioTools::window(right, samples->data() + AAC_XFORM_HALFWIN_SIZE_LONG, AAC_XFORM_HALFWIN_SIZE_LONG);
+      sink = (*samples)[0];
+    }});
+  }
+}
+
+static void addOutputBenchmark(std::vector<Benchmark> *benchmarks)
+{
+  // Overlap-add and conversion to int16, including clipping
+  auto decoder = std::make_shared<AacChannelDecoder>(AAC_CHANNEL_FIRST, AacConstants::getIndexBySampleRate(44100));
+  auto input = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_LONG);
+  auto samples = std::make_shared<std::vector<double>>(AAC_XFORM_WIN_SIZE_LONG);
+  auto audio = std::make_shared<std::vector<int16_t>>(AAC_AUDIO_SAMPLE_OUTPUT_COUNT * 2);
+  fillRandom(input->data(), input->size(), 20000.0, BENCH_SEED + 600);
+
+  benchmarks->push_back({"overlap-output", AAC_AUDIO_SAMPLE_OUTPUT_COUNT, "samples", [=]()
+  {
+    AacIcsInfo ics = {};
+    ics.windowShape = AAC_WINSHAPE_SIN;
+
+    AacDecodeInfo info = {};
+    info.ics = &ics;
+
+    std::copy(input->begin(), input->end(), samples->begin());
+    decoder->overlap(&info, samples->data(), audio->data(), 2);  // Interleaved stereo
+    sink = (*audio)[0];
+  }});
+}
+
+static uint64_t nowNs(void)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double getPercentile(std::vector<double> sorted, double percentile)
+{
+  size_t index = std::min(sorted.size() - 1, static_cast<size_t>(percentile / 100.0 * sorted.size()));
+  return sorted[index];
+}
+
+static BenchmarkResult runBenchmark(const Benchmark *benchmark, unsigned int sampleCount)
+{
+  // Warm up, doubling the batch until one takes long enough to time
+  unsigned int batchSize = 1;
+  uint64_t warmupStart = nowNs();
+
+  while (true)
+  {
+    uint64_t start = nowNs();
+    for (unsigned int i = 0; i < batchSize; i++)
+      benchmark->run();
+
+    uint64_t end = nowNs();
+    if ((end - start < BENCH_BATCH_NS) && (batchSize < (1u << 24)))
+      batchSize *= 2;
+    else if (end - warmupStart >= BENCH_WARMUP_NS)
+      break;
+  }
+
+  std::vector<double> perCall;
+  perCall.reserve(sampleCount);
+
+  for (unsigned int s = 0; s < sampleCount; s++)
+  {
+    uint64_t start = nowNs();
+    for (unsigned int i = 0; i < batchSize; i++)
+      benchmark->run();
+
+    perCall.push_back(static_cast<double>(nowNs() - start) / batchSize);
+  }
+
+  std::sort(perCall.begin(), perCall.end());
+
+  BenchmarkResult result;
+  result.benchmark = benchmark;
+  result.batchSize = batchSize;
+  result.medianNs  = getPercentile(perCall, 50.0);
+  result.p99Ns     = getPercentile(perCall, 99.0);
+  result.minNs     = perCall.front();
+
+  return result;
+}
+
+static void printText(const BenchmarkResult *result)
+{
+  const Benchmark *benchmark = result->benchmark;
+
+  printf("%-22s %11.1f %11.1f %9.1f M %s/s\n", benchmark->name.c_str(), result->medianNs, result->p99Ns, benchmark->itemCount * 1000.0 / result->medianNs, benchmark->itemName);
+  fflush(stdout);
+}
+
+static void printJson(const std::vector<BenchmarkResult> &results, unsigned int sampleCount)
+{
+  printf("{\n");
+  printf("  \"seed\": %u,\n", BENCH_SEED);
+  printf("  \"samples\": %u,\n", sampleCount);
+  printf("  \"compiler\": \"%s\",\n", __VERSION__);
+  printf("  \"benchmarks\": [\n");
+
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const BenchmarkResult *result = &results[i];
+    const Benchmark *benchmark = result->benchmark;
+
+    printf("    {\"name\": \"%s\", \"items\": %u, \"item_name\": \"%s\", \"batch\": %u, \"median_ns\": %.1f, \"p99_ns\": %.1f, \"min_ns\": %.1f}%s\n",
+           benchmark->name.c_str(), benchmark->itemCount, benchmark->itemName, result->batchSize, result->medianNs, result->p99Ns, result->minNs, (i + 1 < results.size()) ? "," : "");
+  }
+
+  printf("  ]\n");
+  printf("}\n");
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--json] [--filter <text>] [--samples <count>]\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Times each numeric kernel on fixed inputs and reports the median and 99th\n");
+  fprintf(stderr, "percentile time per call in nanoseconds. --json writes the results as JSON\n");
+  fprintf(stderr, "instead, and --filter runs only benchmarks whose names contain the text.\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"json",    no_argument,       NULL, 'j'},
+    {"filter",  required_argument, NULL, 'f'},
+    {"samples", required_argument, NULL, 's'},
+    {NULL,      0,                 NULL, 0},
+  };
+
+  bool isJson = false;
+  const char *filter = NULL;
+  unsigned int sampleCount = BENCH_DEFAULT_SAMPLE_COUNT;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "jf:s:", options, NULL)) != -1)
+  {
+    char *end;
+    unsigned long count;
+
+    switch (opt)
+    {
+    case 'j':
+      isJson = true;
+      break;
+    case 'f':
+      filter = optarg;
+      break;
+    case 's':
+      errno = 0;
+      count = strtoul(optarg, &end, 10);
+      if ((end == optarg) || *end || errno || (count < 1) || (count > BENCH_MAX_SAMPLE_COUNT))
+        usage(argv[0]);
+      sampleCount = count;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind != argc)
+    usage(argv[0]);
+
+  std::vector<Benchmark> benchmarks;
+  addHuffmanBenchmarks(&benchmarks);
+  addScalefactorBenchmark(&benchmarks);
+  addDequantizeBenchmark(&benchmarks);
+  addImdctBenchmarks(&benchmarks);
+  addTnsBenchmarks(&benchmarks);
+  addWindowBenchmarks(&benchmarks);
+  addOutputBenchmark(&benchmarks);
+
+  if (!isJson)
+    printf("%-22s %11s %11s %9s\n", "benchmark", "median ns", "p99 ns", "rate");
+
+  std::vector<BenchmarkResult> results;
+
+  for (const auto &benchmark : benchmarks)
+  {
+    if (filter && (benchmark.name.find(filter) == std::string::npos))
+      continue;
+
+    results.push_back(runBenchmark(&benchmark, sampleCount));
+
+    if (!isJson)
+      printText(&results.back());
+  }
+
+  if (isJson)
+    printJson(results, sampleCount);
+
+  return 0;
+}
@@ -10,13 +10,32 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <getopt.h>
+#include <dirent.h>
+#include <strings.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
 //#include <endian.h>
 
 #include "AacAdtsFrameHeader.h"
 #include "AacAdtsFrame.h"
 #include "AacAdtsFrameReader.h"
 #include "AacDecoder.h"
+#include "AacDecoderStats.h"
+#include "AacPerfCounters.h"
 #include "AacAudioBlock.h"
+#include "AacPipelinedDecoder.h"
+#include "AacFrameParallelDecoder.h"
+#include "AacSegmentParallelDecoder.h"
+#include "AacThreadPool.h"
+#include "AacBatchTranscoder.h"
+#include "AacStreamDecoder.h"
+#include "AacMp4Demuxer.h"
+#include "AacLoasFrameReader.h"
+#include "AacBitReader.h"
+#include "AacTrace.h"
 
 #include "WavWriter.h"
 
@@ -49,103 +68,945 @@ uint8_t *mmapFile(const char *filename, size_t *sizePtr)
   return bytes;
 }
 
-int main(int argc, char *argv[])
+// Bytes read from a stream at a time
+#define STREAM_CHUNK_SIZE (1024 * 1024)
+
+// More threads than this is surely a typo
+#define MAX_THREAD_COUNT 1024
+
+// Where the decoded audio goes. If outputFd is set, it's used instead of the
+//  filename.
+static const char *outputFilename = "out.wav";
+static int outputFd = -1;
+static bool isDirectOutput = false;
+
+// Whether to check the CRC of frames that carry one
+static bool isCrcChecked = false;
+
+// Whether to print where the decoder's time went
+static bool isStatsShown = false;
+
+// Hardware counters for --perf, counting on the main thread
+static bool isPerfShown = false;
+static AacPerfCounters perfCounters;
+
+// Where --trace writes its records, and which ones
+static const char *traceFilename = NULL;
+static AacTraceLevel traceLevel = AAC_TRACE_INFO;
+static unsigned int traceCategories = AAC_TRACE_ALL_CATEGORIES;
+
+// Bytes of audio the input should decode to, if known, so the output file can
+//  be preallocated
+static uint64_t expectedOutputSize = 0;
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--pipeline | --frame-parallel <threads> | --threads <threads> | --crc | --stats | --perf | --trace <file>] [--direct] <filename> [<output>]\n", name);
+  fprintf(stderr, "       %s --batch <list-file | directory> [--output <template>] [--threads <threads>] [--direct]\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "The output defaults to out.wav. Either filename may be - for stdin or stdout.\n");
+  fprintf(stderr, "--direct writes output files with O_DIRECT, bypassing the page cache.\n");
+  fprintf(stderr, "--crc skips frames whose CRC doesn't match, instead of decoding them.\n");
+  fprintf(stderr, "--stats prints the time spent in each decoding stage (needs make STATS=1).\n");
+  fprintf(stderr, "--perf prints each stage's IPC and cache and branch miss rates, from the\n");
+  fprintf(stderr, "hardware performance counters (also needs make STATS=1).\n");
+  fprintf(stderr, "--trace records what the decoder parses to a binary file for aac-trace to print.\n");
+  fprintf(stderr, "--trace-level is error, info (the default) or debug, and --trace-categories a\n");
+  fprintf(stderr, "comma-separated list of framing, side-info, spectral and transform (all by default).\n");
+  fprintf(stderr, "In an output template, %%d is the input file's directory, %%n is its name\n");
+  fprintf(stderr, "without the extension, and %%i is its position in the batch.\n");
+  exit(1);
+}
+
+static bool parseThreadCount(const char *text, unsigned int *threadCount)
 {
-  if (argc != 2)
+  char *end;
+  errno = 0;
+  unsigned long count = strtoul(text, &end, 10);
+  if ((end == text) || *end || errno || (count < 1) || (count > MAX_THREAD_COUNT))
+    return false;
+
+  *threadCount = count;
+  return true;
+}
+
+static void openOutput(WavWriter *writer, unsigned int channelCount, unsigned int sampleRate)
+{
+  bool success;
+
+  writer->setDirect(isDirectOutput);
+
+  if (outputFd >= 0)
+    success = writer->open(outputFd, channelCount, 16, sampleRate, expectedOutputSize);
+  else
+    success = writer->open(outputFilename, channelCount, 16, sampleRate, expectedOutputSize);
+
+  if (!success)
   {
-    fprintf(stderr, "Usage: %s <filename>\n", argv[0]);
+    fprintf(stderr, "Could not open output file: %s\n", strerror(errno));
     exit(1);
   }
+}
 
-  // Map the input file into memory
-  size_t bytesSize;
-  uint8_t *bytes = mmapFile(argv[1], &bytesSize);
-  if (!bytes)
+static void writeAudio(WavWriter *writer, AacAudioBlock *audio)
+{
+  // Open output file, if not yet open
+  if (!writer->isOpen())
+    openOutput(writer, audio->getChannelCount(), audio->getSampleRate());
+
+  // Ensure little-endian samples
+  audio->switchEndianness(std::endian::little);
+
+  // Write to output file
+  int16_t *buf;
+  auto size = audio->getSampleBuffer(&buf);
+  if (!writer->write(reinterpret_cast<uint8_t *>(buf), size))
   {
-    fprintf(stderr, "Couldn't open input file.\n");
+    fprintf(stderr, "Could not write to output file\n");
     exit(1);
   }
+}
 
-  auto reader = AacAdtsFrameReader(bytes, bytesSize);
+// The last of the output is only written when the file is closed
+static void closeOutput(WavWriter *writer)
+{
+  if (!writer->close())
+  {
+    fprintf(stderr, "Could not write to output file: %s\n", strerror(errno));
+    exit(1);
+  }
+}
 
-  // Skip over any initial ID3 tag
-  if (size_t id3Size = reader.skipID3())
-    printf("Skipped ID3 tag of %zd bytes.\n", id3Size);
+static void printLatency(const char *name, const AacLatencyHistogram *histogram)
+{
+  if (histogram->getCount() == 0)
+    return;
 
-  // Position reader at first frame header
-  if (!reader.isAtFrameHeader())
-    reader.findNextFrame();
+  double usPerTick = 1e6 / AacDecoderStats::getTicksPerSecond();
 
-  // Read frame header
-  AacAdtsFrameHeader header;
-  if (!reader.readFrameHeader(&header))
+  printf("  %-14s: %8.1f %8.1f %8.1f %8.1f  at offset %llu\n", name, histogram->getPercentile(50.0) * usPerTick, histogram->getPercentile(99.0) * usPerTick,
+         histogram->getPercentile(99.9) * usPerTick, histogram->getMax() * usPerTick, static_cast<unsigned long long>(histogram->getMaxTag()));
+}
+
+// Events per thousand instructions, or - if either wasn't counted
+static void printPerThousand(uint64_t count, uint64_t instructions, bool isAvailable)
+{
+  if (isAvailable && instructions)
+    printf(" %9.2f", 1000.0 * count / instructions);
+  else
+    printf(" %9s", "-");
+}
+
+static void printPerf(const AacDecoderStats *stats)
+{
+  if (!perfCounters.isOpen())
+    return;
+
+  bool hasCycles       = perfCounters.isAvailable(AAC_PERF_CYCLES);
+  bool hasInstructions = perfCounters.isAvailable(AAC_PERF_INSTRUCTIONS);
+
+  uint64_t blockCount = std::max<uint64_t>(stats->blockCount, 1);
+
+  printf("Counters        :    cycles/block       IPC  L1D MPKI   br MPKI\n");
+
+  uint64_t totals[AAC_PERF_EVENT_COUNT] = {};
+
+  for (unsigned int i = 0; i <= AAC_STAGE_COUNT; i++)
   {
-    fprintf(stderr, "Could not find initial frame header.\n");
-    exit(1);
+    const uint64_t *events = totals;
+    const char *name = "total";
+
+    if (i < AAC_STAGE_COUNT)
+    {
+      events = stats->events[i];
+      name = AacDecoderStats::getStageName(static_cast<AacDecoderStage>(i));
+
+      for (unsigned int j = 0; j < AAC_PERF_EVENT_COUNT; j++)
+        totals[j] += events[j];
+    }
+
+    printf("  %-14s:", name);
+
+    if (hasCycles)
+      printf(" %15llu", static_cast<unsigned long long>(events[AAC_PERF_CYCLES] / blockCount));
+    else
+      printf(" %15s", "-");
+
+    if (hasCycles && hasInstructions && events[AAC_PERF_CYCLES])
+      printf(" %9.2f", static_cast<double>(events[AAC_PERF_INSTRUCTIONS]) / events[AAC_PERF_CYCLES]);
+    else
+      printf(" %9s", "-");
+
+    printPerThousand(events[AAC_PERF_L1D_MISSES], events[AAC_PERF_INSTRUCTIONS], hasInstructions && perfCounters.isAvailable(AAC_PERF_L1D_MISSES));
+    printPerThousand(events[AAC_PERF_BRANCH_MISSES], events[AAC_PERF_INSTRUCTIONS], hasInstructions && perfCounters.isAvailable(AAC_PERF_BRANCH_MISSES));
+    printf("\n");
   }
 
-  header.dump();
+  for (unsigned int i = 0; i < AAC_PERF_EVENT_COUNT; i++)
+  {
+    if (!perfCounters.isAvailable(static_cast<AacPerfEvent>(i)))
+      printf("Not counted     : %s\n", AacPerfCounters::getEventName(static_cast<AacPerfEvent>(i)));
+  }
 
-  // Create WAV writer
-  WavWriter writer;
+  if (perfCounters.isMultiplexed())
+    printf("The counters were shared with other users of the PMU, so they undercount.\n");
+}
+
+static void printStats(const AacDecoderStats *stats)
+{
+  if (!stats)
+    return;
+
+  if (isPerfShown)
+    printPerf(stats);
+
+  if (!isStatsShown)
+    return;
+
+  uint64_t totalTicks = stats->getTotalTicks();
+  uint64_t blockCount = std::max<uint64_t>(stats->blockCount, 1);
 
+  printf("Decoding        : %llu %s over %llu blocks (%llu per block)\n", static_cast<unsigned long long>(totalTicks), AacDecoderStats::getTickUnit(),
+         static_cast<unsigned long long>(stats->blockCount), static_cast<unsigned long long>(totalTicks / blockCount));
+
+  for (unsigned int i = 0; i < AAC_STAGE_COUNT; i++)
+  {
+    double share = totalTicks ? (100.0 * stats->ticks[i] / totalTicks) : 0.0;
+    printf("  %-14s: %5.1f%%  %llu per block\n", AacDecoderStats::getStageName(static_cast<AacDecoderStage>(i)), share, static_cast<unsigned long long>(stats->ticks[i] / blockCount));
+  }
+
+  printf("Window sequences (channels):\n");
+  for (unsigned int i = 0; i < AAC_STATS_WINDOW_SEQUENCE_COUNT; i++)
+    printf("  %-22s: %llu\n", AacConstants::getWindowSequenceName(static_cast<AacWindowSequence>(i)), static_cast<unsigned long long>(stats->windowSequenceCounts[i]));
+
+  printf("Codebooks (scalefactor bands):\n");
+  for (unsigned int i = 0; i < AAC_STATS_CODEBOOK_COUNT; i++)
+  {
+    if (stats->codebookCounts[i])
+      printf("  %-2u: %llu\n", i, static_cast<unsigned long long>(stats->codebookCounts[i]));
+  }
+
+  printf("Latency (us)    :      p50      p99    p99.9      max\n");
+  printLatency("block", &stats->blockLatency);
+
+  for (unsigned int i = 0; i < AAC_STATS_ELEMENT_COUNT; i++)
+    printLatency(AacConstants::getElementNameShort(static_cast<AacElementId>(i)), &stats->elementLatency[i]);
+}
+
+static void decodeSerial(AacAdtsFrameReader *reader, unsigned int sampleRate, WavWriter *writer)
+{
   // Create decoder
-  auto decoder = AacDecoder(header.getSampleRate());
+  auto decoder = AacDecoder(sampleRate);
+  decoder.setCrcCheck(isCrcChecked);
+  decoder.setTrace(traceFilename ? traceLevel : AAC_TRACE_OFF, traceCategories);
 
   AacAudioBlock audio;
 
-  while (!reader.isComplete())
+  while (!reader->isComplete())
   {
     auto frame = AacAdtsFrame();
-    if (!reader.readFrame(&frame))
+    if (!reader->readFrame(&frame))
     {
-      size_t skipped = reader.findNextFrame();
+      size_t skipped = reader->findNextFrame();
       printf("Skipped %zd bytes looking for a frame header.\n", skipped);
       continue;
     }
 
-    frame.getHeader()->dump();
-
     if (decoder.getSampleRate() != frame.getHeader()->getSampleRate())
     {
       fprintf(stderr, "Detected sample rate change (%u -> %u)! Reinitializing decoder.\n", decoder.getSampleRate(), frame.getHeader()->getSampleRate());
       decoder = AacDecoder(frame.getHeader()->getSampleRate());
     }
 
-    if (!decoder.decodeBlock(frame.getReader(), &audio))
+    unsigned int crcErrorCount = decoder.getCrcErrorCount();
+
+    decoder.setStatsPosition(reader->getPosition());
+
+    if (!decoder.decodeFrame(&frame, &audio))
     {
-      fprintf(stderr, "Failed to decode block\n");
+      if (decoder.getCrcErrorCount() == crcErrorCount)
+      {
+        fprintf(stderr, "Failed to decode block\n");
+        exit(1);
+      }
+
+      fprintf(stderr, "CRC mismatch in frame at offset %zu. Skipped it.\n", reader->getPosition());
+      reader->advance(frame.getSize());
+      continue;
+    }
+
+    writeAudio(writer, &audio);
+
+    // Advance the reader
+    size_t frameSize = frame.getSize();
+    reader->advance(frameSize);
+  }
+
+  printStats(decoder.getStats());
+}
+
+static void closeTrace(void)
+{
+  if (!AacTrace::close())
+    fprintf(stderr, "%s: Could not write the trace\n", traceFilename);
+}
+
+// Parses on a second thread while this one does the signal processing
+static void decodePipelined(AacAdtsFrameReader *reader, WavWriter *writer)
+{
+  AacPipelinedDecoder decoder(reader, isCrcChecked);
+
+  AacAudioBlock audio;
+  size_t skipped = 0;
+
+  // The parse thread resyncs, but it's reported here, as by a serial decode
+  auto reportSkipped = [&]()
+  {
+    if (decoder.getSkippedSize() != skipped)
+    {
+      printf("Skipped %zd bytes looking for a frame header.\n", decoder.getSkippedSize() - skipped);
+      skipped = decoder.getSkippedSize();
+    }
+  };
+
+  while (!decoder.isComplete())
+  {
+    unsigned int crcErrorCount = decoder.getCrcErrorCount();
+
+    bool success = decoder.decodeBlock(&audio);
+    reportSkipped();
+
+    if (!success)
+    {
+      if (decoder.getCrcErrorCount() != crcErrorCount)
+      {
+        fprintf(stderr, "CRC mismatch in frame at offset %zu. Skipped it.\n", decoder.getPosition());
+        continue;
+      }
+
+      fprintf(stderr, "Failed to decode block at offset %zu\n", decoder.getPosition());
       exit(1);
     }
 
+    writeAudio(writer, &audio);
+  }
+
+  reportSkipped();
+}
+
+// Windows frames on a thread pool, with the overlap-add done here in order
+static void decodeFrameParallel(AacAdtsFrameReader *reader, unsigned int threadCount, WavWriter *writer)
+{
+  AacThreadPool pool(threadCount);
+
+  AacFrameParallelDecoder decoder(reader, &pool);
+
+  AacAudioBlock audio;
+  size_t skipped = 0;
+
+  // Frames are parsed a batch ahead, but skips are reported here, as by a
+  //  serial decode
+  auto reportSkipped = [&]()
+  {
+    if (decoder.getSkippedSize() != skipped)
+    {
+      printf("Skipped %zd bytes looking for a frame header.\n", decoder.getSkippedSize() - skipped);
+      skipped = decoder.getSkippedSize();
+    }
+  };
+
+  while (!decoder.isComplete())
+  {
+    bool success = decoder.decodeBlock(&audio);
+    reportSkipped();
+
+    if (!success)
+    {
+      fprintf(stderr, "Failed to decode block at offset %zu\n", decoder.getPosition());
+      exit(1);
+    }
+
+    writeAudio(writer, &audio);
+  }
+
+  reportSkipped();
+}
+
+// Decodes independent segments of the file at once, and stitches them together
+static void decodeSegmentParallel(AacAdtsFrameReader *reader, unsigned int threadCount, WavWriter *writer)
+{
+  AacThreadPool pool(threadCount);
+
+  AacSegmentParallelDecoder decoder(reader, &pool, AAC_SEGMENT_DEFAULT_FRAME_COUNT, std::endian::little);
+
+  while (auto segment = decoder.nextSegment())
+  {
     // Open output file, if not yet open
-    if (!writer.isOpen())
+    if (!writer->isOpen() && segment->channelCount)
+      openOutput(writer, segment->channelCount, segment->sampleRate);
+
+    // Write to output file
+    size_t size = segment->samples.size() * sizeof(int16_t);
+    if (size && !writer->write(reinterpret_cast<const uint8_t *>(segment->samples.data()), size))
+    {
+      fprintf(stderr, "Could not write to output file\n");
+      exit(1);
+    }
+
+    for (size_t skipped : segment->skippedSizes)
+      printf("Skipped %zd bytes looking for a frame header.\n", skipped);
+
+    if (!segment->isValid)
+    {
+      fprintf(stderr, "Failed to decode block at offset %zu\n", segment->failedPosition);
+      writer->close();
+      exit(1);
+    }
+  }
+}
+
+// Decodes the AAC track of an MP4/M4A file, feeding each access unit to the
+//  decoder straight from the mapped file
+static void decodeMp4(const uint8_t *bytes, size_t size, WavWriter *writer)
+{
+  AacMp4Demuxer demuxer;
+  if (!demuxer.open(bytes, size))
+  {
+    fprintf(stderr, "Could not find an AAC track.\n");
+    exit(1);
+  }
+
+  auto config = demuxer.getConfig();
+  if (config->objectType != AAC_OBJECT_TYPE_LC)
+  {
+    fprintf(stderr, "Unsupported audio object type %u. Only AAC-LC can be decoded.\n", config->objectType);
+    exit(1);
+  }
+
+  printf("AAC track       : %u Hz, channel configuration %u, %u access units\n", config->sampleRate, config->channelConfiguration, demuxer.getSampleCount());
+
+  expectedOutputSize = static_cast<uint64_t>(demuxer.getSampleCount()) * AAC_AUDIO_BLOCK_SAMPLE_COUNT * config->getChannelCount() * sizeof(int16_t);
+
+  auto decoder = AacDecoder(config->sampleRate);
+  decoder.setTrace(traceFilename ? traceLevel : AAC_TRACE_OFF, traceCategories);
+
+  AacAudioBlock audio;
+
+  while (!demuxer.isComplete())
+  {
+    AacMp4AccessUnit unit;
+    if (!demuxer.readAccessUnit(&unit))
+    {
+      fprintf(stderr, "Access unit runs past the end of the file.\n");
+      exit(1);
+    }
+
+    AacBitReader reader(unit.bytes, unit.size);
+    decoder.setStatsPosition(unit.offset);
+
+    if (!decoder.decodeBlock(&reader, &audio))
+    {
+      fprintf(stderr, "Failed to decode block at offset %llu\n", static_cast<unsigned long long>(unit.offset));
+      exit(1);
+    }
+
+    writeAudio(writer, &audio);
+  }
+
+  printStats(decoder.getStats());
+}
+
+// Decodes LOAS/LATM, as in DVB captures, passing each payload to the decoder
+//  where it lies in the mapped file
+static void decodeLoas(const uint8_t *bytes, size_t size, WavWriter *writer)
+{
+  auto reader = AacLoasFrameReader(bytes, size);
+
+  // The decoder is made once the first config gives the sample rate
+  auto decoder = AacDecoder(0);
+  decoder.setTrace(traceFilename ? traceLevel : AAC_TRACE_OFF, traceCategories);
+
+  AacAudioBlock audio;
+
+  if (!reader.isAtFrameHeader())
+  {
+    size_t skipped = reader.findNextFrame();
+    printf("Skipped %zd bytes looking for a frame header.\n", skipped);
+  }
+
+  while (!reader.isComplete())
+  {
+    auto frame = AacLoasFrame();
+    if (!reader.readFrame(&frame))
+    {
+      size_t skipped = reader.findNextFrame();
+      printf("Skipped %zd bytes looking for a usable frame.\n", skipped);
+      continue;
+    }
+
+    auto config = &frame.getConfig()->audio;
+    if (config->objectType != AAC_OBJECT_TYPE_LC)
+    {
+      fprintf(stderr, "Unsupported audio object type %u. Only AAC-LC can be decoded.\n", config->objectType);
+      exit(1);
+    }
+
+    if (decoder.getSampleRate() != config->sampleRate)
     {
-      if (!writer.open("out.wav", audio.getChannelCount(), 16, audio.getSampleRate()))
+      if (decoder.getSampleRate())
+        fprintf(stderr, "Detected sample rate change (%u -> %u)! Reinitializing decoder.\n", decoder.getSampleRate(), config->sampleRate);
+
+      decoder = AacDecoder(config->sampleRate);
+    }
+
+    for (unsigned int i = 0; i < frame.getPayloadCount(); i++)
+    {
+      AacBitReader payload = frame.getPayloadReader(i);
+      decoder.setStatsPosition(reader.getPosition());
+
+      if (!decoder.decodeBlock(&payload, &audio))
       {
-        fprintf(stderr, "Could not open output file: %s\n", strerror(errno));
+        fprintf(stderr, "Failed to decode block at offset %zu\n", reader.getPosition());
         exit(1);
       }
+
+      writeAudio(writer, &audio);
     }
 
-    // Ensure little-endian samples
-    audio.switchEndianness(std::endian::little);
+    reader.advance(frame.getSize());
+  }
 
-    // Write to output file
-    int16_t *buf;
-    auto size = audio.getSampleBuffer(&buf);
-    if (!writer.write(reinterpret_cast<uint8_t *>(buf), size))
+  printStats(decoder.getStats());
+}
+
+// Decodes from a pipe or other stream, a chunk at a time, without ever
+//  holding the whole input
+static void decodeStream(int fd, WavWriter *writer)
+{
+  AacStreamDecoder decoder;
+  decoder.setCrcCheck(isCrcChecked);
+  decoder.setTrace(traceFilename ? traceLevel : AAC_TRACE_OFF, traceCategories);
+
+  AacAudioBlock audio;
+
+  std::vector<uint8_t> chunk(STREAM_CHUNK_SIZE);
+  size_t skipped = 0;
+
+  while (true)
+  {
+    ssize_t count = read(fd, chunk.data(), chunk.size());
+    if (count < 0)
     {
-      fprintf(stderr, "Could not write to output file\n");
+      if (errno == EINTR)
+        continue;
+
+      fprintf(stderr, "read(): %s\n", strerror(errno));
       exit(1);
     }
 
-    // Advance the reader
-    size_t frameSize = frame.getSize();
-    reader.advance(frameSize);
+    if (count == 0)
+      break;  // EOF
+
+    decoder.feed(chunk.data(), count);
+
+    AacStreamStatus status;
+    while ((status = decoder.decodeBlock(&audio)) != AAC_STREAM_NEED_INPUT)
+    {
+      if (decoder.getSkippedSize() != skipped)
+      {
+        printf("Skipped %zd bytes looking for a frame header.\n", decoder.getSkippedSize() - skipped);
+        skipped = decoder.getSkippedSize();
+      }
+
+      if (status == AAC_STREAM_FAILED)
+      {
+        fprintf(stderr, "Failed to decode block at offset %zu\n", decoder.getPosition());
+        exit(1);
+      }
+
+      if (status == AAC_STREAM_CRC_ERROR)
+      {
+        fprintf(stderr, "CRC mismatch in frame at offset %zu. Skipped it.\n", decoder.getPosition());
+        continue;
+      }
+
+      writeAudio(writer, &audio);
+    }
+  }
+
+  if (decoder.getBufferedSize())
+    printf("Ignored incomplete frame of %zd bytes at end of input.\n", decoder.getBufferedSize());
+
+  printStats(decoder.getStats());
+}
+
+// Expands an output filename template for one input file
+static std::string formatOutputPath(const char *format, const std::string &inputPath, size_t index)
+{
+  size_t slash = inputPath.rfind('/');
+  std::string dir  = (slash == std::string::npos) ? "." : inputPath.substr(0, slash);
+  std::string name = (slash == std::string::npos) ? inputPath : inputPath.substr(slash + 1);
+
+  size_t dot = name.rfind('.');
+  if ((dot != std::string::npos) && (dot > 0))
+    name.resize(dot);
+
+  std::string path;
+  for (const char *p = format; *p; p++)
+  {
+    if ((*p != '%') || !p[1])
+    {
+      path += *p;
+      continue;
+    }
+
+    switch (*++p)
+    {
+    case 'd':
+      path += dir;
+      break;
+    case 'n':
+      path += name;
+      break;
+    case 'i':
+      path += std::to_string(index);
+      break;
+    default:
+      path += *p;
+      break;
+    }
   }
 
-  writer.close();
+  return path;
+}
+
+// Lists the .aac files in a directory, or the lines of a list file
+static bool readBatchInputs(const char *source, std::vector<std::string> *inputs)
+{
+  struct stat st;
+  if (stat(source, &st) < 0)
+    return false;
+
+  if (S_ISDIR(st.st_mode))
+  {
+    DIR *dir = opendir(source);
+    if (!dir)
+      return false;
+
+    while (struct dirent *entry = readdir(dir))
+    {
+      size_t length = strlen(entry->d_name);
+      if ((length > 4) && !strcasecmp(entry->d_name + length - 4, ".aac"))
+        inputs->push_back(std::string(source) + "/" + entry->d_name);
+    }
+
+    closedir(dir);
+
+    std::sort(inputs->begin(), inputs->end());
+    return true;
+  }
+
+  FILE *list = fopen(source, "r");
+  if (!list)
+    return false;
+
+  char line[4096];
+  while (fgets(line, sizeof(line), list))
+  {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0])
+      inputs->push_back(line);
+  }
+
+  fclose(list);
+  return true;
+}
+
+// Transcodes many files in one process
+static void transcodeBatch(const char *source, const char *format, unsigned int threadCount)
+{
+  std::vector<std::string> inputs;
+  if (!readBatchInputs(source, &inputs))
+  {
+    fprintf(stderr, "Could not read batch list %s: %s\n", source, strerror(errno));
+    exit(1);
+  }
+
+  AacThreadPool pool(threadCount);
+
+  AacBatchTranscoder transcoder(&pool);
+  transcoder.setDirect(isDirectOutput);
+
+  for (size_t i = 0; i < inputs.size(); i++)
+  {
+    std::string outputPath = formatOutputPath(format, inputs[i], i);
+    if (!transcoder.addFile(inputs[i].c_str(), outputPath.c_str()))
+      fprintf(stderr, "%s: %s\n", inputs[i].c_str(), strerror(errno));
+  }
+
+  AacBatchStats stats;
+  bool success = transcoder.run(&stats);
+
+  for (const auto &job : transcoder.getJobs())
+  {
+    if (job.isSuccess)
+      continue;
+
+    if (job.failureErrno)
+      fprintf(stderr, "%s: %s: %s\n", job.inputPath.c_str(), job.failure, strerror(job.failureErrno));
+    else
+      fprintf(stderr, "%s: %s\n", job.inputPath.c_str(), job.failure);
+  }
+
+  double seconds = (stats.elapsedSeconds > 0.0) ? stats.elapsedSeconds : 1e-9;
+
+  printf("Files           : %u (%u failed)\n", stats.fileCount, stats.failedCount);
+  printf("Threads         : %u\n", pool.getThreadCount());
+  printf("Input           : %.1f MB (%.1f MB/s)\n", stats.inputBytes / 1e6, stats.inputBytes / 1e6 / seconds);
+  printf("Output          : %.1f MB (%.1f MB/s)\n", stats.outputBytes / 1e6, stats.outputBytes / 1e6 / seconds);
+  printf("Blocks          : %llu (%.0f blocks/s)\n", static_cast<unsigned long long>(stats.blockCount), stats.blockCount / seconds);
+  printf("Audio           : %.1f s (%.1fx realtime)\n", stats.audioSeconds, stats.audioSeconds / seconds);
+  printf("Elapsed         : %.3f s\n", stats.elapsedSeconds);
+
+  exit(success ? 0 : 1);
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"pipeline",         no_argument,       NULL, 'p'},
+    {"frame-parallel",   required_argument, NULL, 'f'},
+    {"threads",          required_argument, NULL, 't'},
+    {"batch",            required_argument, NULL, 'b'},
+    {"output",           required_argument, NULL, 'o'},
+    {"direct",           no_argument,       NULL, 'D'},
+    {"crc",              no_argument,       NULL, 'c'},
+    {"stats",            no_argument,       NULL, 's'},
+    {"perf",             no_argument,       NULL, 'P'},
+    {"trace",            required_argument, NULL, 'T'},
+    {"trace-level",      required_argument, NULL, 'L'},
+    {"trace-categories", required_argument, NULL, 'C'},
+    {NULL,               0,                 NULL, 0},
+  };
+
+  bool pipelined = false;
+  unsigned int frameThreadCount = 0;
+  unsigned int segmentThreadCount = 0;
+  const char *batchSource = NULL;
+  const char *outputFormat = "%d/%n.wav";
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "pf:t:b:o:", options, NULL)) != -1)
+  {
+    switch (opt)
+    {
+    case 'p':
+      pipelined = true;
+      break;
+    case 'f':
+      if (!parseThreadCount(optarg, &frameThreadCount))
+        usage(argv[0]);
+      break;
+    case 't':
+      if (!parseThreadCount(optarg, &segmentThreadCount))
+        usage(argv[0]);
+      break;
+    case 'b':
+      batchSource = optarg;
+      break;
+    case 'o':
+      outputFormat = optarg;
+      break;
+    case 'D':
+      isDirectOutput = true;
+      break;
+    case 'c':
+      isCrcChecked = true;
+      break;
+    case 's':
+      isStatsShown = true;
+      break;
+    case 'P':
+      isPerfShown = true;
+      break;
+    case 'T':
+      traceFilename = optarg;
+      break;
+    case 'L':
+      if (!AacTrace::parseLevel(optarg, &traceLevel))
+        usage(argv[0]);
+      break;
+    case 'C':
+      if (!AacTrace::parseCategories(optarg, &traceCategories))
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (isCrcChecked && (batchSource || frameThreadCount || segmentThreadCount))
+  {
+    fprintf(stderr, "CRC checking is only possible with serial or pipelined decoding.\n");
+    exit(1);
+  }
+
+  if ((isStatsShown || isPerfShown) && (batchSource || pipelined || frameThreadCount || segmentThreadCount))
+  {
+    fprintf(stderr, "Stage timing is only possible with serial decoding.\n");
+    exit(1);
+  }
+
+  if (traceFilename && (batchSource || pipelined || frameThreadCount || segmentThreadCount))
+  {
+    fprintf(stderr, "Tracing is only possible with serial decoding.\n");
+    exit(1);
+  }
+
+  // Closing at exit writes out the records leading up to a failure, too
+  if (traceFilename)
+  {
+    if (!AacTrace::open(traceFilename))
+    {
+      fprintf(stderr, "%s: %s\n", traceFilename, strerror(errno));
+      exit(1);
+    }
+
+    atexit(closeTrace);
+  }
+
+#if !defined(AAC_STATS)
+  if (isStatsShown || isPerfShown)
+  {
+    fprintf(stderr, "Built without stage timing. Rebuild with make clean && make STATS=1 to use --stats or --perf.\n");
+    exit(1);
+  }
+#endif
+
+  // Without counters, decoding goes ahead anyway
+  if (isPerfShown)
+  {
+    if (perfCounters.open())
+      perfCounters.start();
+    else
+      fprintf(stderr, "Performance counters unavailable: %s\n", perfCounters.getError());
+  }
+
+  if (batchSource)
+  {
+    if (optind != argc)
+      usage(argv[0]);
+
+    // In batch mode, --threads sizes the pool that files are spread over
+    transcodeBatch(batchSource, outputFormat, segmentThreadCount);
+  }
+
+  if ((optind != argc - 1) && (optind != argc - 2))
+    usage(argv[0]);
+
+  const char *inputFilename = argv[optind];
+
+  if (optind == argc - 2)
+    outputFilename = argv[optind + 1];
+
+  if (!strcmp(outputFilename, "-"))
+  {
+    // Keep the real stdout for the audio, and send anything else that gets
+    //  printed to stderr instead
+    outputFd = dup(STDOUT_FILENO);
+    if ((outputFd < 0) || (dup2(STDERR_FILENO, STDOUT_FILENO) < 0))
+    {
+      fprintf(stderr, "dup(): %s\n", strerror(errno));
+      exit(1);
+    }
+  }
+
+  // Create WAV writer
+  WavWriter writer;
+
+  if (!strcmp(inputFilename, "-"))
+  {
+    // A stream can only be decoded as it arrives
+    if (pipelined || frameThreadCount || segmentThreadCount)
+    {
+      fprintf(stderr, "Only serial decoding is possible from stdin.\n");
+      exit(1);
+    }
+
+    decodeStream(STDIN_FILENO, &writer);
+
+    closeOutput(&writer);
+
+    return 0;
+  }
+
+  // Map the input file into memory
+  size_t bytesSize;
+  uint8_t *bytes = mmapFile(inputFilename, &bytesSize);
+  if (!bytes)
+  {
+    fprintf(stderr, "Couldn't open input file.\n");
+    exit(1);
+  }
+
+  bool isMp4 = AacMp4Demuxer::isMp4(bytes, bytesSize);
+  bool isLoas = !isMp4 && AacLoasFrameReader::isLoas(bytes, bytesSize);
+
+  if (isMp4 || isLoas)
+  {
+    if (pipelined || frameThreadCount || segmentThreadCount)
+    {
+      fprintf(stderr, "Only serial decoding is possible for MP4 and LOAS input.\n");
+      exit(1);
+    }
+
+    if (isMp4)
+      decodeMp4(bytes, bytesSize, &writer);
+    else
+      decodeLoas(bytes, bytesSize, &writer);
+
+    closeOutput(&writer);
+
+    return 0;
+  }
+
+  auto reader = AacAdtsFrameReader(bytes, bytesSize);
+
+  // Skip over any initial ID3 tag
+  if (size_t id3Size = reader.skipID3())
+    printf("Skipped ID3 tag of %zd bytes.\n", id3Size);
+
+  // Position reader at first frame header
+  if (!reader.isAtFrameHeader())
+    reader.findNextFrame();
+
+  // Read frame header
+  AacAdtsFrameHeader header;
+  if (!reader.readFrameHeader(&header))
+  {
+    fprintf(stderr, "Could not find initial frame header.\n");
+    exit(1);
+  }
+
+  header.dump();
+
+  // Every frame decodes to one block, so the output size can be worked out
+  //  from the headers alone
+  auto channelConfig = header.getChannelConfiguration();
+  unsigned int channelCount = channelConfig->fullChannelCount + channelConfig->subwooferChannelCount;
+  expectedOutputSize = static_cast<uint64_t>(reader.countFrames()) * AAC_AUDIO_BLOCK_SAMPLE_COUNT * channelCount * sizeof(int16_t);
+
+  if (pipelined)
+    decodePipelined(&reader, &writer);
+  else if (frameThreadCount)
+    decodeFrameParallel(&reader, frameThreadCount, &writer);
+  else if (segmentThreadCount)
+    decodeSegmentParallel(&reader, segmentThreadCount, &writer);
+  else
+    decodeSerial(&reader, header.getSampleRate(), &writer);
+
+  closeOutput(&writer);
 
   return 0;
 }
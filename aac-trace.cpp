@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "AacTrace.h"
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--level <level>] [--categories <list>] [--decoder <n>] <trace-file>\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "Prints the records of a trace written by aac-to-wav --trace, one per line, in\n");
+  fprintf(stderr, "time order: seconds since the first record, the decoder, block number and\n");
+  fprintf(stderr, "stream position, then the event and its fields.\n");
+  fprintf(stderr, "\n");
+  fprintf(stderr, "  --level <level>        Only records at error, info or debug and below\n");
+  fprintf(stderr, "  --categories <list>    Only framing, side-info, spectral and transform records,\n");
+  fprintf(stderr, "                         as a comma-separated list or all\n");
+  fprintf(stderr, "  --decoder <n>          Only records from one decoder\n");
+  exit(1);
+}
+
+static bool readTrace(const char *filename, double *ticksPerSecond, std::vector<AacTraceRecord> *records)
+{
+  FILE *file = fopen(filename, "rb");
+  if (!file)
+  {
+    fprintf(stderr, "%s: %s\n", filename, strerror(errno));
+    return false;
+  }
+
+  AacTraceFileHeader header;
+  if ((fread(&header, sizeof(header), 1, file) != 1) || (header.magic != AAC_TRACE_FILE_MAGIC))
+  {
+    fprintf(stderr, "%s: Not a trace file, or written with the other byte order\n", filename);
+    fclose(file);
+    return false;
+  }
+
+  if ((header.version != AAC_TRACE_FILE_VERSION) || (header.recordSize != sizeof(AacTraceRecord)))
+  {
+    fprintf(stderr, "%s: Trace file version %u isn't supported\n", filename, header.version);
+    fclose(file);
+    return false;
+  }
+
+  *ticksPerSecond = header.ticksPerSecond;
+
+  AacTraceRecord record;
+  while (fread(&record, sizeof(record), 1, file) == 1)
+    records->push_back(record);
+
+  if (ferror(file))
+    fprintf(stderr, "%s: %s\n", filename, strerror(errno));
+  else if (ftell(file) != static_cast<long>(sizeof(header) + (records->size() * sizeof(record))))
+    fprintf(stderr, "%s: Ignored a partial record at the end\n", filename);
+
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  static const struct option options[] =
+  {
+    {"level",      required_argument, NULL, 'l'},
+    {"categories", required_argument, NULL, 'c'},
+    {"decoder",    required_argument, NULL, 'd'},
+    {NULL,         0,                 NULL, 0},
+  };
+
+  AacTraceLevel level = AAC_TRACE_DEBUG;
+  unsigned int categories = AAC_TRACE_ALL_CATEGORIES;
+  unsigned int source = 0;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "l:c:d:", options, NULL)) != -1)
+  {
+    char *end;
+
+    switch (opt)
+    {
+    case 'l':
+      if (!AacTrace::parseLevel(optarg, &level))
+        usage(argv[0]);
+      break;
+    case 'c':
+      if (!AacTrace::parseCategories(optarg, &categories))
+        usage(argv[0]);
+      break;
+    case 'd':
+      source = strtoul(optarg, &end, 10);
+      if (*end || (source == 0))
+        usage(argv[0]);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+
+  if (optind != argc - 1)
+    usage(argv[0]);
+
+  double ticksPerSecond;
+  std::vector<AacTraceRecord> records;
+  if (!readTrace(argv[optind], &ticksPerSecond, &records))
+    exit(1);
+
+  // Each thread's records are written out together, so they're only in
+  //  order within a thread
+  std::stable_sort(records.begin(), records.end(), [](const AacTraceRecord &a, const AacTraceRecord &b) { return a.timestamp < b.timestamp; });
+
+  uint64_t startTicks = records.empty() ? 0 : records[0].timestamp;
+
+  char text[512];
+  uint64_t unknownCount = 0;
+
+  for (auto &record : records)
+  {
+    if ((AacTrace::getLevel(record.event) > level) || !(categories & (1U << AacTrace::getCategory(record.event))))
+      continue;
+
+    if (source && (record.source != source))
+      continue;
+
+    if (!AacTrace::format(&record, text, sizeof(text)))
+    {
+      unknownCount++;
+      continue;
+    }
+
+    const char *levelName = AacTrace::getLevelName(AacTrace::getLevel(record.event));
+    const char *categoryName = AacTrace::getCategoryName(AacTrace::getCategory(record.event));
+
+    printf("%12.6f  d%-3u block %-8u @%-10llu %-5s %-9s  %s\n", (record.timestamp - startTicks) / ticksPerSecond, record.source, record.block, static_cast<unsigned long long>(record.position), levelName, categoryName, text);
+  }
+
+  if (unknownCount)
+    fprintf(stderr, "Skipped %llu records of events this build doesn't know\n", static_cast<unsigned long long>(unknownCount));
+
+  return 0;
+}
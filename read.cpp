@@ -10,13 +10,23 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+
+#include <algorithm>
+#include <vector>
 //#include <endian.h>
 
 #include "AacAdtsFrameHeader.h"
 #include "AacAdtsFrame.h"
 #include "AacAdtsFrameReader.h"
+#include "AacAdtsProbe.h"
+#include "AacBitstreamStats.h"
 #include "AacDecoder.h"
 #include "AacAudioBlock.h"
+#include "AacStreamDecoder.h"
+#include "BufferedWriter.h"
+
+// Bytes read from a stream at a time
+#define STREAM_CHUNK_SIZE (1024 * 1024)
 
 uint8_t *mmapFile(const char *filename, size_t *sizePtr)
 {
@@ -47,31 +57,388 @@ uint8_t *mmapFile(const char *filename, size_t *sizePtr)
   return bytes;
 }
 
-int main(int argc, char *argv[])
+static void writeAudio(BufferedWriter *output, AacAudioBlock *audio)
 {
-  if (argc != 2)
+  int16_t *buf;
+  audio->switchEndianness(std::endian::big);
+  auto size = audio->getSampleBuffer(&buf);
+  if (!output->write(reinterpret_cast<uint8_t *>(buf), size))
   {
-    fprintf(stderr, "Usage: %s <filename>\n", argv[0]);
-    exit(1);
+    perror("write()");
+    abort();
   }
+}
 
-  // Map the input file into memory
+// Decodes from a pipe or other stream, a chunk at a time
+static void decodeStream(int fd, BufferedWriter *output, bool isCrcChecked)
+{
+  AacStreamDecoder decoder;
+  decoder.setCrcCheck(isCrcChecked);
+
+  AacAudioBlock audio;
+
+  std::vector<uint8_t> chunk(STREAM_CHUNK_SIZE);
+  size_t skipped = 0;
+
+  while (true)
+  {
+    ssize_t count = read(fd, chunk.data(), chunk.size());
+    if (count < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      perror("read()");
+      abort();
+    }
+
+    if (count == 0)
+      break;  // EOF
+
+    decoder.feed(chunk.data(), count);
+
+    AacStreamStatus status;
+    while ((status = decoder.decodeBlock(&audio)) != AAC_STREAM_NEED_INPUT)
+    {
+      if (decoder.getSkippedSize() != skipped)
+      {
+        printf("Skipped %zd bytes looking for a frame header.\n", decoder.getSkippedSize() - skipped);
+        skipped = decoder.getSkippedSize();
+      }
+
+      if (status == AAC_STREAM_BLOCK)
+        writeAudio(output, &audio);
+      else if (status == AAC_STREAM_CRC_ERROR)
+        fprintf(stderr, "CRC mismatch\n");
+      else
+        fprintf(stderr, "Failed to decode block\n");
+    }
+  }
+}
+
+// Reports on a file from its frame headers, without decoding. Returns false
+//  if it couldn't be read, has no frames or is damaged.
+static bool probeFile(const char *filename)
+{
   size_t bytesSize;
-  uint8_t *bytes = mmapFile(argv[1], &bytesSize);
+  uint8_t *bytes = mmapFile(filename, &bytesSize);
   if (!bytes)
   {
-    fprintf(stderr, "Couldn't open input file.\n");
-    exit(1);
+    fprintf(stderr, "%s: Couldn't open input file.\n", filename);
+    return false;
+  }
+
+  auto reader = AacAdtsFrameReader(bytes, bytesSize);
+
+  AacAdtsProbeResult result;
+  AacAdtsProbe::probe(&reader, &result);
+
+  munmap(bytes, bytesSize);
+
+  printf("--- %s ---\n", filename);
+
+  if (result.id3Size)
+    printf("ID3 tag         : %zu bytes\n", result.id3Size);
+
+  printf("Frames          : %llu (%llu bytes)\n", static_cast<unsigned long long>(result.frameCount), static_cast<unsigned long long>(result.frameBytes));
+  printf("Samples         : %llu per channel\n", static_cast<unsigned long long>(result.sampleCount));
+  printf("Duration        : %.3f s\n", result.duration);
+  printf("Bitrate         : %.1f kbit/s (min %.1f, max %.1f)\n", result.averageBitrate / 1000, result.minBitrate / 1000, result.maxBitrate / 1000);
+
+  for (auto &change : result.parameters)
+  {
+    printf("Parameters      : %u Hz, %u channels, %s from offset %llu (sample %llu)\n", change.sampleRate, change.channelCount,
+      AacAdtsFrameHeader::getProfileName(change.profile), static_cast<unsigned long long>(change.offset), static_cast<unsigned long long>(change.sample));
+  }
+
+  for (auto &region : result.damagedRegions)
+    printf("Damaged         : %llu bytes at offset %llu\n", static_cast<unsigned long long>(region.size), static_cast<unsigned long long>(region.offset));
+
+  return (result.frameCount > 0) && result.damagedRegions.empty();
+}
+
+// Parses every frame of a file, without the transform, into the stats.
+//  Returns false if it couldn't be read.
+static bool gatherStats(const char *filename, AacBitstreamStats *total, double *duration, uint64_t *failedCount)
+{
+  size_t bytesSize;
+  uint8_t *bytes = mmapFile(filename, &bytesSize);
+  if (!bytes)
+  {
+    fprintf(stderr, "%s: Couldn't open input file.\n", filename);
+    return false;
+  }
+
+  auto reader = AacAdtsFrameReader(bytes, bytesSize);
+  reader.skipID3();
+
+  // Window transitions are only counted within a file
+  AacBitstreamStats stats;
+  auto decoder = AacDecoder(0);
+
+  auto block = new AacSpectralBlock;
+
+  while (!reader.isComplete())
+  {
+    // Frames are checked from their headers first, as by --probe, so damage
+    //  is passed over and counted rather than parsed
+    AacAdtsFrameHeader header;
+    bool isValid = reader.readFrameHeader(&header);
+    size_t frameSize = isValid ? header.getFrameSize() : 0;
+    unsigned int sampleRate = isValid ? header.getSampleRate() : 0;
+
+    if (!isValid || (frameSize < AAC_ADTS_FRAME_HEADER_SIZE + (header.hasCrcProtection() ? 2 : 0)) || (frameSize > reader.getRemainingSize()) || (sampleRate == 0))
+    {
+      (*failedCount)++;
+      reader.findNextFrame();
+      continue;
+    }
+
+    // Every frame found counts towards the duration, parsed or not
+    unsigned int blockCount = header.getDataBlockCount();
+    *duration += static_cast<double>(blockCount * AAC_AUDIO_BLOCK_SAMPLE_COUNT) / sampleRate;
+
+    // Only single block frames can be parsed
+    if (blockCount != 1)
+    {
+      *failedCount += blockCount;
+      reader.advance(frameSize);
+      continue;
+    }
+
+    auto frame = AacAdtsFrame();
+    frame.setHeader(&header);
+
+    if (decoder.getSampleRate() != sampleRate)
+    {
+      decoder = AacDecoder(sampleRate);
+      decoder.setBitstreamStats(&stats);
+    }
+
+    if (!decoder.parseFrame(&frame, block))
+      (*failedCount)++;
+
+    reader.advance(frameSize);
   }
 
+  delete block;
+  munmap(bytes, bytesSize);
+
+  total->add(stats);
+  return true;
+}
+
+static double getShare(uint64_t count, uint64_t total)
+{
+  return total ? (100.0 * count / total) : 0.0;
+}
+
+static void printMaxSfbCounts(const char *name, const uint64_t counts[AAC_MAX_SFB_COUNT + 1])
+{
+  uint64_t total = 0;
+  for (unsigned int i = 0; i <= AAC_MAX_SFB_COUNT; i++)
+    total += counts[i];
+
+  if (total == 0)
+    return;
+
+  printf("%-16s:\n", name);
+  for (unsigned int i = 0; i <= AAC_MAX_SFB_COUNT; i++)
+  {
+    if (counts[i])
+      printf("  %-14u: %10llu  %5.1f%%\n", i, static_cast<unsigned long long>(counts[i]), getShare(counts[i], total));
+  }
+}
+
+static void printStats(const AacBitstreamStats *stats, unsigned int fileCount, double duration, uint64_t failedCount)
+{
+  static const char *sequenceNames[] = {"long", "start", "short", "stop"};
+  static const char *shapeNames[] = {"sine", "KBD"};
+  static const char *msMaskNames[] = {"none", "some bands", "all bands", "reserved"};
+
+  uint64_t totalBits = stats->getTotalBits();
+  uint64_t blockCount = std::max<uint64_t>(stats->blockCount, 1);
+
+  printf("Files           : %u\n", fileCount);
+  printf("Blocks          : %llu (%llu failed), %llu channels\n", static_cast<unsigned long long>(stats->blockCount), static_cast<unsigned long long>(failedCount),
+         static_cast<unsigned long long>(stats->channelCount));
+  printf("Duration        : %.3f s\n", duration);
+  printf("Bitrate         : %.1f kbit/s of raw data blocks\n", (duration > 0.0) ? (totalBits / duration / 1000) : 0.0);
+
+  printf("Elements        : %llu SCE, %llu CPE, %llu FIL, %llu PCE\n", static_cast<unsigned long long>(stats->elementCounts[AAC_ID_SCE]),
+         static_cast<unsigned long long>(stats->elementCounts[AAC_ID_CPE]), static_cast<unsigned long long>(stats->elementCounts[AAC_ID_FIL]),
+         static_cast<unsigned long long>(stats->elementCounts[AAC_ID_PCE]));
+
+  printf("Bits            :       total   per block  share\n");
+  for (unsigned int i = 0; i < AAC_BITS_PART_COUNT; i++)
+  {
+    printf("  %-14s: %11llu  %10.1f  %5.1f%%\n", AacBitstreamStats::getPartName(static_cast<AacBitstreamPart>(i)), static_cast<unsigned long long>(stats->bits[i]),
+           static_cast<double>(stats->bits[i]) / blockCount, getShare(stats->bits[i], totalBits));
+  }
+
+  uint64_t totalBands = 0;
+  for (unsigned int i = 0; i < AAC_BITSTREAM_CODEBOOK_COUNT; i++)
+    totalBands += stats->codebookBands[i];
+
+  printf("Codebooks       :       bands  share  spectral bits  bits/band\n");
+  for (unsigned int i = 0; i < AAC_BITSTREAM_CODEBOOK_COUNT; i++)
+  {
+    if (!stats->codebookBands[i])
+      continue;
+
+    const char *kind = (i == AAC_HCB_ZERO) ? " (zero)" : (i == AAC_HCB_NOISE) ? " (PNS)" : AAC_IS_INTENSITY_CODEBOOK(i) ? " (intensity)" : "";
+
+    char name[32];
+    snprintf(name, sizeof(name), "%u%s", i, kind);
+
+    printf("  %-14s: %11llu  %5.1f%%  %13llu  %9.1f\n", name, static_cast<unsigned long long>(stats->codebookBands[i]), getShare(stats->codebookBands[i], totalBands),
+           static_cast<unsigned long long>(stats->codebookBits[i]), static_cast<double>(stats->codebookBits[i]) / stats->codebookBands[i]);
+  }
+
+  printf("Escapes         : %llu (%.2f per block)\n", static_cast<unsigned long long>(stats->escapeCount), static_cast<double>(stats->escapeCount) / blockCount);
+
+  uint64_t channelCount = std::max<uint64_t>(stats->channelCount, 1);
+  printf("TNS             : %llu channels (%.1f%%)\n", static_cast<unsigned long long>(stats->tnsChannels), getShare(stats->tnsChannels, channelCount));
+  printf("Pulse           : %llu channels (%.1f%%)\n", static_cast<unsigned long long>(stats->pulseChannels), getShare(stats->pulseChannels, channelCount));
+  printf("PNS             : %llu bands\n", static_cast<unsigned long long>(stats->codebookBands[AAC_HCB_NOISE]));
+  printf("Intensity       : %llu bands\n", static_cast<unsigned long long>(stats->codebookBands[AAC_HCB_INTENSITY] + stats->codebookBands[AAC_HCB_INTENSITY2]));
+
+  printf("M/S mask        :");
+  for (unsigned int i = 0; i < AAC_BITSTREAM_MS_MASK_COUNT; i++)
+    printf("%s %llu %s", i ? "," : "", static_cast<unsigned long long>(stats->msMaskCounts[i]), msMaskNames[i]);
+  printf(" (CPEs with a common window)\n");
+
+  printf("Window sequence : from \\ to");
+  for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT; j++)
+    printf(" %9s", sequenceNames[j]);
+  printf("\n");
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT; i++)
+  {
+    printf("  %-24s", sequenceNames[i]);
+    for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SEQUENCE_COUNT; j++)
+      printf(" %9llu", static_cast<unsigned long long>(stats->windowSequenceTransitions[i][j]));
+    printf("\n");
+  }
+
+  printf("Window shape    : from \\ to");
+  for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SHAPE_COUNT; j++)
+    printf(" %9s", shapeNames[j]);
+  printf("\n");
+
+  for (unsigned int i = 0; i < AAC_BITSTREAM_WINDOW_SHAPE_COUNT; i++)
+  {
+    printf("  %-24s", shapeNames[i]);
+    for (unsigned int j = 0; j < AAC_BITSTREAM_WINDOW_SHAPE_COUNT; j++)
+      printf(" %9llu", static_cast<unsigned long long>(stats->windowShapeTransitions[i][j]));
+    printf("\n");
+  }
+
+  printMaxSfbCounts("Max SFB (long)", stats->longMaxSfbCounts);
+  printMaxSfbCounts("Max SFB (short)", stats->shortMaxSfbCounts);
+}
+
+static void usage(const char *name)
+{
+  fprintf(stderr, "Usage: %s [--crc] <filename> [<output>]\n", name);
+  fprintf(stderr, "       %s --probe <filename>...\n", name);
+  fprintf(stderr, "       %s --stats <filename>...\n", name);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "The output defaults to out.pcm. Either filename may be - for stdin or stdout.\n");
+  fprintf(stderr, "--crc skips frames whose CRC doesn't match, instead of decoding them.\n");
+  fprintf(stderr, "--probe reports each file's duration, bitrate, parameters and damage from\n");
+  fprintf(stderr, "its frame headers, without decoding. It exits with 1 if any file is damaged.\n");
+  fprintf(stderr, "--stats parses every block of the files and reports, over all of them, the\n");
+  fprintf(stderr, "bits spent on each part of the syntax, codebook and coding tool use, window\n");
+  fprintf(stderr, "transitions and the spread of max_sfb.\n");
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  if ((argc >= 2) && !strcmp(argv[1], "--probe"))
+  {
+    if (argc < 3)
+      usage(argv[0]);
+
+    bool success = true;
+    for (int i = 2; i < argc; i++)
+      success = probeFile(argv[i]) && success;
+
+    return success ? 0 : 1;
+  }
+
+  if ((argc >= 2) && !strcmp(argv[1], "--stats"))
+  {
+    if (argc < 3)
+      usage(argv[0]);
+
+    AacBitstreamStats stats;
+    double duration = 0.0;
+    uint64_t failedCount = 0;
+
+    bool success = true;
+    for (int i = 2; i < argc; i++)
+      success = gatherStats(argv[i], &stats, &duration, &failedCount) && success;
+
+    printStats(&stats, argc - 2, duration, failedCount);
+
+    return success ? 0 : 1;
+  }
+
+  int first = 1;
+
+  bool isCrcChecked = (argc >= 2) && !strcmp(argv[1], "--crc");
+  if (isCrcChecked)
+    first++;
+
+  if ((argc != first + 1) && (argc != first + 2))
+    usage(argv[0]);
+
+  const char *inputFilename = argv[first];
+  const char *outputFilename = (argc == first + 2) ? argv[first + 1] : "out.pcm";
+
   // Open the output file
-  int fd = open("out.pcm", O_WRONLY|O_CREAT|O_TRUNC, 0600);
-  if (fd < 1)
+  BufferedWriter output;
+
+  if (!strcmp(outputFilename, "-"))
+  {
+    // Keep the real stdout for the audio, and send messages to stderr
+    int fd = dup(STDOUT_FILENO);
+    if ((fd < 0) || (dup2(STDERR_FILENO, STDOUT_FILENO) < 0) || !output.open(fd))
+    {
+      perror("open()");
+      abort();
+    }
+  }
+  else if (!output.open(outputFilename))
   {
     perror("open()");
     abort();
   }
 
+  if (!strcmp(inputFilename, "-"))
+  {
+    decodeStream(STDIN_FILENO, &output, isCrcChecked);
+
+    if (!output.close())
+    {
+      perror("close()");
+      abort();
+    }
+
+    return 0;
+  }
+
+  // Map the input file into memory
+  size_t bytesSize;
+  uint8_t *bytes = mmapFile(inputFilename, &bytesSize);
+  if (!bytes)
+  {
+    fprintf(stderr, "Couldn't open input file.\n");
+    exit(1);
+  }
+
   auto reader = AacAdtsFrameReader(bytes, bytesSize);
 
   // Skip over any initial ID3 tag
@@ -94,6 +461,7 @@ int main(int argc, char *argv[])
 
   // Create decoder
   auto decoder = AacDecoder(header.getSampleRate());
+  decoder.setCrcCheck(isCrcChecked);
 
   AacAudioBlock audio;
 
@@ -107,24 +475,21 @@ int main(int argc, char *argv[])
       continue;
     }
 
-    frame.getHeader()->dump();
-
     if (decoder.getSampleRate() != frame.getHeader()->getSampleRate())
     {
       fprintf(stderr, "Detected sample rate change (%u -> %u)! Reinitializing decoder.\n", decoder.getSampleRate(), frame.getHeader()->getSampleRate());
       decoder = AacDecoder(frame.getHeader()->getSampleRate());
     }
 
-    if (decoder.decodeBlock(frame.getReader(), &audio))
+    unsigned int crcErrorCount = decoder.getCrcErrorCount();
+
+    if (decoder.decodeFrame(&frame, &audio))
     {
-      int16_t *buf;
-      audio.switchEndianness(std::endian::big);
-      auto size = audio.getSampleBuffer(&buf);
-      if (write(fd, buf, size) != static_cast<ssize_t>(size))
-      {
-        fprintf(stderr, "write(): Short write\n");
-        abort();
-      }
+      writeAudio(&output, &audio);
+    }
+    else if (decoder.getCrcErrorCount() != crcErrorCount)
+    {
+      fprintf(stderr, "CRC mismatch\n");
     }
     else
     {
@@ -136,7 +501,11 @@ int main(int argc, char *argv[])
     reader.advance(frameSize);
   }
 
-  close(fd);
+  if (!output.close())
+  {
+    perror("close()");
+    abort();
+  }
 
   return 0;
 }
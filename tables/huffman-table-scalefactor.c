@@ -0,0 +1,128 @@
+{
+  .count = 121,
+  .maxBits = 19,
+  .entries =
+  {
+    { 1, 0x0     ,  0},
+    { 3, 0x4     , -1},
+    { 4, 0xA     ,  1},
+    { 4, 0xB     , -2},
+    { 4, 0xC     ,  2},
+    { 5, 0x1A    , -3},
+    { 5, 0x1B    ,  3},
+    { 6, 0x38    , -4},
+    { 6, 0x39    ,  4},
+    { 6, 0x3A    , -5},
+    { 6, 0x3B    ,  5},
+    { 7, 0x78    ,  6},
+    { 7, 0x79    , -6},
+    { 7, 0x7A    ,  7},
+    { 8, 0xF6    , -7},
+    { 8, 0xF7    ,  8},
+    { 8, 0xF8    , -8},
+    { 8, 0xF9    ,  9},
+    { 8, 0xFA    , -9},
+    { 9, 0x1F6   , 10},
+    { 9, 0x1F7   , -10},
+    { 9, 0x1F8   , -11},
+    { 9, 0x1F9   , 11},
+    {10, 0x3F4   , 12},
+    {10, 0x3F5   , -12},
+    {10, 0x3F6   , 13},
+    {10, 0x3F7   , -13},
+    {10, 0x3F8   , 14},
+    {10, 0x3F9   , -14},
+    {11, 0x7F4   , 16},
+    {11, 0x7F5   , 15},
+    {11, 0x7F6   , 17},
+    {11, 0x7F7   , 18},
+    {11, 0x7F8   , -15},
+    {11, 0x7F9   , -17},
+    {12, 0xFF4   , -16},
+    {12, 0xFF5   , 19},
+    {12, 0xFF6   , -18},
+    {12, 0xFF7   , -19},
+    {12, 0xFF8   , 20},
+    {12, 0xFF9   , -20},
+    {13, 0x1FF4  , 21},
+    {13, 0x1FF5  , -21},
+    {13, 0x1FF6  , 22},
+    {13, 0x1FF7  , -22},
+    {13, 0x1FF8  , 23},
+    {14, 0x3FF2  , -23},
+    {14, 0x3FF3  , -25},
+    {14, 0x3FF4  , 25},
+    {14, 0x3FF5  , -27},
+    {14, 0x3FF6  , -24},
+    {14, 0x3FF7  , -26},
+    {14, 0x3FF8  , 24},
+    {14, 0x3FF9  , -28},
+    {15, 0x7FF4  , 27},
+    {15, 0x7FF5  , 29},
+    {15, 0x7FF6  , -30},
+    {15, 0x7FF7  , -29},
+    {16, 0xFFF0  , 26},
+    {16, 0xFFF1  , -31},
+    {16, 0xFFF2  , -34},
+    {16, 0xFFF3  , -33},
+    {16, 0xFFF4  , -32},
+    {16, 0xFFF5  , -36},
+    {16, 0xFFF6  , 28},
+    {17, 0x1FFEE , -35},
+    {17, 0x1FFEF , -38},
+    {17, 0x1FFF0 , -37},
+    {18, 0x3FFE2 , 30},
+    {18, 0x3FFE3 , -39},
+    {18, 0x3FFE4 , -41},
+    {18, 0x3FFE5 , -57},
+    {18, 0x3FFE6 , -59},
+    {18, 0x3FFE7 , -58},
+    {18, 0x3FFE8 , -60},
+    {19, 0x7FFD2 , 38},
+    {19, 0x7FFD3 , 39},
+    {19, 0x7FFD4 , 40},
+    {19, 0x7FFD5 , 41},
+    {19, 0x7FFD6 , 42},
+    {19, 0x7FFD7 , 57},
+    {19, 0x7FFD8 , 37},
+    {19, 0x7FFD9 , 31},
+    {19, 0x7FFDA , 32},
+    {19, 0x7FFDB , 33},
+    {19, 0x7FFDC , 34},
+    {19, 0x7FFDD , 35},
+    {19, 0x7FFDE , 36},
+    {19, 0x7FFDF , 44},
+    {19, 0x7FFE0 , 51},
+    {19, 0x7FFE1 , 52},
+    {19, 0x7FFE2 , 53},
+    {19, 0x7FFE3 , 54},
+    {19, 0x7FFE4 , 55},
+    {19, 0x7FFE5 , 56},
+    {19, 0x7FFE6 , 50},
+    {19, 0x7FFE7 , 45},
+    {19, 0x7FFE8 , 46},
+    {19, 0x7FFE9 , 47},
+    {19, 0x7FFEA , 48},
+    {19, 0x7FFEB , 49},
+    {19, 0x7FFEC , 58},
+    {19, 0x7FFED , -54},
+    {19, 0x7FFEE , -52},
+    {19, 0x7FFEF , -51},
+    {19, 0x7FFF0 , -50},
+    {19, 0x7FFF1 , -55},
+    {19, 0x7FFF2 , 43},
+    {19, 0x7FFF3 , 60},
+    {19, 0x7FFF4 , 59},
+    {19, 0x7FFF5 , -56},
+    {19, 0x7FFF6 , -53},
+    {19, 0x7FFF7 , -45},
+    {19, 0x7FFF8 , -44},
+    {19, 0x7FFF9 , -42},
+    {19, 0x7FFFA , -40},
+    {19, 0x7FFFB , -43},
+    {19, 0x7FFFC , -49},
+    {19, 0x7FFFD , -48},
+    {19, 0x7FFFE , -46},
+    {19, 0x7FFFF , -47},
+  }
+};
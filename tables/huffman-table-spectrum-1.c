@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 11,
+  .entries =
+  {
+    { 1, 0x0     ,  0,  0,  0,  0},
+    { 5, 0x10    ,  1,  0,  0,  0},
+    { 5, 0x11    , -1,  0,  0,  0},
+    { 5, 0x12    ,  0,  0,  0, -1},
+    { 5, 0x13    ,  0,  1,  0,  0},
+    { 5, 0x14    ,  0,  0,  0,  1},
+    { 5, 0x15    ,  0,  0, -1,  0},
+    { 5, 0x16    ,  0,  0,  1,  0},
+    { 5, 0x17    ,  0, -1,  0,  0},
+    { 7, 0x60    ,  1, -1,  0,  0},
+    { 7, 0x61    , -1,  1,  0,  0},
+    { 7, 0x62    ,  0,  0, -1,  1},
+    { 7, 0x63    ,  0,  1, -1,  0},
+    { 7, 0x64    ,  0, -1,  1,  0},
+    { 7, 0x65    ,  0,  0,  1, -1},
+    { 7, 0x66    ,  1,  1,  0,  0},
+    { 7, 0x67    ,  0,  0, -1, -1},
+    { 7, 0x68    , -1, -1,  0,  0},
+    { 7, 0x69    ,  0, -1, -1,  0},
+    { 7, 0x6A    ,  1,  0, -1,  0},
+    { 7, 0x6B    ,  0,  1,  0, -1},
+    { 7, 0x6C    , -1,  0,  1,  0},
+    { 7, 0x6D    ,  0,  0,  1,  1},
+    { 7, 0x6E    ,  1,  0,  1,  0},
+    { 7, 0x6F    ,  0, -1,  0,  1},
+    { 7, 0x70    ,  0,  1,  1,  0},
+    { 7, 0x71    ,  0,  1,  0,  1},
+    { 7, 0x72    , -1,  0, -1,  0},
+    { 7, 0x73    ,  1,  0,  0,  1},
+    { 7, 0x74    , -1,  0,  0, -1},
+    { 7, 0x75    ,  1,  0,  0, -1},
+    { 7, 0x76    , -1,  0,  0,  1},
+    { 7, 0x77    ,  0, -1,  0, -1},
+    { 9, 0x1E0   ,  1,  1, -1,  0},
+    { 9, 0x1E1   , -1,  1, -1,  0},
+    { 9, 0x1E2   ,  1, -1,  1,  0},
+    { 9, 0x1E3   ,  0,  1,  1, -1},
+    { 9, 0x1E4   ,  0,  1, -1,  1},
+    { 9, 0x1E5   ,  0, -1,  1,  1},
+    { 9, 0x1E6   ,  0, -1,  1, -1},
+    { 9, 0x1E7   ,  1, -1, -1,  0},
+    { 9, 0x1E8   ,  1,  0, -1,  1},
+    { 9, 0x1E9   ,  0,  1, -1, -1},
+    { 9, 0x1EA   , -1,  1,  1,  0},
+    { 9, 0x1EB   , -1,  0,  1, -1},
+    { 9, 0x1EC   , -1, -1,  1,  0},
+    { 9, 0x1ED   ,  0, -1, -1,  1},
+    { 9, 0x1EE   ,  1, -1,  0,  1},
+    { 9, 0x1EF   ,  1, -1,  0, -1},
+    { 9, 0x1F0   , -1,  1,  0, -1},
+    { 9, 0x1F1   , -1, -1, -1,  0},
+    { 9, 0x1F2   ,  0, -1, -1, -1},
+    { 9, 0x1F3   ,  0,  1,  1,  1},
+    { 9, 0x1F4   ,  1,  0,  1, -1},
+    { 9, 0x1F5   ,  1,  1,  0,  1},
+    { 9, 0x1F6   , -1,  1,  0,  1},
+    { 9, 0x1F7   ,  1,  1,  1,  0},
+    {10, 0x3F0   , -1, -1,  0,  1},
+    {10, 0x3F1   , -1,  0, -1, -1},
+    {10, 0x3F2   ,  1,  1,  0, -1},
+    {10, 0x3F3   ,  1,  0, -1, -1},
+    {10, 0x3F4   , -1,  0, -1,  1},
+    {10, 0x3F5   , -1, -1,  0, -1},
+    {10, 0x3F6   , -1,  0,  1,  1},
+    {10, 0x3F7   ,  1,  0,  1,  1},
+    {11, 0x7F0   ,  1, -1,  1, -1},
+    {11, 0x7F1   , -1,  1, -1,  1},
+    {11, 0x7F2   , -1,  1,  1, -1},
+    {11, 0x7F3   ,  1, -1, -1,  1},
+    {11, 0x7F4   ,  1,  1,  1,  1},
+    {11, 0x7F5   , -1, -1,  1,  1},
+    {11, 0x7F6   ,  1,  1, -1, -1},
+    {11, 0x7F7   , -1, -1,  1, -1},
+    {11, 0x7F8   , -1, -1, -1, -1},
+    {11, 0x7F9   ,  1,  1, -1,  1},
+    {11, 0x7FA   ,  1, -1,  1,  1},
+    {11, 0x7FB   , -1,  1,  1,  1},
+    {11, 0x7FC   , -1,  1, -1, -1},
+    {11, 0x7FD   , -1, -1, -1,  1},
+    {11, 0x7FE   ,  1, -1, -1, -1},
+    {11, 0x7FF   ,  1,  1,  1, -1},
+  }
+};
@@ -0,0 +1,176 @@
+{
+  .count = 169,
+  .maxBits = 12,
+  .entries =
+  {
+    { 4, 0x0     ,  1,  1},
+    { 4, 0x1     ,  1,  2},
+    { 4, 0x2     ,  2,  1},
+    { 5, 0x6     ,  2,  2},
+    { 5, 0x7     ,  1,  0},
+    { 5, 0x8     ,  0,  1},
+    { 5, 0x9     ,  1,  3},
+    { 5, 0xA     ,  3,  2},
+    { 5, 0xB     ,  3,  1},
+    { 5, 0xC     ,  2,  3},
+    { 5, 0xD     ,  3,  3},
+    { 6, 0x1C    ,  2,  0},
+    { 6, 0x1D    ,  0,  2},
+    { 6, 0x1E    ,  2,  4},
+    { 6, 0x1F    ,  4,  2},
+    { 6, 0x20    ,  1,  4},
+    { 6, 0x21    ,  4,  1},
+    { 6, 0x22    ,  0,  0},
+    { 6, 0x23    ,  4,  3},
+    { 6, 0x24    ,  3,  4},
+    { 6, 0x25    ,  3,  0},
+    { 6, 0x26    ,  0,  3},
+    { 6, 0x27    ,  4,  4},
+    { 6, 0x28    ,  2,  5},
+    { 6, 0x29    ,  5,  2},
+    { 7, 0x54    ,  1,  5},
+    { 7, 0x55    ,  5,  1},
+    { 7, 0x56    ,  5,  3},
+    { 7, 0x57    ,  3,  5},
+    { 7, 0x58    ,  5,  4},
+    { 7, 0x59    ,  4,  5},
+    { 7, 0x5A    ,  6,  2},
+    { 7, 0x5B    ,  2,  6},
+    { 7, 0x5C    ,  6,  3},
+    { 7, 0x5D    ,  4,  0},
+    { 7, 0x5E    ,  6,  1},
+    { 7, 0x5F    ,  0,  4},
+    { 7, 0x60    ,  1,  6},
+    { 7, 0x61    ,  3,  6},
+    { 7, 0x62    ,  5,  5},
+    { 7, 0x63    ,  6,  4},
+    { 7, 0x64    ,  4,  6},
+    { 8, 0xCA    ,  6,  5},
+    { 8, 0xCB    ,  7,  2},
+    { 8, 0xCC    ,  3,  7},
+    { 8, 0xCD    ,  2,  7},
+    { 8, 0xCE    ,  5,  6},
+    { 8, 0xCF    ,  8,  2},
+    { 8, 0xD0    ,  7,  3},
+    { 8, 0xD1    ,  5,  0},
+    { 8, 0xD2    ,  7,  1},
+    { 8, 0xD3    ,  0,  5},
+    { 8, 0xD4    ,  8,  1},
+    { 8, 0xD5    ,  1,  7},
+    { 8, 0xD6    ,  8,  3},
+    { 8, 0xD7    ,  7,  4},
+    { 8, 0xD8    ,  4,  7},
+    { 8, 0xD9    ,  2,  8},
+    { 8, 0xDA    ,  6,  6},
+    { 8, 0xDB    ,  7,  5},
+    { 8, 0xDC    ,  1,  8},
+    { 8, 0xDD    ,  3,  8},
+    { 8, 0xDE    ,  8,  4},
+    { 8, 0xDF    ,  4,  8},
+    { 8, 0xE0    ,  5,  7},
+    { 8, 0xE1    ,  8,  5},
+    { 8, 0xE2    ,  5,  8},
+    { 9, 0x1C6   ,  7,  6},
+    { 9, 0x1C7   ,  6,  7},
+    { 9, 0x1C8   ,  9,  2},
+    { 9, 0x1C9   ,  6,  0},
+    { 9, 0x1CA   ,  6,  8},
+    { 9, 0x1CB   ,  9,  3},
+    { 9, 0x1CC   ,  3,  9},
+    { 9, 0x1CD   ,  9,  1},
+    { 9, 0x1CE   ,  2,  9},
+    { 9, 0x1CF   ,  0,  6},
+    { 9, 0x1D0   ,  8,  6},
+    { 9, 0x1D1   ,  9,  4},
+    { 9, 0x1D2   ,  4,  9},
+    { 9, 0x1D3   , 10,  2},
+    { 9, 0x1D4   ,  1,  9},
+    { 9, 0x1D5   ,  7,  7},
+    { 9, 0x1D6   ,  8,  7},
+    { 9, 0x1D7   ,  9,  5},
+    { 9, 0x1D8   ,  7,  8},
+    { 9, 0x1D9   , 10,  3},
+    { 9, 0x1DA   ,  5,  9},
+    { 9, 0x1DB   , 10,  4},
+    { 9, 0x1DC   ,  2, 10},
+    { 9, 0x1DD   , 10,  1},
+    { 9, 0x1DE   ,  3, 10},
+    { 9, 0x1DF   ,  9,  6},
+    { 9, 0x1E0   ,  6,  9},
+    { 9, 0x1E1   ,  8,  0},
+    { 9, 0x1E2   ,  4, 10},
+    { 9, 0x1E3   ,  7,  0},
+    { 9, 0x1E4   , 11,  2},
+    {10, 0x3CA   ,  7,  9},
+    {10, 0x3CB   , 11,  3},
+    {10, 0x3CC   , 10,  6},
+    {10, 0x3CD   ,  1, 10},
+    {10, 0x3CE   , 11,  1},
+    {10, 0x3CF   ,  9,  7},
+    {10, 0x3D0   ,  0,  7},
+    {10, 0x3D1   ,  8,  8},
+    {10, 0x3D2   , 10,  5},
+    {10, 0x3D3   ,  3, 11},
+    {10, 0x3D4   ,  5, 10},
+    {10, 0x3D5   ,  8,  9},
+    {10, 0x3D6   , 11,  5},
+    {10, 0x3D7   ,  0,  8},
+    {10, 0x3D8   , 11,  4},
+    {10, 0x3D9   ,  2, 11},
+    {10, 0x3DA   ,  7, 10},
+    {10, 0x3DB   ,  6, 10},
+    {10, 0x3DC   , 10,  7},
+    {10, 0x3DD   ,  4, 11},
+    {10, 0x3DE   ,  1, 11},
+    {10, 0x3DF   , 12,  2},
+    {10, 0x3E0   ,  9,  8},
+    {10, 0x3E1   , 12,  3},
+    {10, 0x3E2   , 11,  6},
+    {10, 0x3E3   ,  5, 11},
+    {10, 0x3E4   , 12,  4},
+    {10, 0x3E5   , 11,  7},
+    {10, 0x3E6   , 12,  5},
+    {10, 0x3E7   ,  3, 12},
+    {10, 0x3E8   ,  6, 11},
+    {10, 0x3E9   ,  9,  0},
+    {10, 0x3EA   , 10,  8},
+    {10, 0x3EB   , 10,  0},
+    {10, 0x3EC   , 12,  1},
+    {10, 0x3ED   ,  0,  9},
+    {10, 0x3EE   ,  4, 12},
+    {10, 0x3EF   ,  9,  9},
+    {10, 0x3F0   , 12,  6},
+    {10, 0x3F1   ,  2, 12},
+    {10, 0x3F2   ,  8, 10},
+    {11, 0x7E6   ,  9, 10},
+    {11, 0x7E7   ,  1, 12},
+    {11, 0x7E8   , 11,  8},
+    {11, 0x7E9   , 12,  7},
+    {11, 0x7EA   ,  7, 11},
+    {11, 0x7EB   ,  5, 12},
+    {11, 0x7EC   ,  6, 12},
+    {11, 0x7ED   , 10,  9},
+    {11, 0x7EE   ,  8, 11},
+    {11, 0x7EF   , 12,  8},
+    {11, 0x7F0   ,  0, 10},
+    {11, 0x7F1   ,  7, 12},
+    {11, 0x7F2   , 11,  0},
+    {11, 0x7F3   , 10, 10},
+    {11, 0x7F4   , 11,  9},
+    {11, 0x7F5   , 11, 10},
+    {11, 0x7F6   ,  0, 11},
+    {11, 0x7F7   , 11, 11},
+    {11, 0x7F8   ,  9, 11},
+    {11, 0x7F9   , 10, 11},
+    {11, 0x7FA   , 12,  0},
+    {11, 0x7FB   ,  8, 12},
+    {12, 0xFF8   , 12,  9},
+    {12, 0xFF9   , 10, 12},
+    {12, 0xFFA   ,  9, 12},
+    {12, 0xFFB   , 11, 12},
+    {12, 0xFFC   , 12, 11},
+    {12, 0xFFD   ,  0, 12},
+    {12, 0xFFE   , 12, 10},
+    {12, 0xFFF   , 12, 12},
+  }
+};
@@ -0,0 +1,296 @@
+{
+  .count = 289,
+  .maxBits = 12,
+  .entries =
+  {
+    { 4, 0x0     ,  0,  0},
+    { 4, 0x1     ,  1,  1},
+    { 5, 0x4     , 16, 16},
+    { 5, 0x5     ,  1,  0},
+    { 5, 0x6     ,  0,  1},
+    { 5, 0x7     ,  2,  1},
+    { 5, 0x8     ,  1,  2},
+    { 5, 0x9     ,  2,  2},
+    { 6, 0x14    ,  1,  3},
+    { 6, 0x15    ,  3,  1},
+    { 6, 0x16    ,  3,  2},
+    { 6, 0x17    ,  2,  0},
+    { 6, 0x18    ,  2,  3},
+    { 6, 0x19    ,  0,  2},
+    { 6, 0x1A    ,  3,  3},
+    { 7, 0x36    ,  4,  1},
+    { 7, 0x37    ,  1,  4},
+    { 7, 0x38    ,  4,  2},
+    { 7, 0x39    ,  2,  4},
+    { 7, 0x3A    ,  4,  3},
+    { 7, 0x3B    ,  3,  4},
+    { 7, 0x3C    ,  3,  0},
+    { 7, 0x3D    ,  0,  3},
+    { 7, 0x3E    ,  5,  1},
+    { 7, 0x3F    ,  5,  2},
+    { 7, 0x40    ,  2,  5},
+    { 7, 0x41    ,  4,  4},
+    { 7, 0x42    ,  1,  5},
+    { 7, 0x43    ,  5,  3},
+    { 7, 0x44    ,  3,  5},
+    { 7, 0x45    ,  5,  4},
+    { 8, 0x8C    ,  4,  5},
+    { 8, 0x8D    ,  6,  2},
+    { 8, 0x8E    ,  2,  6},
+    { 8, 0x8F    ,  6,  1},
+    { 8, 0x90    ,  6,  3},
+    { 8, 0x91    ,  3,  6},
+    { 8, 0x92    ,  1,  6},
+    { 8, 0x93    ,  4, 16},
+    { 8, 0x94    ,  3, 16},
+    { 8, 0x95    , 16,  5},
+    { 8, 0x96    , 16,  3},
+    { 8, 0x97    , 16,  4},
+    { 8, 0x98    ,  6,  4},
+    { 8, 0x99    , 16,  6},
+    { 8, 0x9A    ,  4,  0},
+    { 8, 0x9B    ,  4,  6},
+    { 8, 0x9C    ,  0,  4},
+    { 8, 0x9D    ,  2, 16},
+    { 8, 0x9E    ,  5,  5},
+    { 8, 0x9F    ,  5, 16},
+    { 8, 0xA0    , 16,  7},
+    { 8, 0xA1    , 16,  2},
+    { 8, 0xA2    , 16,  8},
+    { 8, 0xA3    ,  2,  7},
+    { 8, 0xA4    ,  7,  2},
+    { 8, 0xA5    ,  3,  7},
+    { 8, 0xA6    ,  6,  5},
+    { 8, 0xA7    ,  5,  6},
+    { 8, 0xA8    ,  6, 16},
+    { 8, 0xA9    , 16, 10},
+    { 8, 0xAA    ,  7,  3},
+    { 8, 0xAB    ,  7,  1},
+    { 8, 0xAC    , 16,  9},
+    { 8, 0xAD    ,  7, 16},
+    { 8, 0xAE    ,  1, 16},
+    { 8, 0xAF    ,  1,  7},
+    { 8, 0xB0    ,  4,  7},
+    { 8, 0xB1    , 16, 11},
+    { 8, 0xB2    ,  7,  4},
+    { 8, 0xB3    , 16, 12},
+    { 8, 0xB4    ,  8, 16},
+    { 8, 0xB5    , 16,  1},
+    { 8, 0xB6    ,  6,  6},
+    { 8, 0xB7    ,  9, 16},
+    { 8, 0xB8    ,  2,  8},
+    { 8, 0xB9    ,  5,  7},
+    { 8, 0xBA    , 10, 16},
+    { 8, 0xBB    , 16, 13},
+    { 8, 0xBC    ,  8,  3},
+    { 8, 0xBD    ,  8,  2},
+    { 8, 0xBE    ,  3,  8},
+    { 8, 0xBF    ,  5,  0},
+    { 8, 0xC0    , 16, 14},
+    { 8, 0xC1    , 11, 16},
+    { 8, 0xC2    ,  7,  5},
+    { 8, 0xC3    ,  4,  8},
+    { 8, 0xC4    ,  6,  7},
+    { 8, 0xC5    ,  7,  6},
+    { 8, 0xC6    ,  0,  5},
+    { 9, 0x18E   ,  8,  4},
+    { 9, 0x18F   , 16, 15},
+    { 9, 0x190   , 12, 16},
+    { 9, 0x191   ,  1,  8},
+    { 9, 0x192   ,  8,  1},
+    { 9, 0x193   , 14, 16},
+    { 9, 0x194   ,  5,  8},
+    { 9, 0x195   , 13, 16},
+    { 9, 0x196   ,  3,  9},
+    { 9, 0x197   ,  8,  5},
+    { 9, 0x198   ,  7,  7},
+    { 9, 0x199   ,  2,  9},
+    { 9, 0x19A   ,  8,  6},
+    { 9, 0x19B   ,  9,  2},
+    { 9, 0x19C   ,  9,  3},
+    { 9, 0x19D   , 15, 16},
+    { 9, 0x19E   ,  4,  9},
+    { 9, 0x19F   ,  6,  8},
+    { 9, 0x1A0   ,  6,  0},
+    { 9, 0x1A1   ,  9,  4},
+    { 9, 0x1A2   ,  5,  9},
+    { 9, 0x1A3   ,  8,  7},
+    { 9, 0x1A4   ,  7,  8},
+    { 9, 0x1A5   ,  1,  9},
+    { 9, 0x1A6   , 10,  3},
+    { 9, 0x1A7   ,  0,  6},
+    { 9, 0x1A8   , 10,  2},
+    { 9, 0x1A9   ,  9,  1},
+    { 9, 0x1AA   ,  9,  5},
+    { 9, 0x1AB   ,  4, 10},
+    { 9, 0x1AC   ,  2, 10},
+    { 9, 0x1AD   ,  9,  6},
+    { 9, 0x1AE   ,  3, 10},
+    { 9, 0x1AF   ,  6,  9},
+    { 9, 0x1B0   , 10,  4},
+    { 9, 0x1B1   ,  8,  8},
+    { 9, 0x1B2   , 10,  5},
+    { 9, 0x1B3   ,  9,  7},
+    { 9, 0x1B4   , 11,  3},
+    { 9, 0x1B5   ,  1, 10},
+    { 9, 0x1B6   ,  7,  0},
+    { 9, 0x1B7   , 10,  6},
+    { 9, 0x1B8   ,  7,  9},
+    { 9, 0x1B9   ,  3, 11},
+    { 9, 0x1BA   ,  5, 10},
+    { 9, 0x1BB   , 10,  1},
+    { 9, 0x1BC   ,  4, 11},
+    { 9, 0x1BD   , 11,  2},
+    { 9, 0x1BE   , 13,  2},
+    { 9, 0x1BF   ,  6, 10},
+    { 9, 0x1C0   , 13,  3},
+    { 9, 0x1C1   ,  2, 11},
+    { 9, 0x1C2   , 16,  0},
+    { 9, 0x1C3   ,  5, 11},
+    { 9, 0x1C4   , 11,  5},
+    {10, 0x38A   , 11,  4},
+    {10, 0x38B   ,  9,  8},
+    {10, 0x38C   ,  7, 10},
+    {10, 0x38D   ,  8,  9},
+    {10, 0x38E   ,  0, 16},
+    {10, 0x38F   ,  4, 13},
+    {10, 0x390   ,  0,  7},
+    {10, 0x391   ,  3, 13},
+    {10, 0x392   , 11,  6},
+    {10, 0x393   , 13,  1},
+    {10, 0x394   , 13,  4},
+    {10, 0x395   , 12,  3},
+    {10, 0x396   ,  2, 13},
+    {10, 0x397   , 13,  5},
+    {10, 0x398   ,  8, 10},
+    {10, 0x399   ,  6, 11},
+    {10, 0x39A   , 10,  8},
+    {10, 0x39B   , 10,  7},
+    {10, 0x39C   , 14,  2},
+    {10, 0x39D   , 12,  4},
+    {10, 0x39E   ,  1, 11},
+    {10, 0x39F   ,  4, 12},
+    {10, 0x3A0   , 11,  1},
+    {10, 0x3A1   ,  3, 12},
+    {10, 0x3A2   ,  1, 13},
+    {10, 0x3A3   , 12,  2},
+    {10, 0x3A4   ,  7, 11},
+    {10, 0x3A5   ,  3, 14},
+    {10, 0x3A6   ,  5, 12},
+    {10, 0x3A7   ,  5, 13},
+    {10, 0x3A8   , 14,  4},
+    {10, 0x3A9   ,  4, 14},
+    {10, 0x3AA   , 11,  7},
+    {10, 0x3AB   , 14,  3},
+    {10, 0x3AC   , 12,  5},
+    {10, 0x3AD   , 13,  6},
+    {10, 0x3AE   , 12,  6},
+    {10, 0x3AF   ,  8,  0},
+    {10, 0x3B0   , 11,  8},
+    {10, 0x3B1   ,  2, 12},
+    {10, 0x3B2   ,  9,  9},
+    {10, 0x3B3   , 14,  5},
+    {10, 0x3B4   ,  6, 13},
+    {10, 0x3B5   , 10, 10},
+    {10, 0x3B6   , 15,  2},
+    {10, 0x3B7   ,  8, 11},
+    {10, 0x3B8   ,  9, 10},
+    {10, 0x3B9   , 14,  6},
+    {10, 0x3BA   , 10,  9},
+    {10, 0x3BB   ,  5, 14},
+    {10, 0x3BC   , 11,  9},
+    {10, 0x3BD   , 14,  1},
+    {10, 0x3BE   ,  2, 14},
+    {10, 0x3BF   ,  6, 12},
+    {10, 0x3C0   ,  1, 12},
+    {10, 0x3C1   , 13,  8},
+    {10, 0x3C2   ,  0,  8},
+    {10, 0x3C3   , 13,  7},
+    {10, 0x3C4   ,  7, 12},
+    {10, 0x3C5   , 12,  7},
+    {10, 0x3C6   ,  7, 13},
+    {10, 0x3C7   , 15,  3},
+    {10, 0x3C8   , 12,  1},
+    {10, 0x3C9   ,  6, 14},
+    {10, 0x3CA   ,  2, 15},
+    {10, 0x3CB   , 15,  5},
+    {10, 0x3CC   , 15,  4},
+    {10, 0x3CD   ,  1, 14},
+    {10, 0x3CE   ,  9, 11},
+    {10, 0x3CF   ,  4, 15},
+    {10, 0x3D0   , 14,  7},
+    {10, 0x3D1   ,  8, 13},
+    {10, 0x3D2   , 13,  9},
+    {10, 0x3D3   ,  8, 12},
+    {10, 0x3D4   ,  5, 15},
+    {10, 0x3D5   ,  3, 15},
+    {10, 0x3D6   , 10, 11},
+    {10, 0x3D7   , 11, 10},
+    {10, 0x3D8   , 12,  8},
+    {10, 0x3D9   , 15,  6},
+    {10, 0x3DA   , 15,  7},
+    {10, 0x3DB   ,  8, 14},
+    {10, 0x3DC   , 15,  1},
+    {10, 0x3DD   ,  7, 14},
+    {10, 0x3DE   ,  9,  0},
+    {10, 0x3DF   ,  0,  9},
+    {10, 0x3E0   ,  9, 13},
+    {10, 0x3E1   ,  9, 12},
+    {10, 0x3E2   , 12,  9},
+    {10, 0x3E3   , 14,  8},
+    {10, 0x3E4   , 10, 13},
+    {10, 0x3E5   , 14,  9},
+    {10, 0x3E6   , 12, 10},
+    {10, 0x3E7   ,  6, 15},
+    {10, 0x3E8   ,  7, 15},
+    {11, 0x7D2   ,  9, 14},
+    {11, 0x7D3   , 15,  8},
+    {11, 0x7D4   , 11, 11},
+    {11, 0x7D5   , 11, 14},
+    {11, 0x7D6   ,  1, 15},
+    {11, 0x7D7   , 10, 12},
+    {11, 0x7D8   , 10, 14},
+    {11, 0x7D9   , 13, 11},
+    {11, 0x7DA   , 13, 10},
+    {11, 0x7DB   , 11, 13},
+    {11, 0x7DC   , 11, 12},
+    {11, 0x7DD   ,  8, 15},
+    {11, 0x7DE   , 14, 11},
+    {11, 0x7DF   , 13, 12},
+    {11, 0x7E0   , 12, 13},
+    {11, 0x7E1   , 15,  9},
+    {11, 0x7E2   , 14, 10},
+    {11, 0x7E3   , 10,  0},
+    {11, 0x7E4   , 12, 11},
+    {11, 0x7E5   ,  9, 15},
+    {11, 0x7E6   ,  0, 10},
+    {11, 0x7E7   , 12, 12},
+    {11, 0x7E8   , 11,  0},
+    {11, 0x7E9   , 12, 14},
+    {11, 0x7EA   , 10, 15},
+    {11, 0x7EB   , 13, 13},
+    {11, 0x7EC   ,  0, 13},
+    {11, 0x7ED   , 14, 12},
+    {11, 0x7EE   , 15, 10},
+    {11, 0x7EF   , 15, 11},
+    {11, 0x7F0   , 11, 15},
+    {11, 0x7F1   , 14, 13},
+    {11, 0x7F2   , 13,  0},
+    {11, 0x7F3   ,  0, 11},
+    {11, 0x7F4   , 13, 14},
+    {11, 0x7F5   , 15, 12},
+    {11, 0x7F6   , 15, 13},
+    {11, 0x7F7   , 12, 15},
+    {11, 0x7F8   , 14,  0},
+    {11, 0x7F9   , 14, 14},
+    {11, 0x7FA   , 13, 15},
+    {11, 0x7FB   , 12,  0},
+    {11, 0x7FC   , 14, 15},
+    {12, 0xFFA   ,  0, 14},
+    {12, 0xFFB   ,  0, 12},
+    {12, 0xFFC   , 15, 14},
+    {12, 0xFFD   , 15,  0},
+    {12, 0xFFE   ,  0, 15},
+    {12, 0xFFF   , 15, 15},
+  }
+};
@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 9,
+  .entries =
+  {
+    { 3, 0x0     ,  0,  0,  0,  0},
+    { 4, 0x2     ,  1,  0,  0,  0},
+    { 5, 0x6     , -1,  0,  0,  0},
+    { 5, 0x7     ,  0,  0,  0,  1},
+    { 5, 0x8     ,  0,  0, -1,  0},
+    { 5, 0x9     ,  0,  0,  0, -1},
+    { 5, 0xA     ,  0, -1,  0,  0},
+    { 5, 0xB     ,  0,  0,  1,  0},
+    { 5, 0xC     ,  0,  1,  0,  0},
+    { 6, 0x1A    ,  0, -1,  1,  0},
+    { 6, 0x1B    , -1,  1,  0,  0},
+    { 6, 0x1C    ,  0,  1, -1,  0},
+    { 6, 0x1D    ,  0,  0,  1, -1},
+    { 6, 0x1E    ,  0,  1,  0, -1},
+    { 6, 0x1F    ,  0,  0, -1,  1},
+    { 6, 0x20    , -1,  0,  0, -1},
+    { 6, 0x21    ,  1, -1,  0,  0},
+    { 6, 0x22    ,  1,  0, -1,  0},
+    { 6, 0x23    , -1, -1,  0,  0},
+    { 6, 0x24    ,  0,  0, -1, -1},
+    { 6, 0x25    ,  1,  0,  1,  0},
+    { 6, 0x26    ,  1,  0,  0,  1},
+    { 6, 0x27    ,  0, -1,  0,  1},
+    { 6, 0x28    , -1,  0,  1,  0},
+    { 6, 0x29    ,  0,  1,  0,  1},
+    { 6, 0x2A    ,  0, -1, -1,  0},
+    { 6, 0x2B    , -1,  0,  0,  1},
+    { 6, 0x2C    ,  0, -1,  0, -1},
+    { 6, 0x2D    , -1,  0, -1,  0},
+    { 6, 0x2E    ,  1,  1,  0,  0},
+    { 6, 0x2F    ,  0,  1,  1,  0},
+    { 6, 0x30    ,  0,  0,  1,  1},
+    { 6, 0x31    ,  1,  0,  0, -1},
+    { 7, 0x64    ,  0,  1, -1,  1},
+    { 7, 0x65    ,  1,  0, -1,  1},
+    { 7, 0x66    , -1,  1, -1,  0},
+    { 7, 0x67    ,  0, -1,  1, -1},
+    { 7, 0x68    ,  1, -1,  1,  0},
+    { 7, 0x69    ,  1,  1,  0, -1},
+    { 7, 0x6A    ,  1,  0,  1,  1},
+    { 7, 0x6B    , -1,  1,  1,  0},
+    { 7, 0x6C    ,  0, -1, -1,  1},
+    { 7, 0x6D    ,  1,  1,  1,  0},
+    { 7, 0x6E    , -1,  0,  1, -1},
+    { 7, 0x6F    , -1, -1, -1,  0},
+    { 7, 0x70    , -1,  0, -1,  1},
+    { 7, 0x71    ,  1, -1, -1,  0},
+    { 7, 0x72    ,  1,  1, -1,  0},
+    { 8, 0xE6    ,  1, -1,  0,  1},
+    { 8, 0xE7    , -1,  1,  0, -1},
+    { 8, 0xE8    , -1, -1,  1,  0},
+    { 8, 0xE9    , -1,  0,  1,  1},
+    { 8, 0xEA    , -1, -1,  0,  1},
+    { 8, 0xEB    , -1, -1,  0, -1},
+    { 8, 0xEC    ,  0, -1, -1, -1},
+    { 8, 0xED    ,  1,  0,  1, -1},
+    { 8, 0xEE    ,  1,  0, -1, -1},
+    { 8, 0xEF    ,  0,  1, -1, -1},
+    { 8, 0xF0    ,  0,  1,  1,  1},
+    { 8, 0xF1    , -1,  1,  0,  1},
+    { 8, 0xF2    , -1,  0, -1, -1},
+    { 8, 0xF3    ,  0,  1,  1, -1},
+    { 8, 0xF4    ,  1, -1,  0, -1},
+    { 8, 0xF5    ,  0, -1,  1,  1},
+    { 8, 0xF6    ,  1,  1,  0,  1},
+    { 8, 0xF7    ,  1, -1,  1, -1},
+    { 8, 0xF8    , -1,  1, -1,  1},
+    { 9, 0x1F2   ,  1, -1, -1,  1},
+    { 9, 0x1F3   , -1, -1, -1, -1},
+    { 9, 0x1F4   , -1,  1,  1, -1},
+    { 9, 0x1F5   , -1,  1,  1,  1},
+    { 9, 0x1F6   ,  1,  1,  1,  1},
+    { 9, 0x1F7   , -1, -1,  1, -1},
+    { 9, 0x1F8   ,  1, -1,  1,  1},
+    { 9, 0x1F9   , -1,  1, -1, -1},
+    { 9, 0x1FA   , -1, -1,  1,  1},
+    { 9, 0x1FB   ,  1,  1, -1, -1},
+    { 9, 0x1FC   ,  1, -1, -1, -1},
+    { 9, 0x1FD   , -1, -1, -1,  1},
+    { 9, 0x1FE   ,  1,  1, -1,  1},
+    { 9, 0x1FF   ,  1,  1,  1, -1},
+  }
+};
@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 16,
+  .entries =
+  {
+    { 1, 0x0     ,  0,  0,  0,  0},
+    { 4, 0x8     ,  1,  0,  0,  0},
+    { 4, 0x9     ,  0,  0,  0,  1},
+    { 4, 0xA     ,  0,  1,  0,  0},
+    { 4, 0xB     ,  0,  0,  1,  0},
+    { 5, 0x18    ,  1,  1,  0,  0},
+    { 5, 0x19    ,  0,  0,  1,  1},
+    { 6, 0x34    ,  0,  1,  1,  0},
+    { 6, 0x35    ,  0,  1,  0,  1},
+    { 6, 0x36    ,  1,  0,  1,  0},
+    { 6, 0x37    ,  0,  1,  1,  1},
+    { 6, 0x38    ,  1,  0,  0,  1},
+    { 6, 0x39    ,  1,  1,  1,  0},
+    { 7, 0x74    ,  1,  1,  1,  1},
+    { 7, 0x75    ,  1,  0,  1,  1},
+    { 7, 0x76    ,  1,  1,  0,  1},
+    { 8, 0xEE    ,  2,  0,  0,  0},
+    { 8, 0xEF    ,  0,  0,  0,  2},
+    { 8, 0xF0    ,  0,  0,  1,  2},
+    { 8, 0xF1    ,  2,  1,  0,  0},
+    { 8, 0xF2    ,  1,  2,  1,  0},
+    { 9, 0x1E6   ,  0,  0,  2,  1},
+    { 9, 0x1E7   ,  0,  1,  2,  1},
+    { 9, 0x1E8   ,  1,  2,  0,  0},
+    { 9, 0x1E9   ,  0,  1,  1,  2},
+    { 9, 0x1EA   ,  2,  1,  1,  0},
+    { 9, 0x1EB   ,  0,  0,  2,  0},
+    { 9, 0x1EC   ,  0,  2,  1,  0},
+    { 9, 0x1ED   ,  0,  1,  2,  0},
+    { 9, 0x1EE   ,  0,  2,  0,  0},
+    { 9, 0x1EF   ,  0,  1,  0,  2},
+    { 9, 0x1F0   ,  2,  0,  1,  0},
+    { 9, 0x1F1   ,  1,  2,  1,  1},
+    { 9, 0x1F2   ,  0,  2,  1,  1},
+    { 9, 0x1F3   ,  1,  1,  2,  0},
+    { 9, 0x1F4   ,  1,  1,  2,  1},
+    {10, 0x3EA   ,  1,  2,  0,  1},
+    {10, 0x3EB   ,  1,  0,  2,  0},
+    {10, 0x3EC   ,  1,  0,  2,  1},
+    {10, 0x3ED   ,  0,  2,  0,  1},
+    {10, 0x3EE   ,  2,  1,  1,  1},
+    {10, 0x3EF   ,  1,  1,  1,  2},
+    {10, 0x3F0   ,  2,  1,  0,  1},
+    {10, 0x3F1   ,  1,  0,  1,  2},
+    {10, 0x3F2   ,  0,  0,  2,  2},
+    {10, 0x3F3   ,  0,  1,  2,  2},
+    {10, 0x3F4   ,  2,  2,  1,  0},
+    {10, 0x3F5   ,  1,  2,  2,  0},
+    {10, 0x3F6   ,  1,  0,  0,  2},
+    {10, 0x3F7   ,  2,  0,  0,  1},
+    {10, 0x3F8   ,  0,  2,  2,  1},
+    {11, 0x7F2   ,  2,  2,  0,  0},
+    {11, 0x7F3   ,  1,  2,  2,  1},
+    {11, 0x7F4   ,  1,  1,  0,  2},
+    {11, 0x7F5   ,  2,  0,  1,  1},
+    {11, 0x7F6   ,  1,  1,  2,  2},
+    {11, 0x7F7   ,  2,  2,  1,  1},
+    {11, 0x7F8   ,  0,  2,  2,  0},
+    {11, 0x7F9   ,  0,  2,  1,  2},
+    {12, 0xFF4   ,  1,  0,  2,  2},
+    {12, 0xFF5   ,  2,  2,  0,  1},
+    {12, 0xFF6   ,  2,  1,  2,  0},
+    {12, 0xFF7   ,  2,  2,  2,  0},
+    {12, 0xFF8   ,  0,  2,  2,  2},
+    {12, 0xFF9   ,  2,  2,  2,  1},
+    {12, 0xFFA   ,  2,  1,  2,  1},
+    {12, 0xFFB   ,  1,  2,  1,  2},
+    {12, 0xFFC   ,  1,  2,  2,  2},
+    {13, 0x1FFA  ,  0,  2,  0,  2},
+    {13, 0x1FFB  ,  2,  0,  2,  0},
+    {13, 0x1FFC  ,  1,  2,  0,  2},
+    {14, 0x3FFA  ,  2,  0,  2,  1},
+    {14, 0x3FFB  ,  2,  1,  1,  2},
+    {14, 0x3FFC  ,  2,  1,  0,  2},
+    {15, 0x7FFA  ,  2,  2,  2,  2},
+    {15, 0x7FFB  ,  2,  2,  1,  2},
+    {15, 0x7FFC  ,  2,  1,  2,  2},
+    {15, 0x7FFD  ,  2,  0,  1,  2},
+    {15, 0x7FFE  ,  2,  0,  0,  2},
+    {16, 0xFFFE  ,  2,  2,  0,  2},
+    {16, 0xFFFF  ,  2,  0,  2,  2},
+  }
+};
@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 12,
+  .entries =
+  {
+    { 4, 0x0     ,  1,  1,  1,  1},
+    { 4, 0x1     ,  0,  1,  1,  1},
+    { 4, 0x2     ,  1,  1,  0,  1},
+    { 4, 0x3     ,  1,  1,  1,  0},
+    { 4, 0x4     ,  1,  0,  1,  1},
+    { 4, 0x5     ,  1,  0,  0,  0},
+    { 4, 0x6     ,  1,  1,  0,  0},
+    { 4, 0x7     ,  0,  0,  0,  0},
+    { 4, 0x8     ,  0,  0,  1,  1},
+    { 4, 0x9     ,  1,  0,  1,  0},
+    { 5, 0x14    ,  1,  0,  0,  1},
+    { 5, 0x15    ,  0,  1,  1,  0},
+    { 5, 0x16    ,  0,  0,  0,  1},
+    { 5, 0x17    ,  0,  1,  0,  1},
+    { 5, 0x18    ,  0,  0,  1,  0},
+    { 5, 0x19    ,  0,  1,  0,  0},
+    { 7, 0x68    ,  2,  1,  1,  1},
+    { 7, 0x69    ,  1,  1,  2,  1},
+    { 7, 0x6A    ,  1,  2,  1,  1},
+    { 7, 0x6B    ,  1,  1,  1,  2},
+    { 7, 0x6C    ,  2,  1,  1,  0},
+    { 7, 0x6D    ,  2,  1,  0,  1},
+    { 7, 0x6E    ,  1,  2,  1,  0},
+    { 7, 0x6F    ,  2,  0,  1,  1},
+    { 7, 0x70    ,  0,  1,  2,  1},
+    { 8, 0xE2    ,  0,  1,  1,  2},
+    { 8, 0xE3    ,  1,  1,  2,  0},
+    { 8, 0xE4    ,  0,  2,  1,  1},
+    { 8, 0xE5    ,  1,  0,  1,  2},
+    { 8, 0xE6    ,  1,  2,  0,  1},
+    { 8, 0xE7    ,  1,  1,  0,  2},
+    { 8, 0xE8    ,  1,  0,  2,  1},
+    { 8, 0xE9    ,  2,  1,  0,  0},
+    { 8, 0xEA    ,  2,  0,  1,  0},
+    { 8, 0xEB    ,  1,  2,  0,  0},
+    { 8, 0xEC    ,  2,  0,  0,  1},
+    { 8, 0xED    ,  0,  1,  0,  2},
+    { 8, 0xEE    ,  0,  2,  1,  0},
+    { 8, 0xEF    ,  0,  0,  1,  2},
+    { 8, 0xF0    ,  0,  1,  2,  0},
+    { 8, 0xF1    ,  0,  2,  0,  1},
+    { 8, 0xF2    ,  1,  0,  0,  2},
+    { 8, 0xF3    ,  0,  0,  2,  1},
+    { 8, 0xF4    ,  1,  0,  2,  0},
+    { 8, 0xF5    ,  2,  0,  0,  0},
+    { 8, 0xF6    ,  0,  0,  0,  2},
+    { 9, 0x1EE   ,  0,  2,  0,  0},
+    { 9, 0x1EF   ,  0,  0,  2,  0},
+    { 9, 0x1F0   ,  1,  2,  2,  1},
+    { 9, 0x1F1   ,  2,  2,  1,  1},
+    { 9, 0x1F2   ,  2,  1,  2,  1},
+    { 9, 0x1F3   ,  1,  1,  2,  2},
+    { 9, 0x1F4   ,  1,  2,  1,  2},
+    { 9, 0x1F5   ,  2,  1,  1,  2},
+    {10, 0x3EC   ,  1,  2,  2,  0},
+    {10, 0x3ED   ,  2,  2,  1,  0},
+    {10, 0x3EE   ,  2,  1,  2,  0},
+    {10, 0x3EF   ,  0,  2,  2,  1},
+    {10, 0x3F0   ,  0,  1,  2,  2},
+    {10, 0x3F1   ,  2,  2,  0,  1},
+    {10, 0x3F2   ,  0,  2,  1,  2},
+    {10, 0x3F3   ,  2,  0,  2,  1},
+    {10, 0x3F4   ,  1,  0,  2,  2},
+    {10, 0x3F5   ,  2,  2,  2,  1},
+    {10, 0x3F6   ,  1,  2,  0,  2},
+    {10, 0x3F7   ,  2,  0,  1,  2},
+    {10, 0x3F8   ,  2,  1,  0,  2},
+    {10, 0x3F9   ,  1,  2,  2,  2},
+    {11, 0x7F4   ,  2,  1,  2,  2},
+    {11, 0x7F5   ,  2,  2,  1,  2},
+    {11, 0x7F6   ,  0,  2,  2,  0},
+    {11, 0x7F7   ,  2,  2,  0,  0},
+    {11, 0x7F8   ,  0,  0,  2,  2},
+    {11, 0x7F9   ,  2,  0,  2,  0},
+    {11, 0x7FA   ,  0,  2,  0,  2},
+    {11, 0x7FB   ,  2,  0,  0,  2},
+    {11, 0x7FC   ,  2,  2,  2,  2},
+    {11, 0x7FD   ,  0,  2,  2,  2},
+    {11, 0x7FE   ,  2,  2,  2,  0},
+    {12, 0xFFE   ,  2,  2,  0,  2},
+    {12, 0xFFF   ,  2,  0,  2,  2},
+  }
+};
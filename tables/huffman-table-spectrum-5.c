@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 13,
+  .entries =
+  {
+    { 1, 0x0     ,  0,  0},
+    { 4, 0x8     , -1,  0},
+    { 4, 0x9     ,  1,  0},
+    { 4, 0xA     ,  0,  1},
+    { 4, 0xB     ,  0, -1},
+    { 5, 0x18    ,  1, -1},
+    { 5, 0x19    , -1,  1},
+    { 5, 0x1A    , -1, -1},
+    { 5, 0x1B    ,  1,  1},
+    { 7, 0x70    , -2,  0},
+    { 7, 0x71    ,  0,  2},
+    { 7, 0x72    ,  2,  0},
+    { 7, 0x73    ,  0, -2},
+    { 8, 0xE8    , -2, -1},
+    { 8, 0xE9    ,  2,  1},
+    { 8, 0xEA    , -1, -2},
+    { 8, 0xEB    ,  1,  2},
+    { 8, 0xEC    , -2,  1},
+    { 8, 0xED    ,  2, -1},
+    { 8, 0xEE    , -1,  2},
+    { 8, 0xEF    ,  1, -2},
+    { 8, 0xF0    , -3,  0},
+    { 8, 0xF1    ,  3,  0},
+    { 8, 0xF2    ,  0, -3},
+    { 8, 0xF3    ,  0,  3},
+    { 9, 0x1E8   , -3, -1},
+    { 9, 0x1E9   ,  1,  3},
+    { 9, 0x1EA   ,  3,  1},
+    { 9, 0x1EB   , -1, -3},
+    { 9, 0x1EC   , -3,  1},
+    { 9, 0x1ED   ,  3, -1},
+    { 9, 0x1EE   ,  1, -3},
+    { 9, 0x1EF   , -1,  3},
+    { 9, 0x1F0   , -2,  2},
+    { 9, 0x1F1   ,  2,  2},
+    { 9, 0x1F2   , -2, -2},
+    { 9, 0x1F3   ,  2, -2},
+    {10, 0x3E8   , -3, -2},
+    {10, 0x3E9   ,  3, -2},
+    {10, 0x3EA   , -2,  3},
+    {10, 0x3EB   ,  2, -3},
+    {10, 0x3EC   ,  3,  2},
+    {10, 0x3ED   ,  2,  3},
+    {10, 0x3EE   , -3,  2},
+    {10, 0x3EF   , -2, -3},
+    {10, 0x3F0   ,  0, -4},
+    {10, 0x3F1   , -4,  0},
+    {10, 0x3F2   ,  4,  1},
+    {10, 0x3F3   ,  4,  0},
+    {11, 0x7E8   , -4, -1},
+    {11, 0x7E9   ,  0,  4},
+    {11, 0x7EA   ,  4, -1},
+    {11, 0x7EB   , -1, -4},
+    {11, 0x7EC   ,  1,  4},
+    {11, 0x7ED   , -1,  4},
+    {11, 0x7EE   , -4,  1},
+    {11, 0x7EF   ,  1, -4},
+    {11, 0x7F0   ,  3, -3},
+    {11, 0x7F1   , -3, -3},
+    {11, 0x7F2   , -3,  3},
+    {11, 0x7F3   , -2,  4},
+    {11, 0x7F4   , -4, -2},
+    {11, 0x7F5   ,  4,  2},
+    {11, 0x7F6   ,  2, -4},
+    {11, 0x7F7   ,  2,  4},
+    {11, 0x7F8   ,  3,  3},
+    {11, 0x7F9   , -4,  2},
+    {12, 0xFF4   , -2, -4},
+    {12, 0xFF5   ,  4, -2},
+    {12, 0xFF6   ,  3, -4},
+    {12, 0xFF7   , -4, -3},
+    {12, 0xFF8   , -4,  3},
+    {12, 0xFF9   ,  3,  4},
+    {12, 0xFFA   , -3,  4},
+    {12, 0xFFB   ,  4,  3},
+    {12, 0xFFC   ,  4, -3},
+    {12, 0xFFD   , -3, -4},
+    {13, 0x1FFC  ,  4, -4},
+    {13, 0x1FFD  , -4,  4},
+    {13, 0x1FFE  ,  4,  4},
+    {13, 0x1FFF  , -4, -4},
+  }
+};
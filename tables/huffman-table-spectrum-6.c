@@ -0,0 +1,88 @@
+{
+  .count = 81,
+  .maxBits = 11,
+  .entries =
+  {
+    { 4, 0x0     ,  0,  0},
+    { 4, 0x1     ,  1,  0},
+    { 4, 0x2     ,  0, -1},
+    { 4, 0x3     ,  0,  1},
+    { 4, 0x4     , -1,  0},
+    { 4, 0x5     ,  1,  1},
+    { 4, 0x6     , -1,  1},
+    { 4, 0x7     ,  1, -1},
+    { 4, 0x8     , -1, -1},
+    { 6, 0x24    ,  2, -1},
+    { 6, 0x25    ,  2,  1},
+    { 6, 0x26    , -2,  1},
+    { 6, 0x27    , -2, -1},
+    { 6, 0x28    , -2,  0},
+    { 6, 0x29    , -1,  2},
+    { 6, 0x2A    ,  2,  0},
+    { 6, 0x2B    ,  1, -2},
+    { 6, 0x2C    ,  1,  2},
+    { 6, 0x2D    ,  0, -2},
+    { 6, 0x2E    , -1, -2},
+    { 6, 0x2F    ,  0,  2},
+    { 6, 0x30    ,  2, -2},
+    { 6, 0x31    , -2,  2},
+    { 6, 0x32    , -2, -2},
+    { 6, 0x33    ,  2,  2},
+    { 7, 0x68    , -3,  1},
+    { 7, 0x69    ,  3,  1},
+    { 7, 0x6A    ,  3, -1},
+    { 7, 0x6B    , -1,  3},
+    { 7, 0x6C    , -3, -1},
+    { 7, 0x6D    ,  1,  3},
+    { 7, 0x6E    ,  1, -3},
+    { 7, 0x6F    , -1, -3},
+    { 7, 0x70    ,  3,  0},
+    { 7, 0x71    , -3,  0},
+    { 7, 0x72    ,  0, -3},
+    { 7, 0x73    ,  0,  3},
+    { 7, 0x74    ,  3,  2},
+    { 8, 0xEA    , -3, -2},
+    { 8, 0xEB    , -2,  3},
+    { 8, 0xEC    ,  2,  3},
+    { 8, 0xED    ,  3, -2},
+    { 8, 0xEE    ,  2, -3},
+    { 8, 0xEF    , -2, -3},
+    { 8, 0xF0    , -3,  2},
+    { 8, 0xF1    ,  3,  3},
+    { 9, 0x1E4   ,  3, -3},
+    { 9, 0x1E5   , -3, -3},
+    { 9, 0x1E6   , -3,  3},
+    { 9, 0x1E7   ,  1, -4},
+    { 9, 0x1E8   , -1, -4},
+    { 9, 0x1E9   ,  4,  1},
+    { 9, 0x1EA   , -4,  1},
+    { 9, 0x1EB   , -4, -1},
+    { 9, 0x1EC   ,  1,  4},
+    { 9, 0x1ED   ,  4, -1},
+    { 9, 0x1EE   , -1,  4},
+    { 9, 0x1EF   ,  0, -4},
+    { 9, 0x1F0   , -4,  2},
+    { 9, 0x1F1   , -4, -2},
+    { 9, 0x1F2   ,  2,  4},
+    { 9, 0x1F3   , -2, -4},
+    { 9, 0x1F4   , -4,  0},
+    { 9, 0x1F5   ,  4,  2},
+    { 9, 0x1F6   ,  4, -2},
+    { 9, 0x1F7   , -2,  4},
+    { 9, 0x1F8   ,  4,  0},
+    { 9, 0x1F9   ,  2, -4},
+    { 9, 0x1FA   ,  0,  4},
+    {10, 0x3F6   , -3, -4},
+    {10, 0x3F7   , -3,  4},
+    {10, 0x3F8   ,  3, -4},
+    {10, 0x3F9   ,  4, -3},
+    {10, 0x3FA   ,  3,  4},
+    {10, 0x3FB   ,  4,  3},
+    {10, 0x3FC   , -4,  3},
+    {10, 0x3FD   , -4, -3},
+    {11, 0x7FC   ,  4,  4},
+    {11, 0x7FD   , -4,  4},
+    {11, 0x7FE   , -4, -4},
+    {11, 0x7FF   ,  4, -4},
+  }
+};
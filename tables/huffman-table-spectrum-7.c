@@ -0,0 +1,71 @@
+{
+  .count = 64,
+  .maxBits = 12,
+  .entries =
+  {
+    { 1, 0x0     ,  0,  0},
+    { 3, 0x4     ,  1,  0},
+    { 3, 0x5     ,  0,  1},
+    { 4, 0xC     ,  1,  1},
+    { 6, 0x34    ,  2,  1},
+    { 6, 0x35    ,  1,  2},
+    { 6, 0x36    ,  2,  0},
+    { 6, 0x37    ,  0,  2},
+    { 7, 0x70    ,  3,  1},
+    { 7, 0x71    ,  1,  3},
+    { 7, 0x72    ,  2,  2},
+    { 7, 0x73    ,  3,  0},
+    { 7, 0x74    ,  0,  3},
+    { 8, 0xEA    ,  2,  3},
+    { 8, 0xEB    ,  3,  2},
+    { 8, 0xEC    ,  1,  4},
+    { 8, 0xED    ,  4,  1},
+    { 8, 0xEE    ,  1,  5},
+    { 8, 0xEF    ,  5,  1},
+    { 8, 0xF0    ,  3,  3},
+    { 8, 0xF1    ,  2,  4},
+    { 8, 0xF2    ,  0,  4},
+    { 8, 0xF3    ,  4,  0},
+    { 9, 0x1E8   ,  4,  2},
+    { 9, 0x1E9   ,  2,  5},
+    { 9, 0x1EA   ,  5,  2},
+    { 9, 0x1EB   ,  0,  5},
+    { 9, 0x1EC   ,  6,  1},
+    { 9, 0x1ED   ,  5,  0},
+    { 9, 0x1EE   ,  1,  6},
+    { 9, 0x1EF   ,  4,  3},
+    { 9, 0x1F0   ,  3,  5},
+    { 9, 0x1F1   ,  3,  4},
+    { 9, 0x1F2   ,  5,  3},
+    { 9, 0x1F3   ,  2,  6},
+    { 9, 0x1F4   ,  6,  2},
+    { 9, 0x1F5   ,  1,  7},
+    {10, 0x3EC   ,  3,  6},
+    {10, 0x3ED   ,  0,  6},
+    {10, 0x3EE   ,  6,  0},
+    {10, 0x3EF   ,  4,  4},
+    {10, 0x3F0   ,  7,  1},
+    {10, 0x3F1   ,  4,  5},
+    {10, 0x3F2   ,  7,  2},
+    {10, 0x3F3   ,  5,  4},
+    {10, 0x3F4   ,  6,  3},
+    {10, 0x3F5   ,  2,  7},
+    {10, 0x3F6   ,  7,  3},
+    {10, 0x3F7   ,  6,  4},
+    {10, 0x3F8   ,  5,  5},
+    {10, 0x3F9   ,  4,  6},
+    {10, 0x3FA   ,  3,  7},
+    {11, 0x7F6   ,  7,  0},
+    {11, 0x7F7   ,  0,  7},
+    {11, 0x7F8   ,  6,  5},
+    {11, 0x7F9   ,  5,  6},
+    {11, 0x7FA   ,  7,  4},
+    {11, 0x7FB   ,  4,  7},
+    {11, 0x7FC   ,  5,  7},
+    {11, 0x7FD   ,  7,  5},
+    {12, 0xFFC   ,  7,  6},
+    {12, 0xFFD   ,  6,  6},
+    {12, 0xFFE   ,  6,  7},
+    {12, 0xFFF   ,  7,  7},
+  }
+};
@@ -0,0 +1,71 @@
+{
+  .count = 64,
+  .maxBits = 10,
+  .entries =
+  {
+    { 3, 0x0     ,  1,  1},
+    { 4, 0x2     ,  2,  1},
+    { 4, 0x3     ,  1,  0},
+    { 4, 0x4     ,  1,  2},
+    { 4, 0x5     ,  0,  1},
+    { 4, 0x6     ,  2,  2},
+    { 5, 0xE     ,  0,  0},
+    { 5, 0xF     ,  2,  0},
+    { 5, 0x10    ,  0,  2},
+    { 5, 0x11    ,  3,  1},
+    { 5, 0x12    ,  1,  3},
+    { 5, 0x13    ,  3,  2},
+    { 5, 0x14    ,  2,  3},
+    { 6, 0x2A    ,  3,  3},
+    { 6, 0x2B    ,  4,  1},
+    { 6, 0x2C    ,  1,  4},
+    { 6, 0x2D    ,  4,  2},
+    { 6, 0x2E    ,  2,  4},
+    { 6, 0x2F    ,  3,  0},
+    { 6, 0x30    ,  0,  3},
+    { 6, 0x31    ,  4,  3},
+    { 6, 0x32    ,  3,  4},
+    { 6, 0x33    ,  5,  2},
+    { 7, 0x68    ,  5,  1},
+    { 7, 0x69    ,  2,  5},
+    { 7, 0x6A    ,  1,  5},
+    { 7, 0x6B    ,  5,  3},
+    { 7, 0x6C    ,  3,  5},
+    { 7, 0x6D    ,  4,  4},
+    { 7, 0x6E    ,  5,  4},
+    { 7, 0x6F    ,  0,  4},
+    { 7, 0x70    ,  4,  5},
+    { 7, 0x71    ,  4,  0},
+    { 7, 0x72    ,  2,  6},
+    { 7, 0x73    ,  6,  2},
+    { 7, 0x74    ,  6,  1},
+    { 7, 0x75    ,  1,  6},
+    { 8, 0xEC    ,  3,  6},
+    { 8, 0xED    ,  6,  3},
+    { 8, 0xEE    ,  5,  5},
+    { 8, 0xEF    ,  5,  0},
+    { 8, 0xF0    ,  6,  4},
+    { 8, 0xF1    ,  0,  5},
+    { 8, 0xF2    ,  4,  6},
+    { 8, 0xF3    ,  7,  1},
+    { 8, 0xF4    ,  7,  2},
+    { 8, 0xF5    ,  2,  7},
+    { 8, 0xF6    ,  6,  5},
+    { 8, 0xF7    ,  7,  3},
+    { 8, 0xF8    ,  1,  7},
+    { 8, 0xF9    ,  5,  6},
+    { 8, 0xFA    ,  3,  7},
+    { 9, 0x1F6   ,  6,  6},
+    { 9, 0x1F7   ,  7,  4},
+    { 9, 0x1F8   ,  6,  0},
+    { 9, 0x1F9   ,  4,  7},
+    { 9, 0x1FA   ,  0,  6},
+    { 9, 0x1FB   ,  7,  5},
+    { 9, 0x1FC   ,  7,  6},
+    { 9, 0x1FD   ,  6,  7},
+    {10, 0x3FC   ,  5,  7},
+    {10, 0x3FD   ,  7,  0},
+    {10, 0x3FE   ,  0,  7},
+    {10, 0x3FF   ,  7,  7},
+  }
+};
@@ -0,0 +1,176 @@
+{
+  .count = 169,
+  .maxBits = 15,
+  .entries =
+  {
+    { 1, 0x0     ,  0,  0},
+    { 3, 0x4     ,  1,  0},
+    { 3, 0x5     ,  0,  1},
+    { 4, 0xC     ,  1,  1},
+    { 6, 0x34    ,  2,  1},
+    { 6, 0x35    ,  1,  2},
+    { 6, 0x36    ,  2,  0},
+    { 6, 0x37    ,  0,  2},
+    { 7, 0x70    ,  3,  1},
+    { 7, 0x71    ,  2,  2},
+    { 7, 0x72    ,  1,  3},
+    { 8, 0xE6    ,  3,  0},
+    { 8, 0xE7    ,  0,  3},
+    { 8, 0xE8    ,  2,  3},
+    { 8, 0xE9    ,  3,  2},
+    { 8, 0xEA    ,  1,  4},
+    { 8, 0xEB    ,  4,  1},
+    { 8, 0xEC    ,  2,  4},
+    { 8, 0xED    ,  1,  5},
+    { 9, 0x1DC   ,  4,  2},
+    { 9, 0x1DD   ,  3,  3},
+    { 9, 0x1DE   ,  0,  4},
+    { 9, 0x1DF   ,  4,  0},
+    { 9, 0x1E0   ,  5,  1},
+    { 9, 0x1E1   ,  2,  5},
+    { 9, 0x1E2   ,  1,  6},
+    { 9, 0x1E3   ,  3,  4},
+    { 9, 0x1E4   ,  5,  2},
+    { 9, 0x1E5   ,  6,  1},
+    { 9, 0x1E6   ,  4,  3},
+    {10, 0x3CE   ,  0,  5},
+    {10, 0x3CF   ,  2,  6},
+    {10, 0x3D0   ,  5,  0},
+    {10, 0x3D1   ,  1,  7},
+    {10, 0x3D2   ,  3,  5},
+    {10, 0x3D3   ,  1,  8},
+    {10, 0x3D4   ,  8,  1},
+    {10, 0x3D5   ,  4,  4},
+    {10, 0x3D6   ,  5,  3},
+    {10, 0x3D7   ,  6,  2},
+    {10, 0x3D8   ,  7,  1},
+    {10, 0x3D9   ,  0,  6},
+    {10, 0x3DA   ,  8,  2},
+    {10, 0x3DB   ,  2,  8},
+    {10, 0x3DC   ,  3,  6},
+    {10, 0x3DD   ,  2,  7},
+    {10, 0x3DE   ,  4,  5},
+    {10, 0x3DF   ,  9,  1},
+    {10, 0x3E0   ,  1,  9},
+    {10, 0x3E1   ,  7,  2},
+    {11, 0x7C4   ,  6,  0},
+    {11, 0x7C5   ,  5,  4},
+    {11, 0x7C6   ,  6,  3},
+    {11, 0x7C7   ,  8,  3},
+    {11, 0x7C8   ,  0,  7},
+    {11, 0x7C9   ,  9,  2},
+    {11, 0x7CA   ,  3,  8},
+    {11, 0x7CB   ,  4,  6},
+    {11, 0x7CC   ,  3,  7},
+    {11, 0x7CD   ,  0,  8},
+    {11, 0x7CE   , 10,  1},
+    {11, 0x7CF   ,  6,  4},
+    {11, 0x7D0   ,  2,  9},
+    {11, 0x7D1   ,  5,  5},
+    {11, 0x7D2   ,  8,  0},
+    {11, 0x7D3   ,  7,  0},
+    {11, 0x7D4   ,  7,  3},
+    {11, 0x7D5   , 10,  2},
+    {11, 0x7D6   ,  9,  3},
+    {11, 0x7D7   ,  8,  4},
+    {11, 0x7D8   ,  1, 10},
+    {11, 0x7D9   ,  7,  4},
+    {11, 0x7DA   ,  6,  5},
+    {11, 0x7DB   ,  5,  6},
+    {11, 0x7DC   ,  4,  8},
+    {11, 0x7DD   ,  4,  7},
+    {11, 0x7DE   ,  3,  9},
+    {11, 0x7DF   , 11,  1},
+    {11, 0x7E0   ,  5,  8},
+    {11, 0x7E1   ,  9,  0},
+    {11, 0x7E2   ,  8,  5},
+    {12, 0xFC6   , 10,  3},
+    {12, 0xFC7   ,  2, 10},
+    {12, 0xFC8   ,  0,  9},
+    {12, 0xFC9   , 11,  2},
+    {12, 0xFCA   ,  9,  4},
+    {12, 0xFCB   ,  6,  6},
+    {12, 0xFCC   , 12,  1},
+    {12, 0xFCD   ,  4,  9},
+    {12, 0xFCE   ,  8,  6},
+    {12, 0xFCF   ,  1, 11},
+    {12, 0xFD0   ,  9,  5},
+    {12, 0xFD1   , 10,  4},
+    {12, 0xFD2   ,  5,  7},
+    {12, 0xFD3   ,  7,  5},
+    {12, 0xFD4   ,  2, 11},
+    {12, 0xFD5   ,  1, 12},
+    {12, 0xFD6   , 12,  2},
+    {12, 0xFD7   , 11,  3},
+    {12, 0xFD8   ,  3, 10},
+    {12, 0xFD9   ,  5,  9},
+    {12, 0xFDA   ,  6,  7},
+    {12, 0xFDB   ,  8,  7},
+    {12, 0xFDC   , 11,  4},
+    {12, 0xFDD   ,  0, 10},
+    {12, 0xFDE   ,  7,  6},
+    {12, 0xFDF   , 12,  3},
+    {12, 0xFE0   , 10,  0},
+    {12, 0xFE1   , 10,  5},
+    {12, 0xFE2   ,  4, 10},
+    {12, 0xFE3   ,  6,  8},
+    {12, 0xFE4   ,  2, 12},
+    {12, 0xFE5   ,  9,  6},
+    {12, 0xFE6   ,  9,  7},
+    {12, 0xFE7   ,  4, 11},
+    {12, 0xFE8   , 11,  0},
+    {12, 0xFE9   ,  6,  9},
+    {12, 0xFEA   ,  3, 11},
+    {12, 0xFEB   ,  5, 10},
+    {13, 0x1FD8  ,  8,  8},
+    {13, 0x1FD9  ,  7,  8},
+    {13, 0x1FDA  , 12,  5},
+    {13, 0x1FDB  ,  3, 12},
+    {13, 0x1FDC  , 11,  5},
+    {13, 0x1FDD  ,  7,  7},
+    {13, 0x1FDE  , 12,  4},
+    {13, 0x1FDF  , 11,  6},
+    {13, 0x1FE0  , 10,  6},
+    {13, 0x1FE1  ,  4, 12},
+    {13, 0x1FE2  ,  7,  9},
+    {13, 0x1FE3  ,  5, 11},
+    {13, 0x1FE4  ,  0, 11},
+    {13, 0x1FE5  , 12,  6},
+    {13, 0x1FE6  ,  6, 10},
+    {13, 0x1FE7  , 12,  0},
+    {13, 0x1FE8  , 10,  7},
+    {13, 0x1FE9  ,  5, 12},
+    {13, 0x1FEA  ,  7, 10},
+    {13, 0x1FEB  ,  9,  8},
+    {13, 0x1FEC  ,  0, 12},
+    {13, 0x1FED  , 11,  7},
+    {13, 0x1FEE  ,  8,  9},
+    {13, 0x1FEF  ,  9,  9},
+    {13, 0x1FF0  , 10,  8},
+    {13, 0x1FF1  ,  7, 11},
+    {13, 0x1FF2  , 12,  7},
+    {13, 0x1FF3  ,  6, 11},
+    {13, 0x1FF4  ,  8, 11},
+    {13, 0x1FF5  , 11,  8},
+    {13, 0x1FF6  ,  7, 12},
+    {13, 0x1FF7  ,  6, 12},
+    {14, 0x3FF0  ,  8, 10},
+    {14, 0x3FF1  , 10,  9},
+    {14, 0x3FF2  ,  8, 12},
+    {14, 0x3FF3  ,  9, 10},
+    {14, 0x3FF4  ,  9, 11},
+    {14, 0x3FF5  ,  9, 12},
+    {14, 0x3FF6  , 10, 11},
+    {14, 0x3FF7  , 12,  9},
+    {14, 0x3FF8  , 10, 10},
+    {14, 0x3FF9  , 11,  9},
+    {14, 0x3FFA  , 12,  8},
+    {14, 0x3FFB  , 11, 10},
+    {14, 0x3FFC  , 12, 10},
+    {14, 0x3FFD  , 12, 11},
+    {15, 0x7FFC  , 10, 12},
+    {15, 0x7FFD  , 11, 11},
+    {15, 0x7FFE  , 11, 12},
+    {15, 0x7FFF  , 12, 12},
+  }
+};